@@ -12,6 +12,8 @@
 #include "private/internationalization.hpp"
 #include <set>
 #include <vector>
+#include <algorithm>
+#include <functional>
 #include <cstring>
 #include <limits>
 
@@ -24,50 +26,99 @@ template <typename WeightedElement>
 class Ranker
 {
 public:
+	/// \brief Implementation strategy of the ranker
+	enum Strategy
+	{
+		AutoStrategy,		///< brute force array for small ranklists, bounded min-heap otherwise
+		BruteForceStrategy,	///< sorted array with index (only for less than 128 ranks)
+		MultiSetStrategy,	///< std::multiset, dropping the minimum element when the list is full
+		HeapStrategy		///< bounded min-heap, elements sorted when the result is fetched
+	};
+
 	/// \brief Constructor
-	explicit Ranker( std::size_t maxNofRanks_)
-		:m_maxNofRanks(maxNofRanks_),m_nofRanks(0)
+	explicit Ranker( std::size_t maxNofRanks_, Strategy strategy_=AutoStrategy)
+		:m_strategy(strategy_),m_maxNofRanks(maxNofRanks_),m_nofRanks(0)
 	{
 		if (maxNofRanks_ == 0) throw strus::runtime_error( "%s",  _TXT( "illegal value for max number of ranks"));
-		std::size_t nn = (m_maxNofRanks < MaxIndexSize)?m_maxNofRanks:MaxIndexSize;
-		for (std::size_t ii=0; ii<nn; ++ii) m_brute_index[ii] = ii;
+		if (m_strategy == AutoStrategy)
+		{
+			m_strategy = (m_maxNofRanks < MaxIndexSize) ? BruteForceStrategy : HeapStrategy;
+		}
+		else if (m_strategy == BruteForceStrategy && m_maxNofRanks >= MaxIndexSize)
+		{
+			throw strus::runtime_error( "%s",  _TXT( "max number of ranks too big for brute force ranker"));
+		}
+		if (m_strategy == BruteForceStrategy)
+		{
+			for (std::size_t ii=0; ii<m_maxNofRanks; ++ii) m_brute_index[ii] = ii;
+		}
+		else if (m_strategy == HeapStrategy)
+		{
+			m_heap.reserve( m_maxNofRanks < MaxHeapReserve ? m_maxNofRanks : MaxHeapReserve);
+		}
 	}
 	~Ranker(){}
 
 	void insert( const WeightedElement& item)
 	{
-		if (m_maxNofRanks < MaxIndexSize)
+		switch (m_strategy)
 		{
-			bruteInsert( item);
-		}
-		else
-		{
-			multisetInsert( item);
+			case HeapStrategy: heapInsert( item); break;
+			case MultiSetStrategy: multisetInsert( item); break;
+			default: bruteInsert( item); break;
 		}
 	}
 
 	std::vector<WeightedElement> result( std::size_t firstRank=0) const
 	{
-		if (m_maxNofRanks < MaxIndexSize)
-		{
-			return bruteResult( firstRank);
-		}
-		else
+		switch (m_strategy)
 		{
-			return multisetResult( firstRank);
+			case HeapStrategy: return heapResult( firstRank);
+			case MultiSetStrategy: return multisetResult( firstRank);
+			default: return bruteResult( firstRank);
 		}
 	}
 
+	/// \brief Get the number of elements accepted into the ranklist, including the ones dropped later for better ones
+	/// \note Elements rejected because the ranklist was complete and they did not exceed the minimum rank are not counted, see 'accepts(const WeightedElement&)'
 	std::size_t nofRanks() const
 	{
 		return m_nofRanks;
 	}
 
+	/// \brief Evaluate if the ranklist has all its slots filled and an element has to be lower than minRank to be dropped
+	bool complete() const
+	{
+		return m_nofRanks >= m_maxNofRanks;
+	}
+
+	/// \brief Get the element with the lowest rank in the list, the threshold an element has to exceed to get into a complete ranklist
+	/// \note Only defined if the ranklist is not empty
+	const WeightedElement& minRank() const
+	{
+		switch (m_strategy)
+		{
+			case HeapStrategy: return m_heap.empty() ? lastRank() : m_heap.front();
+			case MultiSetStrategy: return m_rankset.empty() ? lastRank() : *m_rankset.begin();
+			default: return lastRank();
+		}
+	}
+
+	/// \brief Evaluate in O(1) if an element would get into the ranklist
+	/// \param[in] item element to check
+	/// \return true, if the element would be inserted
+	bool accepts( const WeightedElement& item) const
+	{
+		return !complete() || item > minRank();
+	}
+
 private:
 	void multisetInsert( const WeightedElement& item)
 	{
+		if (!accepts( item)) return;
 		m_rankset.insert( item);
-		if (m_maxNofRanks < ++m_nofRanks)
+		++m_nofRanks;
+		if (m_rankset.size() > m_maxNofRanks)
 		{
 			m_rankset.erase( m_rankset.begin());
 		}
@@ -90,6 +141,42 @@ private:
 		return rt;
 	}
 
+	void heapInsert( const WeightedElement& item)
+	{
+		if (m_heap.size() < m_maxNofRanks)
+		{
+			++m_nofRanks;
+			m_heap.push_back( item);
+			std::push_heap( m_heap.begin(), m_heap.end(), std::greater<WeightedElement>());
+		}
+		else if (item > m_heap.front())
+		{
+			++m_nofRanks;
+			// ... replace the minimum element at the root and sift it down
+			std::size_t size = m_heap.size();
+			std::size_t idx = 0;
+			for (;;)
+			{
+				std::size_t child = idx*2 + 1;
+				if (child >= size) break;
+				if (child+1 < size && m_heap[ child+1] < m_heap[ child]) ++child;
+				if (!(m_heap[ child] < item)) break;
+				m_heap[ idx] = m_heap[ child];
+				idx = child;
+			}
+			m_heap[ idx] = item;
+		}
+	}
+
+	std::vector<WeightedElement> heapResult( std::size_t firstRank) const
+	{
+		if (firstRank >= m_heap.size()) return std::vector<WeightedElement>();
+		std::vector<WeightedElement> rt( m_heap);
+		std::sort( rt.begin(), rt.end(), std::greater<WeightedElement>());
+		rt.erase( rt.begin(), rt.begin() + firstRank);
+		return rt;
+	}
+
 	void bruteInsert_at( std::size_t idx, const WeightedElement& doc)
 	{
 		std::size_t docix = m_brute_index[ m_maxNofRanks-1];
@@ -100,6 +187,7 @@ private:
 
 	void bruteInsert( const WeightedElement& doc)
 	{
+		if (!accepts( doc)) return;
 		if (!m_nofRanks)
 		{
 			m_brute_ar[ m_brute_index[ 0] = 0] = doc;
@@ -180,8 +268,10 @@ private:
 			WeightedElement,
 			std::less<WeightedElement>,
 			LocalStructAllocator<WeightedElement> > RankSet;
+	enum {MaxIndexSize=128, MaxHeapReserve=1<<14};
+	Strategy m_strategy;
 	RankSet m_rankset;
-	enum {MaxIndexSize=128};
+	std::vector<WeightedElement> m_heap;
 
 	unsigned char m_brute_index[ MaxIndexSize];
 	WeightedElement m_brute_ar[ MaxIndexSize];
@@ -9,6 +9,7 @@
 /// \file "databaseClientInterface.hpp"
 #ifndef _STRUS_DATABASE_CLIENT_INTERFACE_HPP_INCLUDED
 #define _STRUS_DATABASE_CLIENT_INTERFACE_HPP_INCLUDED
+#include "strus/storage/databasePinnedSlice.hpp"
 #include <string>
 
 namespace strus
@@ -75,6 +76,26 @@ public:
 			std::string& value,
 			const DatabaseOptions& options) const=0;
 
+	/// \brief Read a value by key into a slice that can be reused for the next read
+	/// \param[in] key pointer to the key of the item to fetch
+	/// \param[in] keysize size of the key of the item to fetch in bytes
+	/// \param[in,out] value slice with the value read, keeping its memory valid as long as a copy of it exists
+	/// \param[in] options options as hints for the database
+	/// \return true, if it was found
+	/// \note The default implementation copies the value with 'readValue' into a buffer owned by 'value' and reuses the memory of this buffer for the next read.
+	///	Databases that can reference the value in place without freezing the state of the database seen by later reads (e.g. a read only memory mapped database) override it.
+	virtual bool readValuePinned(
+			const char* key,
+			std::size_t keysize,
+			DatabasePinnedSlice& value,
+			const DatabaseOptions& options) const
+	{
+		value.reset();
+		if (!readValue( key, keysize, value.buffer(), options)) return false;
+		value.assignBuffer();
+		return true;
+	}
+
 	/// \brief Get the disk usage in kilo byte units (approximately) of the database
 	virtual long diskUsage() const=0;
 
@@ -11,6 +11,10 @@
 #define _STRUS_FORWARD_INDEX_ITERATOR_INTERFACE_HPP_INCLUDED
 #include "strus/storage/index.hpp"
 #include <string>
+#include <vector>
+#include <cstddef>
+#include <limits>
+#include <new>
 
 namespace strus
 {
@@ -18,6 +22,51 @@ namespace strus
 /// \brief Iterator on the forward index mapping occurrencies to the terms inserted
 class ForwardIteratorInterface
 {
+public:
+	/// \brief Reference to the value of an item in the forward index without ownership
+	class Slice
+	{
+	public:
+		/// \brief Default constructor
+		Slice()
+			:m_ptr(0),m_size(0){}
+		/// \brief Constructor
+		/// \param[in] ptr_ pointer to the value
+		/// \param[in] size_ size of the value in bytes
+		Slice( const char* ptr_, std::size_t size_)
+			:m_ptr(ptr_),m_size(size_){}
+		/// \brief Copy constructor
+		Slice( const Slice& o)
+			:m_ptr(o.m_ptr),m_size(o.m_size){}
+
+		/// \brief Get the pointer to the value
+		const char* ptr() const		{return m_ptr;}
+		/// \brief Get the size of the value in bytes
+		std::size_t size() const	{return m_size;}
+		/// \brief Get a copy of the value as string
+		std::string tostring() const	{return std::string(m_ptr,m_size);}
+		/// \brief Evaluate if the slice is defined
+		bool defined() const		{return m_ptr!=0;}
+
+	private:
+		const char* m_ptr;		///< pointer to data (no ownership)
+		std::size_t m_size;		///< size of the data in bytes
+	};
+
+	/// \brief Item of the forward index with its position
+	struct Token
+	{
+		Index pos;			///< position of the item
+		Slice value;			///< value of the item
+
+		/// \brief Constructor
+		Token( const Index& pos_, const Slice& value_)
+			:pos(pos_),value(value_){}
+		/// \brief Copy constructor
+		Token( const Token& o)
+			:pos(o.pos),value(o.value){}
+	};
+
 public:
 	/// \brief Destructor
 	virtual ~ForwardIteratorInterface(){}
@@ -34,6 +83,62 @@ public:
 	/// \brief Fetch the item at the current position
 	/// \return the element string
 	virtual std::string fetch()=0;
+
+	/// \brief Fetch the item at the current position without copying it
+	/// \return the element as slice referencing memory of the iterator, valid until the next call of a method of this iterator that moves it
+	/// \note The default implementation copies the result of 'fetch()' into a buffer of the iterator
+	virtual Slice fetchSlice()
+	{
+		try
+		{
+			m_fetchBuffer = fetch();
+			return Slice( m_fetchBuffer.c_str(), m_fetchBuffer.size());
+		}
+		catch (const std::bad_alloc&)
+		{
+			return Slice();
+		}
+	}
+
+	/// \brief Fetch all items of a position range of the current document in one call without copying them
+	/// \param[in] range range of positions (end excluded) to fetch, an undefined range ends with the end of the document
+	/// \param[in] maxNofTokens maximum number of items to fetch or 0 if not restricted
+	/// \param[out] tokens where to write the items fetched to, cleared before, the slices are valid until the next call of a method of this iterator that moves it
+	/// \note The current position of the iterator is undefined after this call
+	/// \note The default implementation iterates with 'skipPos( const Index&)' and copies the results of 'fetch()' into a buffer of the iterator
+	virtual void fetchRange( const IndexRange& range, std::size_t maxNofTokens, std::vector<Token>& tokens)
+	{
+		try
+		{
+			tokens.clear();
+			m_fetchBuffer.clear();
+			Index endpos = range.defined() ? range.end() : std::numeric_limits<Index>::max();
+			Index pos = skipPos( range.start());
+			for (; pos && pos < endpos; pos = skipPos( pos+1))
+			{
+				std::string value = fetch();
+				m_fetchBuffer.append( value);
+				tokens.push_back( Token( pos, Slice( 0, value.size())));
+				if (tokens.size() == maxNofTokens) break;
+			}
+			// Assign the values at the end, the buffer may get reallocated while appending:
+			std::size_t valueofs = 0;
+			std::vector<Token>::iterator ti = tokens.begin(), te = tokens.end();
+			for (; ti != te; ++ti)
+			{
+				std::size_t valuesize = ti->value.size();
+				ti->value = Slice( m_fetchBuffer.c_str() + valueofs, valuesize);
+				valueofs += valuesize;
+			}
+		}
+		catch (const std::bad_alloc&)
+		{
+			tokens.clear();
+		}
+	}
+
+private:
+	std::string m_fetchBuffer;		///< buffer for the values returned by the default implementations of 'fetchSlice()' and 'fetchRange(const IndexRange&,std::size_t,std::vector<Token>&)'
 };
 
 }//namespace
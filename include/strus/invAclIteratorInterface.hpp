@@ -10,6 +10,8 @@
 #ifndef _STRUS_INVERTED_ACL_ITERATOR_INTERFACE_HPP_INCLUDED
 #define _STRUS_INVERTED_ACL_ITERATOR_INTERFACE_HPP_INCLUDED
 #include "strus/storage/index.hpp"
+#include <vector>
+#include <algorithm>
 
 namespace strus
 {
@@ -27,6 +29,28 @@ public:
 	virtual Index skipDoc( const Index& docno)=0;
 };
 
+/// \brief Iterator on an ascending sorted list of document numbers without any state besides this list
+/// \note Used as default for the ACL restriction of a set of users, see StorageClientInterface::createInvAclIterator(const std::vector<std::string>&)
+class InvAclDocumentSetIterator
+	:public InvAclIteratorInterface
+{
+public:
+	/// \brief Constructor
+	/// \param[in] docnos_ ascending sorted list of document numbers without duplicates
+	explicit InvAclDocumentSetIterator( const std::vector<Index>& docnos_)
+		:m_docnos(docnos_){}
+	virtual ~InvAclDocumentSetIterator(){}
+
+	virtual Index skipDoc( const Index& docno)
+	{
+		std::vector<Index>::const_iterator di = std::lower_bound( m_docnos.begin(), m_docnos.end(), docno);
+		return di == m_docnos.end() ? 0 : *di;
+	}
+
+private:
+	std::vector<Index> m_docnos;		///< ascending sorted list of document numbers
+};
+
 }//namespace
 #endif
 
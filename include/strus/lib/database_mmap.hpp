@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Exported functions of the library implementing the read only key/value store database interface on memory mapped files
+/// \file database_mmap.hpp
+#ifndef _STRUS_DATABASE_MMAP_LIB_HPP_INCLUDED
+#define _STRUS_DATABASE_MMAP_LIB_HPP_INCLUDED
+#include <string>
+
+/// \brief strus toplevel namespace
+namespace strus {
+
+/// \brief Forward declaration
+class FileLocatorInterface;
+/// \brief Forward declaration
+class DatabaseInterface;
+/// \brief Forward declaration
+class ErrorBufferInterface;
+
+/// \brief Create a read only database interface on an immutable, sorted, memory mapped file with the functions for accessing the key/value store database.
+/// \note A database of this type is created by exporting an existing database with DatabaseInterface::restoreDatabase
+/// \param[in] filelocator interface to locate files to read or the working directory where to write files to
+/// \param[in] errorhnd reference to error buffer (ownership hold by caller)
+DatabaseInterface* createDatabaseType_mmap( const FileLocatorInterface* filelocator, ErrorBufferInterface* errorhnd);
+
+}//namespace
+#endif
+
@@ -93,6 +93,61 @@ int load_user_assignments(
 		int commitSize,
 		ErrorBufferInterface* errorhnd);
 
+/// \brief Load some meta data assignments for a storage with the bulk loader for big files
+/// \note The file is memory mapped and parsed by a pool of threads, the document ids are resolved in batches and the updates are sorted by document number, so that the meta data blocks are rewritten once per commit
+/// \param[in,out] storage the storage to instrument
+/// \param[in] metadataName name of the meta data field to assign
+/// \param[in] attributemapref map that maps the update key to a list of document numbers to update (NULL, if the docid or docno is the key)
+/// \param[in] file the file to read from
+/// \param[in] commitSize number of documents to update until an implicit commit is called (0 => no implicit commit), should be big for sorting to pay off
+/// \param[in] nofThreads number of threads parsing the file
+/// \param[in,out] errorhnd buffer for reporting errors (exceptions)
+/// \return the number of documents (non distinct) updated
+int load_metadata_assignments_bulk(
+		StorageClientInterface& storage,
+		const std::string& metadataName,
+		const std::multimap<std::string,strus::Index>* attributemapref,
+		const std::string& file,
+		int commitSize,
+		int nofThreads,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Load some attribute assignments for a storage with the bulk loader for big files
+/// \note The file is memory mapped and parsed by a pool of threads, the document ids are resolved in batches and the updates are sorted by document number
+/// \param[in,out] storage the storage to instrument
+/// \param[in] attributeName name of the attribute to assign
+/// \param[in] attributemapref map that maps the update key to a list of document numbers to update (NULL, if the docid or docno is the key)
+/// \param[in] file the file to read from
+/// \param[in] commitSize number of documents to update until an implicit commit is called (0 => no implicit commit)
+/// \param[in] nofThreads number of threads parsing the file
+/// \param[in,out] errorhnd buffer for reporting errors (exceptions)
+/// \return the number of documents (non distinct) updated
+int load_attribute_assignments_bulk(
+		StorageClientInterface& storage,
+		const std::string& attributeName,
+		const std::multimap<std::string,strus::Index>* attributemapref,
+		const std::string& file,
+		int commitSize,
+		int nofThreads,
+		ErrorBufferInterface* errorhnd);
+
+/// \brief Load some user rights assignments for a storage with the bulk loader for big files
+/// \note The file is memory mapped and parsed by a pool of threads, the document ids are resolved in batches and the updates are sorted by document number
+/// \param[in,out] storage the storage to instrument
+/// \param[in] attributemapref map that maps the update key to a list of document numbers to update (NULL, if the docid or docno is the key)
+/// \param[in] file the file to read from
+/// \param[in] commitSize number of documents to update until an implicit commit is called (0 => no implicit commit)
+/// \param[in] nofThreads number of threads parsing the file
+/// \param[in,out] errorhnd buffer for reporting errors (exceptions)
+/// \return the number of documents (non distinct) updated
+int load_user_assignments_bulk(
+		StorageClientInterface& storage,
+		const std::multimap<std::string,strus::Index>* attributemapref,
+		const std::string& file,
+		int commitSize,
+		int nofThreads,
+		ErrorBufferInterface* errorhnd);
+
 /// \brief Adds the feature definitions in the file (word2vec text or binary format) given by a path to a vector storage
 /// \param[in] vstorage vector storage object where to add the loaded vectors to
 /// \param[in] vectorfile Path of the file to parse, either a google binary vector file format or text
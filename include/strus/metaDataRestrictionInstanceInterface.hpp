@@ -26,6 +26,22 @@ public:
 	/// \return true, if it matches, false if not
 	/// \remark A deleted document has every metadata element nulled out. So it depends on the restriction expression wheter the document number matches or not. There esists no other flag for the document number in the system telling wheter it exists or not. 
 	virtual bool match( const Index& docno) const=0;
+
+	/// \brief Get the smallest document number greater than or equal to a document number and smaller than or equal to an upper bound that matches the restriction condition
+	/// \param[in] docno local internal document number to start the search from
+	/// \param[in] maxdocno upper bound of the document numbers visited, e.g. the end of the document number range evaluated
+	/// \return the document number found or 0 if there is no matching document with a number up to 'maxdocno' or up to the maximum document number of the storage at creation of this instance
+	/// \remark Allows callers to skip whole ranges of documents not matching the restriction without calling match for each of them
+	/// \note The default implementation calls match for each document number visited
+	virtual Index skipDoc( const Index& docno, const Index& maxdocno) const
+	{
+		Index dn = docno > 0 ? docno : 1;
+		for (; dn <= maxdocno; ++dn)
+		{
+			if (match( dn)) return dn;
+		}
+		return 0;
+	}
 };
 
 } //namespace
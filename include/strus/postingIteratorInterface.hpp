@@ -10,6 +10,7 @@
 #ifndef _STRUS_POSTING_ITERATOR_INTERFACE_HPP_INCLUDED
 #define _STRUS_POSTING_ITERATOR_INTERFACE_HPP_INCLUDED
 #include "strus/storage/index.hpp"
+#include "strus/storage/postingBlockSummary.hpp"
 #include <vector>
 
 namespace strus
@@ -59,6 +60,14 @@ public:
 	/// \brief Get the ordinal position length of the current match
 	/// \return the ordinal position length
 	virtual Index length() const=0;
+
+	/// \brief Get the summary (maximum ff, minimum document length) of the storage block containing the current document (the one returned with the last 'skipDoc( const Index&)' call)
+	/// \return the block summary or an undefined summary, if not available (e.g. for composed features or storage blocks written without summary)
+	/// \note Used for calculating upper bounds of weights of a range of documents without decoding positions
+	virtual PostingBlockSummary blockSummary()
+	{
+		return PostingBlockSummary();
+	}
 };
 
 }//namespace
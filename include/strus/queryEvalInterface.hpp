@@ -12,6 +12,7 @@
 #include "strus/structView.hpp"
 #include <iostream>
 #include <vector>
+#include <cstddef>
 
 namespace strus
 {
@@ -135,6 +136,20 @@ public:
 	/// \note Default is set to yes = true
 	virtual void usePositionInformation( const std::string& featureSet, bool yes)=0;
 
+	/// \brief Define the number of threads used to evaluate a single query
+	/// \note The document number space is partitioned into ranges evaluated in parallel and the partial ranklists are merged. The result is the same as for a sequential evaluation.
+	/// \remark Queries with more than one selection feature set are evaluated sequentially, because the evaluation of a subsequent selection set depends on the number of ranks found with the sets before.
+	/// \param[in] nofThreads number of threads to use, 0 or 1 for a sequential evaluation in the calling thread (default)
+	virtual void defineParallelism( int nofThreads)=0;
+
+	/// \brief Define a cache for the results of queries evaluated with this program
+	/// \note Results are identified by the query features, restrictions, variables, evaluation set, users and rank range and by the revision of the storage.
+	///	A commit of a transaction of the storage makes all results cached for it outdated.
+	/// \remark The configuration of the program must not change after defining the cache, results would be identified without it.
+	/// \note Queries evaluated with a debug trace enabled are not answered from or put into the cache.
+	/// \param[in] maxMemoryUsage maximum number of bytes of results held in the cache, 0 to disable the cache (default)
+	virtual void defineResultCache( std::size_t maxMemoryUsage)=0;
+
 	/// \brief Create a new query
 	/// \param[in] storage storage to run the query on
 	/// \return a query instance for this query evaluation type
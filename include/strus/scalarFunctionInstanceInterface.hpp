@@ -11,6 +11,7 @@
 #define _STRUS_SCALAR_FUNCTION_INSTANCE_INTERFACE_HPP_INCLUDED
 #include "strus/structView.hpp"
 #include <string>
+#include <cstddef>
 
 namespace strus
 {
@@ -35,6 +36,20 @@ public:
 	/// \param[in] nofargs number of elements in args
 	virtual double call( const double* args, unsigned int nofargs) const=0;
 
+	/// \brief Execute the function for an array of argument tuples
+	/// \param[in] args array of 'nofcalls' argument tuples with 'nofargs' elements each, stored one after the other
+	/// \param[in] nofargs number of elements of each argument tuple
+	/// \param[in] nofcalls number of argument tuples
+	/// \param[out] results array of 'nofcalls' elements the results are written to
+	/// \remark The default implementation calls 'call' for each tuple
+	virtual void callBatch( const double* args, unsigned int nofargs, std::size_t nofcalls, double* results) const
+	{
+		for (std::size_t ci=0; ci < nofcalls; ++ci)
+		{
+			results[ ci] = call( args + ci * nofargs, nofargs);
+		}
+	}
+
 	/// \brief Get the name of the function
 	/// \return the identifier
 	virtual const char* name() const=0;
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Slice of a value read from the key/value store database, referencing the value in place or owning a reusable copy of it
+/// \file "databasePinnedSlice.hpp"
+#ifndef _STRUS_DATABASE_PINNED_SLICE_HPP_INCLUDED
+#define _STRUS_DATABASE_PINNED_SLICE_HPP_INCLUDED
+#include "strus/base/shared_ptr.hpp"
+#include <string>
+#include <cstddef>
+
+namespace strus
+{
+
+/// \brief Slice with a value read from the database, either referencing the memory of the value kept valid by a reference to its owner or owning a copy of it
+/// \note The owner is any object keeping the memory of the value valid, e.g. the memory mapped file or a cursor positioned on the value
+/// \note The memory of the value is valid as long as a copy of the slice referencing it exists.
+class DatabasePinnedSlice
+{
+public:
+	/// \brief Default constructor, creates an undefined slice
+	DatabasePinnedSlice()
+		:m_owner(),m_buf(),m_ptr(0),m_size(0),m_owned(false){}
+	/// \brief Constructor
+	/// \param[in] owner_ object keeping the memory of the value valid
+	/// \param[in] ptr_ pointer to the value
+	/// \param[in] size_ size of the value in bytes
+	DatabasePinnedSlice( const strus::shared_ptr<void>& owner_, const char* ptr_, std::size_t size_)
+		:m_owner(owner_),m_buf(),m_ptr(ptr_),m_size(size_),m_owned(false){}
+	/// \brief Copy constructor
+	DatabasePinnedSlice( const DatabasePinnedSlice& o)
+		:m_owner(o.m_owner),m_buf(o.m_buf),m_ptr(o.m_owned?m_buf.c_str():o.m_ptr),m_size(o.m_size),m_owned(o.m_owned){}
+	/// \brief Assignment
+	DatabasePinnedSlice& operator=( const DatabasePinnedSlice& o)
+	{
+		m_owner = o.m_owner; m_buf = o.m_buf; m_ptr = o.m_owned?m_buf.c_str():o.m_ptr; m_size = o.m_size; m_owned = o.m_owned;
+		return *this;
+	}
+
+	/// \brief Get the pointer to the value
+	const char* ptr() const			{return m_ptr;}
+	/// \brief Get the size of the value in bytes
+	std::size_t size() const		{return m_size;}
+	/// \brief Evaluate if the slice is defined
+	bool defined() const			{return m_ptr!=0;}
+	/// \brief Return the value as a string (copy)
+	std::string tostring() const		{return std::string(m_ptr,m_size);}
+
+	/// \brief Get the object keeping the memory of the value valid, if the value is not owned by the slice
+	const strus::shared_ptr<void>& owner() const	{return m_owner;}
+
+	/// \brief Get the buffer owned by the slice to copy a value into
+	/// \note The value copied into the buffer gets the value of the slice with 'assignBuffer()'
+	std::string& buffer()			{return m_buf;}
+	/// \brief Make the contents of the buffer owned by the slice its value
+	void assignBuffer()
+	{
+		m_owner.reset(); m_ptr = m_buf.c_str(); m_size = m_buf.size(); m_owned = true;
+	}
+	/// \brief Make a value referenced in place the value of the slice
+	/// \param[in] owner_ object keeping the memory of the value valid
+	/// \param[in] ptr_ pointer to the value
+	/// \param[in] size_ size of the value in bytes
+	/// \note The memory of the owned buffer is kept for reuse
+	void assignPinned( const strus::shared_ptr<void>& owner_, const char* ptr_, std::size_t size_)
+	{
+		m_owner = owner_; m_buf.clear(); m_ptr = ptr_; m_size = size_; m_owned = false;
+	}
+
+	/// \brief Release the value and the reference to its owner
+	/// \note The memory of the owned buffer is kept for reuse
+	void reset()
+	{
+		m_owner.reset(); m_buf.clear(); m_ptr = 0; m_size = 0; m_owned = false;
+	}
+
+private:
+	strus::shared_ptr<void> m_owner;			///< object keeping the memory of the value valid, if not owned
+	std::string m_buf;					///< buffer with the value, if owned
+	const char* m_ptr;					///< pointer to the value
+	std::size_t m_size;					///< size of the value in bytes
+	bool m_owned;						///< true, if the value is the contents of m_buf
+};
+
+}//namespace
+#endif
+
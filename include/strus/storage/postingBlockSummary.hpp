@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Summary of a storage block of postings used to calculate upper bounds of weights without decoding the block
+/// \file postingBlockSummary.hpp
+#ifndef _STRUS_POSTING_BLOCK_SUMMARY_HPP_INCLUDED
+#define _STRUS_POSTING_BLOCK_SUMMARY_HPP_INCLUDED
+#include "strus/storage/index.hpp"
+
+namespace strus {
+
+/// \brief Summary of the storage block of postings containing the current document of a posting iterator
+class PostingBlockSummary
+{
+public:
+	/// \brief Default constructor (undefined summary)
+	PostingBlockSummary()
+		:m_lastdocno(0),m_maxff(0),m_mindoclen(0){}
+	/// \brief Constructor
+	/// \param[in] lastdocno_ last document number covered by the summary
+	/// \param[in] maxff_ maximum feature frequency of all documents covered
+	/// \param[in] mindoclen_ minimum lower bound of the document length in ordinal positions of all documents covered
+	PostingBlockSummary( const Index& lastdocno_, int maxff_, int mindoclen_)
+		:m_lastdocno(lastdocno_),m_maxff(maxff_),m_mindoclen(mindoclen_){}
+	/// \brief Copy constructor
+	PostingBlockSummary( const PostingBlockSummary& o)
+		:m_lastdocno(o.m_lastdocno),m_maxff(o.m_maxff),m_mindoclen(o.m_mindoclen){}
+
+	/// \brief Get the last document number covered by this summary, the first is the current document of the iterator
+	Index lastdocno() const				{return m_lastdocno;}
+	/// \brief Get the maximum feature frequency of all documents covered
+	int maxff() const				{return m_maxff;}
+	/// \brief Get the minimum lower bound of the document length of all documents covered
+	/// \note The lower bound of a document length is the highest position of the feature in the document (or its ff, if no positions are stored)
+	int mindoclen() const				{return m_mindoclen;}
+
+	/// \brief Evaluate if the summary is defined
+	bool defined() const				{return m_lastdocno > 0;}
+
+private:
+	Index m_lastdocno;	///< last document number covered
+	int m_maxff;		///< maximum feature frequency of all documents covered
+	int m_mindoclen;	///< minimum lower bound of the document length of all documents covered
+};
+
+}//namespace
+#endif
+
@@ -14,9 +14,12 @@
 #include "strus/storage/statisticsMessage.hpp"
 #include "strus/storage/blockStatistics.hpp"
 #include "strus/storage/termStatistics.hpp"
+#include "strus/invAclIteratorInterface.hpp"
 #include <string>
 #include <vector>
 #include <ostream>
+#include <algorithm>
+#include <new>
 
 namespace strus
 {
@@ -30,8 +33,6 @@ class ForwardIteratorInterface;
 /// \brief Forward declaration
 class DocumentTermIteratorInterface;
 /// \brief Forward declaration
-class InvAclIteratorInterface;
-/// \brief Forward declaration
 class ValueIteratorInterface;
 /// \brief Forward declaration
 class StorageTransactionInterface;
@@ -142,6 +143,53 @@ public:
 		createInvAclIterator(
 			const std::string& username) const=0;
 
+	/// \brief Create a an iterator on the numbers of documents any user of a set is allowed to see
+	/// \param[in] usernames names of the users (order and duplicates do not matter, unknown users are ignored)
+	/// \return the iterator on the documents (with ownership) or NULL, if there is no access control enabled
+	/// \note The union of the documents of the users is computed once, each skip is a lookup in this set
+	/// \note The iterator returned has no state besides this set and can be shared by threads evaluating the same query
+	/// \note The storage has to be created with access control enabled
+	/// \note The default implementation collects the documents of the single user iterators into a list
+	virtual InvAclIteratorInterface*
+		createInvAclIterator(
+			const std::vector<std::string>& usernames) const
+	{
+		std::vector<Index> docnos;
+		bool withAcl = false;
+		std::vector<std::string>::const_iterator ui = usernames.begin(), ue = usernames.end();
+		for (; ui != ue; ++ui)
+		{
+			InvAclIteratorInterface* itr = createInvAclIterator( *ui);
+			if (!itr) return 0;
+			withAcl = true;
+			try
+			{
+				Index docno = itr->skipDoc( 1);
+				for (; docno; docno = itr->skipDoc( docno+1))
+				{
+					docnos.push_back( docno);
+				}
+			}
+			catch (const std::bad_alloc&)
+			{
+				delete itr;
+				return 0;
+			}
+			delete itr;
+		}
+		if (!withAcl) return 0;
+		std::sort( docnos.begin(), docnos.end());
+		docnos.erase( std::unique( docnos.begin(), docnos.end()), docnos.end());
+		try
+		{
+			return new InvAclDocumentSetIterator( docnos);
+		}
+		catch (const std::bad_alloc&)
+		{
+			return 0;
+		}
+	}
+
 	/// \brief Create a an iterator on the access control lists of documents
 	/// \return the iterator on the ACLs
 	/// \note The storage has to be created with access control enabled
@@ -163,6 +211,24 @@ public:
 	/// \return the document number, or 0, if no documents are inserted
 	virtual Index maxDocumentNumber() const=0;
 
+	/// \brief Get the revision of the storage content, incremented with every change visible to queries (transaction commit, meta data table change, reload)
+	/// \return the revision number
+	/// \note Can be used to detect if results derived from the storage content (e.g. cached query results) are outdated
+	/// \note The default implementation returns 0, the revision is only meaningful for a storage with an instance identifier
+	virtual unsigned int revision() const
+	{
+		return 0;
+	}
+
+	/// \brief Get the identifier of this storage client instance, assigned at construction and unique in the process
+	/// \return the identifier or 0, if the storage client cannot be identified
+	/// \note Can be used together with the revision to identify the storage of results derived from the storage content (e.g. cached query results)
+	/// \note The default implementation returns 0, results of queries on storages without identifier are not cached
+	virtual unsigned int instanceId() const
+	{
+		return 0;
+	}
+
 	/// \brief Get the local internal document number
 	/// \param[in] docid document id of the document inserted
 	/// \return the document number or 0, if it does not exist
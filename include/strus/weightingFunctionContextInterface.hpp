@@ -13,6 +13,9 @@
 #include "strus/storage/termStatistics.hpp"
 #include "strus/storage/weightedField.hpp"
 #include <string>
+#include <vector>
+#include <limits>
+#include <cstddef>
 
 namespace strus
 {
@@ -47,6 +50,68 @@ public:
 	/// \param[in] docno document number
 	/// \return the calculated best N weighted fields of the document as reference
 	virtual const std::vector<WeightedField>& call( const Index& docno)=0;
+
+	/// \brief Evaluate if the function can weight any batch of documents with 'callBatch', because it never returns weighted fields or more than one weight
+	/// \return true if 'callBatch' can be used, false if the documents have to be weighted with 'call'
+	/// \remark The default implementation returns false
+	/// \note Do call this method after all features have been added and all variables have been set
+	/// \note Decided before any document is weighted, because a batch evaluation cannot be repeated without seeking backwards
+	virtual bool batchCapable() const
+	{
+		return false;
+	}
+
+	/// \brief Call the weighting function for a batch of documents
+	/// \param[in] docnos array of document numbers in ascending order
+	/// \param[in] nofdocnos number of document numbers in 'docnos'
+	/// \param[out] weights array of size 'nofdocnos' the weight of each document is written to
+	/// \return true on success, false on error or if the function returns weighted fields
+	/// \remark The default implementation calls 'call' for each document
+	/// \note Only used for functions declaring with 'batchCapable' that they never return weighted fields
+	/// \note Allows the weighting functions to run the lookups and the formula for many documents in tight loops
+	virtual bool callBatch( const Index* docnos, std::size_t nofdocnos, double* weights)
+	{
+		for (std::size_t di=0; di < nofdocnos; ++di)
+		{
+			const std::vector<WeightedField>& wf = call( docnos[ di]);
+			if (wf.empty())
+			{
+				weights[ di] = 0.0;
+			}
+			else if (wf.size() == 1 && !wf[0].field().defined())
+			{
+				weights[ di] = wf[0].weight();
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/// \brief Get an upper bound for any weight returned by 'call' for any document
+	/// \return the maximum weight or +infinity if the function cannot give a bound
+	/// \remark Used by the query evaluation for dynamic pruning (MaxScore) of documents that cannot make it into the result
+	/// \note Do call this method after all features have been added and all variables have been set
+	virtual double maxWeight() const
+	{
+		return std::numeric_limits<double>::infinity();
+	}
+
+	/// \brief Get an upper bound for the weights returned by 'call' for a range of documents starting with a given document number
+	/// \param[in] docno first document number of the range
+	/// \param[out] lastdocno last document number of the range the bound returned is valid for
+	/// \return the maximum weight or +infinity if the function cannot give a bound
+	/// \remark The default implementation returns 'maxWeight()' valid for all documents
+	/// \note Used for block-max pruning, called interleaved with 'call'
+	/// \note Implementations may move the posting iterators of the features to inspect the block they are in, but they have to restore the previous document position before returning
+	virtual double maxWeightRange( const Index& docno, Index& lastdocno)
+	{
+		(void)docno;
+		lastdocno = std::numeric_limits<Index>::max();
+		return maxWeight();
+	}
 };
 
 }//namespace
@@ -13,7 +13,7 @@
 #include "strus/fileLocatorInterface.hpp"
 #include "strus/errorBufferInterface.hpp"
 #include "strus/base/configParser.hpp"
-#include "strus/base/fileio.hpp"
+#include "strus/base/string_conv.hpp"
 #include "database.hpp"
 #include "leveldbErrorCode.hpp"
 #include "private/internationalization.hpp"
@@ -36,7 +36,8 @@ static bool checkConfigString( const std::string& configsource, ErrorBufferInter
 	{
 		static const char* ar[] = {
 			"path","compression","autocompact","cache",
-			"max_open_files","write_buffer_size","block_size",0};
+			"max_open_files","write_buffer_size","block_size","compact_on_open",
+			"bloom_filter","prefix_cache","prefix_cache_keys","paranoid_checks","verify_checksums",0};
 		char const** ai = ar;
 		for (; *ai && 0!=std::strcmp(*ai,ci->first.c_str()); ++ai){}
 		if (!*ai)
@@ -59,6 +60,14 @@ DatabaseClientInterface* Database::createClient( const std::string& configsource
 		unsigned int maxOpenFiles = 0;
 		unsigned int writeBufferSize = 0;
 		unsigned int blockSize = 0;
+		LevelDbHandle::CompactOnOpen compactOnOpen = LevelDbHandle::CompactOnOpenUnclean;
+		std::string compactOnOpenName;
+		unsigned int bloomFilterBits = 0;
+		unsigned int prefixCacheSize = 0;
+		unsigned int prefixCacheSize_kb = 0;
+		std::string prefixCacheKeys;
+		bool paranoidChecks = false;
+		bool verifyChecksums = false;
 		std::string path;
 		std::string src( configsource);
 
@@ -80,10 +89,29 @@ DatabaseClientInterface* Database::createClient( const std::string& configsource
 		(void)extractUIntFromConfigString( maxOpenFiles, src, "max_open_files", m_errorhnd);
 		(void)extractUIntFromConfigString( writeBufferSize, src, "write_buffer_size", m_errorhnd);
 		(void)extractUIntFromConfigString( blockSize, src, "block_size", m_errorhnd);
+		if (extractStringFromConfigString( compactOnOpenName, src, "compact_on_open", m_errorhnd))
+		{
+			if (!LevelDbHandle::compactOnOpenFromName( compactOnOpen, string_conv::tolower( compactOnOpenName)))
+			{
+				m_errorhnd->report( ErrorCodeInvalidArgument, _TXT( "unknown value '%s' of '%s' in database configuration string, expected one of %s"), compactOnOpenName.c_str(), "compact_on_open", "no, unclean, background, yes");
+				return 0;
+			}
+		}
+		(void)extractUIntFromConfigString( bloomFilterBits, src, "bloom_filter", m_errorhnd);
+		(void)extractUIntFromConfigString( prefixCacheSize, src, "prefix_cache", m_errorhnd);
+		prefixCacheSize_kb = (unsigned int)((prefixCacheSize + 1023)/1024);
+		(void)extractStringFromConfigString( prefixCacheKeys, src, "prefix_cache_keys", m_errorhnd);
+		(void)extractBooleanFromConfigString( paranoidChecks, src, "paranoid_checks", m_errorhnd);
+		(void)extractBooleanFromConfigString( verifyChecksums, src, "verify_checksums", m_errorhnd);
+		if (prefixCacheSize_kb && prefixCacheKeys.empty())
+		{
+			m_errorhnd->report( ErrorCodeIncompleteConfiguration, _TXT( "missing '%s' in database configuration string, needed if '%s' is specified"), "prefix_cache_keys", "prefix_cache");
+			return 0;
+		}
 		if (m_errorhnd->hasError()) return 0;
 
 		if (!checkConfigString( src, m_errorhnd)) return 0;
-		return new DatabaseClient( &m_dbhandle_map, path.c_str(), maxOpenFiles, cachesize_kb, compression, writeBufferSize, blockSize, autocompaction, m_errorhnd);
+		return new DatabaseClient( &m_dbhandle_map, path.c_str(), maxOpenFiles, cachesize_kb, compression, writeBufferSize, blockSize, autocompaction, compactOnOpen, bloomFilterBits, prefixCacheSize_kb, prefixCacheKeys, paranoidChecks, verifyChecksums, m_errorhnd);
 	}
 	CATCH_ERROR_MAP_RETURN( _TXT("error creating database client: %s"), *m_errorhnd, 0);
 }
@@ -191,6 +219,9 @@ bool Database::destroyDatabase( const std::string& configsource) const
 		}
 		if (!expandDatabaseFullPath( path)) return false;
 
+		//... remove the open marker left by a database not closed properly, otherwise the directory cannot be removed
+		(void)strus::removeFile( strus::joinFilePath( path, LevelDbHandle::openMarkerFileName()), false);
+
 		leveldb::Options options;
 		leveldb::Status status = leveldb::DestroyDB( path, options);
 		if (!status.ok())
@@ -290,7 +321,7 @@ const char* Database::getConfigDescription( const ConfigType& type) const
 	switch (type)
 	{
 		case CmdCreateClient:
-			return "path=<LevelDB storage path>\ncreate=<yes/no, yes=do create if database does not exist yet>\ncache=<size of LRU cache for LevelDB>\ncompression=<yes/no>\nmax_open_files=<maximum number of open files for LevelDB>\nwrite_buffer_size=<Amount of data to build up in memory per file>\nblock_size=<approximate size of user data packed per block>\nautocompact=<yes/no for implicitely doing a storage compaction after every commit or not, default is yes>";
+			return "path=<LevelDB storage path>\ncreate=<yes/no, yes=do create if database does not exist yet>\ncache=<size of LRU cache for LevelDB>\ncompression=<yes/no>\nmax_open_files=<maximum number of open files for LevelDB>\nwrite_buffer_size=<Amount of data to build up in memory per file>\nblock_size=<approximate size of user data packed per block>\nautocompact=<yes/no for implicitely doing a storage compaction after every commit or not, default is yes>\ncompact_on_open=<no/unclean/background/yes for doing a storage compaction on open never, only if not closed properly before (default), in a background thread or always>\nbloom_filter=<number of bits per key of a bloom filter for point lookups, 0 or undefined for no bloom filter (10 is a good value)>\nprefix_cache=<size of LRU cache for values of keys starting with one of the characters in prefix_cache_keys>\nprefix_cache_keys=<characters of the first byte of the keys with values cached in prefix_cache>\nparanoid_checks=<yes/no for aggressive checking of the data with early stop on errors detected, default is no>\nverify_checksums=<yes/no for verifying the checksums of all data read, default is no>";
 
 		case CmdCreate:
 			return "path=<LevelDB storage path>\ncompression=<yes/no>";
@@ -303,7 +334,7 @@ const char* Database::getConfigDescription( const ConfigType& type) const
 
 const char** Database::getConfigParameters( const ConfigType& type) const
 {
-	static const char* keys_CreateDatabaseClient[] = {"path","cache","compression","max_open_files","write_buffer_size","block_size","autocompact",0};
+	static const char* keys_CreateDatabaseClient[] = {"path","cache","compression","max_open_files","write_buffer_size","block_size","autocompact","compact_on_open","bloom_filter","prefix_cache","prefix_cache_keys","paranoid_checks","verify_checksums",0};
 	static const char* keys_CreateDatabase[] = {"path","compression", 0};
 	static const char* keys_DestroyDatabase[] = {"path", 0};
 	switch (type)
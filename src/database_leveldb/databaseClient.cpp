@@ -28,6 +28,34 @@ using namespace strus;
 
 #define MODULENAME "databaseClient"
 
+DatabaseClient::DatabaseClient(
+		LevelDbHandleMap* dbmap,
+		const std::string& path,
+		unsigned int maxOpenFiles,
+		unsigned int cachesize_k,
+		bool compression,
+		unsigned int writeBufferSize,
+		unsigned int blockSize,
+		bool autocompaction_,
+		LevelDbHandle::CompactOnOpen compactOnOpen,
+		unsigned int bloomFilterBits,
+		unsigned int prefixCacheSize_k,
+		const std::string& prefixCacheKeys,
+		bool paranoidChecks,
+		bool verifyChecksums,
+		ErrorBufferInterface* errorhnd_)
+	:m_conn(),m_autocompaction(autocompaction_),m_errorhnd(errorhnd_)
+{
+	bool created = false;
+	LevelDbHandleRef hnd = dbmap->create( path, maxOpenFiles, cachesize_k, compression, writeBufferSize, blockSize, compactOnOpen, bloomFilterBits, prefixCacheSize_k, prefixCacheKeys, paranoidChecks, verifyChecksums, created);
+	m_conn.reset( new LevelDbConnection( dbmap, hnd));
+	if (created)
+	{
+		std::string stats = hnd->startupStatistics();
+		m_errorhnd->info( _TXT("opened key value store database '%s': %s"), path.c_str(), stats.c_str());
+	}
+}
+
 DatabaseClient::~DatabaseClient()
 {
 	try
@@ -128,6 +156,11 @@ void DatabaseClient::writeImm(
 		leveldb::Status status = db->Put( options,
 						leveldb::Slice( key, keysize),
 						leveldb::Slice( value, valuesize));
+		LevelDbPrefixCache* prefixCache = m_conn->prefixCache();
+		if (prefixCache && prefixCache->matches( key, keysize))
+		{
+			prefixCache->invalidate( std::string( key, keysize));
+		}
 		if (!status.ok())
 		{
 			std::string ststr( status.ToString());
@@ -149,6 +182,11 @@ void DatabaseClient::removeImm(
 		leveldb::WriteOptions options;
 		options.sync = true;
 		leveldb::Status status = db->Delete( options, leveldb::Slice( key, keysize));
+		LevelDbPrefixCache* prefixCache = m_conn->prefixCache();
+		if (prefixCache && prefixCache->matches( key, keysize))
+		{
+			prefixCache->invalidate( std::string( key, keysize));
+		}
 		if (!status.ok())
 		{
 			std::string ststr( status.ToString());
@@ -169,10 +207,36 @@ bool DatabaseClient::readValue(
 		leveldb::DB* db = m_conn->db();
 		if (!db) throw strus::runtime_error(_TXT("called method '%s::%s' after close"), MODULENAME, "readValue");
 
-		std::string rt;
 		leveldb::ReadOptions readoptions;
 		readoptions.fill_cache = options.useCacheEnabled();
+		readoptions.verify_checksums = m_conn->verifyChecksums();
 
+		LevelDbPrefixCache* prefixCache = m_conn->prefixCache();
+		if (prefixCache && prefixCache->matches( key, keysize))
+		{
+			std::string keystr( key, keysize);
+			switch (prefixCache->lookup( keystr, value))
+			{
+				case LevelDbPrefixCache::Found: return true;
+				case LevelDbPrefixCache::NotFound: return false;
+				case LevelDbPrefixCache::NotCached: break;
+			}
+			uint64_t generation = prefixCache->generation();
+			leveldb::Status status = db->Get( readoptions, leveldb::Slice( key, keysize), &value);
+			if (status.IsNotFound())
+			{
+				prefixCache->insert( keystr, false, std::string(), generation);
+				return false;
+			}
+			if (!status.ok())
+			{
+				std::string ststr( status.ToString());
+				m_errorhnd->report( leveldbErrorCode(status), _TXT( "leveldb error: %s"), ststr.c_str());
+				return true;
+			}
+			prefixCache->insert( keystr, true, value, generation);
+			return true;
+		}
 		leveldb::Status status = db->Get( readoptions, leveldb::Slice( key, keysize), &value);
 		if (status.IsNotFound())
 		{
@@ -33,6 +33,12 @@ public:
 	/// \param[in] writeBufferSize size of write buffer per file
 	/// \param[in] blockSize block size on disk (size of units)
 	/// \param[in] autocompaction_ true if compaction is called on every transaction commit, false else
+	/// \param[in] compactOnOpen policy for the compaction of the database on open
+	/// \param[in] bloomFilterBits number of bits per key of the bloom filter (0 for no bloom filter)
+	/// \param[in] prefixCacheSize_k number of K of the cache for values of keys starting with one of prefixCacheKeys (0 for no cache)
+	/// \param[in] prefixCacheKeys characters of the first byte of the keys with values cached in the prefix cache
+	/// \param[in] paranoidChecks true if LevelDB should do aggressive checking of the data and stop early on errors detected
+	/// \param[in] verifyChecksums true if the checksums of all data read from disk should be verified
 	DatabaseClient(
 			LevelDbHandleMap* dbmap,
 			const std::string& path,
@@ -42,11 +48,13 @@ public:
 			unsigned int writeBufferSize,
 			unsigned int blockSize,
 			bool autocompaction_,
-			ErrorBufferInterface* errorhnd_)
-		:m_conn( new LevelDbConnection( dbmap, dbmap->create( path, maxOpenFiles, cachesize_k, compression, writeBufferSize, blockSize)))
-		,m_autocompaction(autocompaction_)
-		,m_errorhnd(errorhnd_)
-	{}
+			LevelDbHandle::CompactOnOpen compactOnOpen,
+			unsigned int bloomFilterBits,
+			unsigned int prefixCacheSize_k,
+			const std::string& prefixCacheKeys,
+			bool paranoidChecks,
+			bool verifyChecksums,
+			ErrorBufferInterface* errorhnd_);
 
 	virtual ~DatabaseClient();
 
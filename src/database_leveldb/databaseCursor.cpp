@@ -26,6 +26,7 @@ static leveldb::ReadOptions getOptions( const strus::shared_ptr<LevelDbConnectio
 		rt.snapshot = db->GetSnapshot();
 	}
 	rt.fill_cache = useCache;
+	rt.verify_checksums = conn_->verifyChecksums();
 	return rt;
 }
 
@@ -24,7 +24,7 @@ using namespace strus;
 #define MODULENAME "DatabaseTransaction"
 
 DatabaseTransaction::DatabaseTransaction( const strus::shared_ptr<LevelDbConnection>& conn_, bool autocompaction_, ErrorBufferInterface* errorhnd_)
-	:m_conn(conn_),m_batch(),m_commit_called(false),m_rollback_called(false),m_autocompaction(autocompaction_),m_errorhnd(errorhnd_)
+	:m_conn(conn_),m_batch(),m_prefixCacheKeys(),m_prefixCacheClear(false),m_commit_called(false),m_rollback_called(false),m_autocompaction(autocompaction_),m_errorhnd(errorhnd_)
 {}
 
 DatabaseTransaction::~DatabaseTransaction()
@@ -54,6 +54,11 @@ void DatabaseTransaction::write(
 		m_batch.Put(
 			leveldb::Slice( key, keysize),
 			leveldb::Slice( value, valuesize));
+		LevelDbPrefixCache* prefixCache = m_conn->prefixCache();
+		if (prefixCache && prefixCache->matches( key, keysize))
+		{
+			m_prefixCacheKeys.push_back( std::string( key, keysize));
+		}
 	}
 	CATCH_ERROR_MAP( _TXT("error writing element in database transaction: %s"), *m_errorhnd);
 }
@@ -65,6 +70,11 @@ void DatabaseTransaction::remove(
 	try
 	{
 		m_batch.Delete( leveldb::Slice( key, keysize));
+		LevelDbPrefixCache* prefixCache = m_conn->prefixCache();
+		if (prefixCache && prefixCache->matches( key, keysize))
+		{
+			m_prefixCacheKeys.push_back( std::string( key, keysize));
+		}
 	}
 	CATCH_ERROR_MAP( _TXT("error removing element in database transaction: %s"), *m_errorhnd);
 }
@@ -78,7 +88,14 @@ void DatabaseTransaction::removeSubTree(
 		leveldb::DB* db = m_conn->db();
 		if (!db) throw strus::runtime_error_ec( ErrorCodeOperationOrder, _TXT("called method '%s::%s' after close"), MODULENAME, "removeSubTree");
 
-		strus::local_ptr<leveldb::Iterator> itr( db->NewIterator( leveldb::ReadOptions()));
+		LevelDbPrefixCache* prefixCache = m_conn->prefixCache();
+		if (prefixCache && prefixCache->matchesDomain( domainkey, domainkeysize))
+		{
+			m_prefixCacheClear = true;
+		}
+		leveldb::ReadOptions readoptions;
+		readoptions.verify_checksums = m_conn->verifyChecksums();
+		strus::local_ptr<leveldb::Iterator> itr( db->NewIterator( readoptions));
 		for (itr->Seek( leveldb::Slice( domainkey,domainkeysize));
 			itr->Valid()
 				&& domainkeysize <= itr->key().size()
@@ -114,6 +131,20 @@ bool DatabaseTransaction::commit()
 		}
 		m_batch.Clear();
 		m_commit_called = true;
+		LevelDbPrefixCache* prefixCache = m_conn->prefixCache();
+		if (prefixCache)
+		{
+			if (m_prefixCacheClear)
+			{
+				prefixCache->clear();
+			}
+			else if (!m_prefixCacheKeys.empty())
+			{
+				prefixCache->invalidate( m_prefixCacheKeys);
+			}
+		}
+		m_prefixCacheKeys.clear();
+		m_prefixCacheClear = false;
 		if (m_autocompaction)
 		{
 			// Do implicit compaction:
@@ -129,6 +160,8 @@ bool DatabaseTransaction::commit()
 void DatabaseTransaction::rollback()
 {
 	m_batch.Clear();
+	m_prefixCacheKeys.clear();
+	m_prefixCacheClear = false;
 	m_rollback_called = true;
 }
 
@@ -12,6 +12,8 @@
 #include "strus/base/shared_ptr.hpp"
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
+#include <vector>
+#include <string>
 
 namespace strus
 {
@@ -53,6 +55,8 @@ public:
 private:
 	strus::shared_ptr<LevelDbConnection> m_conn;	///< levelDB connection
 	leveldb::WriteBatch m_batch;			///< batch used for the transaction
+	std::vector<std::string> m_prefixCacheKeys;	///< keys written or removed that have to be invalidated in the prefix cache after commit
+	bool m_prefixCacheClear;			///< true if the prefix cache has to be cleared after commit because of a subtree removed
 	bool m_commit_called;				///< true if the transaction has been committed
 	bool m_rollback_called;				///< true if the transaction has been rolled back
 	bool m_autocompaction;				///< true if the storage should be compacted after the commit
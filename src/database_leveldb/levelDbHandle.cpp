@@ -11,11 +11,15 @@
 #include "private/errorUtils.hpp"
 #include "strus/base/shared_ptr.hpp"
 #include "strus/base/thread.hpp"
+#include "strus/base/fileio.hpp"
 #include <leveldb/db.h>
 #include <leveldb/cache.h>
+#include <leveldb/filter_policy.h>
 #include <iostream>
 #include <sstream>
+#include <iomanip>
 #include <cstring>
+#include <sys/time.h>
 
 using namespace strus;
 
@@ -41,14 +45,56 @@ static std::string normalizePath( const std::string& path_)
 	return rt;
 }
 
-LevelDbHandle::LevelDbHandle( const std::string& path_, unsigned int maxOpenFiles_, unsigned int cachesize_k_, bool compression_, unsigned int writeBufferSize_, unsigned int blockSize_)
+static double getTimeSeconds()
+{
+	struct timeval tv;
+	::gettimeofday( &tv, NULL);
+	return (double)tv.tv_sec + (double)tv.tv_usec / 1000000.0;
+}
+
+const char* LevelDbHandle::compactOnOpenName( CompactOnOpen value)
+{
+	static const char* ar[] = {"no","unclean","background","yes"};
+	return ar[ value];
+}
+
+bool LevelDbHandle::compactOnOpenFromName( CompactOnOpen& value, const std::string& name)
+{
+	static const CompactOnOpen ar[] = {CompactOnOpenNo,CompactOnOpenUnclean,CompactOnOpenBackground,CompactOnOpenYes};
+	for (std::size_t ai=0; ai < sizeof(ar)/sizeof(ar[0]); ++ai)
+	{
+		if (0==std::strcmp( name.c_str(), compactOnOpenName( ar[ai])))
+		{
+			value = ar[ai];
+			return true;
+		}
+	}
+	return false;
+}
+
+LevelDbHandle::LevelDbHandle( const std::string& path_, unsigned int maxOpenFiles_, unsigned int cachesize_k_, bool compression_, unsigned int writeBufferSize_, unsigned int blockSize_, CompactOnOpen compactOnOpen_, unsigned int bloomFilterBits_, unsigned int prefixCacheSize_k_, const std::string& prefixCacheKeys_, bool paranoidChecks_, bool verifyChecksums_)
 	:m_path(path_),m_db(0)
 	,m_maxOpenFiles(maxOpenFiles_)
 	,m_cachesize_k(cachesize_k_)
 	,m_compression(compression_)
 	,m_writeBufferSize(writeBufferSize_)
 	,m_blockSize(blockSize_)
+	,m_compactOnOpen(compactOnOpen_)
+	,m_uncleanClose(false)
+	,m_openDuration(0.0)
+	,m_compactionDuration(0.0)
+	,m_compactionThread(0)
+	,m_bloomFilterBits(bloomFilterBits_)
+	,m_prefixCacheSize_k(prefixCacheSize_k_)
+	,m_prefixCacheKeys(prefixCacheKeys_)
+	,m_paranoidChecks(paranoidChecks_)
+	,m_verifyChecksums(verifyChecksums_)
+	,m_prefixCache(0)
 {
+	double starttime = getTimeSeconds();
+	std::string markerpath = strus::joinFilePath( path_, openMarkerFileName());
+	m_uncleanClose = strus::isFile( markerpath);
+
 	m_dboptions.create_if_missing = false;
 	if (m_maxOpenFiles)
 	{
@@ -72,17 +118,105 @@ LevelDbHandle::LevelDbHandle( const std::string& path_, unsigned int maxOpenFile
 	{
 		m_dboptions.block_size = m_blockSize;
 	}
+	if (m_bloomFilterBits)
+	{
+		//... tables written before the filter policy was set have no filter, they get one with the next compaction
+		m_dboptions.filter_policy = leveldb::NewBloomFilterPolicy( m_bloomFilterBits);
+	}
+	m_dboptions.paranoid_checks = m_paranoidChecks;
 	leveldb::Status status = leveldb::DB::Open( m_dboptions, path_.c_str(), &m_db);
 	if (!status.ok())
 	{
 		std::string err = status.ToString();
 		if (m_dboptions.block_cache) delete m_dboptions.block_cache;
+		if (m_dboptions.filter_policy) delete m_dboptions.filter_policy;
 		throw strus::runtime_error( _TXT( "failed to open key value store database: %s"), err.c_str());
 	}
-	// Do compaction, if state of db was closed previously without:
+	m_openDuration = getTimeSeconds() - starttime;
+	try
+	{
+		if (m_prefixCacheSize_k && !m_prefixCacheKeys.empty())
+		{
+			if (m_prefixCacheSize_k * 1024 < m_prefixCacheSize_k) throw std::runtime_error( _TXT( "size of prefix cache out of range"));
+			m_prefixCache = new LevelDbPrefixCache( (std::size_t)m_prefixCacheSize_k * 1024, m_prefixCacheKeys);
+		}
+		int ec = strus::writeFile( markerpath, std::string());
+		if (ec) throw strus::runtime_error( _TXT( "failed to create file '%s' marking the key value store database as open: %s"), markerpath.c_str(), ::strerror(ec));
+
+		switch (m_compactOnOpen)
+		{
+			case CompactOnOpenNo:
+				break;
+			case CompactOnOpenUnclean:
+				// Do compaction, if state of db was closed previously without:
+				if (m_uncleanClose) compact();
+				break;
+			case CompactOnOpenBackground:
+				m_compactionThread = new strus::thread( &LevelDbHandle::runBackgroundCompaction, this);
+				break;
+			case CompactOnOpenYes:
+				compact();
+				break;
+		}
+	}
+	catch (...)
+	{
+		delete m_db;
+		if (m_prefixCache) delete m_prefixCache;
+		if (m_dboptions.block_cache) delete m_dboptions.block_cache;
+		if (m_dboptions.filter_policy) delete m_dboptions.filter_policy;
+		throw;
+	}
+}
+
+void LevelDbHandle::compact()
+{
+	double starttime = getTimeSeconds();
 	m_db->CompactRange( NULL, NULL);
 	m_db->CompactRange( NULL, NULL);
 	// ... has to be called twice, see https://github.com/google/leveldb/issues/227
+	m_compactionDuration = getTimeSeconds() - starttime;
+}
+
+void LevelDbHandle::runBackgroundCompaction()
+{
+	try
+	{
+		compact();
+	}
+	catch (...)
+	{
+		//... an exception must not escape the thread, a failed compaction is not an error
+	}
+}
+
+std::string LevelDbHandle::startupStatistics() const
+{
+	std::ostringstream out;
+	out << std::fixed << std::setprecision(3) << "open " << m_openDuration << "s";
+	switch (m_compactOnOpen)
+	{
+		case CompactOnOpenNo:
+			out << ", compaction disabled";
+			break;
+		case CompactOnOpenUnclean:
+			if (m_uncleanClose)
+			{
+				out << ", compaction " << m_compactionDuration << "s after unclean close";
+			}
+			else
+			{
+				out << ", no compaction needed";
+			}
+			break;
+		case CompactOnOpenBackground:
+			out << ", compaction running in background";
+			break;
+		case CompactOnOpenYes:
+			out << ", compaction " << m_compactionDuration << "s";
+			break;
+	}
+	return out.str();
 }
 
 std::string LevelDbHandle::config() const
@@ -94,11 +228,21 @@ std::string LevelDbHandle::config() const
 	if (m_maxOpenFiles) out << ";max_open_files=" << m_maxOpenFiles;
 	if (m_writeBufferSize) out << ";write_buffer_size=" << m_writeBufferSize;
 	if (m_blockSize) out << ";block_size=" << m_blockSize;
+	if (m_compactOnOpen != CompactOnOpenUnclean) out << ";compact_on_open=" << compactOnOpenName( m_compactOnOpen);
+	if (m_bloomFilterBits) out << ";bloom_filter=" << m_bloomFilterBits;
+	if (m_prefixCache)
+	{
+		out << ";prefix_cache=" << m_prefixCacheSize_k << "K";
+		out << ";prefix_cache_keys='" << m_prefixCacheKeys << "'";
+	}
+	if (m_paranoidChecks) out << ";paranoid_checks=Y";
+	if (m_verifyChecksums) out << ";verify_checksums=Y";
 	return out.str();
 }
 
-strus::shared_ptr<LevelDbHandle> LevelDbHandleMap::create( const std::string& path_, unsigned int maxOpenFiles_, unsigned int cachesize_k_, bool compression_, unsigned int writeBufferSize_, unsigned int blockSize_)
+strus::shared_ptr<LevelDbHandle> LevelDbHandleMap::create( const std::string& path_, unsigned int maxOpenFiles_, unsigned int cachesize_k_, bool compression_, unsigned int writeBufferSize_, unsigned int blockSize_, LevelDbHandle::CompactOnOpen compactOnOpen_, unsigned int bloomFilterBits_, unsigned int prefixCacheSize_k_, const std::string& prefixCacheKeys_, bool paranoidChecks_, bool verifyChecksums_, bool& created)
 {
+	created = false;
 	strus::scoped_lock lock( m_map_mutex);
 	std::string path = normalizePath( path_);
 
@@ -112,8 +256,9 @@ strus::shared_ptr<LevelDbHandle> LevelDbHandleMap::create( const std::string& pa
 	}
 	if (mi == m_map.end())
 	{
-		strus::shared_ptr<LevelDbHandle> rt( new LevelDbHandle( path_, maxOpenFiles_, cachesize_k_, compression_, writeBufferSize_, blockSize_));
+		strus::shared_ptr<LevelDbHandle> rt( new LevelDbHandle( path_, maxOpenFiles_, cachesize_k_, compression_, writeBufferSize_, blockSize_, compactOnOpen_, bloomFilterBits_, prefixCacheSize_k_, prefixCacheKeys_, paranoidChecks_, verifyChecksums_));
 		m_map.push_back( rt);
+		created = true;
 		return rt;
 	}
 	else
@@ -122,7 +267,12 @@ strus::shared_ptr<LevelDbHandle> LevelDbHandleMap::create( const std::string& pa
 		||  (cachesize_k_ && (*mi)->cachesize_k() != cachesize_k_)
 		||  (compression_ != (*mi)->compression())
 		||  (writeBufferSize_ && (*mi)->writeBufferSize() != writeBufferSize_)
-		||  (blockSize_ && (*mi)->blockSize() != blockSize_))
+		||  (blockSize_ && (*mi)->blockSize() != blockSize_)
+		||  (bloomFilterBits_ && (*mi)->bloomFilterBits() != bloomFilterBits_)
+		||  (prefixCacheSize_k_ && (*mi)->prefixCacheSize_k() != prefixCacheSize_k_)
+		||  (!prefixCacheKeys_.empty() && (*mi)->prefixCacheKeys() != prefixCacheKeys_)
+		||  (paranoidChecks_ != (*mi)->paranoidChecks())
+		||  (verifyChecksums_ != (*mi)->verifyChecksums()))
 		{
 			throw std::runtime_error( _TXT( "level DB key value store with the same path opened twice but with different settings"));
 		}
@@ -149,8 +299,20 @@ void LevelDbHandleMap::dereference( const char* path)
 
 LevelDbHandle::~LevelDbHandle()
 {
-	if (m_db) delete m_db;
+	if (m_compactionThread)
+	{
+		//... a running compaction cannot be interrupted, we have to wait for it
+		m_compactionThread->join();
+		delete m_compactionThread;
+	}
+	if (m_db)
+	{
+		delete m_db;
+		(void)strus::removeFile( strus::joinFilePath( m_path, openMarkerFileName()), false);
+	}
+	if (m_prefixCache) delete m_prefixCache;
 	if (m_dboptions.block_cache) delete m_dboptions.block_cache;
+	if (m_dboptions.filter_policy) delete m_dboptions.filter_policy;
 }
 
 void LevelDbConnection::close()
@@ -9,6 +9,7 @@
 #define _STRUS_DATABASE_LEVELDB_HANDLE_HPP_INCLUDED
 #include "strus/base/shared_ptr.hpp"
 #include "strus/base/thread.hpp"
+#include "levelDbPrefixCache.hpp"
 #include <leveldb/db.h>
 #include <vector>
 #include <string>
@@ -21,6 +22,24 @@ namespace strus
 class LevelDbHandle
 {
 public:
+	/// \brief Policy for the compaction of the database when it is opened
+	enum CompactOnOpen
+	{
+		CompactOnOpenNo,		///< never compact on open
+		CompactOnOpenUnclean,		///< compact on open if the database was not closed properly before (default)
+		CompactOnOpenBackground,	///< compact in a background thread after open
+		CompactOnOpenYes		///< always compact on open before returning
+	};
+	/// \brief Get the name of a compaction on open policy as used in the configuration
+	static const char* compactOnOpenName( CompactOnOpen value);
+	/// \brief Get the compaction on open policy from its name in the configuration
+	/// \return false if the name is unknown
+	static bool compactOnOpenFromName( CompactOnOpen& value, const std::string& name);
+
+	/// \brief Name of the file in the database directory marking the database as open
+	/// \note The file is created on open and removed on close, if it exists on open, then the database was not closed properly
+	static const char* openMarkerFileName()		{return "STRUS_OPEN";}
+
 	/// \brief Constructor
 	/// \param[in] path_ path of the storage
 	/// \param[in] maxOpenFiles_ maximum number of files open (0 for default)
@@ -28,12 +47,24 @@ public:
 	/// \param[in] compression_ wheter to use snappy compression (true) or not
 	/// \param[in] writeBufferSize_ size of write buffer per file
 	/// \param[in] blockSize_ block size on disk (size of units)
+	/// \param[in] compactOnOpen_ policy for the compaction of the database on open
+	/// \param[in] bloomFilterBits_ number of bits per key of the bloom filter (0 for no bloom filter)
+	/// \param[in] prefixCacheSize_k_ number of K of the cache for values of keys starting with one of prefixCacheKeys_ (0 for no cache)
+	/// \param[in] prefixCacheKeys_ characters of the first byte of the keys with values cached in the prefix cache
+	/// \param[in] paranoidChecks_ true if LevelDB should do aggressive checking of the data and stop early on errors detected
+	/// \param[in] verifyChecksums_ true if the checksums of all data read from disk should be verified
 	LevelDbHandle( const std::string& path_,
 			unsigned int maxOpenFiles_,
 			unsigned int cachesize_k_,
 			bool compression_,
 			unsigned int writeBufferSize_,
-			unsigned int blockSize_);
+			unsigned int blockSize_,
+			CompactOnOpen compactOnOpen_,
+			unsigned int bloomFilterBits_,
+			unsigned int prefixCacheSize_k_,
+			const std::string& prefixCacheKeys_,
+			bool paranoidChecks_,
+			bool verifyChecksums_);
 
 	/// \brief Destructor
 	~LevelDbHandle();
@@ -45,8 +76,26 @@ public:
 	unsigned int writeBufferSize() const		{return m_writeBufferSize;}
 	unsigned int blockSize() const			{return m_blockSize;}
 	bool compression() const			{return m_compression;}
+	CompactOnOpen compactOnOpen() const		{return m_compactOnOpen;}
+	unsigned int bloomFilterBits() const		{return m_bloomFilterBits;}
+	unsigned int prefixCacheSize_k() const		{return m_prefixCacheSize_k;}
+	const std::string& prefixCacheKeys() const	{return m_prefixCacheKeys;}
+	bool paranoidChecks() const			{return m_paranoidChecks;}
+	bool verifyChecksums() const			{return m_verifyChecksums;}
+	LevelDbPrefixCache* prefixCache() const		{return m_prefixCache;}
 	std::string config() const;
 
+	/// \brief Get a description of the time spent in the phases of opening the database, for logging
+	std::string startupStatistics() const;
+
+private:
+	void compact();
+	void runBackgroundCompaction();
+
+private:
+	LevelDbHandle( const LevelDbHandle&){}		//... non copyable
+	void operator=( const LevelDbHandle&){}		//... non copyable
+
 private:
 	std::string m_path;				///< path to level DB storage directory
 	leveldb::Options m_dboptions;			///< options for level DB
@@ -56,6 +105,17 @@ private:
 	bool m_compression;				///< true if compression enabled
 	unsigned int m_writeBufferSize;			///< size of write buffer (default 4M)
 	unsigned int m_blockSize;			///< block unit size (default 4K)
+	CompactOnOpen m_compactOnOpen;			///< policy for the compaction of the database on open
+	bool m_uncleanClose;				///< true if the database was not closed properly before it was opened
+	double m_openDuration;				///< seconds spent in opening the database
+	double m_compactionDuration;			///< seconds spent in the compaction on open (not for compaction in background)
+	strus::thread* m_compactionThread;		///< thread of the compaction in background or NULL
+	unsigned int m_bloomFilterBits;			///< number of bits per key of the bloom filter or 0
+	unsigned int m_prefixCacheSize_k;		///< kilobytes of the cache for values of keys with a prefix in m_prefixCacheKeys
+	std::string m_prefixCacheKeys;			///< characters of the first byte of the keys with values cached in m_prefixCache
+	bool m_paranoidChecks;				///< true if paranoid checks of LevelDB are enabled
+	bool m_verifyChecksums;				///< true if checksums of data read are verified
+	LevelDbPrefixCache* m_prefixCache;		///< cache for values of keys with a prefix in m_prefixCacheKeys or NULL
 };
 
 typedef strus::shared_ptr<LevelDbHandle> LevelDbHandleRef;
@@ -77,6 +137,13 @@ public:
 	/// \param[in] compression_ wheter to use snappy compression (true) or not
 	/// \param[in] writeBufferSize_ size of write buffer per file
 	/// \param[in] blockSize_ block size on disk (size of units)
+	/// \param[in] compactOnOpen_ policy for the compaction of the database on open, ignored if the handle is already in use
+	/// \param[in] bloomFilterBits_ number of bits per key of the bloom filter (0 for no bloom filter)
+	/// \param[in] prefixCacheSize_k_ number of K of the cache for values of keys starting with one of prefixCacheKeys_ (0 for no cache)
+	/// \param[in] prefixCacheKeys_ characters of the first byte of the keys with values cached in the prefix cache
+	/// \param[in] paranoidChecks_ true if LevelDB should do aggressive checking of the data and stop early on errors detected
+	/// \param[in] verifyChecksums_ true if the checksums of all data read from disk should be verified
+	/// \param[out] created true if a new handle was created, false if an instance already in use is returned
 	/// \note the method throws if the configuration parameters are incompatible to an existing instance
 	strus::shared_ptr<LevelDbHandle> create(
 			const std::string& path_,
@@ -84,7 +151,14 @@ public:
 			unsigned int cachesize_k,
 			bool compression,
 			unsigned int writeBufferSize_,
-			unsigned int blockSize_);
+			unsigned int blockSize_,
+			LevelDbHandle::CompactOnOpen compactOnOpen_,
+			unsigned int bloomFilterBits_,
+			unsigned int prefixCacheSize_k_,
+			const std::string& prefixCacheKeys_,
+			bool paranoidChecks_,
+			bool verifyChecksums_,
+			bool& created);
 
 	/// \brief Dereference the handle for the database referenced by path and dispose the handle, if this reference is the last instance
 	void dereference( const char* path_);
@@ -127,6 +201,16 @@ public:
 		return (m_db.get())?m_db->path():std::string();
 	}
 
+	LevelDbPrefixCache* prefixCache() const
+	{
+		return (m_db.get())?m_db->prefixCache():0;
+	}
+
+	bool verifyChecksums() const
+	{
+		return (m_db.get())?m_db->verifyChecksums():false;
+	}
+
 private:
 	LevelDbHandleMap* m_dbmap;			///< pointer to map of shared levelDB handles, needed for unregister
 	strus::shared_ptr<LevelDbHandle> m_db;		///< shared levelDB handle
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief LRU cache for the values of keys starting with a configured set of prefix characters
+/// \file "levelDbPrefixCache.cpp"
+#include "levelDbPrefixCache.hpp"
+#include <cstring>
+
+using namespace strus;
+
+LevelDbPrefixCache::LevelDbPrefixCache( std::size_t maxsize_, const std::string& prefixes_)
+	:m_mutex(),m_maxsize(maxsize_),m_size(0),m_prefixes(prefixes_),m_generation(0),m_lru(),m_map()
+{
+	std::memset( m_prefixmap, 0, sizeof(m_prefixmap));
+	std::string::const_iterator pi = m_prefixes.begin(), pe = m_prefixes.end();
+	for (; pi != pe; ++pi)
+	{
+		m_prefixmap[ (unsigned char)*pi] = true;
+	}
+}
+
+LevelDbPrefixCache::LookupResult LevelDbPrefixCache::lookup( const std::string& key, std::string& value)
+{
+	strus::scoped_lock lock( m_mutex);
+	EntryMap::iterator mi = m_map.find( key);
+	if (mi == m_map.end()) return NotCached;
+
+	m_lru.splice( m_lru.begin(), m_lru, mi->second);
+	if (!mi->second->found) return NotFound;
+	value = mi->second->value;
+	return Found;
+}
+
+uint64_t LevelDbPrefixCache::generation() const
+{
+	strus::scoped_lock lock( m_mutex);
+	return m_generation;
+}
+
+void LevelDbPrefixCache::removeEntry( EntryMap::iterator mi)
+{
+	m_size -= mi->second->memsize();
+	m_lru.erase( mi->second);
+	m_map.erase( mi);
+}
+
+void LevelDbPrefixCache::insert( const std::string& key, bool found, const std::string& value, uint64_t generation_)
+{
+	Entry entry( key, found ? value : std::string(), found);
+	std::size_t entrysize = entry.memsize();
+	if (entrysize > m_maxsize) return;
+
+	strus::scoped_lock lock( m_mutex);
+	if (generation_ != m_generation) return;
+
+	EntryMap::iterator mi = m_map.find( key);
+	if (mi != m_map.end()) removeEntry( mi);
+	while (m_size + entrysize > m_maxsize && !m_lru.empty())
+	{
+		removeEntry( m_map.find( m_lru.back().key));
+	}
+	m_lru.push_front( entry);
+	m_map[ key] = m_lru.begin();
+	m_size += entrysize;
+}
+
+void LevelDbPrefixCache::invalidate( const std::string& key)
+{
+	strus::scoped_lock lock( m_mutex);
+	++m_generation;
+	EntryMap::iterator mi = m_map.find( key);
+	if (mi != m_map.end()) removeEntry( mi);
+}
+
+void LevelDbPrefixCache::invalidate( const std::vector<std::string>& keys)
+{
+	strus::scoped_lock lock( m_mutex);
+	++m_generation;
+	std::vector<std::string>::const_iterator ki = keys.begin(), ke = keys.end();
+	for (; ki != ke; ++ki)
+	{
+		EntryMap::iterator mi = m_map.find( *ki);
+		if (mi != m_map.end()) removeEntry( mi);
+	}
+}
+
+void LevelDbPrefixCache::clear()
+{
+	strus::scoped_lock lock( m_mutex);
+	++m_generation;
+	m_lru.clear();
+	m_map.clear();
+	m_size = 0;
+}
+
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief LRU cache for the values of keys starting with a configured set of prefix characters
+/// \file "levelDbPrefixCache.hpp"
+#ifndef _STRUS_DATABASE_LEVELDB_PREFIX_CACHE_HPP_INCLUDED
+#define _STRUS_DATABASE_LEVELDB_PREFIX_CACHE_HPP_INCLUDED
+#include "strus/base/thread.hpp"
+#include "strus/base/stdint.h"
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <cstddef>
+
+namespace strus
+{
+
+/// \brief LRU cache for the values of keys starting with one of a set of prefix characters
+/// \note Used for point lookups of small values (e.g. dictionary entries) that would need a block read of LevelDB on every miss of its block cache
+/// \note Keys not found are cached too, because lookups of unknown terms are frequent in query evaluation
+class LevelDbPrefixCache
+{
+public:
+	/// \brief Constructor
+	/// \param[in] maxsize_ maximum number of bytes used for the cached keys and values
+	/// \param[in] prefixes_ characters of the first byte of the keys cached
+	LevelDbPrefixCache( std::size_t maxsize_, const std::string& prefixes_);
+
+	/// \brief Result of a lookup
+	enum LookupResult
+	{
+		NotCached,		///< key not in the cache
+		Found,			///< key in the cache with its value
+		NotFound		///< key in the cache as not existing in the database
+	};
+
+	/// \brief Evaluate if a key is subject to caching
+	bool matches( const char* key, std::size_t keysize) const
+	{
+		return keysize && m_prefixmap[ (unsigned char)key[0]];
+	}
+	/// \brief Evaluate if keys starting with a domain key can be subject to caching
+	bool matchesDomain( const char* domainkey, std::size_t domainkeysize) const
+	{
+		return !domainkeysize || m_prefixmap[ (unsigned char)domainkey[0]];
+	}
+
+	/// \brief Lookup a key
+	/// \param[in] key key to lookup
+	/// \param[out] value value of the key if found
+	LookupResult lookup( const std::string& key, std::string& value);
+
+	/// \brief Get the current generation of the cache, to pass to insert for a value read after this call
+	uint64_t generation() const;
+
+	/// \brief Insert the result of a database read into the cache
+	/// \param[in] key key read
+	/// \param[in] found true if the key exists in the database
+	/// \param[in] value value of the key if found
+	/// \param[in] generation_ generation of the cache before the database read
+	/// \note The insert is rejected if any invalidation happened since the generation passed, because the value read might be stale then
+	void insert( const std::string& key, bool found, const std::string& value, uint64_t generation_);
+
+	/// \brief Remove a key from the cache after a write or a delete in the database
+	void invalidate( const std::string& key);
+	/// \brief Remove a list of keys from the cache after a write or a delete in the database
+	void invalidate( const std::vector<std::string>& keys);
+	/// \brief Remove all keys from the cache
+	void clear();
+
+	/// \brief Get the maximum number of bytes used
+	std::size_t maxsize() const			{return m_maxsize;}
+	/// \brief Get the characters of the first byte of the keys cached
+	const std::string& prefixes() const		{return m_prefixes;}
+
+private:
+	struct Entry
+	{
+		std::string key;
+		std::string value;
+		bool found;
+
+		Entry( const std::string& key_, const std::string& value_, bool found_)
+			:key(key_),value(value_),found(found_){}
+		Entry( const Entry& o)
+			:key(o.key),value(o.value),found(o.found){}
+
+		std::size_t memsize() const
+		{
+			//... key is stored twice, in the list and in the map, plus an estimate of the overhead of the list and map nodes
+			return 2*key.size() + value.size() + 128;
+		}
+	};
+	typedef std::list<Entry> EntryList;
+	typedef std::map<std::string,EntryList::iterator> EntryMap;
+
+	void removeEntry( EntryMap::iterator mi);
+
+private:
+	LevelDbPrefixCache( const LevelDbPrefixCache&){}	//... non copyable
+	void operator=( const LevelDbPrefixCache&){}		//... non copyable
+
+private:
+	mutable strus::mutex m_mutex;			///< mutual exclusion of accesses to the cache
+	std::size_t m_maxsize;				///< maximum number of bytes used
+	std::size_t m_size;				///< number of bytes used
+	std::string m_prefixes;				///< characters of the first byte of the keys cached
+	bool m_prefixmap[ 256];				///< map of the first byte of the keys cached
+	uint64_t m_generation;				///< counter incremented on every invalidation
+	EntryList m_lru;				///< entries in the order of their last access, most recent first
+	EntryMap m_map;					///< map of keys to entries
+};
+
+}//namespace
+#endif
+
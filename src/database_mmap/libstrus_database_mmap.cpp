@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "strus/lib/database_mmap.hpp"
+#include "strus/fileLocatorInterface.hpp"
+#include "strus/errorBufferInterface.hpp"
+#include "mmapDatabase.hpp"
+#include "strus/base/dll_tags.hpp"
+#include "private/internationalization.hpp"
+#include "private/errorUtils.hpp"
+
+using namespace strus;
+
+DLL_PUBLIC DatabaseInterface* strus::createDatabaseType_mmap( const FileLocatorInterface* filelocator, ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		static bool intl_initialized = false;
+		if (!intl_initialized)
+		{
+			strus::initMessageTextDomain();
+			intl_initialized = true;
+		}
+		return new MmapDatabase( filelocator, errorhnd);
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error creating database based on memory mapped files: %s"), *errorhnd, 0);
+}
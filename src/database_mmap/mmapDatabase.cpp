@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Interface to create, export and destroy read only databases on memory mapped frozen files
+/// \file "mmapDatabase.cpp"
+#include "mmapDatabase.hpp"
+#include "mmapDatabaseClient.hpp"
+#include "mmapFrozenFile.hpp"
+#include "strus/databaseClientInterface.hpp"
+#include "strus/databaseBackupCursorInterface.hpp"
+#include "strus/fileLocatorInterface.hpp"
+#include "strus/errorBufferInterface.hpp"
+#include "strus/base/configParser.hpp"
+#include "strus/base/fileio.hpp"
+#include "private/internationalization.hpp"
+#include "private/errorUtils.hpp"
+#include <stdexcept>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+
+using namespace strus;
+
+static bool checkConfigString( const std::string& configsource, const char** keys, ErrorBufferInterface* errorhnd)
+{
+	std::vector<std::pair<std::string,std::string> > items = strus::getConfigStringItems( configsource, errorhnd);
+	std::vector<std::pair<std::string,std::string> >::const_iterator ci = items.begin(), ce = items.end();
+	for (; ci != ce; ++ci)
+	{
+		char const** ai = keys;
+		for (; *ai && 0!=std::strcmp(*ai,ci->first.c_str()); ++ai){}
+		if (!*ai)
+		{
+			errorhnd->report( ErrorCodeUnknownIdentifier, _TXT("undefined configuration item key '%s'"), ci->first.c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
+/// \brief Temporary file removed on destruction, if not released
+class TemporaryFile
+{
+public:
+	explicit TemporaryFile( const std::string& name_)
+		:m_name(name_){}
+	~TemporaryFile()
+	{
+		if (!m_name.empty()) (void)strus::removeFile( m_name, false);
+	}
+
+	const std::string& name() const
+	{
+		return m_name;
+	}
+	/// \brief Keep the file, because it has been renamed or moved
+	void release()
+	{
+		m_name.clear();
+	}
+
+private:
+	TemporaryFile( const TemporaryFile&){}	//... non copyable
+	void operator=( const TemporaryFile&){}	//... non copyable
+
+private:
+	std::string m_name;
+};
+
+bool MmapDatabase::getDatabasePath( std::string& path, std::string& configsource) const
+{
+	if (!extractStringFromConfigString( path, configsource, "path", m_errorhnd))
+	{
+		m_errorhnd->report( ErrorCodeIncompleteConfiguration, _TXT( "missing '%s' in database configuration string"), "path");
+		return false;
+	}
+	std::string workdir = m_filelocator->getWorkingDirectory();
+	if (!workdir.empty())
+	{
+		if (strus::hasUpdirReference( path))
+		{
+			m_errorhnd->report( ErrorCodeInvalidFilePath, _TXT( "path in database configuration must not contain up-directory references ('..') if workdir is specified"));
+			return false;
+		}
+		path = strus::joinFilePath( workdir, path);
+	}
+	return true;
+}
+
+DatabaseClientInterface* MmapDatabase::createClient( const std::string& configsource) const
+{
+	try
+	{
+		std::string path;
+		std::string src( configsource);
+
+		if (!getDatabasePath( path, src)) return 0;
+		if (!checkConfigString( src, getConfigParameters( CmdCreateClient), m_errorhnd)) return 0;
+		if (!isDir( path))
+		{
+			throw strus::runtime_error( _TXT( "unknown path '%s' specified in database configuration string"), path.c_str());
+		}
+		return new MmapDatabaseClient( path, m_errorhnd);
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error creating database client: %s"), *m_errorhnd, 0);
+}
+
+bool MmapDatabase::exists( const std::string& configsource) const
+{
+	try
+	{
+		std::string path;
+		std::string src( configsource);
+
+		if (!getDatabasePath( path, src)) return false;
+		return isFile( strus::joinFilePath( path, MmapFrozenFile::defaultFileName()));
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error checking if database exists: %s"), *m_errorhnd, false);
+}
+
+bool MmapDatabase::createDatabase( const std::string&) const
+{
+	m_errorhnd->report( ErrorCodeNotAllowed, _TXT("error creating database: %s"), _TXT("a memory mapped database is read only and can only be created by exporting an existing database (restore)"));
+	return false;
+}
+
+bool MmapDatabase::destroyDatabase( const std::string& configsource) const
+{
+	try
+	{
+		std::string path;
+		std::string src( configsource);
+
+		if (!getDatabasePath( path, src)) return false;
+		int ec = strus::removeFile( strus::joinFilePath( path, MmapFrozenFile::defaultFileName()), true);
+		if (ec)
+		{
+			m_errorhnd->report( ErrorCodeIOError, _TXT( "failed to remove memory mapped database file in '%s': %s"), path.c_str(), ::strerror(ec));
+			return false;
+		}
+		return true;
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error destroying database: %s"), *m_errorhnd, false);
+}
+
+bool MmapDatabase::restoreDatabase( const std::string& configsource, DatabaseBackupCursorInterface* backup) const
+{
+	try
+	{
+		unsigned int bloomFilterBits = 0;
+		std::string bloomFilterKeys;
+		std::string path;
+		std::string src( configsource);
+
+		if (!getDatabasePath( path, src)) return false;
+		(void)extractUIntFromConfigString( bloomFilterBits, src, "bloom_filter", m_errorhnd);
+		(void)extractStringFromConfigString( bloomFilterKeys, src, "bloom_filter_keys", m_errorhnd);
+		if (m_errorhnd->hasError()) return false;
+		if (!checkConfigString( src, getConfigParameters( CmdCreate), m_errorhnd)) return false;
+
+		std::string dirCreated;
+		int ec = strus::mkdirp( path, dirCreated);
+		if (ec != 0)
+		{
+			m_errorhnd->report( ErrorCodeIOError, _TXT( "failed to create directory '%s' for database"), path.c_str());
+			return false;
+		}
+		std::string filename = strus::joinFilePath( path, MmapFrozenFile::defaultFileName());
+		if (isFile( filename))
+		{
+			m_errorhnd->report( ErrorCodeNotAllowed, _TXT( "memory mapped database in '%s' already exists"), path.c_str());
+			return false;
+		}
+		// Write a temporary file first, so that a database interrupted while exporting is never visible:
+		TemporaryFile tmpfile( filename + ".tmp");
+		(void)MmapFrozenFile::write( tmpfile.name(), backup, bloomFilterBits, bloomFilterKeys);
+		if (m_errorhnd->hasError())
+		{
+			m_errorhnd->explain( _TXT("error fetching records to export: %s"));
+			return false;
+		}
+		if (0!=std::rename( tmpfile.name().c_str(), filename.c_str()))
+		{
+			ec = errno;
+			m_errorhnd->report( ErrorCodeIOError, _TXT( "failed to rename memory mapped database file '%s': %s"), tmpfile.name().c_str(), ::strerror(ec));
+			return false;
+		}
+		tmpfile.release();
+		return true;
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error exporting database to memory mapped file: %s"), *m_errorhnd, false);
+}
+
+const char* MmapDatabase::getConfigDescription( const ConfigType& type) const
+{
+	switch (type)
+	{
+		case CmdCreateClient:
+			return "path=<path of the directory of the memory mapped database>";
+
+		case CmdCreate:
+			return "path=<path of the directory of the memory mapped database>\nbloom_filter=<number of bits per key of a bloom filter for point lookups, 0 or undefined for no bloom filter (10 is a good value)>\nbloom_filter_keys=<characters of the first byte of the keys in the bloom filter, undefined for all keys>";
+
+		case CmdDestroy:
+			return "path=<path of the directory of the memory mapped database>";
+	}
+	return 0;
+}
+
+const char** MmapDatabase::getConfigParameters( const ConfigType& type) const
+{
+	static const char* keys_CreateDatabaseClient[] = {"path", 0};
+	static const char* keys_CreateDatabase[] = {"path","bloom_filter","bloom_filter_keys", 0};
+	static const char* keys_DestroyDatabase[] = {"path", 0};
+	switch (type)
+	{
+		case CmdCreateClient:	return keys_CreateDatabaseClient;
+		case CmdCreate:		return keys_CreateDatabase;
+		case CmdDestroy:	return keys_DestroyDatabase;
+	}
+	return 0;
+}
+
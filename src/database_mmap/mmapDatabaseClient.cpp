@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Implementation of the read only database client on a memory mapped frozen file
+/// \file "mmapDatabaseClient.cpp"
+#include "mmapDatabaseClient.hpp"
+#include "mmapDatabaseCursor.hpp"
+#include "strus/storage/databaseOptions.hpp"
+#include "strus/storage/databasePinnedSlice.hpp"
+#include "strus/base/fileio.hpp"
+#include "strus/base/shared_ptr.hpp"
+#include "strus/errorBufferInterface.hpp"
+#include "private/internationalization.hpp"
+#include "private/errorUtils.hpp"
+
+using namespace strus;
+
+#define MODULENAME "MmapDatabaseClient"
+
+MmapDatabaseClient::MmapDatabaseClient( const std::string& path, ErrorBufferInterface* errorhnd_)
+	:m_path(path),m_file(),m_errorhnd(errorhnd_)
+{
+	m_file.reset( new MmapFrozenFile( strus::joinFilePath( m_path, MmapFrozenFile::defaultFileName())));
+}
+
+DatabaseTransactionInterface* MmapDatabaseClient::createTransaction()
+{
+	m_errorhnd->report( ErrorCodeNotAllowed, _TXT("error creating transaction: %s"), _TXT("memory mapped database is read only"));
+	return 0;
+}
+
+DatabaseCursorInterface* MmapDatabaseClient::createCursor( const DatabaseOptions&) const
+{
+	try
+	{
+		if (!m_file.get()) throw strus::runtime_error(_TXT("called method '%s::%s' after close"), MODULENAME, "createCursor");
+		return new MmapDatabaseCursor( m_file, m_errorhnd);
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error creating database cursor: %s"), *m_errorhnd, 0);
+}
+
+DatabaseBackupCursorInterface* MmapDatabaseClient::createBackupCursor() const
+{
+	try
+	{
+		if (!m_file.get()) throw strus::runtime_error(_TXT("called method '%s::%s' after close"), MODULENAME, "createBackupCursor");
+		return new MmapDatabaseBackupCursor( m_file);
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error creating '%s' backup cursor: %s"), MODULENAME, *m_errorhnd, 0);
+}
+
+void MmapDatabaseClient::writeImm(
+			const char*,
+			std::size_t,
+			const char*,
+			std::size_t)
+{
+	m_errorhnd->report( ErrorCodeNotAllowed, _TXT("error '%s' writeImm: %s"), MODULENAME, _TXT("memory mapped database is read only"));
+}
+
+void MmapDatabaseClient::removeImm(
+			const char*,
+			std::size_t)
+{
+	m_errorhnd->report( ErrorCodeNotAllowed, _TXT("error '%s' removeImm: %s"), MODULENAME, _TXT("memory mapped database is read only"));
+}
+
+bool MmapDatabaseClient::readValue(
+		const char* key,
+		std::size_t keysize,
+		std::string& value,
+		const DatabaseOptions&) const
+{
+	try
+	{
+		if (!m_file.get()) throw strus::runtime_error(_TXT("called method '%s::%s' after close"), MODULENAME, "readValue");
+
+		if (!m_file->mayContain( key, keysize)) return false;
+		MmapFrozenFile::Position pos = m_file->lowerBound( key, keysize);
+		if (!m_file->valid( pos)) return false;
+
+		std::size_t reckeysize;
+		const char* reckey = m_file->key( pos, reckeysize);
+		if (reckeysize != keysize || 0!=std::memcmp( reckey, key, keysize)) return false;
+
+		std::size_t valuesize;
+		const char* valueptr = m_file->value( pos, valuesize);
+		value.assign( valueptr, valuesize);
+		return true;
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error '%s' readValue: %s"), MODULENAME, *m_errorhnd, false);
+}
+
+bool MmapDatabaseClient::readValuePinned(
+		const char* key,
+		std::size_t keysize,
+		DatabasePinnedSlice& value,
+		const DatabaseOptions&) const
+{
+	try
+	{
+		if (!m_file.get()) throw strus::runtime_error(_TXT("called method '%s::%s' after close"), MODULENAME, "readValuePinned");
+
+		value.reset();
+		if (!m_file->mayContain( key, keysize)) return false;
+		MmapFrozenFile::Position pos = m_file->lowerBound( key, keysize);
+		if (!m_file->valid( pos)) return false;
+
+		std::size_t reckeysize;
+		const char* reckey = m_file->key( pos, reckeysize);
+		if (reckeysize != keysize || 0!=std::memcmp( reckey, key, keysize)) return false;
+
+		std::size_t valuesize;
+		const char* valueptr = m_file->value( pos, valuesize);
+		//... the value points into the mapping that is kept alive by the reference to the file
+		value.assignPinned( m_file, valueptr, valuesize);
+		return true;
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error '%s' readValuePinned: %s"), MODULENAME, *m_errorhnd, false);
+}
+
+long MmapDatabaseClient::diskUsage() const
+{
+	try
+	{
+		if (!m_file.get()) throw strus::runtime_error(_TXT("called method '%s::%s' after close"), MODULENAME, "diskUsage");
+		return (long)(m_file->size() / 1024);
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error '%s' diskUsage: %s"), MODULENAME, *m_errorhnd, 0);
+}
+
+std::string MmapDatabaseClient::config() const
+{
+	try
+	{
+		if (!m_file.get()) throw strus::runtime_error(_TXT("called method '%s::%s' after close"), MODULENAME, "config");
+		return std::string("path=") + m_path;
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error in '%s' mapping configuration to string: %s"), MODULENAME, *m_errorhnd, std::string());
+}
+
+bool MmapDatabaseClient::compactDatabase()
+{
+	//... nothing to compact, the file is written once in sorted order
+	return true;
+}
+
+void MmapDatabaseClient::close()
+{
+	//... the mapping is released when the last cursor or pinned value referencing it is gone
+	m_file.reset();
+}
+
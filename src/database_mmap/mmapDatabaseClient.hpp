@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Implementation of the read only database client on a memory mapped frozen file
+/// \file "mmapDatabaseClient.hpp"
+#ifndef _STRUS_DATABASE_MMAP_CLIENT_HPP_INCLUDED
+#define _STRUS_DATABASE_MMAP_CLIENT_HPP_INCLUDED
+#include "strus/databaseClientInterface.hpp"
+#include "mmapFrozenFile.hpp"
+#include <string>
+
+namespace strus
+{
+/// \brief Forward declaration
+class ErrorBufferInterface;
+
+/// \brief Implementation of the strus key value storage database on a memory mapped frozen file
+/// \note All write operations are rejected, the database is read only.
+///	Values read with cursors or readValuePinned are not copied, they point into the memory mapping.
+class MmapDatabaseClient
+	:public DatabaseClientInterface
+{
+public:
+	/// \brief Constructor
+	/// \param[in] path path of the database directory
+	/// \param[in] errorhnd_ reference to error buffer (ownership hold by caller)
+	MmapDatabaseClient( const std::string& path, ErrorBufferInterface* errorhnd_);
+
+	virtual ~MmapDatabaseClient(){}
+
+	virtual DatabaseTransactionInterface* createTransaction();
+
+	virtual DatabaseCursorInterface* createCursor( const DatabaseOptions& options) const;
+
+	virtual DatabaseBackupCursorInterface* createBackupCursor() const;
+
+	virtual void writeImm(
+			const char* key,
+			std::size_t keysize,
+			const char* value,
+			std::size_t valuesize);
+
+	virtual void removeImm(
+			const char* key,
+			std::size_t keysize);
+
+	virtual bool readValue(
+			const char* key,
+			std::size_t keysize,
+			std::string& value,
+			const DatabaseOptions& options) const;
+
+	virtual bool readValuePinned(
+			const char* key,
+			std::size_t keysize,
+			DatabasePinnedSlice& value,
+			const DatabaseOptions& options) const;
+
+	virtual long diskUsage() const;
+
+	virtual std::string config() const;
+
+	virtual bool compactDatabase();
+
+	virtual void close();
+
+private:
+#if __cplusplus >= 201103L
+	MmapDatabaseClient( MmapDatabaseClient&) = delete;	//... non copyable
+	void operator=( MmapDatabaseClient&) = delete;		//... non copyable
+#endif
+
+private:
+	std::string m_path;				///< path of the database directory
+	MmapFrozenFileRef m_file;			///< file mapped, shared with the cursors, reset on close
+	ErrorBufferInterface* m_errorhnd;		///< buffer for reporting errors
+};
+
+}//namespace
+#endif
+
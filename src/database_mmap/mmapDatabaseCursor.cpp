@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Implementation of the database cursor on a memory mapped frozen file
+/// \file "mmapDatabaseCursor.cpp"
+#include "mmapDatabaseCursor.hpp"
+#include "strus/errorBufferInterface.hpp"
+#include "private/internationalization.hpp"
+#include "private/errorUtils.hpp"
+#include <cstring>
+#include <stdexcept>
+
+using namespace strus;
+
+MmapDatabaseCursor::MmapDatabaseCursor( const MmapFrozenFileRef& file_, ErrorBufferInterface* errorhnd_)
+	:m_file(file_),m_pos(file_->end()),m_domainkeysize(0),m_errorhnd(errorhnd_)
+{}
+
+bool MmapDatabaseCursor::checkDomain() const
+{
+	if (!m_file->valid( m_pos)) return false;
+	std::size_t keysize;
+	const char* keyptr = m_file->key( m_pos, keysize);
+	return m_domainkeysize <= keysize && 0==std::memcmp( m_domainkey, keyptr, m_domainkeysize);
+}
+
+void MmapDatabaseCursor::initDomain( const char* domainkey, std::size_t domainkeysize)
+{
+	if (domainkeysize+1 >= sizeof(m_domainkey))
+	{
+		throw std::runtime_error( _TXT( "key domain prefix string exceeds maximum size allowed"));
+	}
+	std::memcpy( m_domainkey, domainkey, m_domainkeysize=domainkeysize);
+	m_domainkey[ m_domainkeysize] = 0xFF;
+}
+
+DatabaseCursorInterface::Slice MmapDatabaseCursor::getCurrentKey() const
+{
+	if (checkDomain())
+	{
+		std::size_t keysize;
+		const char* keyptr = m_file->key( m_pos, keysize);
+		return Slice( keyptr, keysize);
+	}
+	else
+	{
+		return Slice();
+	}
+}
+
+DatabaseCursorInterface::Slice MmapDatabaseCursor::seekUpperBound(
+		const char* keystr,
+		std::size_t keysize,
+		std::size_t domainkeysize)
+{
+	try
+	{
+		initDomain( keystr, domainkeysize);
+		m_pos = m_file->lowerBound( keystr, keysize);
+		return getCurrentKey();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error database cursor seek upper bound: %s"), *m_errorhnd, DatabaseCursorInterface::Slice());
+}
+
+DatabaseCursorInterface::Slice MmapDatabaseCursor::seekKeyValue(
+		const char* keystr,
+		std::size_t keysize)
+{
+	m_domainkeysize = 0;
+	m_pos = m_file->lowerBound( keystr, keysize);
+	if (m_file->valid( m_pos))
+	{
+		std::size_t reckeysize;
+		const char* reckey = m_file->key( m_pos, reckeysize);
+		if (reckeysize == keysize && 0==std::memcmp( reckey, keystr, keysize))
+		{
+			std::size_t valuesize;
+			const char* valueptr = m_file->value( m_pos, valuesize);
+			return Slice( valueptr, valuesize);
+		}
+	}
+	return Slice();
+}
+
+DatabaseCursorInterface::Slice MmapDatabaseCursor::seekUpperBoundRestricted(
+		const char* keystr,
+		std::size_t keysize,
+		const char* upkey,
+		std::size_t upkeysize)
+{
+	try
+	{
+		m_pos = m_file->lowerBound( keystr, keysize);
+		if (m_file->valid( m_pos))
+		{
+			std::size_t reckeysize;
+			const char* reckey = m_file->key( m_pos, reckeysize);
+			std::size_t kk = upkeysize < keysize ? upkeysize : keysize;
+			if (kk > reckeysize) kk = reckeysize;
+			int res = std::memcmp( reckey, upkey, kk);
+			if (res < 0 || (res == 0 && upkeysize < keysize))
+			{
+				return Slice( reckey, reckeysize);
+			}
+		}
+		return Slice();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error database cursor seek upper bound restricted: %s"), *m_errorhnd, DatabaseCursorInterface::Slice());
+}
+
+DatabaseCursorInterface::Slice MmapDatabaseCursor::seekFirst(
+		const char* domainkey,
+		std::size_t domainkeysize)
+{
+	try
+	{
+		initDomain( domainkey, domainkeysize);
+		m_pos = m_file->lowerBound( domainkey, domainkeysize);
+		return getCurrentKey();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error database cursor seek first: %s"), *m_errorhnd, DatabaseCursorInterface::Slice());
+}
+
+DatabaseCursorInterface::Slice MmapDatabaseCursor::seekLast(
+		const char* domainkey,
+		std::size_t domainkeysize)
+{
+	try
+	{
+		initDomain( domainkey, domainkeysize);
+		if (m_domainkeysize == 0)
+		{
+			m_pos = m_file->last();
+		}
+		else
+		{
+			//... the last key of the domain precedes the first key bigger than the domain prefix followed by 0xFF
+			m_pos = m_file->prev( m_file->lowerBound( (const char*)m_domainkey, m_domainkeysize+1));
+		}
+		return getCurrentKey();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error database cursor seek last: %s"), *m_errorhnd, DatabaseCursorInterface::Slice());
+}
+
+DatabaseCursorInterface::Slice MmapDatabaseCursor::seekNext()
+{
+	try
+	{
+		if (m_file->valid( m_pos))
+		{
+			m_pos = m_file->next( m_pos);
+			return getCurrentKey();
+		}
+		return Slice();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error database cursor seek next: %s"), *m_errorhnd, DatabaseCursorInterface::Slice());
+}
+
+DatabaseCursorInterface::Slice MmapDatabaseCursor::seekPrev()
+{
+	try
+	{
+		if (m_file->valid( m_pos))
+		{
+			m_pos = m_file->prev( m_pos);
+			return getCurrentKey();
+		}
+		return Slice();
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error database cursor seek previous: %s"), *m_errorhnd, DatabaseCursorInterface::Slice());
+}
+
+DatabaseCursorInterface::Slice MmapDatabaseCursor::key() const
+{
+	if (m_file->valid( m_pos))
+	{
+		std::size_t keysize;
+		const char* keyptr = m_file->key( m_pos, keysize);
+		return Slice( keyptr, keysize);
+	}
+	else
+	{
+		return Slice();
+	}
+}
+
+DatabaseCursorInterface::Slice MmapDatabaseCursor::value() const
+{
+	if (m_file->valid( m_pos))
+	{
+		std::size_t valuesize;
+		const char* valueptr = m_file->value( m_pos, valuesize);
+		return Slice( valueptr, valuesize);
+	}
+	else
+	{
+		return Slice();
+	}
+}
+
+bool MmapDatabaseBackupCursor::fetch(
+		const char*& keyptr,
+		std::size_t& keysize,
+		const char*& blkptr,
+		std::size_t& blksize)
+{
+	if (!m_started)
+	{
+		m_pos = m_file->begin();
+		m_started = true;
+	}
+	else if (m_file->valid( m_pos))
+	{
+		m_pos = m_file->next( m_pos);
+	}
+	if (!m_file->valid( m_pos)) return false;
+	keyptr = m_file->key( m_pos, keysize);
+	blkptr = m_file->value( m_pos, blksize);
+	return true;
+}
+
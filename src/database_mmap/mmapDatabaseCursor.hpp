@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Implementation of the database cursor on a memory mapped frozen file
+/// \file "mmapDatabaseCursor.hpp"
+#ifndef _STRUS_DATABASE_MMAP_CURSOR_HPP_INCLUDED
+#define _STRUS_DATABASE_MMAP_CURSOR_HPP_INCLUDED
+#include "strus/databaseCursorInterface.hpp"
+#include "strus/databaseBackupCursorInterface.hpp"
+#include "mmapFrozenFile.hpp"
+#include <string>
+
+namespace strus
+{
+/// \brief Forward declaration
+class ErrorBufferInterface;
+
+/// \brief Implementation of the DatabaseCursorInterface on a memory mapped frozen file
+/// \note The slices returned point into the memory mapping and stay valid as long as the cursor exists
+class MmapDatabaseCursor
+	:public DatabaseCursorInterface
+{
+public:
+	MmapDatabaseCursor( const MmapFrozenFileRef& file_, ErrorBufferInterface* errorhnd_);
+
+	virtual ~MmapDatabaseCursor(){}
+
+	virtual Slice seekUpperBound(
+			const char* keystr,
+			std::size_t keysize,
+			std::size_t domainkeysize);
+
+	virtual Slice seekUpperBoundRestricted(
+			const char* keystr,
+			std::size_t keysize,
+			const char* upkey,
+			std::size_t upkeysize);
+
+	virtual Slice seekFirst(
+			const char* domainkey,
+			std::size_t domainkeysize);
+
+	virtual Slice seekLast(
+			const char* domainkey,
+			std::size_t domainkeysize);
+
+	virtual Slice seekNext();
+
+	virtual Slice seekPrev();
+
+	virtual Slice key() const;
+
+	virtual Slice value() const;
+
+	/// \brief Move cursor to the element with a key
+	/// \param[in] keystr pointer to the key of the item to seek
+	/// \param[in] keysize size of 'key' in bytes
+	/// \return the value of the element with the key or an undefined slice if it does not exist
+	Slice seekKeyValue(
+			const char* keystr,
+			std::size_t keysize);
+
+private:
+#if __cplusplus >= 201103L
+	MmapDatabaseCursor( MmapDatabaseCursor&) = delete;	//... non copyable
+	void operator=( MmapDatabaseCursor&) = delete;		//... non copyable
+#endif
+
+private:
+	bool checkDomain() const;
+	void initDomain( const char* domainkey, std::size_t domainkeysize);
+	Slice getCurrentKey() const;
+
+private:
+	MmapFrozenFileRef m_file;				///< file mapped, kept alive by the cursor
+	MmapFrozenFile::Position m_pos;				///< current position of the cursor
+	enum {MaxDomainKeySize=32};
+	unsigned char m_domainkey[ MaxDomainKeySize];		///< key prefix defining the current domain to scan
+	std::size_t m_domainkeysize;				///< size of domain key in bytes
+	ErrorBufferInterface* m_errorhnd;			///< buffer for reporting errors
+};
+
+
+/// \brief Implementation of the DatabaseBackupCursorInterface on a memory mapped frozen file
+class MmapDatabaseBackupCursor
+	:public DatabaseBackupCursorInterface
+{
+public:
+	MmapDatabaseBackupCursor( const MmapFrozenFileRef& file_)
+		:m_file(file_),m_pos(file_->end()),m_started(false){}
+
+	virtual bool fetch(
+			const char*& keyptr,
+			std::size_t& keysize,
+			const char*& blkptr,
+			std::size_t& blksize);
+
+private:
+	MmapFrozenFileRef m_file;				///< file mapped, kept alive by the cursor
+	MmapFrozenFile::Position m_pos;				///< position of the last record fetched
+	bool m_started;						///< true if the first record has been fetched
+};
+
+}//namespace
+#endif
+
@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Immutable sorted key/value file accessed through a read only memory mapping
+/// \file "mmapFrozenFile.cpp"
+#include "mmapFrozenFile.hpp"
+#include "strus/databaseBackupCursorInterface.hpp"
+#include "private/internationalization.hpp"
+#include "private/errorUtils.hpp"
+#include <vector>
+#include <stdexcept>
+#include <cstdio>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace strus;
+
+static const char g_magic[8] = {'S','T','R','U','S','M','M','F'};
+
+MmapFrozenFile::MmapFrozenFile( const std::string& filename_)
+	:m_filename(filename_),m_base(0),m_size(0),m_header(0)
+{
+	int fd = ::open( m_filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		int ec = errno;
+		throw strus::runtime_error( _TXT("failed to open frozen database file '%s': %s"), m_filename.c_str(), ::strerror(ec));
+	}
+	struct stat st;
+	if (0!=::fstat( fd, &st))
+	{
+		int ec = errno;
+		::close( fd);
+		throw strus::runtime_error( _TXT("failed to get size of frozen database file '%s': %s"), m_filename.c_str(), ::strerror(ec));
+	}
+	m_size = (std::size_t)st.st_size;
+	if (m_size < sizeof(MmapFrozenFileHeader))
+	{
+		::close( fd);
+		throw strus::runtime_error( _TXT("frozen database file '%s' is too small for a header"), m_filename.c_str());
+	}
+	void* mem = ::mmap( 0, m_size, PROT_READ, MAP_SHARED, fd, 0);
+	int ec = errno;
+	::close( fd);
+	//... the mapping stays valid after closing the file descriptor
+	if (mem == MAP_FAILED)
+	{
+		throw strus::runtime_error( _TXT("failed to map frozen database file '%s' into memory: %s"), m_filename.c_str(), ::strerror(ec));
+	}
+	m_base = (const char*)mem;
+	m_header = (const MmapFrozenFileHeader*)mem;
+
+	const char* errmsg = 0;
+	if (0!=std::memcmp( m_header->magic, g_magic, sizeof(g_magic)))
+	{
+		errmsg = _TXT("not a frozen database file");
+	}
+	else if (m_header->byteOrderMark != MmapFrozenFileHeader::ByteOrderMark)
+	{
+		errmsg = _TXT("byte order of the file does not match the platform");
+	}
+	else if (m_header->version != MmapFrozenFileHeader::Version)
+	{
+		errmsg = _TXT("unknown version of the file format");
+	}
+	else if (m_header->indexInterval == 0
+		|| m_header->nofIndexEntries != (m_header->nofRecords + m_header->indexInterval - 1) / m_header->indexInterval
+		|| m_header->indexOfs < sizeof(MmapFrozenFileHeader)
+		|| m_header->indexOfs + m_header->nofIndexEntries * sizeof(uint64_t) > m_size
+		|| m_header->bloomOfs + (m_header->bloomBits + 7) / 8 > m_size
+		|| (m_header->bloomBits && m_header->bloomHashes == 0))
+	{
+		errmsg = _TXT("header is corrupt");
+	}
+	if (errmsg)
+	{
+		::munmap( (void*)m_base, m_size);
+		throw strus::runtime_error( _TXT("failed to open frozen database file '%s': %s"), m_filename.c_str(), errmsg);
+	}
+}
+
+MmapFrozenFile::~MmapFrozenFile()
+{
+	::munmap( (void*)m_base, m_size);
+}
+
+int MmapFrozenFile::compareKey( uint64_t offset, const char* key, std::size_t keysize) const
+{
+	std::size_t reckeysize = readUInt32( offset);
+	const char* reckey = m_base + offset + 2*sizeof(uint32_t);
+	int cmp = std::memcmp( reckey, key, reckeysize < keysize ? reckeysize : keysize);
+	if (cmp) return cmp;
+	return reckeysize < keysize ? -1 : (reckeysize > keysize ? 1 : 0);
+}
+
+MmapFrozenFile::Position MmapFrozenFile::next( const Position& pos) const
+{
+	return Position( pos.ordinal + 1, pos.offset + 2*sizeof(uint32_t) + readUInt32( pos.offset) + readUInt32( pos.offset + sizeof(uint32_t)));
+}
+
+MmapFrozenFile::Position MmapFrozenFile::lowerBound( const char* key, std::size_t keysize) const
+{
+	if (m_header->nofRecords == 0) return end();
+
+	// Binary search for the first sparse index entry with a key bigger than the key searched:
+	uint64_t lo = 0, hi = m_header->nofIndexEntries;
+	while (lo < hi)
+	{
+		uint64_t mid = (lo + hi) >> 1;
+		if (compareKey( indexOffset( mid), key, keysize) <= 0)
+		{
+			lo = mid+1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	if (lo > 0) --lo;
+
+	// Linear scan of the records of the sparse index entry preceding it:
+	Position rt( lo * m_header->indexInterval, indexOffset( lo));
+	while (rt.ordinal < m_header->nofRecords && compareKey( rt.offset, key, keysize) < 0)
+	{
+		rt = next( rt);
+	}
+	return rt;
+}
+
+MmapFrozenFile::Position MmapFrozenFile::prev( const Position& pos) const
+{
+	if (pos.ordinal == 0) return end();
+	uint64_t target = pos.ordinal - 1;
+	uint64_t idx = target / m_header->indexInterval;
+	Position rt( idx * m_header->indexInterval, indexOffset( idx));
+	while (rt.ordinal < target)
+	{
+		rt = next( rt);
+	}
+	return rt;
+}
+
+MmapFrozenFile::Position MmapFrozenFile::last() const
+{
+	if (m_header->nofRecords == 0) return end();
+	return prev( end());
+}
+
+static uint64_t bloomHash( const char* key, std::size_t keysize)
+{
+	// FNV-1a 64 bit:
+	uint64_t rt = 14695981039346656037ULL;
+	std::size_t ki = 0;
+	for (; ki < keysize; ++ki)
+	{
+		rt ^= (unsigned char)key[ ki];
+		rt *= 1099511628211ULL;
+	}
+	return rt;
+}
+
+static inline bool bloomPrefixMatches( const unsigned char* prefixSet, const char* key, std::size_t keysize)
+{
+	if (keysize == 0) return false;
+	unsigned char first = (unsigned char)key[0];
+	return 0!=(prefixSet[ first >> 3] & (1 << (first & 7)));
+}
+
+bool MmapFrozenFile::mayContain( const char* key, std::size_t keysize) const
+{
+	if (m_header->bloomBits == 0 || !bloomPrefixMatches( m_header->bloomPrefixSet, key, keysize)) return true;
+
+	const unsigned char* bits = (const unsigned char*)(m_base + m_header->bloomOfs);
+	uint64_t hash = bloomHash( key, keysize);
+	uint64_t delta = (hash >> 33) | (hash << 31) | 1;
+	uint32_t hi = 0;
+	for (; hi < m_header->bloomHashes; ++hi, hash += delta)
+	{
+		uint64_t bitidx = hash % m_header->bloomBits;
+		if (0==(bits[ bitidx >> 3] & (1 << (bitidx & 7)))) return false;
+	}
+	return true;
+}
+
+/// \brief Output file closed on destruction
+class FrozenFileWriter
+{
+public:
+	explicit FrozenFileWriter( const std::string& filename_)
+		:m_filename(filename_),m_file(::fopen( filename_.c_str(), "wb")),m_ofs(0)
+	{
+		if (!m_file)
+		{
+			int ec = errno;
+			throw strus::runtime_error( _TXT("failed to create frozen database file '%s': %s"), m_filename.c_str(), ::strerror(ec));
+		}
+	}
+	~FrozenFileWriter()
+	{
+		if (m_file) ::fclose( m_file);
+	}
+
+	void write( const void* ptr, std::size_t size)
+	{
+		if (size && 1!=::fwrite( ptr, size, 1, m_file))
+		{
+			int ec = errno;
+			throw strus::runtime_error( _TXT("failed to write frozen database file '%s': %s"), m_filename.c_str(), ::strerror(ec));
+		}
+		m_ofs += size;
+	}
+	void rewind()
+	{
+		if (0!=::fseek( m_file, 0, SEEK_SET))
+		{
+			int ec = errno;
+			throw strus::runtime_error( _TXT("failed to write frozen database file '%s': %s"), m_filename.c_str(), ::strerror(ec));
+		}
+	}
+	void close()
+	{
+		FILE* file = m_file;
+		m_file = 0;
+		if (0!=::fclose( file))
+		{
+			int ec = errno;
+			throw strus::runtime_error( _TXT("failed to write frozen database file '%s': %s"), m_filename.c_str(), ::strerror(ec));
+		}
+	}
+	uint64_t offset() const
+	{
+		return m_ofs;
+	}
+
+private:
+	std::string m_filename;
+	FILE* m_file;
+	uint64_t m_ofs;
+};
+
+uint64_t MmapFrozenFile::write( const std::string& filename, DatabaseBackupCursorInterface* backup, unsigned int bloomFilterBits, const std::string& bloomFilterKeys)
+{
+	MmapFrozenFileHeader header;
+	std::memset( &header, 0, sizeof(header));
+	std::memcpy( header.magic, g_magic, sizeof(g_magic));
+	header.version = MmapFrozenFileHeader::Version;
+	header.byteOrderMark = MmapFrozenFileHeader::ByteOrderMark;
+	header.indexInterval = MmapFrozenFileHeader::IndexInterval;
+	if (bloomFilterKeys.empty())
+	{
+		std::memset( header.bloomPrefixSet, 0xFF, sizeof(header.bloomPrefixSet));
+	}
+	else
+	{
+		std::string::const_iterator ki = bloomFilterKeys.begin(), ke = bloomFilterKeys.end();
+		for (; ki != ke; ++ki)
+		{
+			unsigned char first = (unsigned char)*ki;
+			header.bloomPrefixSet[ first >> 3] |= (1 << (first & 7));
+		}
+	}
+	FrozenFileWriter out( filename);
+	out.write( &header, sizeof(header));
+
+	std::vector<uint64_t> index;
+	std::vector<uint64_t> hashes;
+	std::string prevkey;
+
+	const char* key;
+	std::size_t keysize;
+	const char* blk;
+	std::size_t blksize;
+
+	while (backup->fetch( key, keysize, blk, blksize))
+	{
+		if (header.nofRecords > 0)
+		{
+			std::size_t kk = prevkey.size() < keysize ? prevkey.size() : keysize;
+			int cmp = std::memcmp( prevkey.c_str(), key, kk);
+			if (cmp > 0 || (cmp == 0 && prevkey.size() >= keysize))
+			{
+				throw std::runtime_error( _TXT("keys of the records to write to a frozen database file are not in strictly ascending order"));
+			}
+		}
+		if (keysize > (std::size_t)0xFFffFFffU || blksize > (std::size_t)0xFFffFFffU)
+		{
+			throw std::runtime_error( _TXT("record too big for a frozen database file"));
+		}
+		if (header.nofRecords % header.indexInterval == 0)
+		{
+			index.push_back( out.offset());
+		}
+		uint32_t sizes[2];
+		sizes[0] = (uint32_t)keysize;
+		sizes[1] = (uint32_t)blksize;
+		out.write( sizes, sizeof(sizes));
+		out.write( key, keysize);
+		out.write( blk, blksize);
+
+		if (bloomFilterBits && bloomPrefixMatches( header.bloomPrefixSet, key, keysize))
+		{
+			hashes.push_back( bloomHash( key, keysize));
+		}
+		prevkey.assign( key, keysize);
+		++header.nofRecords;
+	}
+	header.indexOfs = out.offset();
+	header.nofIndexEntries = index.size();
+	if (!index.empty())
+	{
+		out.write( index.data(), index.size() * sizeof(uint64_t));
+	}
+	header.bloomOfs = out.offset();
+	if (bloomFilterBits && !hashes.empty())
+	{
+		// Number of hash functions minimizing the false positive rate, (bits per key * ln(2)) like LevelDB:
+		unsigned int nofHashes = bloomFilterBits * 69 / 100;
+		if (nofHashes < 1) nofHashes = 1;
+		if (nofHashes > 30) nofHashes = 30;
+
+		uint64_t nofBits = (uint64_t)hashes.size() * bloomFilterBits;
+		if (nofBits < 64) nofBits = 64;
+		std::vector<unsigned char> bits( (std::size_t)((nofBits + 7) / 8), 0);
+		std::vector<uint64_t>::const_iterator hi = hashes.begin(), he = hashes.end();
+		for (; hi != he; ++hi)
+		{
+			uint64_t hash = *hi;
+			uint64_t delta = (hash >> 33) | (hash << 31) | 1;
+			unsigned int ii = 0;
+			for (; ii < nofHashes; ++ii, hash += delta)
+			{
+				uint64_t bitidx = hash % nofBits;
+				bits[ bitidx >> 3] |= (1 << (bitidx & 7));
+			}
+		}
+		out.write( bits.data(), bits.size());
+		header.bloomBits = nofBits;
+		header.bloomHashes = nofHashes;
+	}
+	out.rewind();
+	out.write( &header, sizeof(header));
+	out.close();
+	return header.nofRecords;
+}
+
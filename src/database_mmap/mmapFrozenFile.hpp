@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Immutable sorted key/value file accessed through a read only memory mapping
+/// \file "mmapFrozenFile.hpp"
+#ifndef _STRUS_DATABASE_MMAP_FROZEN_FILE_HPP_INCLUDED
+#define _STRUS_DATABASE_MMAP_FROZEN_FILE_HPP_INCLUDED
+#include "strus/base/shared_ptr.hpp"
+#include <string>
+#include <cstddef>
+#include <cstring>
+#include <stdint.h>
+
+namespace strus {
+
+/// \brief Forward declaration
+class DatabaseBackupCursorInterface;
+
+/// \brief Layout of the frozen file:
+///	[header] [records sorted by key] [sparse index] [bloom filter]
+///	- a record is {uint32 keysize, uint32 valuesize, key, value}, records are ordered by memcmp of the keys
+///	- the sparse index is an array of the uint64 file offsets of every IndexInterval'th record
+///	- the bloom filter is a bit array over the keys starting with a byte in the set of the header
+struct MmapFrozenFileHeader
+{
+	enum {Version=1, ByteOrderMark=0x01020304, IndexInterval=16};
+
+	char magic[8];				///< magic "STRUSMMF"
+	uint32_t version;			///< version of the format
+	uint32_t byteOrderMark;			///< ByteOrderMark in the byte order of the writer
+	uint64_t nofRecords;			///< number of records
+	uint64_t indexOfs;			///< file offset of the sparse index
+	uint64_t nofIndexEntries;		///< number of entries of the sparse index
+	uint64_t bloomOfs;			///< file offset of the bloom filter
+	uint64_t bloomBits;			///< number of bits of the bloom filter, 0 if there is no bloom filter
+	uint32_t bloomHashes;			///< number of hash functions of the bloom filter
+	uint32_t indexInterval;			///< number of records per sparse index entry
+	unsigned char bloomPrefixSet[32];	///< bit set of the first bytes of the keys in the bloom filter
+};
+
+/// \brief Read only view of a frozen file mapped into memory
+/// \note Opening a file maps it and checks the header, no data is read. All access goes through the page cache.
+class MmapFrozenFile
+{
+public:
+	/// \brief Constructor, maps a file and validates its header
+	/// \param[in] filename path of the file to map
+	explicit MmapFrozenFile( const std::string& filename);
+	~MmapFrozenFile();
+
+	/// \brief Position of a record in the file
+	struct Position
+	{
+		uint64_t ordinal;	///< index of the record in the order of the keys starting with 0
+		uint64_t offset;	///< file offset of the record
+
+		Position()
+			:ordinal(0),offset(0){}
+		Position( uint64_t ordinal_, uint64_t offset_)
+			:ordinal(ordinal_),offset(offset_){}
+	};
+
+	/// \brief Get the number of records
+	uint64_t nofRecords() const		{return m_header->nofRecords;}
+	/// \brief Evaluate if a position refers to a record
+	bool valid( const Position& pos) const	{return pos.ordinal < m_header->nofRecords;}
+	/// \brief Get the position of the first record
+	Position begin() const			{return Position( 0, sizeof(MmapFrozenFileHeader));}
+	/// \brief Get the position behind the last record
+	Position end() const			{return Position( m_header->nofRecords, m_header->indexOfs);}
+
+	/// \brief Get the position of the first record with a key bigger than or equal to a key
+	Position lowerBound( const char* key, std::size_t keysize) const;
+	/// \brief Get the position of the record following a valid position
+	Position next( const Position& pos) const;
+	/// \brief Get the position of the record preceding a valid position or end() if it is the first
+	Position prev( const Position& pos) const;
+	/// \brief Get the position of the last record or end() if there are no records
+	Position last() const;
+
+	/// \brief Get the key of the record at a valid position
+	const char* key( const Position& pos, std::size_t& keysize) const
+	{
+		keysize = readUInt32( pos.offset);
+		return m_base + pos.offset + 2*sizeof(uint32_t);
+	}
+	/// \brief Get the value of the record at a valid position
+	const char* value( const Position& pos, std::size_t& valuesize) const
+	{
+		valuesize = readUInt32( pos.offset + sizeof(uint32_t));
+		return m_base + pos.offset + 2*sizeof(uint32_t) + readUInt32( pos.offset);
+	}
+
+	/// \brief Evaluate if a key may exist according to the bloom filter
+	/// \return false if the key definitely does not exist, true if it may exist
+	bool mayContain( const char* key, std::size_t keysize) const;
+
+	/// \brief Get the size of the file in bytes
+	std::size_t size() const		{return m_size;}
+	/// \brief Get the name of the file
+	const std::string& filename() const	{return m_filename;}
+
+	/// \brief Write a frozen file with the contents of a backup cursor, records have to be fetched in ascending order of the keys
+	/// \param[in] filename path of the file to write
+	/// \param[in] backup cursor to fetch the records from
+	/// \param[in] bloomFilterBits number of bits per key of the bloom filter (0 for no bloom filter)
+	/// \param[in] bloomFilterKeys characters of the first byte of the keys to put into the bloom filter (empty for all keys)
+	/// \return the number of records written
+	static uint64_t write( const std::string& filename, DatabaseBackupCursorInterface* backup, unsigned int bloomFilterBits, const std::string& bloomFilterKeys);
+
+	/// \brief Name of the file in the database directory
+	static const char* defaultFileName()	{return "frozen.mmf";}
+
+private:
+#if __cplusplus >= 201103L
+	MmapFrozenFile( MmapFrozenFile&) = delete;	//... non copyable
+	void operator=( MmapFrozenFile&) = delete;	//... non copyable
+#endif
+	uint32_t readUInt32( uint64_t ofs) const
+	{
+		uint32_t rt;
+		std::memcpy( &rt, m_base + ofs, sizeof(rt));
+		return rt;
+	}
+	uint64_t indexOffset( uint64_t idx) const
+	{
+		uint64_t rt;
+		std::memcpy( &rt, m_base + m_header->indexOfs + idx * sizeof(uint64_t), sizeof(rt));
+		return rt;
+	}
+	int compareKey( uint64_t offset, const char* key, std::size_t keysize) const;
+
+private:
+	std::string m_filename;				///< name of the file mapped
+	const char* m_base;				///< start of the memory mapping
+	std::size_t m_size;				///< size of the file and of the memory mapping
+	const MmapFrozenFileHeader* m_header;		///< header of the file
+};
+
+typedef strus::shared_ptr<MmapFrozenFile> MmapFrozenFileRef;
+
+}//namespace
+#endif
+
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Program exporting a storage to a read only memory mapped database for search replicas
+/// \file "strusExportMmapDatabase.cpp"
+#include "strus/lib/error.hpp"
+#include "strus/lib/database_leveldb.hpp"
+#include "strus/lib/database_mmap.hpp"
+#include "strus/lib/filelocator.hpp"
+#include "strus/errorBufferInterface.hpp"
+#include "strus/fileLocatorInterface.hpp"
+#include "strus/databaseInterface.hpp"
+#include "strus/databaseClientInterface.hpp"
+#include "strus/databaseBackupCursorInterface.hpp"
+#include "strus/reference.hpp"
+#include "strus/base/local_ptr.hpp"
+#include "strus/versionStorage.hpp"
+#include "private/errorUtils.hpp"
+#include "private/internationalization.hpp"
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <iostream>
+
+static void printUsage()
+{
+	std::cout << "strusExportMmapDatabase [options] <srcconfig> <dstconfig>" << std::endl;
+	std::cout << "Description: Exports the contents of a key/value store database (LevelDB)" << std::endl;
+	std::cout << "  to an immutable, sorted file accessed through a memory mapping." << std::endl;
+	std::cout << "  The database exported is read only and meant for search replicas." << std::endl;
+	std::cout << "  It is used by specifying 'database=mmap' in the storage configuration." << std::endl;
+	std::cout << "Options:" << std::endl;
+	std::cout << "-h|--help" << std::endl;
+	std::cout << "    " << _TXT("Print this usage and do nothing else") << std::endl;
+	std::cout << "-v|--version" << std::endl;
+	std::cout << "    " << _TXT("Print the program version and do nothing else") << std::endl;
+	std::cout << "<srcconfig>  : " << _TXT("configuration string of the key/value store database to export") << std::endl;
+	std::cout << "<dstconfig>  : " << _TXT("configuration string of the memory mapped database to create:") << std::endl;
+	std::cout << "               path=" << _TXT("path of the directory of the database to create") << std::endl;
+	std::cout << "               bloom_filter=" << _TXT("number of bits per key of a bloom filter for point lookups (optional)") << std::endl;
+	std::cout << "               bloom_filter_keys=" << _TXT("characters of the first byte of the keys in the bloom filter (optional, default all keys)") << std::endl;
+}
+
+static strus::ErrorBufferInterface* g_errorBuffer = 0;	// error buffer
+
+int main( int argc, const char* argv[])
+{
+	try
+	{
+		strus::local_ptr<strus::ErrorBufferInterface> errorBuffer( strus::createErrorBuffer_standard( 0, 2, NULL/*debug trace interface*/));
+		if (!errorBuffer.get())
+		{
+			std::cerr << _TXT("failed to create error buffer") << std::endl;
+			return -1;
+		}
+		g_errorBuffer = errorBuffer.get();
+		strus::Reference<strus::FileLocatorInterface> filelocator( strus::createFileLocator_std( g_errorBuffer));
+		if (!filelocator.get())
+		{
+			std::cerr << _TXT("failed to create file locator") << std::endl;
+			return -1;
+		}
+		bool doExit = false;
+		int argi = 1;
+
+		// Parsing arguments:
+		for (; argi < argc; ++argi)
+		{
+			if (0==std::strcmp( argv[argi], "-h") || 0==std::strcmp( argv[argi], "--help"))
+			{
+				printUsage();
+				doExit = true;
+			}
+			else if (0==std::strcmp( argv[argi], "-v") || 0==std::strcmp( argv[argi], "--version"))
+			{
+				std::cerr << "strus storage version " << STRUS_STORAGE_VERSION_STRING << std::endl;
+				doExit = true;
+			}
+			else if (argv[argi][0] == '-')
+			{
+				throw strus::runtime_error(_TXT("unknown option %s"), argv[ argi]);
+			}
+			else
+			{
+				break;
+			}
+		}
+		if (doExit) return 0;
+		if (argc - argi < 2) throw strus::runtime_error( _TXT("too few arguments (given %u, required %u)"), argc - argi, 2);
+		if (argc - argi > 2) throw strus::runtime_error( _TXT("too many arguments (given %u, required %u)"), argc - argi, 2);
+
+		std::string srcconfig( argv[ argi+0]);
+		std::string dstconfig( argv[ argi+1]);
+
+		strus::Reference<strus::DatabaseInterface> srcdbi( strus::createDatabaseType_leveldb( filelocator.get(), g_errorBuffer));
+		if (!srcdbi.get()) throw strus::runtime_error( "%s",  _TXT("could not create leveldb key/value store database handler"));
+		strus::Reference<strus::DatabaseInterface> dstdbi( strus::createDatabaseType_mmap( filelocator.get(), g_errorBuffer));
+		if (!dstdbi.get()) throw strus::runtime_error( "%s",  _TXT("could not create memory mapped database handler"));
+		if (g_errorBuffer->hasError()) throw std::runtime_error( _TXT("error in initialization"));
+
+		strus::local_ptr<strus::DatabaseClientInterface> srcdb( srcdbi->createClient( srcconfig));
+		if (!srcdb.get()) throw strus::runtime_error( "%s",  _TXT("failed to open database to export"));
+		strus::local_ptr<strus::DatabaseBackupCursorInterface> cursor( srcdb->createBackupCursor());
+		if (!cursor.get()) throw strus::runtime_error( "%s",  _TXT("failed to create cursor on database to export"));
+
+		if (!dstdbi->restoreDatabase( dstconfig, cursor.get()))
+		{
+			throw strus::runtime_error( "%s",  _TXT("failed to export database"));
+		}
+		// Check for reported error an terminate regularly:
+		if (g_errorBuffer->hasError())
+		{
+			throw strus::runtime_error( "%s",  _TXT("error exporting database"));
+		}
+		std::cerr << _TXT("done") << std::endl;
+		return 0;
+	}
+	catch (const std::exception& e)
+	{
+		const char* errormsg = g_errorBuffer?g_errorBuffer->fetchError():0;
+		if (errormsg)
+		{
+			std::cerr << e.what() << ": " << errormsg << std::endl;
+		}
+		else
+		{
+			std::cerr << e.what() << std::endl;
+		}
+	}
+	return -1;
+}
+
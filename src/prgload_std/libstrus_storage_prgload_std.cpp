@@ -55,7 +55,7 @@ DLL_PUBLIC int strus::load_metadata_assignments(
 			strus::initMessageTextDomain();
 			g_intl_initialized = true;
 		}
-		return loadDocumentMetaDataAssignments( storage, metadataName, attributemapref, file, commitSize, errorhnd);
+		return loadDocumentMetaDataAssignments( storage, metadataName, attributemapref, file, commitSize, 0/*nofThreads*/, errorhnd);
 	}
 	CATCH_ERROR_MAP_RETURN( _TXT("error loading metadata assignments: %s"), *errorhnd, -1);
 }
@@ -75,7 +75,7 @@ DLL_PUBLIC int strus::load_attribute_assignments(
 			strus::initMessageTextDomain();
 			g_intl_initialized = true;
 		}
-		return loadDocumentAttributeAssignments( storage, attributeName, attributemapref, file, commitSize, errorhnd);
+		return loadDocumentAttributeAssignments( storage, attributeName, attributemapref, file, commitSize, 0/*nofThreads*/, errorhnd);
 	}
 	CATCH_ERROR_MAP_RETURN( _TXT("error loading attribute assignments: %s"), *errorhnd, -1);
 }
@@ -94,7 +94,69 @@ DLL_PUBLIC int strus::load_user_assignments(
 			strus::initMessageTextDomain();
 			g_intl_initialized = true;
 		}
-		return loadDocumentUserRightsAssignments( storage, attributemapref, file, commitSize, errorhnd);
+		return loadDocumentUserRightsAssignments( storage, attributemapref, file, commitSize, 0/*nofThreads*/, errorhnd);
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error loading user right assignments: %s"), *errorhnd, -1);
+}
+
+DLL_PUBLIC int strus::load_metadata_assignments_bulk(
+		StorageClientInterface& storage,
+		const std::string& metadataName,
+		const std::multimap<std::string,strus::Index>* attributemapref,
+		const std::string& file,
+		int commitSize,
+		int nofThreads,
+		ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		if (!g_intl_initialized)
+		{
+			strus::initMessageTextDomain();
+			g_intl_initialized = true;
+		}
+		return loadDocumentMetaDataAssignments( storage, metadataName, attributemapref, file, commitSize, nofThreads > 0 ? nofThreads : 1, errorhnd);
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error loading metadata assignments: %s"), *errorhnd, -1);
+}
+
+DLL_PUBLIC int strus::load_attribute_assignments_bulk(
+		StorageClientInterface& storage,
+		const std::string& attributeName,
+		const std::multimap<std::string,strus::Index>* attributemapref,
+		const std::string& file,
+		int commitSize,
+		int nofThreads,
+		ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		if (!g_intl_initialized)
+		{
+			strus::initMessageTextDomain();
+			g_intl_initialized = true;
+		}
+		return loadDocumentAttributeAssignments( storage, attributeName, attributemapref, file, commitSize, nofThreads > 0 ? nofThreads : 1, errorhnd);
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error loading attribute assignments: %s"), *errorhnd, -1);
+}
+
+DLL_PUBLIC int strus::load_user_assignments_bulk(
+		StorageClientInterface& storage,
+		const std::multimap<std::string,strus::Index>* attributemapref,
+		const std::string& file,
+		int commitSize,
+		int nofThreads,
+		ErrorBufferInterface* errorhnd)
+{
+	try
+	{
+		if (!g_intl_initialized)
+		{
+			strus::initMessageTextDomain();
+			g_intl_initialized = true;
+		}
+		return loadDocumentUserRightsAssignments( storage, attributemapref, file, commitSize, nofThreads > 0 ? nofThreads : 1, errorhnd);
 	}
 	CATCH_ERROR_MAP_RETURN( _TXT("error loading user right assignments: %s"), *errorhnd, -1);
 }
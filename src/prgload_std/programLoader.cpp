@@ -33,14 +33,24 @@
 #include "strus/base/dll_tags.hpp"
 #include "strus/base/inputStream.hpp"
 #include "strus/base/hton.hpp"
+#include "strus/base/thread.hpp"
+#include "strus/reference.hpp"
 #include "private/internationalization.hpp"
 #include <string>
 #include <vector>
 #include <set>
 #include <map>
 #include <limits>
+#include <algorithm>
 #include <iostream>
 #include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace strus;
 
@@ -856,6 +866,10 @@ static unsigned int loadStorageValues(
 		char line[ 4096];
 		for (; stream.readLine( line, sizeof(line)); ++linecnt)
 		{
+			//... strip end of line (LF or CRLF) the same way as the bulk loader does
+			std::size_t linelen = std::strlen( line);
+			while (linelen && (line[ linelen-1] == '\n' || line[ linelen-1] == '\r')) line[ --linelen] = 0;
+
 			char const* itr = line;
 			if (attributemapref)
 			{
@@ -918,17 +932,399 @@ static unsigned int loadStorageValues(
 }
 
 
+/// \brief Read only memory mapping of an input file
+class MappedInputFile
+{
+public:
+	explicit MappedInputFile( const std::string& filename)
+		:m_ptr(0),m_size(0)
+	{
+		int fd = ::open( filename.c_str(), O_RDONLY);
+		if (fd < 0) throw strus::runtime_error(_TXT("failed to open storage value file '%s': %s"), filename.c_str(), ::strerror(errno));
+		struct stat st;
+		if (0!=::fstat( fd, &st))
+		{
+			int ec = errno;
+			::close( fd);
+			throw strus::runtime_error(_TXT("failed to get size of storage value file '%s': %s"), filename.c_str(), ::strerror(ec));
+		}
+		m_size = st.st_size;
+		if (m_size)
+		{
+			void* mem = ::mmap( 0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			int ec = errno;
+			::close( fd);
+			if (mem == MAP_FAILED) throw strus::runtime_error(_TXT("failed to map storage value file '%s' into memory: %s"), filename.c_str(), ::strerror(ec));
+			m_ptr = (const char*)mem;
+			(void)::madvise( mem, m_size, MADV_SEQUENTIAL);
+		}
+		else
+		{
+			::close( fd);
+		}
+	}
+	~MappedInputFile()
+	{
+		if (m_ptr) ::munmap( (void*)m_ptr, m_size);
+	}
+
+	const char* ptr() const		{return m_ptr;}
+	std::size_t size() const	{return m_size;}
+
+private:
+	MappedInputFile( const MappedInputFile&){}	//... non copyable
+	void operator=( const MappedInputFile&){}	//... non copyable
+
+private:
+	const char* m_ptr;
+	std::size_t m_size;
+};
+
+/// \brief Assignment of a storage value parsed from a line of the input
+struct StorageValueAssignment
+{
+	strus::Index docno;		///< document number to update
+	std::size_t lineno;		///< line number in the input, relative to the chunk parsed until merged
+	const char* value;		///< pointer to the value in the memory mapped input
+	std::size_t valuesize;		///< size of the value in bytes
+
+	StorageValueAssignment( strus::Index docno_, std::size_t lineno_, const char* value_, std::size_t valuesize_)
+		:docno(docno_),lineno(lineno_),value(value_),valuesize(valuesize_){}
+	StorageValueAssignment( const StorageValueAssignment& o)
+		:docno(o.docno),lineno(o.lineno),value(o.value),valuesize(o.valuesize){}
+
+	/// \brief Order by document number, assignments to the same document keep the order of the input
+	bool operator < (const StorageValueAssignment& o) const
+	{
+		return (docno == o.docno) ? (lineno < o.lineno) : (docno < o.docno);
+	}
+};
+
+/// \brief Parser of a chunk of lines of the memory mapped input, running in its own thread
+class StorageValueChunkParser
+{
+public:
+	StorageValueChunkParser( const StorageClientInterface* storage_, const KeyDocnoMap* attributemapref_, const char* chunk_, std::size_t chunksize_, ErrorBufferInterface* errorhnd_)
+		:m_storage(storage_),m_attributemapref(attributemapref_),m_chunk(chunk_),m_chunksize(chunksize_)
+		,m_assignments(),m_nofLines(0),m_errorLine(0),m_error(),m_errorhnd(errorhnd_){}
+
+	void runThread()
+	{
+		m_errorhnd->allocContext();
+		run();
+		m_errorhnd->releaseContext();
+	}
+
+	void run()
+	{
+		try
+		{
+			typedef std::pair<std::string,std::size_t> DocidRef;
+			std::vector<DocidRef> docids;	//... document ids with the index of their assignment to resolve
+			std::string line;
+			char const* li = m_chunk;
+			const char* ce = m_chunk + m_chunksize;
+			while (li < ce)
+			{
+				++m_nofLines;
+				const char* le = (const char*)std::memchr( li, '\n', ce - li);
+				if (!le) le = ce;
+				line.assign( li, le - li);
+				if (!line.empty() && line[ line.size()-1] == '\r') line.resize( line.size()-1);
+
+				char const* itr = line.c_str();
+				if (m_attributemapref)
+				{
+					std::string attr = parseNextItem( itr);
+					std::size_t valueofs = itr - line.c_str();
+					std::pair<KeyDocnoMap::const_iterator,KeyDocnoMap::const_iterator>
+						range = m_attributemapref->equal_range( attr);
+					KeyDocnoMap::const_iterator ki = range.first, ke = range.second;
+					for (; ki != ke; ++ki)
+					{
+						m_assignments.push_back( StorageValueAssignment( ki->second, m_nofLines, li + valueofs, line.size() - valueofs));
+					}
+				}
+				else
+				{
+					std::string docid( parseNextItem( itr));
+					std::size_t valueofs = itr - line.c_str();
+					if (docid.empty())
+					{
+						throw std::runtime_error(_TXT("document id is empty"));
+					}
+					strus::Index docno = 0;
+					if (docid[0] >= '0' && docid[0] <= '9')
+					{
+						docno = numstring_conv::toint( docid, std::numeric_limits<strus::Index>::max());
+					}
+					else if (docid[0] == '_')
+					{
+						docno = numstring_conv::toint( docid.c_str()+1, docid.size()-1, std::numeric_limits<strus::Index>::max());
+					}
+					else
+					{
+						docids.push_back( DocidRef( docid, m_assignments.size()));
+					}
+					m_assignments.push_back( StorageValueAssignment( docno, m_nofLines, li + valueofs, line.size() - valueofs));
+				}
+				li = le + 1;
+			}
+			// Resolve the document ids as one batch in ascending key order:
+			m_errorLine = 0;
+			std::sort( docids.begin(), docids.end());
+			std::vector<DocidRef>::const_iterator di = docids.begin(), de = docids.end();
+			while (di != de)
+			{
+				strus::Index docno = m_storage->documentNumber( di->first);
+				if (!docno && m_errorhnd->hasError())
+				{
+					m_errorLine = m_assignments[ di->second].lineno;
+					throw std::runtime_error( m_errorhnd->fetchError());
+				}
+				const std::string& docid = di->first;
+				for (; di != de && di->first == docid; ++di)
+				{
+					m_assignments[ di->second].docno = docno;
+				}
+			}
+			// Assignments to documents not in the storage are ignored:
+			std::vector<StorageValueAssignment>::iterator
+				ai = m_assignments.begin(), ae = m_assignments.end(), aa = ai;
+			for (; ai != ae; ++ai)
+			{
+				if (ai->docno) *aa++ = *ai;
+			}
+			m_assignments.erase( aa, ae);
+		}
+		catch (const std::bad_alloc&)
+		{
+			if (!m_errorLine) m_errorLine = m_nofLines;
+			m_error = _TXT("out of memory");
+		}
+		catch (const std::runtime_error& err)
+		{
+			if (!m_errorLine) m_errorLine = m_nofLines;
+			m_error = err.what();
+		}
+		catch (const std::exception& err)
+		{
+			//... no exception must escape the procedure of a thread
+			if (!m_errorLine) m_errorLine = m_nofLines;
+			m_error = strus::string_format( _TXT("uncaught exception: %s"), err.what());
+		}
+		catch (...)
+		{
+			if (!m_errorLine) m_errorLine = m_nofLines;
+			m_error = _TXT("uncaught exception of unknown type");
+		}
+	}
+
+	std::vector<StorageValueAssignment>& assignments()	{return m_assignments;}
+	std::size_t nofLines() const				{return m_nofLines;}
+	std::size_t errorLine() const				{return m_errorLine;}
+	const std::string& error() const			{return m_error;}
+
+private:
+	const StorageClientInterface* m_storage;
+	const KeyDocnoMap* m_attributemapref;
+	const char* m_chunk;
+	std::size_t m_chunksize;
+	std::vector<StorageValueAssignment> m_assignments;
+	std::size_t m_nofLines;
+	std::size_t m_errorLine;
+	std::string m_error;
+	ErrorBufferInterface* m_errorhnd;
+};
+
+/// \brief Group of threads joined on destruction, also in case of an exception
+class LoaderThreadGroup
+{
+public:
+	LoaderThreadGroup(){}
+	~LoaderThreadGroup()
+	{
+		joinAll();
+	}
+	void add( strus::thread* thread_)
+	{
+		m_threads.push_back( Reference<strus::thread>( thread_));
+	}
+	void joinAll()
+	{
+		std::vector<Reference<strus::thread> >::iterator ti = m_threads.begin(), te = m_threads.end();
+		for (; ti != te; ++ti)
+		{
+			(*ti)->join();
+		}
+		m_threads.clear();
+	}
+
+private:
+	std::vector<Reference<strus::thread> > m_threads;
+};
+
+/// \brief Get the start of the line following the line containing a position
+static const char* nextLineStart( const char* pos, const char* end)
+{
+	const char* eoln = (const char*)std::memchr( pos, '\n', end - pos);
+	return eoln ? (eoln+1) : end;
+}
+
+enum {
+	BulkLoadSegmentSize=(1<<28)	///< size of the segments of the input that are parsed and sorted as a whole, bounds the memory used for the assignments
+};
+
+static void commitStorageValues( StorageClientInterface& storage, strus::local_ptr<StorageTransactionInterface>& transaction)
+{
+	if (!transaction->commit())
+	{
+		throw std::runtime_error( _TXT("transaction commit failed"));
+	}
+	transaction.reset( storage.createTransaction());
+	if (!transaction.get()) throw strus::runtime_error( _TXT("failed to recreate storage transaction after commit"));
+}
+
+/// \brief Bulk loader: the input is memory mapped and processed in segments, every segment is split into chunks of lines parsed in parallel,
+///	the assignments of a segment are sorted by document number, so that the blocks of a document range are rewritten once per commit
+static unsigned int loadStorageValuesBulk(
+		StorageClientInterface& storage,
+		const std::string& elementName,
+		const KeyDocnoMap* attributemapref,
+		const std::string& file,
+		StorageValueType valueType,
+		unsigned int commitSize,
+		unsigned int nofThreads,
+		ErrorBufferInterface* errorhnd)
+{
+	MappedInputFile input( file);
+	unsigned int rt = 0;
+	strus::local_ptr<StorageTransactionInterface> transaction( storage.createTransaction());
+	if (!transaction.get()) throw strus::runtime_error( _TXT("failed to create storage transaction"));
+	std::size_t linecnt = 1;
+	unsigned int commitcnt = 0;
+	try
+	{
+		const char* fe = input.ptr() + input.size();
+		char const* si = input.ptr();
+		std::size_t segmentLineStart = 1;
+		while (si < fe)
+		{
+			// [1] Split the segment into chunks of lines of equal size:
+			const char* se = ((std::size_t)(fe - si) <= BulkLoadSegmentSize) ? fe : nextLineStart( si + BulkLoadSegmentSize, fe);
+			std::size_t chunksize = ((se - si) + nofThreads - 1) / nofThreads;
+			std::vector<Reference<StorageValueChunkParser> > parsers;
+			char const* ci = si;
+			while (ci < se)
+			{
+				const char* ce = ((std::size_t)(se - ci) <= chunksize) ? se : nextLineStart( ci + chunksize, se);
+				parsers.push_back( Reference<StorageValueChunkParser>(
+					new StorageValueChunkParser( &storage, attributemapref, ci, ce - ci, errorhnd)));
+				ci = ce;
+			}
+			// [2] Parse the chunks, the first one in the calling thread:
+			{
+				LoaderThreadGroup threads;
+				std::vector<Reference<StorageValueChunkParser> >::const_iterator
+					pi = parsers.begin()+1, pe = parsers.end();
+				for (; pi != pe; ++pi)
+				{
+					threads.add( new strus::thread( &StorageValueChunkParser::runThread, pi->get()));
+				}
+				parsers[0]->run();
+				threads.joinAll();
+			}
+			// [3] Merge the assignments of the chunks with the line numbers made absolute and sort them:
+			std::vector<StorageValueAssignment> assignments;
+			std::size_t chunkLineStart = segmentLineStart;
+			std::vector<Reference<StorageValueChunkParser> >::const_iterator
+				pi = parsers.begin(), pe = parsers.end();
+			for (; pi != pe; ++pi)
+			{
+				if (!(*pi)->error().empty())
+				{
+					linecnt = chunkLineStart + (*pi)->errorLine() - 1;
+					throw std::runtime_error( (*pi)->error());
+				}
+				std::vector<StorageValueAssignment>& chunkAssignments = (*pi)->assignments();
+				std::vector<StorageValueAssignment>::iterator
+					ai = chunkAssignments.begin(), ae = chunkAssignments.end();
+				for (; ai != ae; ++ai)
+				{
+					ai->lineno += chunkLineStart - 1;
+				}
+				assignments.insert( assignments.end(), chunkAssignments.begin(), chunkAssignments.end());
+				std::vector<StorageValueAssignment>().swap( chunkAssignments);
+				chunkLineStart += (*pi)->nofLines();
+			}
+			parsers.clear();
+			std::sort( assignments.begin(), assignments.end());
+
+			// [4] Write the assignments in document number order:
+			std::vector<StorageValueAssignment>::const_iterator
+				ai = assignments.begin(), ae = assignments.end();
+			for (; ai != ae; ++ai)
+			{
+				linecnt = ai->lineno;
+				if (updateStorageValue( transaction.get(), ai->docno, elementName, valueType, std::string( ai->value, ai->valuesize)))
+				{
+					rt += 1;
+				}
+				if (++commitcnt == commitSize)
+				{
+					commitStorageValues( storage, transaction);
+					commitcnt = 0;
+				}
+			}
+			segmentLineStart = chunkLineStart;
+			si = se;
+		}
+		if (commitcnt)
+		{
+			commitStorageValues( storage, transaction);
+			commitcnt = 0;
+		}
+		return rt;
+	}
+	catch (const std::runtime_error& err)
+	{
+		throw strus::runtime_error( _TXT("error on line %u: %s"), (unsigned int)linecnt, err.what());
+	}
+}
+
+static unsigned int loadStorageValues(
+		StorageClientInterface& storage,
+		const std::string& elementName,
+		const KeyDocnoMap* attributemapref,
+		const std::string& file,
+		StorageValueType valueType,
+		unsigned int commitSize,
+		int nofThreads,
+		ErrorBufferInterface* errorhnd)
+{
+	if (nofThreads <= 0 || file == "-")
+	{
+		//... the standard input cannot be memory mapped and is read sequentially
+		return loadStorageValues( storage, elementName, attributemapref, file, valueType, commitSize, errorhnd);
+	}
+	else
+	{
+		return loadStorageValuesBulk( storage, elementName, attributemapref, file, valueType, commitSize, nofThreads, errorhnd);
+	}
+}
+
 DLL_PUBLIC int strus::loadDocumentMetaDataAssignments(
 		StorageClientInterface& storage,
 		const std::string& metadataName,
 		const std::multimap<std::string,strus::Index>* attributemapref,
 		const std::string& file,
 		int commitSize,
+		int nofThreads,
 		ErrorBufferInterface* errorhnd)
 {
 	try
 	{
-		return loadStorageValues( storage, metadataName, attributemapref, file, StorageValueMetaData, commitSize, errorhnd);
+		return loadStorageValues( storage, metadataName, attributemapref, file, StorageValueMetaData, commitSize, nofThreads, errorhnd);
 	}
 	catch (const std::bad_alloc&)
 	{
@@ -949,11 +1345,12 @@ DLL_PUBLIC int strus::loadDocumentAttributeAssignments(
 		const std::multimap<std::string,strus::Index>* attributemapref,
 		const std::string& file,
 		int commitSize,
+		int nofThreads,
 		ErrorBufferInterface* errorhnd)
 {
 	try
 	{
-		return loadStorageValues( storage, attributeName, attributemapref, file, StorageValueAttribute, commitSize, errorhnd);
+		return loadStorageValues( storage, attributeName, attributemapref, file, StorageValueAttribute, commitSize, nofThreads, errorhnd);
 	}
 	catch (const std::bad_alloc&)
 	{
@@ -973,11 +1370,12 @@ DLL_PUBLIC int strus::loadDocumentUserRightsAssignments(
 		const std::multimap<std::string,strus::Index>* attributemapref,
 		const std::string& file,
 		int commitSize,
+		int nofThreads,
 		ErrorBufferInterface* errorhnd)
 {
 	try
 	{
-		return loadStorageValues( storage, std::string(), attributemapref, file, StorageUserRights, commitSize, errorhnd);
+		return loadStorageValues( storage, std::string(), attributemapref, file, StorageUserRights, commitSize, nofThreads, errorhnd);
 	}
 	catch (const std::bad_alloc&)
 	{
@@ -53,6 +53,7 @@ bool loadQueryEvalProgram(
 /// \param[in] attributemapref map that maps the update key to a list of document numbers to update (NULL, if the docid or docno is the key)
 /// \param[in] file the file to read from
 /// \param[in] commitSize number of documents to update until an implicit commit is called (0 => no implicit commit)
+/// \param[in] nofThreads number of threads parsing the file memory mapped with the updates sorted by document number (bulk loader), 0 for reading the file line by line
 /// \param[in,out] errorhnd buffer for reporting errors (exceptions)
 /// \return the number of documents (non distinct) updated
 int loadDocumentMetaDataAssignments(
@@ -61,6 +62,7 @@ int loadDocumentMetaDataAssignments(
 		const std::multimap<std::string,strus::Index>* attributemapref,
 		const std::string& file,
 		int commitSize,
+		int nofThreads,
 		ErrorBufferInterface* errorhnd);
 
 /// \brief Load some attribute assignments for a storage from a stream
@@ -69,6 +71,7 @@ int loadDocumentMetaDataAssignments(
 /// \param[in] attributemapref map that maps the update key to a list of document numbers to update (NULL, if the docid or docno is the key)
 /// \param[in] file the file to read from
 /// \param[in] commitSize number of documents to update until an implicit commit is called (0 => no implicit commit)
+/// \param[in] nofThreads number of threads parsing the file memory mapped with the updates sorted by document number (bulk loader), 0 for reading the file line by line
 /// \param[in,out] errorhnd buffer for reporting errors (exceptions)
 /// \return the number of documents (non distinct) updated
 int loadDocumentAttributeAssignments(
@@ -77,6 +80,7 @@ int loadDocumentAttributeAssignments(
 		const std::multimap<std::string,strus::Index>* attributemapref,
 		const std::string& file,
 		int commitSize,
+		int nofThreads,
 		ErrorBufferInterface* errorhnd);
 
 /// \brief Load some user rights assignments for a storage from a stream
@@ -84,6 +88,7 @@ int loadDocumentAttributeAssignments(
 /// \param[in] attributemapref map that maps the update key to a list of document numbers to update (NULL, if the docid or docno is the key)
 /// \param[in] file the file to read from
 /// \param[in] commitSize number of documents to update until an implicit commit is called (0 => no implicit commit)
+/// \param[in] nofThreads number of threads parsing the file memory mapped with the updates sorted by document number (bulk loader), 0 for reading the file line by line
 /// \param[in,out] errorhnd buffer for reporting errors (exceptions)
 /// \return the number of documents (non distinct) updated
 int loadDocumentUserRightsAssignments(
@@ -91,6 +96,7 @@ int loadDocumentUserRightsAssignments(
 		const std::multimap<std::string,strus::Index>* attributemapref,
 		const std::string& file,
 		int commitSize,
+		int nofThreads,
 		ErrorBufferInterface* errorhnd);
 
 /// \brief Adds the feature definitions in the file with path vectorfile to a vector storage
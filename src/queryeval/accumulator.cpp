@@ -16,6 +16,8 @@
 #include "strus/scalarFunctionInstanceInterface.hpp"
 #include "private/internationalization.hpp"
 #include <cstdlib>
+#include <algorithm>
+#include <utility>
 #include <limits>
 #include <stdexcept>
 #include <iostream>
@@ -54,6 +56,275 @@ void Accumulator::defineWeightingVariableValue( std::size_t index, const std::st
 	m_weightingElements[ index]->setVariableValue( varname, value);
 }
 
+void Accumulator::initPruning()
+{
+	m_pruningInitialized = true;
+	m_pruningOrder.clear();
+	m_pruningMaxWeight.clear();
+	if (m_weightingFormula)
+	{
+		// ... we cannot make any assumptions about the monotonicity of a weighting formula
+		return;
+	}
+	std::vector<std::pair<double,std::size_t> > maxweights;
+	std::vector<WeightingElement>::const_iterator
+		ai = m_weightingElements.begin(), ae = m_weightingElements.end();
+	bool bounded = false;
+	for (std::size_t aidx=0; ai != ae; ++ai,++aidx)
+	{
+		double maxweight = (*ai)->maxWeight();
+		if (maxweight < std::numeric_limits<double>::infinity())
+		{
+			bounded = true;
+		}
+		maxweights.push_back( std::pair<double,std::size_t>( -maxweight, aidx));
+		m_pruningMaxWeight.push_back( maxweight);
+	}
+	if (!bounded)
+	{
+		m_pruningMaxWeight.clear();
+		return;
+	}
+	// Order the weighting elements by descending maximum weight (MaxScore), so that the upper bound of a document weight shrinks fastest:
+	std::stable_sort( maxweights.begin(), maxweights.end());
+	std::vector<std::pair<double,std::size_t> >::const_iterator
+		mi = maxweights.begin(), me = maxweights.end();
+	for (; mi != me; ++mi)
+	{
+		m_pruningOrder.push_back( mi->second);
+	}
+	m_pruningRangeMaxWeight = m_pruningMaxWeight;
+	m_pruningRangeStart.assign( m_pruningMaxWeight.size(), 0);
+	m_pruningRangeEnd.assign( m_pruningMaxWeight.size(), 0);
+}
+
+void Accumulator::rankWeightingFormula()
+{
+	// Weighting formula defined then calculate one weight from the weighting element weights:
+	std::vector<WeightingElement>::iterator
+		ai = m_weightingElements.begin(), ae = m_weightingElements.end();
+	const std::vector<WeightedField>* weightedFields = 0;
+	int weightedFieldsIndex = -1;
+	double weights[ Constants::MaxNofWeightingElements];
+	// Calculate a weight for every element and call the weighting formula with the result:
+	for (std::size_t aidx=0; ai != ae; ++ai,++aidx)
+	{
+		const std::vector<WeightedField>& wf = (*ai)->call( m_docno);
+		if (wf.size() == 1 && !wf[0].field().defined())
+		{
+			weights[ aidx] = wf[0].weight();
+		}
+		else if (wf.size() == 0)
+		{
+			weights[ aidx] = 0.0;
+		}
+		else if (weightedFields != 0)
+		{
+			throw std::runtime_error(_TXT("using a weighting formula to calculate a total score having more than one weighting functions defining a field with a score"));
+		}
+		else
+		{
+			weights[ aidx] = 0.0;
+			weightedFields = &wf;
+			weightedFieldsIndex = aidx;
+		}
+	}
+	if (weightedFields)
+	{
+		std::vector<WeightedField>::const_iterator
+			wi = weightedFields->begin(), we =  weightedFields->end();
+		for (; wi != we; ++wi)
+		{
+			weights[ weightedFieldsIndex] = wi->weight();
+			double fres = m_weightingFormula->call( weights, m_weightingElements.size());
+			m_ranker.insert( WeightedDocument( m_docno, wi->field(), fres));
+		}
+	}
+	else
+	{
+		double fres = m_weightingFormula->call( weights, m_weightingElements.size());
+		m_ranker.insert( WeightedDocument( m_docno, strus::IndexRange(), fres));
+	}
+}
+
+/// \brief Safety margin for the comparison of a weight upper bound with the current ranklist threshold, covering floating point rounding differences of the summation order
+static inline bool isBelowThreshold( double maxweight, double threshold)
+{
+	return maxweight + (maxweight < 0.0 ? -maxweight : maxweight) * 1E-9 + 1E-12 < threshold;
+}
+
+void Accumulator::rankWeightingSum()
+{
+	// No formula then summate weights:
+	double weights[ Constants::MaxNofWeightingElements];
+	const std::vector<WeightedField>* weightedFields = 0;
+	std::size_t ai = 0, ae = m_weightingElements.size();
+
+	if (!m_pruningOrder.empty() && m_ranker.complete())
+	{
+		// Dynamic pruning (MaxScore): Evaluate the weighting elements in descending order
+		// of their maximum weight and stop as soon as the weight of the document
+		// cannot reach the lowest rank in the result anymore:
+		double threshold = m_ranker.minRank().weight();
+
+		// Get the maximum weights of the elements for the range of documents the current belongs to (block-max):
+		double maxweightsum[ Constants::MaxNofWeightingElements+1];
+		for (; ai != ae; ++ai)
+		{
+			std::size_t aidx = m_pruningOrder[ ai];
+			if (m_docno < m_pruningRangeStart[ aidx] || m_docno > m_pruningRangeEnd[ aidx])
+			{
+				double maxweight = m_weightingElements[ aidx]->maxWeightRange( m_docno, m_pruningRangeEnd[ aidx]);
+				m_pruningRangeMaxWeight[ aidx] = (maxweight < m_pruningMaxWeight[ aidx]) ? maxweight : m_pruningMaxWeight[ aidx];
+				m_pruningRangeStart[ aidx] = m_docno;
+			}
+		}
+		// Calculate the sums of the maximum weights of the remaining elements for every step:
+		maxweightsum[ ae] = 0.0;
+		for (; ai > 0; --ai)
+		{
+			maxweightsum[ ai-1] = maxweightsum[ ai] + m_pruningRangeMaxWeight[ m_pruningOrder[ ai-1]];
+		}
+		double partialsum = 0.0;
+		for (; ai != ae; ++ai)
+		{
+			if (isBelowThreshold( partialsum + maxweightsum[ ai], threshold))
+			{
+				++m_nofDocumentsPruned;
+				return;
+			}
+			std::size_t aidx = m_pruningOrder[ ai];
+			const std::vector<WeightedField>& wf = m_weightingElements[ aidx]->call( m_docno);
+			weights[ aidx] = 0.0;
+			if (wf.size() >= 1 && wf[0].field().defined())
+			{
+				if (weightedFields)
+				{
+					throw std::runtime_error(_TXT("having more than one weighting functions defining a field with a score"));
+				}
+				weightedFields = &wf;
+				double maxfieldweight = wf[0].weight();
+				std::vector<WeightedField>::const_iterator wi = wf.begin(), we = wf.end();
+				for (++wi; wi != we; ++wi)
+				{
+					if (wi->weight() > maxfieldweight) maxfieldweight = wi->weight();
+				}
+				partialsum += maxfieldweight;
+			}
+			else if (wf.size() == 1)
+			{
+				weights[ aidx] = wf[0].weight();
+				partialsum += weights[ aidx];
+			}
+		}
+	}
+	else
+	{
+		for (; ai != ae; ++ai)
+		{
+			const std::vector<WeightedField>& wf = m_weightingElements[ ai]->call( m_docno);
+			weights[ ai] = 0.0;
+			if (wf.size() >= 1 && wf[0].field().defined())
+			{
+				if (weightedFields)
+				{
+					throw std::runtime_error(_TXT("having more than one weighting functions defining a field with a score"));
+				}
+				weightedFields = &wf;
+			}
+			else if (wf.size() == 1)
+			{
+				weights[ ai] = wf[0].weight();
+			}
+		}
+	}
+	// Summate in the order of declaration to get exactly the same result with and without pruning:
+	double weightsum = 0.0;
+	for (ai = 0; ai != ae; ++ai)
+	{
+		weightsum += weights[ ai];
+	}
+	if (weightedFields)
+	{
+		std::vector<WeightedField>::const_iterator
+			wi = weightedFields->begin(), we =  weightedFields->end();
+		for (; wi != we; ++wi)
+		{
+			m_ranker.insert( WeightedDocument( m_docno, wi->field(), weightsum + wi->weight()));
+		}
+	}
+	else if (weightsum > std::numeric_limits<double>::epsilon())
+	{
+		m_ranker.insert( WeightedDocument( m_docno, strus::IndexRange()/*field*/, weightsum));
+	}
+}
+
+bool Accumulator::isBatchRanking() const
+{
+	// ... with dynamic pruning the weighting elements are evaluated document by document as soon as the ranklist is complete
+	return !m_batchDisabled && (m_pruningOrder.empty() || !m_ranker.complete());
+}
+
+void Accumulator::initBatchRanking()
+{
+	// ... decided before any weighting element is called, a batch weighted by some of the elements cannot be weighted again document by document without seeking backwards
+	std::vector<WeightingElement>::const_iterator ai = m_weightingElements.begin(), ae = m_weightingElements.end();
+	for (; ai != ae && (*ai)->batchCapable(); ++ai){}
+	m_batchDisabled = (ai != ae);
+}
+
+void Accumulator::rankBatch()
+{
+	std::size_t nofdocs = m_batch.size();
+	std::size_t ai = 0, ae = m_weightingElements.size();
+	m_batchWeights.resize( ae * nofdocs);
+	for (; ai != ae; ++ai)
+	{
+		if (!m_weightingElements[ ai]->callBatch( m_batch.data(), nofdocs, m_batchWeights.data() + ai * nofdocs))
+		{
+			throw std::runtime_error(_TXT("weighting function failed to weight a batch of documents"));
+		}
+	}
+	Index docno = m_docno;
+	std::size_t di = 0;
+	if (m_weightingFormula)
+	{
+		// Evaluate the weighting formula for all documents of the batch with one call:
+		m_batchFormulaArgs.resize( nofdocs * ae);
+		m_batchFormulaResults.resize( nofdocs);
+		for (; di != nofdocs; ++di)
+		{
+			for (ai = 0; ai != ae; ++ai)
+			{
+				m_batchFormulaArgs[ di * ae + ai] = m_batchWeights[ ai * nofdocs + di];
+			}
+		}
+		m_weightingFormula->callBatch( m_batchFormulaArgs.data(), ae, nofdocs, m_batchFormulaResults.data());
+		for (di = 0; di != nofdocs; ++di)
+		{
+			m_ranker.insert( WeightedDocument( m_batch[ di], strus::IndexRange(), m_batchFormulaResults[ di]));
+		}
+	}
+	else
+	{
+		for (; di != nofdocs; ++di)
+		{
+			// Summate in the order of declaration to get exactly the same result as rankWeightingSum:
+			double weightsum = 0.0;
+			for (ai = 0; ai != ae; ++ai)
+			{
+				weightsum += m_batchWeights[ ai * nofdocs + di];
+			}
+			if (weightsum > std::numeric_limits<double>::epsilon())
+			{
+				m_ranker.insert( WeightedDocument( m_batch[ di], strus::IndexRange()/*field*/, weightsum));
+			}
+		}
+	}
+	m_docno = docno;
+	m_batch.clear();
+}
+
 bool Accumulator::nextRank(
 		Index& docno,
 		unsigned int& selectorState)
@@ -66,13 +337,26 @@ bool Accumulator::nextRank(
 	{
 		throw std::runtime_error( _TXT( "query has no valid selection set defined"));
 	}
+	if (!m_pruningInitialized)
+	{
+		initPruning();
+		initBatchRanking();
+	}
 	while (si != se)
 	{
+		if (!m_batch.empty() && (int)m_selectoridx != m_rankedSelectoridx)
+		{
+			// ... the documents of a batch all belong to the same selector, weight them before switching to the next one
+			docno = m_batch.back();
+			selectorState = m_selectorPostings[ m_rankedSelectoridx].setindex;
+			rankBatch();
+			return true;
+		}
 		// Select candidate document:
 		if (m_evaluationSetIterator)
 		{
 			// ... we evaluate the query on a document subset defined by a posting iterator
-			Index dn = m_docno+1;
+			Index dn = (m_docno < m_docnoRangeStart) ? m_docnoRangeStart : (m_docno+1);
 			do
 			{
 				m_docno = m_evaluationSetIterator->skipDoc( dn);
@@ -83,22 +367,24 @@ bool Accumulator::nextRank(
 		else
 		{
 			// ... we evaluate the query on all documents
-			m_docno = si->postings->skipDoc( m_docno+1);
+			m_docno = si->postings->skipDoc( (m_docno < m_docnoRangeStart) ? m_docnoRangeStart : (m_docno+1));
 		}
-		if (!m_docno)
+		if (!m_docno || m_docno > m_docnoRangeEnd)
 		{
+			// ... end of selection postings or end of the document range evaluated.
+			//	Documents with docno bigger than m_maxDocumentNumber 
+			//	were just inserted and are not respected in this query.
+			m_docno = 0;
 			++si;
 			++m_selectoridx;
 			continue;
 		}
 		// Test if it already has been visited:
-		if (m_docno > m_maxDocumentNumber || m_visited.test( m_docno-1))
+		if (m_visited.test( m_docno - m_docnoRangeStart))
 		{
-			// ... documents with docno bigger than m_maxDocumentNumber 
-			//	were just inserted and are not respected in this query.
 			continue;
 		}
-		m_visited.set( m_docno-1);
+		m_visited.set( m_docno - m_docnoRangeStart);
 
 		// Check if any ACL restriction (alternatives combined with OR):
 		if (m_aclRestrictions.size())
@@ -142,113 +428,96 @@ bool Accumulator::nextRank(
 		// Check meta data restrictions:
 		if (m_metaDataRestriction.get() && !m_metaDataRestriction->match(m_docno))
 		{
-			continue;
+			// ... skip all documents up to the next one matching the restriction in the document range evaluated
+			Index nextMetaDataMatch = m_metaDataRestriction->skipDoc( m_docno, m_docnoRangeEnd);
+			if (nextMetaDataMatch)
+			{
+				m_docno = nextMetaDataMatch -1;
+				continue;
+			}
+			else
+			{
+				m_docno = 0;
+				++m_selectoridx;
+				++si;
+				continue;
+			}
 		}
 
 		// Check feature restrictions:
 		std::vector<SelectorPostings>::const_iterator
 			ri = m_featureRestrictions.begin(),
 			re = m_featureRestrictions.end();
+		Index nextRestrictionMatch = 0;
 		for (; ri != re; ++ri)
 		{
-			if (ri->isNegative ^ (m_docno != ri->postings->skipDoc( m_docno)))
+			nextRestrictionMatch = ri->postings->skipDoc( m_docno);
+			if (ri->isNegative ^ (m_docno != nextRestrictionMatch))
 			{
 				break;
 			}
 		}
-		if (ri != re) continue;
-
-		// Init result:
-		docno = m_docno;
-		selectorState = m_selectorPostings[ m_selectoridx].setindex;
-		++m_nofDocumentsRanked;
-
-		if (m_weightingFormula)
+		if (ri != re)
 		{
-			// Weighting formula defined then calculate one weight from the weighting element weights:
-			std::vector<WeightingElement>::iterator
-				ai = m_weightingElements.begin(), ae = m_weightingElements.end();
-			const std::vector<WeightedField>* weightedFields = 0;
-			int weightedFieldsIndex = -1;
-			double weights[ Constants::MaxNofWeightingElements];
-			// Calculate a weight for every element and call the weighting formula with the result:
-			for (std::size_t aidx=0; ai != ae; ++ai,++aidx)
-			{
-				const std::vector<WeightedField>& wf = (*ai)->call( m_docno);
-				if (wf.size() == 1 && !wf[0].field().defined())
-				{
-					weights[ aidx] = wf[0].weight();
-				}
-				else if (wf.size() == 0)
-				{
-					weights[ aidx] = 0.0;
-				}
-				else if (weightedFields != 0)
-				{
-					throw std::runtime_error(_TXT("using a weighting formula to calculate a total score having more than one weighting functions defining a field with a score"));
-				}
-				else
-				{
-					weights[ aidx] = 0.0;
-					weightedFields = &wf;
-					weightedFieldsIndex = aidx;
-				}
+			if (ri->isNegative)
+			{
+				continue;
 			}
-			if (weightedFields)
+			// ... skip all documents up to the next one matching the positive restriction that failed
+			else if (nextRestrictionMatch)
 			{
-				std::vector<WeightedField>::const_iterator
-					wi = weightedFields->begin(), we =  weightedFields->end();
-				for (; wi != we; ++wi)
-				{
-					weights[ weightedFieldsIndex] = wi->weight();
-					double fres = m_weightingFormula->call( weights, m_weightingElements.size());
-					m_ranker.insert( WeightedDocument( m_docno, wi->field(), fres));
-				}
+				m_docno = nextRestrictionMatch -1;
+				continue;
 			}
 			else
 			{
-				double fres = m_weightingFormula->call( weights, m_weightingElements.size());
-				m_ranker.insert( WeightedDocument( m_docno, strus::IndexRange(), fres));
+				m_docno = 0;
+				++m_selectoridx;
+				++si;
+				continue;
 			}
 		}
+
+		++m_nofDocumentsRanked;
+		if ((int)m_selectoridx == m_rankedSelectoridx && isBatchRanking())
+		{
+			// ... collect the document for weighting it together with its successors.
+			//	The first document of a selector is always ranked alone, so that the caller
+			//	can stop the evaluation on a selector state change as before.
+			m_batch.push_back( m_docno);
+			if (m_batch.size() < (std::size_t)BatchSize) continue;
+
+			docno = m_docno;
+			selectorState = m_selectorPostings[ m_selectoridx].setindex;
+			rankBatch();
+			return true;
+		}
+		if (!m_batch.empty())
+		{
+			rankBatch();
+		}
+		// Init result:
+		docno = m_docno;
+		selectorState = m_selectorPostings[ m_selectoridx].setindex;
+		m_rankedSelectoridx = m_selectoridx;
+
+		if (m_weightingFormula)
+		{
+			rankWeightingFormula();
+		}
 		else
 		{
-			// No formula then summate weights:
-			const std::vector<WeightedField>* weightedFields = 0;
-			double weightsum = 0.0;
-			int ai = 0, ae = m_weightingElements.size();
-			for (; ai != ae; ++ai)
-			{
-				const std::vector<WeightedField>& wf = m_weightingElements[ ai]->call( m_docno);
-				if (wf.size() >= 1 && wf[0].field().defined())
-				{
-					if (weightedFields)
-					{
-						throw std::runtime_error(_TXT("having more than one weighting functions defining a field with a score"));
-					}
-					weightedFields = &wf;
-				}
-				else if (wf.size() == 1)
-				{
-					weightsum += wf[0].weight();
-				}
-			}
-			if (weightedFields)
-			{
-				std::vector<WeightedField>::const_iterator
-					wi = weightedFields->begin(), we =  weightedFields->end();
-				for (; wi != we; ++wi)
-				{
-					m_ranker.insert( WeightedDocument( m_docno, wi->field(), weightsum + wi->weight()));
-				}
-			}
-			else if (weightsum > std::numeric_limits<double>::epsilon())
-			{
-				m_ranker.insert( WeightedDocument( m_docno, strus::IndexRange()/*field*/, weightsum));
-			}
+			rankWeightingSum();
 		}
 		return true;
 	}
+	if (!m_batch.empty())
+	{
+		docno = m_batch.back();
+		selectorState = m_selectorPostings[ m_rankedSelectoridx].setindex;
+		rankBatch();
+		return true;
+	}
 	return false;
 }
 
@@ -53,7 +53,9 @@ public:
 			const MetaDataRestrictionInterface* metaDataRestriction_,
 			const ScalarFunctionInstanceInterface* weightingFormula_,
 			std::size_t maxNofRanks_,
-			std::size_t maxDocumentNumber_)
+			std::size_t maxDocumentNumber_,
+			const Index& docnoRangeStart_=1,
+			const Index& docnoRangeEnd_=0)
 		:m_storage(storage_)
 		,m_metadata(metadata_)
 		,m_metaDataRestriction(metaDataRestriction_?metaDataRestriction_->createInstance():0)
@@ -61,13 +63,28 @@ public:
 		,m_weightingElements(),m_selectorPostings(),m_featureRestrictions(),m_aclRestrictions()
 		,m_selectoridx(0)
 		,m_docno(0)
-		,m_visited(maxDocumentNumber_)
+		,m_visited(docnoRangeSize( maxDocumentNumber_, docnoRangeStart_, docnoRangeEnd_))
 		,m_maxNofRanks(maxNofRanks_)
 		,m_maxDocumentNumber(maxDocumentNumber_)
+		,m_docnoRangeStart(docnoRangeStart_)
+		,m_docnoRangeEnd(docnoRangeEnd_ && docnoRangeEnd_ < (Index)maxDocumentNumber_ ? docnoRangeEnd_ : (Index)maxDocumentNumber_)
 		,m_nofDocumentsRanked(0)
 		,m_nofDocumentsVisited(0)
+		,m_nofDocumentsPruned(0)
 		,m_ranker(maxNofRanks_)
 		,m_evaluationSetIterator(0)
+		,m_pruningInitialized(false)
+		,m_pruningOrder()
+		,m_pruningMaxWeight()
+		,m_pruningRangeMaxWeight()
+		,m_pruningRangeStart()
+		,m_pruningRangeEnd()
+		,m_batch()
+		,m_batchWeights()
+		,m_batchFormulaArgs()
+		,m_batchFormulaResults()
+		,m_rankedSelectoridx(-1)
+		,m_batchDisabled(false)
 	{}
 
 	~Accumulator(){}
@@ -91,14 +108,28 @@ public:
 
 	unsigned int nofDocumentsRanked() const		{return m_nofDocumentsRanked;}
 	unsigned int nofDocumentsVisited() const	{return m_nofDocumentsVisited;}
+	/// \brief Get the number of documents passing all restrictions but skipped by dynamic pruning (they are counted as ranked too)
+	unsigned int nofDocumentsPruned() const		{return m_nofDocumentsPruned;}
 
 	void defineWeightingVariableValue( std::size_t index, const std::string& varname, double value);
 
 private:
+	static std::size_t docnoRangeSize( std::size_t maxDocumentNumber_, const Index& start_, const Index& end_)
+	{
+		Index last = (end_ && end_ < (Index)maxDocumentNumber_) ? end_ : (Index)maxDocumentNumber_;
+		return (last >= start_) ? (std::size_t)(last - start_ + 1) : 0;
+	}
 	bool isRelevantSelectionFeature( PostingIteratorInterface& itr) const;
+	void initPruning();
+	void rankWeightingFormula();
+	void rankWeightingSum();
+	void initBatchRanking();
+	bool isBatchRanking() const;
+	void rankBatch();
 
 private:
 	typedef Reference< WeightingFunctionContextInterface> WeightingElement;
+	enum {BatchSize=64};				///< maximum number of documents weighted together in one batch
 
 	struct SelectorPostings
 	{
@@ -127,10 +158,25 @@ private:
 	strus::dynamic_bitset m_visited;
 	std::size_t m_maxNofRanks;
 	Index m_maxDocumentNumber;
+	Index m_docnoRangeStart;			///< first document number evaluated (partition of a parallel query evaluation)
+	Index m_docnoRangeEnd;				///< last document number evaluated (partition of a parallel query evaluation)
 	unsigned int m_nofDocumentsRanked;
 	unsigned int m_nofDocumentsVisited;
+	unsigned int m_nofDocumentsPruned;
 	Ranker<WeightedDocument> m_ranker;
 	PostingIteratorInterface* m_evaluationSetIterator;
+	bool m_pruningInitialized;			///< true, if the dynamic pruning structures have been initialized and the use of batch ranking decided
+	std::vector<std::size_t> m_pruningOrder;	///< weighting elements ordered by descending maximum weight (MaxScore), empty if pruning is disabled
+	std::vector<double> m_pruningMaxWeight;		///< maximum weight of a weighting element for any document
+	std::vector<double> m_pruningRangeMaxWeight;	///< maximum weight of a weighting element for the documents in the range [m_pruningRangeStart,m_pruningRangeEnd] (block-max)
+	std::vector<Index> m_pruningRangeStart;		///< start of the document range m_pruningRangeMaxWeight is valid for
+	std::vector<Index> m_pruningRangeEnd;		///< end of the document range m_pruningRangeMaxWeight is valid for
+	std::vector<Index> m_batch;			///< documents selected, but not weighted yet (batch ranking)
+	std::vector<double> m_batchWeights;		///< weights of the documents of a batch, all documents of one weighting element contiguous
+	std::vector<double> m_batchFormulaArgs;		///< weights of the documents of a batch as argument tuples of the weighting formula
+	std::vector<double> m_batchFormulaResults;	///< results of the weighting formula for the documents of a batch
+	int m_rankedSelectoridx;			///< index of the selector of the last document ranked, -1 if none
+	bool m_batchDisabled;				///< true, if batch ranking is not possible because a weighting element cannot weight any batch of documents
 };
 
 }//namespace
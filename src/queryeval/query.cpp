@@ -23,6 +23,8 @@
 #include "strus/base/snprintf.h"
 #include "strus/base/local_ptr.hpp"
 #include "strus/base/string_conv.hpp"
+#include "strus/base/string_format.hpp"
+#include "strus/base/thread.hpp"
 #include "strus/errorBufferInterface.hpp"
 #include "strus/debugTraceInterface.hpp"
 #include "private/internationalization.hpp"
@@ -32,8 +34,10 @@
 #include <utility>
 #include <algorithm>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <limits>
 
 #define STRUS_DBGTRACE_COMPONENT_NAME "query"
 
@@ -348,6 +352,176 @@ void Query::addAccess( const std::string& username_)
 	CATCH_ERROR_MAP( _TXT("error adding user to query: %s"), *m_errorhnd);
 }
 
+/// \brief Document frequency of a node in the query plan that can not be estimated
+#define UNKNOWN_DF (std::numeric_limits<Index>::max())
+
+/// \brief Classes of posting join operators distinguished by the query planning
+enum JoinOperatorClass
+{
+	JoinUnknown,		///< no estimate possible
+	JoinAllMatch,		///< documents matching 'cardinality' (all if 0) of the arguments
+	JoinStructAllMatch,	///< first argument is a structure delimiter, documents matching all of the other arguments
+	JoinDifference,		///< documents matching the first argument
+	JoinUnion		///< documents matching any of the arguments
+};
+
+static JoinOperatorClass joinOperatorClass( const PostingJoinOperatorInterface* operation)
+{
+	static const char* allMatchOps[] = {"intersect","contains","within","inrange","sequence","chain","sequence_imm","succ","pred",0};
+	static const char* structAllMatchOps[] = {"within_struct","inrange_struct","sequence_struct","chain_struct",0};
+	const char* name = operation->name();
+	int oi = 0;
+	for (oi=0; allMatchOps[oi]; ++oi) if (0==std::strcmp( allMatchOps[oi], name)) return JoinAllMatch;
+	for (oi=0; structAllMatchOps[oi]; ++oi) if (0==std::strcmp( structAllMatchOps[oi], name)) return JoinStructAllMatch;
+	if (0==std::strcmp( "diff", name)) return JoinDifference;
+	if (0==std::strcmp( "union", name)) return JoinUnion;
+	return JoinUnknown;
+}
+
+static Index addDocumentFrequency( Index df1, Index df2)
+{
+	return (df1 >= UNKNOWN_DF - df2) ? UNKNOWN_DF : (df1 + df2);
+}
+
+static std::string documentFrequencyString( Index df)
+{
+	return df == UNKNOWN_DF ? std::string("unknown") : strus::string_format( "%d", (int)df);
+}
+
+Index Query::estimateDocumentFrequency( const NodeAddress& nodeadr, NodeDfMap& nodeDfMap, DebugTraceContextInterface* debugtrace) const
+{
+	NodeDfMap::const_iterator di = nodeDfMap.find( nodeadr);
+	if (di != nodeDfMap.end()) return di->second;
+
+	Index rt = UNKNOWN_DF;
+	switch (nodeType( nodeadr))
+	{
+		case NullNode:
+			break;
+		case TermNode:
+		{
+			const Term& term = m_terms[ nodeIndex( nodeadr)];
+			rt = m_storage->documentFrequency( term.type, term.value);
+			if (debugtrace) debugtrace->event( "plan-term", "type='%s' value='%s' df=%d", term.type.c_str(), term.value.c_str(), (int)rt);
+			break;
+		}
+		case ExpressionNode:
+		{
+			const Expression& expr = m_expressions[ nodeIndex( nodeadr)];
+			std::vector<Index> argdf;
+			std::vector<NodeAddress>::const_iterator
+				ni = expr.subnodes.begin(), ne = expr.subnodes.end();
+			for (; ni != ne; ++ni)
+			{
+				if (nodeType( *ni) != NullNode)
+				{
+					argdf.push_back( estimateDocumentFrequency( *ni, nodeDfMap, debugtrace));
+				}
+			}
+			if (argdf.empty()) break;
+
+			switch (joinOperatorClass( expr.operation))
+			{
+				case JoinUnknown:
+					break;
+				case JoinAllMatch:
+				{
+					// ... a document matching 'cardinality' of N arguments is in at least one of any N-cardinality+1 argument sets:
+					std::size_t cardinality = (expr.cardinality == 0 || expr.cardinality > argdf.size()) ? argdf.size() : expr.cardinality;
+					std::sort( argdf.begin(), argdf.end());
+					std::vector<Index>::const_iterator ai = argdf.begin(), ae = argdf.begin() + (argdf.size() - cardinality + 1);
+					for (rt = 0; ai != ae; ++ai) rt = addDocumentFrequency( rt, *ai);
+					break;
+				}
+				case JoinStructAllMatch:
+					if (argdf.size() > 1) rt = *std::min_element( argdf.begin()+1, argdf.end());
+					break;
+				case JoinDifference:
+					rt = argdf[0];
+					break;
+				case JoinUnion:
+				{
+					std::vector<Index>::const_iterator ai = argdf.begin(), ae = argdf.end();
+					for (rt = 0; ai != ae; ++ai) rt = addDocumentFrequency( rt, *ai);
+					break;
+				}
+			}
+			if (debugtrace)
+			{
+				std::string dfstr = documentFrequencyString( rt);
+				debugtrace->event( "plan-expression", "op=%s argc=%d df=%s", expr.operation->name(), (int)expr.subnodes.size(), dfstr.c_str());
+			}
+			break;
+		}
+	}
+	nodeDfMap[ nodeadr] = rt;
+	return rt;
+}
+
+Index Query::nodeDocumentFrequency( const NodeAddress& nodeadr, const NodeDfMap& nodeDfMap) const
+{
+	NodeDfMap::const_iterator di = nodeDfMap.find( nodeadr);
+	return di == nodeDfMap.end() ? UNKNOWN_DF : di->second;
+}
+
+void Query::planQuery( NodeDfMap& nodeDfMap, DebugTraceContextInterface* debugtrace) const
+{
+	if (debugtrace) debugtrace->open( "plan");
+	std::vector<Feature>::const_iterator
+		fi = m_features.begin(), fe = m_features.end();
+	for (; fi != fe; ++fi)
+	{
+		Index df = estimateDocumentFrequency( fi->node, nodeDfMap, debugtrace);
+		if (debugtrace)
+		{
+			std::string dfstr = documentFrequencyString( df);
+			debugtrace->event( "plan-feature", "set=%s df=%s", fi->set.c_str(), dfstr.c_str());
+		}
+	}
+	if (debugtrace) debugtrace->close();
+}
+
+bool Query::planEmptyResult( const NodeDfMap& nodeDfMap, DebugTraceContextInterface* debugtrace) const
+{
+	// [1] A positive feature restriction that matches no document:
+	std::vector<std::string>::const_iterator
+		xi = m_queryEval->restrictionSets().begin(),
+		xe = m_queryEval->restrictionSets().end();
+	for (; xi != xe; ++xi)
+	{
+		std::vector<Feature>::const_iterator
+			fi = m_features.begin(), fe = m_features.end();
+		for (; fi != fe; ++fi)
+		{
+			if (*xi == fi->set && nodeDocumentFrequency( fi->node, nodeDfMap) == 0)
+			{
+				if (debugtrace) debugtrace->event( "plan-empty", "restriction set=%s matches no document", xi->c_str());
+				return true;
+			}
+		}
+	}
+	// [2] Selection features that all match no document:
+	int nofSelectors = 0;
+	std::vector<std::string>::const_iterator
+		si = m_queryEval->selectionSets().begin(),
+		se = m_queryEval->selectionSets().end();
+	for (; si != se; ++si)
+	{
+		std::vector<Feature>::const_iterator
+			fi = m_features.begin(), fe = m_features.end();
+		for (; fi != fe; ++fi)
+		{
+			if (*si == fi->set)
+			{
+				if (nodeDocumentFrequency( fi->node, nodeDfMap) != 0) return false;
+				++nofSelectors;
+			}
+		}
+	}
+	if (nofSelectors && debugtrace) debugtrace->event( "plan-empty", "%s", "no selection feature matches any document");
+	return nofSelectors > 0;
+}
+
 PostingIteratorInterface* Query::createExpressionPostingIterator( const Expression& expr, NodeStorageDataMap& nodeStorageDataMap, bool usePosinfo) const
 {
 	if (expr.subnodes.size() > MaxNofJoinopArguments)
@@ -515,283 +689,897 @@ void Query::setWeightingVariableValue(
 					m_errorhnd->report( ErrorCodeOperationOrder, _TXT("try to defined weighting variable without weighting formula defined"));
 				}
 				m_weightingFormula->setVariableValue( name, value);
+				m_formulavars.push_back( std::pair<std::string,double>( name, value));
 				break;
 		}
 	}
 }
 
-QueryResult Query::evaluate( int minRank, int maxNofRanks) const
+bool Query::createFeaturePostings(
+		std::vector<Reference<PostingIteratorInterface> >& postings,
+		NodeStorageDataMap& nodeStorageDataMap) const
 {
-	const char* evaluationPhase = "query feature postings initialization";
-	try
+	std::vector<Feature>::const_iterator
+		fi = m_features.begin(), fe = m_features.end();
+	for (; fi != fe; ++fi)
 	{
-		if (m_debugtrace)
-		{
-			m_debugtrace->open( "eval");
-			std::string str = view().tostring();
-			m_debugtrace->event( "query", "%s", str.c_str());
-		}
-		// [1] Check initial conditions:
-		if (maxNofRanks == 0)
+		bool usePosinfo = m_queryEval->usePositionInformation( fi->set);
+		Reference<PostingIteratorInterface> postingsElem(
+			createNodePostingIterator( fi->node, nodeStorageDataMap, usePosinfo));
+		if (!postingsElem.get())
 		{
-			if (m_debugtrace) m_debugtrace->close();
-			return QueryResult();
+			return false;
 		}
-		if (m_queryEval->weightingFunctions().empty())
+		postings.push_back( postingsElem);
+	}
+	return true;
+}
+
+Reference<InvAclIteratorInterface> Query::createAclRestriction( DebugTraceContextInterface* debugtrace) const
+{
+	Reference<InvAclIteratorInterface> rt;
+	if (!m_usernames.empty())
+	{
+		if (debugtrace)
 		{
-			m_errorhnd->report( ErrorCodeIncompleteDefinition, _TXT( "cannot evaluate query, no weighting function defined"));
-			if (m_debugtrace) m_debugtrace->close();
-			return QueryResult();
+			std::vector<std::string>::const_iterator ui = m_usernames.begin(), ue = m_usernames.end();
+			for (; ui != ue; ++ui)
+			{
+				debugtrace->event( "user-restriction", "name=%s", ui->c_str());
+			}
 		}
-		if (m_queryEval->selectionSets().empty())
+		rt.reset( m_storage->createInvAclIterator( m_usernames));
+		if (!rt.get() && m_errorhnd->hasError())
 		{
-			m_errorhnd->report( ErrorCodeIncompleteDefinition, _TXT( "cannot evaluate query, no selection features defined"));
-			if (m_debugtrace) m_debugtrace->close();
-			return QueryResult();
+			throw std::runtime_error( _TXT( "storage built without ACL resrictions, cannot handle username passed with query"));
 		}
-		NodeStorageDataMap nodeStorageDataMap;
+	}
+	return rt;
+}
 
-		// [3] Create the posting sets of the query features:
-		std::vector<Reference<PostingIteratorInterface> > postings;
+void Query::initAccumulator(
+		Accumulator& accumulator,
+		DocsetPostingIterator& evalset_itr,
+		const NodeStorageDataMap& nodeStorageDataMap,
+		const NodeDfMap& nodeDfMap,
+		const Reference<InvAclIteratorInterface>& aclRestriction,
+		const char*& evaluationPhase,
+		DebugTraceContextInterface* debugtrace) const
+{
+	// [4.1] Define document subset to evaluate query on:
+	if (m_evalset_defined)
+	{
+		evalset_itr = DocsetPostingIterator( m_evalset_docnolist);
+		accumulator.defineEvaluationSet( &evalset_itr);
+	}
+	// [4.2] Add document selection postings:
+	{
+		std::vector<std::string>::const_iterator
+			si = m_queryEval->selectionSets().begin(),
+			se = m_queryEval->selectionSets().end();
+
+		for (int sidx=0; si != se; ++si,++sidx)
 		{
 			std::vector<Feature>::const_iterator
 				fi = m_features.begin(), fe = m_features.end();
 			for (; fi != fe; ++fi)
 			{
-				bool usePosinfo = m_queryEval->usePositionInformation( fi->set);
-				Reference<PostingIteratorInterface> postingsElem(
-					createNodePostingIterator( fi->node, nodeStorageDataMap, usePosinfo));
-				if (!postingsElem.get())
+				if (*si == fi->set)
 				{
-					if (m_debugtrace) m_debugtrace->close();
-					return QueryResult();
+					if (nodeDocumentFrequency( fi->node, nodeDfMap) == 0)
+					{
+						// ... selection features matching no document are not visited
+						if (debugtrace) debugtrace->event( "plan-skip", "selector set=%s", si->c_str());
+						continue;
+					}
+					accumulator.addSelector(
+						nodeStorageData( fi->node, nodeStorageDataMap),
+						sidx);
 				}
-				postings.push_back( postingsElem);
 			}
 		}
-		// [4] Create the accumulator:
-		DocsetPostingIterator evalset_itr;
-		Accumulator accumulator(
-			m_storage,
-			m_metaDataReader.get(), m_metaDataRestriction.get(), m_weightingFormula.get(),
-			minRank + maxNofRanks, m_storage->maxDocumentNumber());
-
-		// [4.1] Define document subset to evaluate query on:
-		if (m_evalset_defined)
-		{
-			evalset_itr = DocsetPostingIterator( m_evalset_docnolist);
-			accumulator.defineEvaluationSet( &evalset_itr);
-		}
-		// [4.2] Add document selection postings:
+	}
+	evaluationPhase = "weighting functions initialization";
+	// [4.3.1] Add features for weighting:
+	{
+		std::vector<WeightingDef>::const_iterator
+			wi = m_queryEval->weightingFunctions().begin(),
+			we = m_queryEval->weightingFunctions().end();
+		for (; wi != we; ++wi)
 		{
-			std::vector<std::string>::const_iterator
-				si = m_queryEval->selectionSets().begin(),
-				se = m_queryEval->selectionSets().end();
-	
-			for (int sidx=0; si != se; ++si,++sidx)
+			if (debugtrace)
+			{
+				debugtrace->open( "function");
+				debugtrace->event( "name", "%s", wi->function()->name());
+			}
+			strus::local_ptr<WeightingFunctionContextInterface> execContext(
+				wi->function()->createFunctionContext( m_storage, m_globstats));
+			if (!execContext.get()) throw std::runtime_error( _TXT("error creating weighting function context"));
+
+			std::vector<QueryEvalInterface::FeatureParameter>::const_iterator
+				si = wi->featureParameters().begin(),
+				se = wi->featureParameters().end();
+			for (; si != se; ++si)
 			{
 				std::vector<Feature>::const_iterator
 					fi = m_features.begin(), fe = m_features.end();
 				for (; fi != fe; ++fi)
 				{
-					if (*si == fi->set)
+					if (si->featureSet() == fi->set)
 					{
-						accumulator.addSelector(
-							nodeStorageData( fi->node, nodeStorageDataMap),
-							sidx);
+						PostingIteratorInterface* itr = nodeStorageData( fi->node, nodeStorageDataMap);
+						execContext->addWeightingFeature( si->featureRole(), itr, fi->weight);
+						if (debugtrace) debugtrace->event( "parameter", "%s= feature %s weight=%f", si->featureRole().c_str(), fi->set.c_str(), fi->weight);
 					}
 				}
 			}
+			accumulator.addWeightingElement( execContext.release());
+			if (debugtrace) debugtrace->close();
 		}
-		evaluationPhase = "weighting functions initialization";
-		// [4.3.1] Add features for weighting:
+	}
+	// [4.3.1] Define feature weighting variable values:
+	std::vector<WeightingVariableValueAssignment>::const_iterator
+		vi = m_weightingvars.begin(), ve = m_weightingvars.end();
+	for (; vi != ve; ++vi)
+	{
+		if (debugtrace) debugtrace->event( "variable", "index=%d name=%s value=%f", (int)vi->index, vi->varname.c_str(), vi->value);
+		accumulator.defineWeightingVariableValue( vi->index, vi->varname, vi->value);
+	}
+
+	evaluationPhase = "restrictions initialization";
+	// [4.4] Define the user ACL restriction, the union of the documents of all users built once per query:
+	if (aclRestriction.get())
+	{
+		accumulator.addAlternativeAclRestriction( aclRestriction);
+	}
+	// [4.5] Define the feature restrictions, the ones with the smallest estimated document frequency first, as they reject most candidates:
+	{
+		std::vector<std::pair<Index,std::size_t> > restrictionOrder;	// (estimated df, index in m_features)
+		std::vector<std::string>::const_iterator
+			xi = m_queryEval->restrictionSets().begin(),
+			xe = m_queryEval->restrictionSets().end();
+		for (; xi != xe; ++xi)
 		{
-			std::vector<WeightingDef>::const_iterator
-				wi = m_queryEval->weightingFunctions().begin(),
-				we = m_queryEval->weightingFunctions().end();
-			for (; wi != we; ++wi)
+			std::vector<Feature>::const_iterator
+				fi = m_features.begin(), fe = m_features.end();
+			for (std::size_t fidx=0; fi != fe; ++fi,++fidx)
 			{
-				if (m_debugtrace)
+				if (*xi == fi->set)
 				{
-					m_debugtrace->open( "function");
-					m_debugtrace->event( "name", "%s", wi->function()->name());
+					restrictionOrder.push_back( std::pair<Index,std::size_t>( nodeDocumentFrequency( fi->node, nodeDfMap), fidx));
 				}
-				strus::local_ptr<WeightingFunctionContextInterface> execContext(
-					wi->function()->createFunctionContext( m_storage, m_globstats));
-				if (!execContext.get()) throw std::runtime_error( _TXT("error creating weighting function context"));
-
-				std::vector<QueryEvalInterface::FeatureParameter>::const_iterator
-					si = wi->featureParameters().begin(),
-					se = wi->featureParameters().end();
-				for (; si != se; ++si)
+			}
+		}
+		std::stable_sort( restrictionOrder.begin(), restrictionOrder.end());
+		std::vector<std::pair<Index,std::size_t> >::const_iterator
+			oi = restrictionOrder.begin(), oe = restrictionOrder.end();
+		for (; oi != oe; ++oi)
+		{
+			const Feature& feature = m_features[ oi->second];
+			if (debugtrace)
+			{
+				std::string dfstr = documentFrequencyString( oi->first);
+				debugtrace->event( "feature-restriction", "name=%s df=%s", feature.set.c_str(), dfstr.c_str());
+			}
+			accumulator.addFeatureRestriction(
+				nodeStorageData( feature.node, nodeStorageDataMap), false);
+		}
+	}
+	// [4.6] Define the feature exclusions:
+	{
+		std::vector<std::string>::const_iterator
+			xi = m_queryEval->exclusionSets().begin(),
+			xe = m_queryEval->exclusionSets().end();
+		for (; xi != xe; ++xi)
+		{
+			std::vector<Feature>::const_iterator
+				fi = m_features.begin(), fe = m_features.end();
+			for (; fi != fe; ++fi)
+			{
+				if (*xi == fi->set)
 				{
-					std::vector<Feature>::const_iterator
-						fi = m_features.begin(), fe = m_features.end();
-					for (; fi != fe; ++fi)
+					if (nodeDocumentFrequency( fi->node, nodeDfMap) == 0)
 					{
-						if (si->featureSet() == fi->set)
-						{
-							PostingIteratorInterface* itr = nodeStorageData( fi->node, nodeStorageDataMap);
-							execContext->addWeightingFeature( si->featureRole(), itr, fi->weight);
-							if (m_debugtrace) m_debugtrace->event( "parameter", "%s= feature %s weight=%f", si->featureRole().c_str(), fi->set.c_str(), fi->weight);
-						}
+						// ... exclusion features matching no document exclude nothing
+						if (debugtrace) debugtrace->event( "plan-skip", "exclusion set=%s", xi->c_str());
+						continue;
 					}
+					if (debugtrace) debugtrace->event( "feature-exclusion", "name=%s", xi->c_str());
+					accumulator.addFeatureRestriction(
+						nodeStorageData( fi->node, nodeStorageDataMap), true);
 				}
-				accumulator.addWeightingElement( execContext.release());
-				if (m_debugtrace) m_debugtrace->close();
 			}
 		}
-		// [4.3.1] Define feature weighting variable values:
-		std::vector<WeightingVariableValueAssignment>::const_iterator
-			vi = m_weightingvars.begin(), ve = m_weightingvars.end();
-		for (; vi != ve; ++vi)
+	}
+}
+
+/// \brief Ranking of the documents of one partition of the document number space in a parallel query evaluation
+class Query::RankingPartition
+{
+public:
+	RankingPartition( const Query* query_, const NodeDfMap* nodeDfMap_, const Reference<InvAclIteratorInterface>& aclRestriction_, const Index& docnoStart_, const Index& docnoEnd_, const Index& maxDocumentNumber_, std::size_t maxNofRanks_)
+		:m_query(query_),m_nodeDfMap(nodeDfMap_),m_aclRestriction(aclRestriction_),m_docnoStart(docnoStart_),m_docnoEnd(docnoEnd_),m_maxDocumentNumber(maxDocumentNumber_)
+		,m_maxNofRanks(maxNofRanks_),m_result(),m_nofDocumentsRanked(0),m_nofDocumentsVisited(0),m_error(){}
+
+	/// \brief Ranking as thread procedure with its own error buffer context
+	void runThread()
+	{
+		m_query->m_errorhnd->allocContext();
+		run();
+		m_query->m_errorhnd->releaseContext();
+	}
+
+	/// \brief Ranking in the calling thread
+	void run()
+	{
+		const char* evaluationPhase = "query feature postings initialization";
+		try
+		{
+			NodeStorageDataMap nodeStorageDataMap;
+			std::vector<Reference<PostingIteratorInterface> > postings;
+			if (!m_query->createFeaturePostings( postings, nodeStorageDataMap))
+			{
+				throw std::runtime_error( _TXT("failed to create feature postings"));
+			}
+			Reference<MetaDataReaderInterface> metadata( m_query->m_storage->createMetaDataReader());
+			if (!metadata.get()) throw std::runtime_error( _TXT("failed to create meta data reader"));
+
+			DocsetPostingIterator evalset_itr;
+			Accumulator accumulator(
+				m_query->m_storage,
+				metadata.get(), m_query->m_metaDataRestriction.get(), m_query->m_weightingFormula.get(),
+				m_maxNofRanks, m_maxDocumentNumber, m_docnoStart, m_docnoEnd);
+			m_query->initAccumulator( accumulator, evalset_itr, nodeStorageDataMap, *m_nodeDfMap, m_aclRestriction, evaluationPhase, 0/*debugtrace*/);
+
+			evaluationPhase = "document ranking";
+			Index docno = 0;
+			unsigned int state = 0;
+			while (accumulator.nextRank( docno, state)){}
+
+			m_result = accumulator.ranker().result( 0);
+			m_nofDocumentsRanked = accumulator.nofDocumentsRanked();
+			m_nofDocumentsVisited = accumulator.nofDocumentsVisited();
+		}
+		catch (const std::bad_alloc&)
+		{
+			m_error = _TXT("out of memory");
+		}
+		catch (const std::runtime_error& err)
+		{
+			m_error = strus::string_format( _TXT("error during %s: %s"), evaluationPhase, err.what());
+		}
+		catch (const std::exception& err)
+		{
+			//... no exception must escape the procedure of a thread
+			m_error = strus::string_format( _TXT("uncaught exception during %s: %s"), evaluationPhase, err.what());
+		}
+		catch (...)
+		{
+			m_error = strus::string_format( _TXT("uncaught exception of unknown type during %s"), evaluationPhase);
+		}
+		if (m_error.empty() && m_query->m_errorhnd->hasError())
 		{
-			if (m_debugtrace) m_debugtrace->event( "variable", "index=%d name=%s value=%f", (int)vi->index, vi->varname.c_str(), vi->value);
-			accumulator.defineWeightingVariableValue( vi->index, vi->varname, vi->value);
+			m_error = m_query->m_errorhnd->fetchError();
 		}
+	}
 
-		evaluationPhase = "restrictions initialization";
-		// [4.4] Define the user ACL restrictions:
-		std::vector<std::string>::const_iterator ui = m_usernames.begin(), ue = m_usernames.end();
-		for (; ui != ue; ++ui)
+	const std::vector<WeightedDocument>& result() const	{return m_result;}
+	unsigned int nofDocumentsRanked() const			{return m_nofDocumentsRanked;}
+	unsigned int nofDocumentsVisited() const		{return m_nofDocumentsVisited;}
+	const std::string& error() const			{return m_error;}
+
+private:
+	const Query* m_query;
+	const NodeDfMap* m_nodeDfMap;
+	Reference<InvAclIteratorInterface> m_aclRestriction;	///< ACL restriction shared by all partitions
+	Index m_docnoStart;
+	Index m_docnoEnd;
+	Index m_maxDocumentNumber;
+	std::size_t m_maxNofRanks;
+	std::vector<WeightedDocument> m_result;
+	unsigned int m_nofDocumentsRanked;
+	unsigned int m_nofDocumentsVisited;
+	std::string m_error;
+};
+
+/// \brief Group of threads evaluating partitions of a query, joined on destruction, also in case of an exception
+class PartitionThreadGroup
+{
+public:
+	PartitionThreadGroup(){}
+	~PartitionThreadGroup()
+	{
+		joinAll();
+	}
+	void add( strus::thread* thread_)
+	{
+		m_threads.push_back( Reference<strus::thread>( thread_));
+	}
+	void joinAll()
+	{
+		std::vector<Reference<strus::thread> >::iterator ti = m_threads.begin(), te = m_threads.end();
+		for (; ti != te; ++ti)
+		{
+			(*ti)->join();
+		}
+		m_threads.clear();
+	}
+
+private:
+	std::vector<Reference<strus::thread> > m_threads;
+};
+
+int Query::nofRankingPartitions() const
+{
+	// Queries with more than one selection set are evaluated sequentially, because the
+	// decision to evaluate the next selection set depends on the ranks found before.
+	// Debug traces are written sequentially by the calling thread.
+	int nofThreads = m_queryEval->nofThreads();
+	if (nofThreads <= 1 || m_debugtrace || m_queryEval->selectionSets().size() > 1)
+	{
+		return 1;
+	}
+	Index nofPartitions = m_storage->maxDocumentNumber() / MinRankingPartitionSize;
+	return (nofPartitions < (Index)nofThreads) ? (nofPartitions ? (int)nofPartitions : 1) : nofThreads;
+}
+
+void Query::rankPartitioned(
+		std::vector<WeightedDocument>& resultlist,
+		unsigned int& nofDocumentsRanked,
+		unsigned int& nofDocumentsVisited,
+		int nofPartitions,
+		int minRank, int maxNofRanks,
+		const NodeDfMap& nodeDfMap,
+		const Reference<InvAclIteratorInterface>& aclRestriction) const
+{
+	// [1] Split the document number space into partitions of equal size:
+	Index maxDocumentNumber = m_storage->maxDocumentNumber();
+	Index partitionSize = (maxDocumentNumber + nofPartitions - 1) / nofPartitions;
+	std::vector<Reference<RankingPartition> > partitions;
+	Index docnoStart = 1;
+	for (int pidx=0; pidx < nofPartitions && docnoStart <= maxDocumentNumber; ++pidx,docnoStart+=partitionSize)
+	{
+		Index docnoEnd = docnoStart + partitionSize - 1;
+		if (docnoEnd > maxDocumentNumber) docnoEnd = maxDocumentNumber;
+		partitions.push_back( Reference<RankingPartition>(
+			new RankingPartition( this, &nodeDfMap, aclRestriction, docnoStart, docnoEnd, maxDocumentNumber, minRank + maxNofRanks)));
+	}
+	if (partitions.empty()) return;
+
+	// [2] Rank the partitions, the first one in the calling thread:
+	{
+		PartitionThreadGroup threads;
+		std::vector<Reference<RankingPartition> >::const_iterator
+			pi = partitions.begin()+1, pe = partitions.end();
+		for (; pi != pe; ++pi)
 		{
-			if (m_debugtrace) m_debugtrace->event( "user-restriction", "name=%s", ui->c_str());
-			Reference<InvAclIteratorInterface> invAcl( m_storage->createInvAclIterator( *ui));
-			if (invAcl.get())
+			threads.add( new strus::thread( &RankingPartition::runThread, pi->get()));
+		}
+		partitions[0]->run();
+		threads.joinAll();
+	}
+	// [3] Merge the ranklists of the partitions:
+	Ranker<WeightedDocument> ranker( minRank + maxNofRanks);
+	std::vector<Reference<RankingPartition> >::const_iterator
+		pi = partitions.begin(), pe = partitions.end();
+	for (int pidx=0; pi != pe; ++pi,++pidx)
+	{
+		if (!(*pi)->error().empty())
+		{
+			throw strus::runtime_error( _TXT("error in partition %d of the parallel query evaluation: %s"), pidx, (*pi)->error().c_str());
+		}
+		std::vector<WeightedDocument>::const_iterator
+			ri = (*pi)->result().begin(), re = (*pi)->result().end();
+		for (; ri != re; ++ri)
+		{
+			ranker.insert( *ri);
+		}
+		nofDocumentsRanked += (*pi)->nofDocumentsRanked();
+		nofDocumentsVisited += (*pi)->nofDocumentsVisited();
+	}
+	resultlist = ranker.result( minRank);
+}
+
+/// \brief Order of the indices of a result list by ascending document number
+class ResultDocnoOrder
+{
+public:
+	explicit ResultDocnoOrder( const std::vector<WeightedDocument>& resultlist_)
+		:m_resultlist(&resultlist_){}
+
+	bool operator()( std::size_t aa, std::size_t bb) const
+	{
+		return (*m_resultlist)[ aa].docno() < (*m_resultlist)[ bb].docno();
+	}
+
+private:
+	const std::vector<WeightedDocument>* m_resultlist;
+};
+
+void Query::createSummarizers(
+		SummarizerContextList& summarizers,
+		const NodeStorageDataMap& nodeStorageDataMap) const
+{
+	// [1] Create the summarizers:
+	std::vector<SummarizerDef>::const_iterator
+		zi = m_queryEval->summarizers().begin(),
+		ze = m_queryEval->summarizers().end();
+	for (; zi != ze; ++zi)
+	{
+		// [1.1] Create the summarizer:
+		summarizers.push_back(
+			zi->function()->createFunctionContext( m_storage, m_globstats));
+		SummarizerFunctionContextInterface* closure = summarizers.back().get();
+		if (!closure) throw std::runtime_error( _TXT("error creating summarizer context"));
+
+		// [1.2] Add features with their variables assigned to summarizer:
+		std::vector<QueryEvalInterface::FeatureParameter>::const_iterator
+			si = zi->featureParameters().begin(),
+			se = zi->featureParameters().end();
+		for (; si != se; ++si)
+		{
+			std::vector<Feature>::const_iterator
+				fi = m_features.begin(), fe = m_features.end();
+			for (; fi != fe; ++fi)
 			{
-				accumulator.addAlternativeAclRestriction( invAcl);
+				if (fi->set == si->featureSet())
+				{
+					std::vector<SummarizationVariable> variables;
+					collectSummarizationVariables( variables, fi->node, nodeStorageDataMap);
+
+					PostingIteratorInterface* itr = nodeStorageData( fi->node, nodeStorageDataMap);
+					closure->addSummarizationFeature(
+						si->featureRole(), itr, variables, fi->weight);
+				}
 			}
-			else if (m_errorhnd->hasError())
+		}
+	}
+	// [2] Define feature summarizer weighting variable values:
+	std::vector<WeightingVariableValueAssignment>::const_iterator
+		vi = m_summaryweightvars.begin(), ve = m_summaryweightvars.end();
+	for (; vi != ve; ++vi)
+	{
+		summarizers[ vi->index]->setVariableValue( vi->varname, vi->value);
+	}
+}
+
+void Query::summarizeDocuments(
+		std::vector<DocumentSummaries>& summaries,
+		SummarizerContextList& summarizers,
+		const std::vector<WeightedDocument>& resultlist,
+		const std::vector<std::size_t>& docnoOrder,
+		std::size_t start, std::size_t end)
+{
+	for (std::size_t oi=start; oi < end; ++oi)
+	{
+		std::size_t ridx = docnoOrder[ oi];
+		DocumentSummaries& docsummaries = summaries[ ridx];
+		docsummaries.reserve( summarizers.size());
+
+		SummarizerContextList::iterator si = summarizers.begin(), se = summarizers.end();
+		for (; si != se; ++si)
+		{
+			docsummaries.push_back( (*si)->getSummary( resultlist[ ridx]));
+		}
+	}
+}
+
+/// \brief Summarization of a part of the result documents, visited in ascending document number order, in a parallel query evaluation
+class Query::SummarizationPartition
+{
+public:
+	SummarizationPartition( const Query* query_, std::vector<DocumentSummaries>* summaries_, const std::vector<WeightedDocument>* resultlist_, const std::vector<std::size_t>* docnoOrder_, std::size_t start_, std::size_t end_)
+		:m_query(query_),m_summaries(summaries_),m_resultlist(resultlist_),m_docnoOrder(docnoOrder_)
+		,m_start(start_),m_end(end_),m_error(){}
+
+	/// \brief Summarization as thread procedure with its own error buffer context
+	void runThread()
+	{
+		m_query->m_errorhnd->allocContext();
+		run();
+		m_query->m_errorhnd->releaseContext();
+	}
+
+	/// \brief Summarization in a thread with its own feature postings
+	void run()
+	{
+		const char* evaluationPhase = "query feature postings initialization";
+		try
+		{
+			NodeStorageDataMap nodeStorageDataMap;
+			std::vector<Reference<PostingIteratorInterface> > postings;
+			if (!m_query->createFeaturePostings( postings, nodeStorageDataMap))
 			{
-				throw std::runtime_error( _TXT( "storage built without ACL resrictions, cannot handle username passed with query"));
+				throw std::runtime_error( _TXT("failed to create feature postings"));
 			}
+			evaluationPhase = "summarization";
+			SummarizerContextList summarizers;
+			m_query->createSummarizers( summarizers, nodeStorageDataMap);
+			summarizeDocuments( *m_summaries, summarizers, *m_resultlist, *m_docnoOrder, m_start, m_end);
+		}
+		catch (const std::bad_alloc&)
+		{
+			m_error = _TXT("out of memory");
+		}
+		catch (const std::runtime_error& err)
+		{
+			m_error = strus::string_format( _TXT("error during %s: %s"), evaluationPhase, err.what());
+		}
+		catch (const std::exception& err)
+		{
+			//... no exception must escape the procedure of a thread
+			m_error = strus::string_format( _TXT("uncaught exception during %s: %s"), evaluationPhase, err.what());
+		}
+		catch (...)
+		{
+			m_error = strus::string_format( _TXT("uncaught exception of unknown type during %s"), evaluationPhase);
+		}
+		if (m_error.empty() && m_query->m_errorhnd->hasError())
+		{
+			m_error = m_query->m_errorhnd->fetchError();
+		}
+	}
+
+	const std::string& error() const			{return m_error;}
+
+private:
+	const Query* m_query;
+	std::vector<DocumentSummaries>* m_summaries;
+	const std::vector<WeightedDocument>* m_resultlist;
+	const std::vector<std::size_t>* m_docnoOrder;
+	std::size_t m_start;
+	std::size_t m_end;
+	std::string m_error;
+};
+
+int Query::nofSummarizationPartitions( std::size_t nofResults) const
+{
+	// Debug traces are written sequentially by the calling thread.
+	int nofThreads = m_queryEval->nofThreads();
+	if (nofThreads <= 1 || m_debugtrace)
+	{
+		return 1;
+	}
+	std::size_t nofPartitions = nofResults / MinSummarizationPartitionSize;
+	return (nofPartitions < (std::size_t)nofThreads) ? (nofPartitions ? (int)nofPartitions : 1) : nofThreads;
+}
+
+void Query::summarizePartitioned(
+		std::vector<DocumentSummaries>& summaries,
+		const std::vector<WeightedDocument>& resultlist,
+		const std::vector<std::size_t>& docnoOrder,
+		int nofPartitions,
+		const NodeStorageDataMap& nodeStorageDataMap) const
+{
+	// [1] Split the result documents in document number order into partitions of equal size:
+	std::size_t partitionSize = (docnoOrder.size() + nofPartitions - 1) / nofPartitions;
+	std::vector<Reference<SummarizationPartition> > partitions;
+	std::size_t start = partitionSize;
+	for (; start < docnoOrder.size(); start += partitionSize)
+	{
+		std::size_t end = start + partitionSize;
+		if (end > docnoOrder.size()) end = docnoOrder.size();
+		partitions.push_back( Reference<SummarizationPartition>(
+			new SummarizationPartition( this, &summaries, &resultlist, &docnoOrder, start, end)));
+	}
+	// [2] Summarize the partitions, the first one in the calling thread with the feature postings of the query:
+	{
+		PartitionThreadGroup threads;
+		std::vector<Reference<SummarizationPartition> >::const_iterator
+			pi = partitions.begin(), pe = partitions.end();
+		for (; pi != pe; ++pi)
+		{
+			threads.add( new strus::thread( &SummarizationPartition::runThread, pi->get()));
+		}
+		SummarizerContextList summarizers;
+		createSummarizers( summarizers, nodeStorageDataMap);
+		summarizeDocuments( summaries, summarizers, resultlist, docnoOrder, 0, partitionSize < docnoOrder.size() ? partitionSize : docnoOrder.size());
+		threads.joinAll();
+	}
+	// [3] Check the results of the partitions:
+	std::vector<Reference<SummarizationPartition> >::const_iterator
+		pi = partitions.begin(), pe = partitions.end();
+	for (int pidx=1; pi != pe; ++pi,++pidx)
+	{
+		if (!(*pi)->error().empty())
+		{
+			throw strus::runtime_error( _TXT("error in partition %d of the parallel summarization: %s"), pidx, (*pi)->error().c_str());
+		}
+	}
+}
+
+/// \brief Append a string to a result cache key, prefixed with its length to make the key unambiguous
+static void appendCacheKeyString( std::string& buf, const std::string& str)
+{
+	buf.append( strus::string_format( "%u:", (unsigned int)str.size()));
+	buf.append( str);
+}
+
+void Query::appendNodeCacheKey( std::string& buf, NodeAddress adr) const
+{
+	switch (nodeType( adr))
+	{
+		case NullNode:
+			buf.push_back( 'N');
+			break;
+		case TermNode:
+		{
+			const Term& term = m_terms[ nodeIndex( adr)];
+			buf.push_back( 'T');
+			appendCacheKeyString( buf, term.type);
+			appendCacheKeyString( buf, term.value);
+			buf.append( strus::string_format( "%d;", (int)term.length));
+			break;
 		}
-		// [4.5] Define the feature restrictions:
+		case ExpressionNode:
 		{
-			std::vector<std::string>::const_iterator
-				xi = m_queryEval->restrictionSets().begin(),
-				xe = m_queryEval->restrictionSets().end();
-			for (; xi != xe; ++xi)
+			const Expression& expr = m_expressions[ nodeIndex( adr)];
+			buf.push_back( 'E');
+			appendCacheKeyString( buf, expr.operation->name());
+			buf.append( strus::string_format( "%d,%u,%u(", expr.range, expr.cardinality, (unsigned int)expr.subnodes.size()));
+			std::vector<NodeAddress>::const_iterator ni = expr.subnodes.begin(), ne = expr.subnodes.end();
+			for (; ni != ne; ++ni)
 			{
-				std::vector<Feature>::const_iterator
-					fi = m_features.begin(), fe = m_features.end();
-				for (; fi != fe; ++fi)
-				{
-					if (*xi == fi->set)
-					{
-						if (m_debugtrace) m_debugtrace->event( "feature-restriction", "name=%s", xi->c_str());
-						accumulator.addFeatureRestriction(
-							nodeStorageData( fi->node, nodeStorageDataMap), false);
-					}
-				}
+				appendNodeCacheKey( buf, *ni);
 			}
+			buf.push_back( ')');
+			break;
+		}
+	}
+	typedef std::multimap<NodeAddress,std::string>::const_iterator VarIter;
+	std::pair<VarIter,VarIter> vrange = m_variableAssignments.equal_range( adr);
+	for (VarIter vi = vrange.first; vi != vrange.second; ++vi)
+	{
+		buf.push_back( 'V');
+		appendCacheKeyString( buf, vi->second);
+	}
+}
+
+/// \brief Get the key identifying the result of the query in the result cache
+/// \note Besides the query, the key contains the identity and the revision of the storage, so that results are outdated by a commit.
+/// \note The key also contains the fingerprint of the query evaluation program, so that results are outdated by a change of the program.
+std::string Query::resultCacheKey( int minRank, int maxNofRanks) const
+{
+	std::string rt = strus::string_format(
+				"%u:%u:%d:%d:%d:%d;",
+				m_storage->instanceId(), m_storage->revision(),
+				(int)m_storage->nofDocumentsInserted(), (int)m_storage->maxDocumentNumber(),
+				minRank, maxNofRanks);
+	appendCacheKeyString( rt, m_queryEval->resultCacheFingerprint());
+	rt.append( strus::string_format( "F%u;", (unsigned int)m_features.size()));
+	std::vector<Feature>::const_iterator fi = m_features.begin(), fe = m_features.end();
+	for (; fi != fe; ++fi)
+	{
+		appendCacheKeyString( rt, fi->set);
+		rt.append( strus::string_format( "%.9g;", (double)fi->weight));
+		appendNodeCacheKey( rt, fi->node);
+	}
+	if (m_metaDataRestriction.get())
+	{
+		rt.push_back( 'R');
+		appendCacheKeyString( rt, m_metaDataRestriction->tostring());
+	}
+	if (m_evalset_defined)
+	{
+		rt.append( strus::string_format( "D%u;", (unsigned int)m_evalset_docnolist.size()));
+		std::vector<Index>::const_iterator di = m_evalset_docnolist.begin(), de = m_evalset_docnolist.end();
+		for (; di != de; ++di)
+		{
+			rt.append( strus::string_format( "%d,", (int)*di));
+		}
+	}
+	if (!m_usernames.empty())
+	{
+		std::vector<std::string> usernames( m_usernames);
+		std::sort( usernames.begin(), usernames.end());
+		rt.append( strus::string_format( "U%u;", (unsigned int)usernames.size()));
+		std::vector<std::string>::const_iterator ui = usernames.begin(), ue = usernames.end();
+		for (; ui != ue; ++ui)
+		{
+			appendCacheKeyString( rt, *ui);
+		}
+	}
+	std::vector<WeightingVariableValueAssignment>::const_iterator wi, we;
+	for (wi = m_weightingvars.begin(), we = m_weightingvars.end(); wi != we; ++wi)
+	{
+		rt.append( strus::string_format( "W%u,%.17g", (unsigned int)wi->index, wi->value));
+		appendCacheKeyString( rt, wi->varname);
+	}
+	for (wi = m_summaryweightvars.begin(), we = m_summaryweightvars.end(); wi != we; ++wi)
+	{
+		rt.append( strus::string_format( "S%u,%.17g", (unsigned int)wi->index, wi->value));
+		appendCacheKeyString( rt, wi->varname);
+	}
+	std::vector<std::pair<std::string,double> >::const_iterator vi = m_formulavars.begin(), ve = m_formulavars.end();
+	for (; vi != ve; ++vi)
+	{
+		rt.append( strus::string_format( "X%.17g", vi->second));
+		appendCacheKeyString( rt, vi->first);
+	}
+	TermStatisticsMap::const_iterator ti = m_termstatsmap.begin(), te = m_termstatsmap.end();
+	for (; ti != te; ++ti)
+	{
+		rt.push_back( 'G');
+		appendCacheKeyString( rt, ti->first.type);
+		appendCacheKeyString( rt, ti->first.value);
+		rt.append( strus::string_format( "%.17g;", (double)ti->second.documentFrequency()));
+	}
+	if (m_globstats.defined())
+	{
+		rt.append( strus::string_format( "N%.17g;", (double)m_globstats.nofDocumentsInserted()));
+	}
+	return rt;
+}
+
+QueryResult Query::evaluate( int minRank, int maxNofRanks) const
+{
+	const char* evaluationPhase = "query feature postings initialization";
+	try
+	{
+		if (m_debugtrace)
+		{
+			m_debugtrace->open( "eval");
+			std::string str = view().tostring();
+			m_debugtrace->event( "query", "%s", str.c_str());
+		}
+		// [1] Check initial conditions:
+		if (maxNofRanks == 0)
+		{
+			if (m_debugtrace) m_debugtrace->close();
+			return QueryResult();
+		}
+		if (m_queryEval->weightingFunctions().empty())
+		{
+			m_errorhnd->report( ErrorCodeIncompleteDefinition, _TXT( "cannot evaluate query, no weighting function defined"));
+			if (m_debugtrace) m_debugtrace->close();
+			return QueryResult();
+		}
+		if (m_queryEval->selectionSets().empty())
+		{
+			m_errorhnd->report( ErrorCodeIncompleteDefinition, _TXT( "cannot evaluate query, no selection features defined"));
+			if (m_debugtrace) m_debugtrace->close();
+			return QueryResult();
 		}
-		// [4.6] Define the feature exclusions:
+		// [2] Look up the result in the result cache:
+		QueryResultCache* resultCache = (m_debugtrace || !m_storage->instanceId()) ? 0 : m_queryEval->resultCache();
+		std::string resultCacheKey_;
+		if (resultCache)
 		{
-			std::vector<std::string>::const_iterator
-				xi = m_queryEval->exclusionSets().begin(),
-				xe = m_queryEval->exclusionSets().end();
-			for (; xi != xe; ++xi)
+			evaluationPhase = "result cache lookup";
+			resultCacheKey_ = resultCacheKey( minRank, maxNofRanks);
+			QueryResult cachedResult;
+			if (resultCache->find( resultCacheKey_, cachedResult))
 			{
-				std::vector<Feature>::const_iterator
-					fi = m_features.begin(), fe = m_features.end();
-				for (; fi != fe; ++fi)
-				{
-					if (*xi == fi->set)
-					{
-						if (m_debugtrace) m_debugtrace->event( "feature-exclusion", "name=%s", xi->c_str());
-						accumulator.addFeatureRestriction(
-							nodeStorageData( fi->node, nodeStorageDataMap), true);
-					}
-				}
+				return cachedResult;
 			}
 		}
-		if (m_debugtrace)
+		// [3] Plan the evaluation with the estimated document frequencies of the query nodes:
+		evaluationPhase = "query planning";
+		NodeDfMap nodeDfMap;
+		planQuery( nodeDfMap, m_debugtrace);
+		if (planEmptyResult( nodeDfMap, m_debugtrace))
+		{
+			if (m_debugtrace) m_debugtrace->close();
+			return QueryResult();
+		}
+		NodeStorageDataMap nodeStorageDataMap;
+
+		// [4] Create the posting sets of the query features:
+		evaluationPhase = "query feature postings initialization";
+		std::vector<Reference<PostingIteratorInterface> > postings;
+		if (!createFeaturePostings( postings, nodeStorageDataMap))
 		{
-			m_debugtrace->open( "ranking");
+			if (m_debugtrace) m_debugtrace->close();
+			return QueryResult();
 		}
-		evaluationPhase = "document ranking";
-		// [5] Do the ranking:
-		std::vector<ResultDocument> ranks;
-		Index docno = 0;
+		std::vector<WeightedDocument> resultlist;
 		unsigned int state = 0;
-		unsigned int prev_state = 0;
-	
-		while (accumulator.nextRank( docno, state))
+		unsigned int nofDocumentsRanked = 0;
+		unsigned int nofDocumentsVisited = 0;
+
+		evaluationPhase = "restrictions initialization";
+		Reference<InvAclIteratorInterface> aclRestriction = createAclRestriction( m_debugtrace);
+
+		bool featurePostingsUsed = false;	//... the feature postings are positioned behind the result documents after ranking with them
+		int nofPartitions = nofRankingPartitions();
+		if (nofPartitions > 1)
+		{
+			// [4,5] Do the ranking in parallel on partitions of the document number space:
+			evaluationPhase = "parallel document ranking";
+			rankPartitioned( resultlist, nofDocumentsRanked, nofDocumentsVisited, nofPartitions, minRank, maxNofRanks, nodeDfMap, aclRestriction);
+		}
+		else
 		{
-			if (state > prev_state && (int)accumulator.ranker().nofRanks() >= maxNofRanks + minRank)
+			// [5] Create the accumulator:
+			DocsetPostingIterator evalset_itr;
+			Accumulator accumulator(
+				m_storage,
+				m_metaDataReader.get(), m_metaDataRestriction.get(), m_weightingFormula.get(),
+				minRank + maxNofRanks, m_storage->maxDocumentNumber());
+			initAccumulator( accumulator, evalset_itr, nodeStorageDataMap, nodeDfMap, aclRestriction, evaluationPhase, m_debugtrace);
+			featurePostingsUsed = true;
+
+			if (m_debugtrace)
 			{
-				state = prev_state;
-				break;
+				m_debugtrace->open( "ranking");
 			}
-			prev_state = state;
+			evaluationPhase = "document ranking";
+			// [6] Do the ranking:
+			Index docno = 0;
+			unsigned int prev_state = 0;
+
+			while (accumulator.nextRank( docno, state))
+			{
+				if (state > prev_state && (int)accumulator.ranker().nofRanks() >= maxNofRanks + minRank)
+				{
+					state = prev_state;
+					break;
+				}
+				prev_state = state;
+			}
+			if (m_debugtrace) m_debugtrace->event( "statistics", "ranked=%u visited=%u pruned=%u", accumulator.nofDocumentsRanked(), accumulator.nofDocumentsVisited(), accumulator.nofDocumentsPruned());
+			resultlist = accumulator.ranker().result( minRank);
+			nofDocumentsRanked = accumulator.nofDocumentsRanked();
+			nofDocumentsVisited = accumulator.nofDocumentsVisited();
 		}
-		std::vector<WeightedDocument> resultlist = accumulator.ranker().result( minRank);
 
-		// [6] Summarization:
+		// [7] Summarization:
 		evaluationPhase = "summarization";
-		std::vector<Reference<SummarizerFunctionContextInterface> > summarizers;
-		if (!resultlist.empty())
-		{
-			// [6.1] Create the summarizers:
-			std::vector<SummarizerDef>::const_iterator
-				zi = m_queryEval->summarizers().begin(),
-				ze = m_queryEval->summarizers().end();
-			for (; zi != ze; ++zi)
-			{
-				// [5.1] Create the summarizer:
-				summarizers.push_back(
-					zi->function()->createFunctionContext( m_storage, m_globstats));
-				SummarizerFunctionContextInterface* closure = summarizers.back().get();
-				if (!closure) throw std::runtime_error( _TXT("error creating summarizer context"));
-
-				// [5.2] Add features with their variables assigned to summarizer:
-				std::vector<QueryEvalInterface::FeatureParameter>::const_iterator
-					si = zi->featureParameters().begin(),
-					se = zi->featureParameters().end();
-				for (; si != se; ++si)
-				{
-					std::vector<Feature>::const_iterator
-						fi = m_features.begin(), fe = m_features.end();
-					for (; fi != fe; ++fi)
-					{
-						if (fi->set == si->featureSet())
-						{
-							std::vector<SummarizationVariable> variables;
-							collectSummarizationVariables( variables, fi->node, nodeStorageDataMap);
+		std::vector<DocumentSummaries> resultSummaries( resultlist.size());
+		if (!resultlist.empty() && !m_queryEval->summarizers().empty())
+		{
+			// [7.1] Visit the result documents in ascending document number order, so that the feature postings only move forward:
+			std::vector<std::size_t> docnoOrder;
+			docnoOrder.reserve( resultlist.size());
+			for (std::size_t ridx=0; ridx < resultlist.size(); ++ridx)
+			{
+				docnoOrder.push_back( ridx);
+			}
+			std::stable_sort( docnoOrder.begin(), docnoOrder.end(), ResultDocnoOrder( resultlist));
 
-							PostingIteratorInterface* itr = nodeStorageData( fi->node, nodeStorageDataMap);
-							closure->addSummarizationFeature(
-								si->featureRole(), itr, variables, fi->weight);
-						}
-					}
+			// [7.2] Create new feature postings for the summarization, if the ones of the query were moved by the ranking:
+			if (featurePostingsUsed)
+			{
+				postings.clear();
+				nodeStorageDataMap.clear();
+				if (!createFeaturePostings( postings, nodeStorageDataMap))
+				{
+					throw std::runtime_error( _TXT("failed to create feature postings for summarization"));
 				}
 			}
-			// [6.2] Define feature summarizer weighting variable values:
-			vi = m_summaryweightvars.begin(), ve = m_summaryweightvars.end();
-			for (; vi != ve; ++vi)
+			// [7.3] Summarize the result documents, in parallel on partitions of the result list if configured:
+			int nofPartitions = nofSummarizationPartitions( resultlist.size());
+			if (nofPartitions > 1)
 			{
-				summarizers[ vi->index]->setVariableValue( vi->varname, vi->value);
+				evaluationPhase = "parallel summarization";
+				summarizePartitioned( resultSummaries, resultlist, docnoOrder, nofPartitions, nodeStorageDataMap);
+			}
+			else
+			{
+				SummarizerContextList summarizers;
+				createSummarizers( summarizers, nodeStorageDataMap);
+				summarizeDocuments( resultSummaries, summarizers, resultlist, docnoOrder, 0, docnoOrder.size());
 			}
 		}
 
 		evaluationPhase = "building of the result";
 
-		// [7] Build the result:
-		// [7.1] Build the ranklist and the map of populated summaries;
+		// [8] Build the result:
+		// [8.1] Build the ranklist and the map of populated summaries;
+		std::vector<ResultDocument> ranks;
 		typedef std::map<std::string,double> SummaryElementMap;
 		std::map< std::string, SummaryElementMap> summaryMap;
 		std::vector<WeightedDocument>::const_iterator ri=resultlist.begin(),re=resultlist.end();
-		for (; ri != re; ++ri)
+		for (std::size_t ridx=0; ri != re; ++ri,++ridx)
 		{
 			if (m_debugtrace) m_debugtrace->event( "result", "docno=%d weight=%f", ri->docno(), ri->weight());
 			std::vector<SummaryElement> summaries;
 
-			std::vector<Reference<SummarizerFunctionContextInterface> >::iterator
-				si = summarizers.begin(), se = summarizers.end();
+			DocumentSummaries::iterator
+				si = resultSummaries[ ridx].begin(), se = resultSummaries[ ridx].end();
 			for (int sidx=0 ;si != se; ++si,++sidx)
 			{
-				std::vector<SummaryElement> summary = (*si)->getSummary( *ri);
+				std::vector<SummaryElement>& summary = *si;
 				std::vector<SummaryElement>::iterator li = summary.begin(), le = summary.end();
 				for (; li != le; ++li)
 				{
@@ -839,7 +1627,7 @@ QueryResult Query::evaluate( int minRank, int maxNofRanks) const
 			}
 			ranks.push_back( ResultDocument( *ri, summaries));
 		}
-		// [7.2] Build the global summary from populated summary elements;
+		// [8.2] Build the global summary from populated summary elements;
 		std::vector<SummaryElement> summary;
 		std::map<std::string, SummaryElementMap>::const_iterator
 			si = summaryMap.begin(), se = summaryMap.end();
@@ -866,7 +1654,13 @@ QueryResult Query::evaluate( int minRank, int maxNofRanks) const
 		}
 		if (m_debugtrace) m_debugtrace->close();/*ranking*/
 		if (m_debugtrace) m_debugtrace->close();/*eval*/
-		return QueryResult( state, accumulator.nofDocumentsRanked(), accumulator.nofDocumentsVisited(), ranks, summary);
+		if (resultCache)
+		{
+			QueryResult rt( state, nofDocumentsRanked, nofDocumentsVisited, ranks, summary);
+			resultCache->insert( resultCacheKey_, rt);
+			return rt;
+		}
+		return QueryResult( state, nofDocumentsRanked, nofDocumentsVisited, ranks, summary);
 	}
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error during %s when evaluating query: %s"), evaluationPhase, *m_errorhnd, QueryResult());
 }
@@ -9,6 +9,7 @@
 #define _STRUS_QUERY_HPP_INCLUDED
 #include "strus/queryInterface.hpp"
 #include "strus/storage/summarizationVariable.hpp"
+#include "strus/storage/summaryElement.hpp"
 #include "strus/reference.hpp"
 #include "private/internationalization.hpp"
 #include "strus/metaDataRestrictionInterface.hpp"
@@ -34,6 +35,16 @@ class PostingIteratorInterface;
 class ErrorBufferInterface;
 /// \brief Forward declaration
 class DebugTraceContextInterface;
+/// \brief Forward declaration
+class Accumulator;
+/// \brief Forward declaration
+class DocsetPostingIterator;
+/// \brief Forward declaration
+class WeightedDocument;
+/// \brief Forward declaration
+class SummarizerFunctionContextInterface;
+/// \brief Forward declaration
+class InvAclIteratorInterface;
 
 /// \brief Implementation of the query interface
 class Query
@@ -181,6 +192,7 @@ private:
 	const TermStatistics& getTermStatistics( const std::string& type_, const std::string& value_) const;
 
 	typedef std::map<NodeAddress,PostingIteratorInterface*> NodeStorageDataMap;
+	typedef std::map<NodeAddress,Index> NodeDfMap;	///< upper bounds of the document frequencies of query nodes estimated in the planning phase
 
 	struct WeightingVariableValueAssignment
 	{
@@ -195,14 +207,68 @@ private:
 	};
 
 	enum {MaxNofJoinopArguments=256};
+	Index estimateDocumentFrequency( const NodeAddress& nodeadr, NodeDfMap& nodeDfMap, DebugTraceContextInterface* debugtrace) const;
+	Index nodeDocumentFrequency( const NodeAddress& nodeadr, const NodeDfMap& nodeDfMap) const;
+	void planQuery( NodeDfMap& nodeDfMap, DebugTraceContextInterface* debugtrace) const;
+	bool planEmptyResult( const NodeDfMap& nodeDfMap, DebugTraceContextInterface* debugtrace) const;
 	PostingIteratorInterface* createExpressionPostingIterator( const Expression& expr, NodeStorageDataMap& nodeStorageDataMap, bool usePosinfo) const;
 	PostingIteratorInterface* createNodePostingIterator( const NodeAddress& nodeadr, NodeStorageDataMap& nodeStorageDataMap, bool usePosinfo) const;
+	bool createFeaturePostings(
+			std::vector<Reference<PostingIteratorInterface> >& postings,
+			NodeStorageDataMap& nodeStorageDataMap) const;
+	Reference<InvAclIteratorInterface> createAclRestriction( DebugTraceContextInterface* debugtrace) const;
+	void initAccumulator(
+			Accumulator& accumulator,
+			DocsetPostingIterator& evalset_itr,
+			const NodeStorageDataMap& nodeStorageDataMap,
+			const NodeDfMap& nodeDfMap,
+			const Reference<InvAclIteratorInterface>& aclRestriction,
+			const char*& evaluationPhase,
+			DebugTraceContextInterface* debugtrace) const;
+
+	enum {MinRankingPartitionSize=4096};
+	class RankingPartition;
+	friend class RankingPartition;
+	int nofRankingPartitions() const;
+	void rankPartitioned(
+			std::vector<WeightedDocument>& resultlist,
+			unsigned int& nofDocumentsRanked,
+			unsigned int& nofDocumentsVisited,
+			int nofPartitions,
+			int minRank, int maxNofRanks,
+			const NodeDfMap& nodeDfMap,
+			const Reference<InvAclIteratorInterface>& aclRestriction) const;
+	typedef std::vector<Reference<SummarizerFunctionContextInterface> > SummarizerContextList;
+	typedef std::vector<std::vector<SummaryElement> > DocumentSummaries;	///< summaries of a result document, one list per summarizer
+	void createSummarizers(
+			SummarizerContextList& summarizers,
+			const NodeStorageDataMap& nodeStorageDataMap) const;
+	static void summarizeDocuments(
+			std::vector<DocumentSummaries>& summaries,
+			SummarizerContextList& summarizers,
+			const std::vector<WeightedDocument>& resultlist,
+			const std::vector<std::size_t>& docnoOrder,
+			std::size_t start, std::size_t end);
+
+	enum {MinSummarizationPartitionSize=8};
+	class SummarizationPartition;
+	friend class SummarizationPartition;
+	int nofSummarizationPartitions( std::size_t nofResults) const;
+	void summarizePartitioned(
+			std::vector<DocumentSummaries>& summaries,
+			const std::vector<WeightedDocument>& resultlist,
+			const std::vector<std::size_t>& docnoOrder,
+			int nofPartitions,
+			const NodeStorageDataMap& nodeStorageDataMap) const;
 	void collectSummarizationVariables(
 				std::vector<SummarizationVariable>& variables,
 				const NodeAddress& nodeadr,
 				const NodeStorageDataMap& nodeStorageDataMap) const;
 	PostingIteratorInterface* nodeStorageData( const NodeAddress& nodeadr, const NodeStorageDataMap& nodeStorageDataMap) const;
 
+	void appendNodeCacheKey( std::string& buf, NodeAddress adr) const;
+	std::string resultCacheKey( int minRank, int maxNofRanks) const;
+
 	StructView nodeView( NodeAddress adr) const;
 	StructView variableView( NodeAddress adr) const;
 	StructView featuresView() const;
@@ -228,6 +294,7 @@ private:
 	GlobalStatistics m_globstats;					///< global statistics (evaluation in case of a distributed index)
 	std::vector<WeightingVariableValueAssignment> m_weightingvars;	///< non constant weight variables (defined by query and not the query eval)
 	std::vector<WeightingVariableValueAssignment> m_summaryweightvars; ///< non constant summarization weight variables (defined by query and not the query eval)
+	std::vector<std::pair<std::string,double> > m_formulavars;	///< non constant weighting formula variables (defined by query and not the query eval), needed for the result cache key
 	ErrorBufferInterface* m_errorhnd;				///< buffer for error messages
 	DebugTraceContextInterface* m_debugtrace;			///< debug trace interface
 };
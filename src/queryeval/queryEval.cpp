@@ -38,6 +38,7 @@ void QueryEval::addTerm(
 	try
 	{
 		m_terms.push_back( TermConfig( set_, type_, value_));
+		updateResultCacheFingerprint();
 	}
 	CATCH_ERROR_MAP( _TXT("error adding term: %s"), *m_errorhnd);
 }
@@ -50,6 +51,7 @@ void QueryEval::addSelectionFeature( const std::string& set_)
 		{
 			m_selectionSets.push_back( set_);
 		}
+		updateResultCacheFingerprint();
 	}
 	CATCH_ERROR_MAP( _TXT("error adding selection feature: %s"), *m_errorhnd);
 }
@@ -62,6 +64,7 @@ void QueryEval::addRestrictionFeature( const std::string& set_)
 		{
 			m_restrictionSets.push_back( set_);
 		}
+		updateResultCacheFingerprint();
 	}
 	CATCH_ERROR_MAP( _TXT("error adding restriction feature: %s"), *m_errorhnd);
 }
@@ -74,6 +77,7 @@ void QueryEval::addExclusionFeature( const std::string& set_)
 		{
 			m_exclusionSets.push_back( set_);
 		}
+		updateResultCacheFingerprint();
 	}
 	CATCH_ERROR_MAP( _TXT("error adding exclusion feature: %s"), *m_errorhnd);
 }
@@ -127,6 +131,7 @@ void QueryEval::addSummarizerFunction(
 			VariableAssignment::SummarizerFunction,
 			m_summarizers.size());
 		m_summarizers.push_back( SummarizerDef( summaryId, functionref, featureParameters));
+		updateResultCacheFingerprint();
 	}
 	CATCH_ERROR_MAP( _TXT("error adding summarization function: %s"), *m_errorhnd);
 }
@@ -151,6 +156,7 @@ void QueryEval::addWeightingFunction(
 			}
 		}
 		m_weightingFunctions.push_back( WeightingDef( functionref, featureParameters));
+		updateResultCacheFingerprint();
 	}
 	CATCH_ERROR_MAP( _TXT("error adding weighting function: %s"), *m_errorhnd);
 }
@@ -165,6 +171,7 @@ void QueryEval::defineWeightingFormula(
 			combinefunc->getVariables(),
 			VariableAssignment::FormulaFunction,
 			0);
+		updateResultCacheFingerprint();
 	}
 	CATCH_ERROR_MAP( _TXT("error adding weighting formula: %s"), *m_errorhnd);
 }
@@ -205,10 +212,38 @@ void QueryEval::usePositionInformation( const std::string& featureSet, bool yes)
 	try
 	{
 		m_featureSetFlagMap[ featureSet].usePosinfo = yes;
+		updateResultCacheFingerprint();
 	}
 	CATCH_ERROR_MAP( _TXT("error initializing position info flag: %s"), *m_errorhnd);
 }
 
+void QueryEval::defineParallelism( int nofThreads)
+{
+	try
+	{
+		if (nofThreads < 0) throw std::runtime_error( _TXT("number of threads for query evaluation must not be negative"));
+		m_nofThreads = nofThreads;
+	}
+	CATCH_ERROR_MAP( _TXT("error defining parallelism of query evaluation: %s"), *m_errorhnd);
+}
+
+void QueryEval::defineResultCache( std::size_t maxMemoryUsage)
+{
+	try
+	{
+		if (maxMemoryUsage)
+		{
+			m_resultCache.reset( new QueryResultCache( maxMemoryUsage));
+		}
+		else
+		{
+			m_resultCache.reset();
+		}
+		updateResultCacheFingerprint();
+	}
+	CATCH_ERROR_MAP( _TXT("error defining result cache of query evaluation: %s"), *m_errorhnd);
+}
+
 bool QueryEval::usePositionInformation( const std::string& featureSet) const
 {
 	std::map<std::string,FeatureSetFlags>::const_iterator fi = m_featureSetFlagMap.find( featureSet);
@@ -299,42 +334,79 @@ static StructView getStructView( const std::vector<TermConfig>& o)
 	return rt;
 }
 
-StructView QueryEval::view() const
+StructView QueryEval::programView() const
 {
-	try
+	StructView rt;
+	if (!m_weightingFunctions.empty())
 	{
-		StructView rt;
-		if (!m_weightingFunctions.empty())
-		{
-			rt( "weighting", getStructView( m_weightingFunctions));
-		}
-		if (!m_summarizers.empty())
-		{
-			rt( "summarizers", getStructView( m_summarizers));
-		}
-		if (!m_terms.empty())
-		{
-			rt( "weighting_sets", getStructView( m_terms));
-		}
-		if (!m_weightingSets.empty())
-		{
-			rt( "weighting_sets", m_weightingSets);
-		}
-		if (!m_selectionSets.empty())
-		{
-			rt( "selection_sets", m_selectionSets);
-		}
-		if (!m_restrictionSets.empty())
+		rt( "weighting", getStructView( m_weightingFunctions));
+	}
+	if (!m_summarizers.empty())
+	{
+		rt( "summarizers", getStructView( m_summarizers));
+	}
+	if (!m_terms.empty())
+	{
+		rt( "weighting_sets", getStructView( m_terms));
+	}
+	if (!m_weightingSets.empty())
+	{
+		rt( "weighting_sets", m_weightingSets);
+	}
+	if (!m_selectionSets.empty())
+	{
+		rt( "selection_sets", m_selectionSets);
+	}
+	if (!m_restrictionSets.empty())
+	{
+		rt( "restriction_sets", m_restrictionSets);
+	}
+	if (!m_exclusionSets.empty())
+	{
+		rt( "exclusion_sets", m_exclusionSets);
+	}
+	if (m_weightingFormula.get())
+	{
+		rt( "formula", m_weightingFormula->view());
+	}
+	return rt;
+}
+
+void QueryEval::updateResultCacheFingerprint()
+{
+	if (m_resultCache.get())
+	{
+		std::ostringstream out;
+		out << programView().tostring();
+		std::map<std::string,FeatureSetFlags>::const_iterator fi = m_featureSetFlagMap.begin(), fe = m_featureSetFlagMap.end();
+		for (; fi != fe; ++fi)
 		{
-			rt( "restriction_sets", m_restrictionSets);
+			out << "\n" << fi->first << (fi->second.usePosinfo ? "+pos" : "-pos");
 		}
-		if (!m_exclusionSets.empty())
+		m_resultCacheFingerprint = out.str();
+	}
+	else
+	{
+		m_resultCacheFingerprint.clear();
+	}
+}
+
+StructView QueryEval::view() const
+{
+	try
+	{
+		StructView rt = programView();
+		if (m_nofThreads > 1)
 		{
-			rt( "exclusion_sets", m_exclusionSets);
+			rt( "threads", m_nofThreads);
 		}
-		if (m_weightingFormula.get())
+		if (m_resultCache.get())
 		{
-			rt( "formula", m_weightingFormula->view());
+			rt( "resultcache", StructView()
+				( "memory", (NumericVariant::UIntType)m_resultCache->maxMemoryUsage())
+				( "usage", (NumericVariant::UIntType)m_resultCache->memoryUsage())
+				( "hits", (NumericVariant::UIntType)m_resultCache->nofHits())
+				( "misses", (NumericVariant::UIntType)m_resultCache->nofMisses()));
 		}
 		return rt;
 	}
@@ -13,6 +13,8 @@
 #include "termConfig.hpp"
 #include "summarizerDef.hpp"
 #include "weightingDef.hpp"
+#include "queryResultCache.hpp"
+#include "strus/base/shared_ptr.hpp"
 #include <string>
 #include <vector>
 #include <map>
@@ -33,7 +35,7 @@ public:
 		:m_weightingSets(),m_selectionSets(),m_restrictionSets()
 		,m_exclusionSets(),m_weightingFunctions(),m_summarizers()
 		,m_weightingFormula(),m_terms(),m_varassignmap()
-		,m_featureSetFlagMap(),m_errorhnd(errorhnd_){}
+		,m_featureSetFlagMap(),m_nofThreads(0),m_resultCache(),m_resultCacheFingerprint(),m_errorhnd(errorhnd_){}
 
 	QueryEval( const QueryEval& o)
 		:m_weightingSets(o.m_weightingSets)
@@ -46,8 +48,17 @@ public:
 		,m_terms(o.m_terms)
 		,m_varassignmap(o.m_varassignmap)
 		,m_featureSetFlagMap(o.m_featureSetFlagMap)
+		,m_nofThreads(o.m_nofThreads)
+		,m_resultCache()
+		,m_resultCacheFingerprint(o.m_resultCacheFingerprint)
 		,m_errorhnd(o.m_errorhnd)
-	{}
+	{
+		//... a copy may be configured differently, it gets its own cache
+		if (o.m_resultCache.get())
+		{
+			m_resultCache.reset( new QueryResultCache( o.m_resultCache->maxMemoryUsage()));
+		}
+	}
 
 	virtual QueryInterface* createQuery(
 			const StorageClientInterface* storage) const;
@@ -81,6 +92,10 @@ public:
 
 	virtual void usePositionInformation( const std::string& featureSet, bool yes);
 
+	virtual void defineParallelism( int nofThreads);
+
+	virtual void defineResultCache( std::size_t maxMemoryUsage);
+
 	virtual StructView view() const;
 
 public:/*Query*/
@@ -108,9 +123,14 @@ public:/*Query*/
 		weightingVariableAssignmentList(
 			const std::string& varname) const;
 	bool usePositionInformation( const std::string& featureSet) const;
+	int nofThreads() const						{return m_nofThreads;}
+	QueryResultCache* resultCache() const				{return m_resultCache.get();}
+	const std::string& resultCacheFingerprint() const		{return m_resultCacheFingerprint;}
 
 private:
 	void defineVariableAssignments( const std::vector<std::string>& variables, VariableAssignment::Target target, std::size_t index);
+	StructView programView() const;
+	void updateResultCacheFingerprint();
 
 private:
 	struct FeatureSetFlags
@@ -134,6 +154,9 @@ private:
 	std::vector<TermConfig> m_terms;				///< list of predefined terms used in query evaluation but not part of the query (e.g. punctuation)
 	std::multimap<std::string,VariableAssignment> m_varassignmap;	///< map of weight variable assignments
 	std::map<std::string,FeatureSetFlags> m_featureSetFlagMap;	///< map of feature set names to the flags assigned
+	int m_nofThreads;						///< number of threads used for evaluating a query (0 or 1 for sequential evaluation)
+	strus::shared_ptr<QueryResultCache> m_resultCache;		///< cache for query results or NULL if not defined
+	std::string m_resultCacheFingerprint;				///< serialization of the program definition, part of the result cache key
 	ErrorBufferInterface* m_errorhnd;				///< buffer for error messages
 };
 
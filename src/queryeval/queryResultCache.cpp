@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Size bounded cache of query results of a query evaluation program
+/// \file "queryResultCache.cpp"
+#include "queryResultCache.hpp"
+#include "private/internationalization.hpp"
+#include <stdexcept>
+
+using namespace strus;
+
+static std::size_t summaryElementsMemoryUsage( const std::vector<SummaryElement>& elems, std::size_t elemOverhead)
+{
+	std::size_t rt = 0;
+	std::vector<SummaryElement>::const_iterator ei = elems.begin(), ee = elems.end();
+	for (; ei != ee; ++ei)
+	{
+		rt += ei->name().size() + ei->value().size() + elemOverhead;
+	}
+	return rt;
+}
+
+std::size_t QueryResultCache::entryMemoryUsage( const std::string& key, const QueryResult& result)
+{
+	std::size_t rt = 2*key.size() + EntryMemoryOverhead;
+	rt += summaryElementsMemoryUsage( result.summaryElements(), SummaryElementMemoryOverhead);
+	std::vector<ResultDocument>::const_iterator ri = result.ranks().begin(), re = result.ranks().end();
+	for (; ri != re; ++ri)
+	{
+		rt += RankMemoryOverhead + summaryElementsMemoryUsage( ri->summaryElements(), SummaryElementMemoryOverhead);
+	}
+	return rt;
+}
+
+bool QueryResultCache::find( const std::string& key, QueryResult& result)
+{
+	strus::scoped_lock lock( m_mutex);
+	Map::iterator mi = m_map.find( key);
+	if (mi == m_map.end())
+	{
+		++m_nofMisses;
+		return false;
+	}
+	++m_nofHits;
+	m_lru.splice( m_lru.begin(), m_lru, mi->second.lruitr);
+	result = mi->second.result;
+	return true;
+}
+
+void QueryResultCache::insert( const std::string& key, const QueryResult& result)
+{
+	std::size_t entrysize = entryMemoryUsage( key, result);
+	if (entrysize > m_maxMemoryUsage) return;
+
+	strus::scoped_lock lock( m_mutex);
+	Map::iterator mi = m_map.find( key);
+	if (mi != m_map.end())
+	{
+		//... evaluated concurrently by another thread, the results are equal
+		m_lru.splice( m_lru.begin(), m_lru, mi->second.lruitr);
+		return;
+	}
+	m_lru.push_front( key);
+	m_map.insert( Map::value_type( key, Entry( result, entrysize, m_lru.begin())));
+	m_memoryUsage += entrysize;
+
+	while (m_memoryUsage > m_maxMemoryUsage && !m_lru.empty())
+	{
+		Map::iterator li = m_map.find( m_lru.back());
+		if (li == m_map.end()) throw std::runtime_error(_TXT("corrupt query result cache"));
+		eraseEntry( li);
+	}
+}
+
+void QueryResultCache::eraseEntry( Map::iterator mi)
+{
+	m_memoryUsage -= mi->second.memsize;
+	m_lru.erase( mi->second.lruitr);
+	m_map.erase( mi);
+}
+
+void QueryResultCache::clear()
+{
+	strus::scoped_lock lock( m_mutex);
+	m_map.clear();
+	m_lru.clear();
+	m_memoryUsage = 0;
+}
+
+std::size_t QueryResultCache::memoryUsage() const
+{
+	strus::scoped_lock lock( m_mutex);
+	return m_memoryUsage;
+}
+
+std::size_t QueryResultCache::nofHits() const
+{
+	strus::scoped_lock lock( m_mutex);
+	return m_nofHits;
+}
+
+std::size_t QueryResultCache::nofMisses() const
+{
+	strus::scoped_lock lock( m_mutex);
+	return m_nofMisses;
+}
+
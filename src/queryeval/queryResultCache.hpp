@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Size bounded cache of query results of a query evaluation program
+/// \file "queryResultCache.hpp"
+#ifndef _STRUS_QUERY_RESULT_CACHE_HPP_INCLUDED
+#define _STRUS_QUERY_RESULT_CACHE_HPP_INCLUDED
+#include "strus/storage/queryResult.hpp"
+#include "strus/base/thread.hpp"
+#include "strus/base/unordered_map.hpp"
+#include <list>
+#include <string>
+#include <cstddef>
+
+namespace strus {
+
+/// \brief Cache of the results of queries evaluated with the same query evaluation program
+/// \note Results are identified by a canonical serialization of the query that includes the revision of the storage.
+///	Results of an outdated revision are never hit again and are evicted by the least recently used policy.
+class QueryResultCache
+{
+public:
+	/// \brief Constructor
+	/// \param[in] maxMemoryUsage_ maximum number of bytes of results to hold in the cache
+	explicit QueryResultCache( std::size_t maxMemoryUsage_)
+		:m_mutex(),m_map(),m_lru(),m_maxMemoryUsage(maxMemoryUsage_),m_memoryUsage(0),m_nofHits(0),m_nofMisses(0){}
+	~QueryResultCache(){}
+
+	/// \brief Find a result in the cache
+	/// \param[in] key canonical serialization of the query
+	/// \param[out] result the result found
+	/// \return true if found, false else
+	bool find( const std::string& key, QueryResult& result);
+
+	/// \brief Insert a result into the cache, replacing an existing entry with the same key
+	/// \param[in] key canonical serialization of the query
+	/// \param[in] result the result to insert (copied)
+	/// \note Results bigger than the maximum memory usage are not cached
+	void insert( const std::string& key, const QueryResult& result);
+
+	/// \brief Remove all results from the cache
+	void clear();
+
+	/// \brief Get the maximum number of bytes of results held in the cache
+	std::size_t maxMemoryUsage() const
+	{
+		return m_maxMemoryUsage;
+	}
+	/// \brief Get the number of bytes of results held in the cache
+	std::size_t memoryUsage() const;
+	/// \brief Get the number of lookups answered by the cache
+	std::size_t nofHits() const;
+	/// \brief Get the number of lookups not answered by the cache
+	std::size_t nofMisses() const;
+
+private:
+	enum {EntryMemoryOverhead=128, RankMemoryOverhead=64, SummaryElementMemoryOverhead=80};
+
+	typedef std::list<std::string> LruList;
+
+	/// \brief Result cached
+	struct Entry
+	{
+		QueryResult result;
+		std::size_t memsize;
+		LruList::iterator lruitr;
+
+		Entry( const QueryResult& result_, std::size_t memsize_, const LruList::iterator& lruitr_)
+			:result(result_),memsize(memsize_),lruitr(lruitr_){}
+		Entry( const Entry& o)
+			:result(o.result),memsize(o.memsize),lruitr(o.lruitr){}
+	};
+	typedef strus::unordered_map<std::string,Entry> Map;
+
+	static std::size_t entryMemoryUsage( const std::string& key, const QueryResult& result);
+	void eraseEntry( Map::iterator mi);
+
+private:
+	QueryResultCache( const QueryResultCache&){}	//... non copyable
+	void operator=( const QueryResultCache&){}	//... non copyable
+
+private:
+	mutable strus::mutex m_mutex;			///< mutex for all operations on the cache
+	Map m_map;					///< map of keys to results cached
+	LruList m_lru;					///< keys cached, least recently used last
+	std::size_t m_maxMemoryUsage;			///< maximum number of bytes of results held in the cache
+	std::size_t m_memoryUsage;			///< number of bytes of results held in the cache
+	std::size_t m_nofHits;				///< number of lookups answered by the cache
+	std::size_t m_nofMisses;			///< number of lookups not answered by the cache
+};
+
+}//namespace
+#endif
+
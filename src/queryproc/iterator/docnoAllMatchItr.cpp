@@ -12,10 +12,22 @@
 #include "private/internationalization.hpp"
 #include "private/errorUtils.hpp"
 
+#include <algorithm>
+
 using namespace strus;
 
+/// \brief Order the arguments by ascending document frequency, so that the leapfrog join starts with the most selective argument
+static std::vector<DocnoAllMatchItr::PostingIteratorReference> orderByAscendingDocumentFrequency(
+		std::vector<DocnoAllMatchItr::PostingIteratorReference>::const_iterator ai,
+		const std::vector<DocnoAllMatchItr::PostingIteratorReference>::const_iterator& ae)
+{
+	std::vector<DocnoAllMatchItr::PostingIteratorReference> rt( orderByDocumentFrequency( ai, ae));
+	std::reverse( rt.begin(), rt.end());
+	return rt;
+}
+
 DocnoAllMatchItr::DocnoAllMatchItr( const std::vector<PostingIteratorReference>& args_)
-	:m_args(orderByDocumentFrequency( args_.begin(), args_.end()))
+	:m_args(orderByAscendingDocumentFrequency( args_.begin(), args_.end()))
 	,m_curdocno(0),m_curdocno_candidate(0)
 {
 	if (m_args.empty()) throw std::runtime_error( _TXT("passed empty set of argument postings to docno all match iterator"));
@@ -24,7 +36,7 @@ DocnoAllMatchItr::DocnoAllMatchItr( const std::vector<PostingIteratorReference>&
 DocnoAllMatchItr::DocnoAllMatchItr(
 		std::vector<PostingIteratorReference>::const_iterator ai,
 		const std::vector<PostingIteratorReference>::const_iterator& ae)
-	:m_args( orderByDocumentFrequency( ai, ae))
+	:m_args( orderByAscendingDocumentFrequency( ai, ae))
 	,m_curdocno(0),m_curdocno_candidate(0)
 {}
 
@@ -99,12 +111,12 @@ Index DocnoAllMatchItr::skipDoc( const Index& docno_)
 
 GlobalCounter DocnoAllMatchItr::maxDocumentFrequency() const
 {
-	return m_args[0]->documentFrequency();
+	return m_args.back()->documentFrequency();
 }
 
 GlobalCounter DocnoAllMatchItr::minDocumentFrequency() const
 {
-	return m_args.back()->documentFrequency();
+	return m_args[0]->documentFrequency();
 }
 
 
@@ -32,6 +32,9 @@ IteratorIntersect::IteratorIntersect( const std::vector<Reference< PostingIterat
 		m_featureid.append( (*ai)->featureid());
 	}
 	m_featureid.push_back( 'I');
+
+	// The feature id is built from the arguments in the order of the query, the positions are matched starting with the argument with the smallest document frequency:
+	m_argar = m_docnoAllMatchItr.args();
 }
 
 IteratorIntersectWithCardinality::IteratorIntersectWithCardinality(
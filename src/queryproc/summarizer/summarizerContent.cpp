@@ -28,7 +28,7 @@ using namespace strus;
 #define THIS_METHOD_NAME const_cast<char*>("content")
 
 SummarizerFunctionContextContent::SummarizerFunctionContextContent( const StorageClientInterface* storage_, const std::string& type_, unsigned int maxNofMatches_, ErrorBufferInterface* errorhnd_)
-	:m_storage(storage_),m_forwardindex(storage_->createForwardIterator(type_))
+	:m_storage(storage_),m_forwardindex(storage_->createForwardIterator(type_)),m_tokens()
 	,m_type(type_),m_maxNofMatches(maxNofMatches_),m_errorhnd(errorhnd_)
 {
 	if (!m_forwardindex.get())
@@ -57,14 +57,13 @@ std::vector<SummaryElement>
 	try
 	{
 		std::vector<SummaryElement> rt;
-		unsigned int cnt = m_maxNofMatches;
 		m_forwardindex->skipDoc( doc.docno());
-		strus::Index pos = m_forwardindex->skipPos( doc.field().start());
-		strus::Index endpos = doc.field().defined() ? doc.field().end() : std::numeric_limits<strus::Index>::max();
-		for (; pos && pos < endpos; pos = m_forwardindex->skipPos( pos+1))
+		m_forwardindex->fetchRange( doc.field(), m_maxNofMatches, m_tokens);
+		rt.reserve( m_tokens.size());
+		std::vector<ForwardIteratorInterface::Token>::const_iterator ti = m_tokens.begin(), te = m_tokens.end();
+		for (; ti != te; ++ti)
 		{
-			rt.push_back( SummaryElement( m_type, m_forwardindex->fetch(), 1.0, pos));
-			if (--cnt == 0) break;
+			rt.push_back( SummaryElement( m_type, ti->value.tostring(), 1.0, ti->pos));
 		}
 		return rt;
 	}
@@ -50,6 +50,7 @@ public:
 private:
 	const StorageClientInterface* m_storage;			///< storage interface
 	Reference<ForwardIteratorInterface> m_forwardindex;		///< forward index iterator
+	std::vector<ForwardIteratorInterface::Token> m_tokens;		///< buffer for the tokens fetched from the forward index
 	std::string m_type;						///< forward index type name
 	unsigned int m_maxNofMatches;					///< maximum number of matches to return
 	ErrorBufferInterface* m_errorhnd;				///< buffer for error messages
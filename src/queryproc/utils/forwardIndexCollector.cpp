@@ -82,17 +82,19 @@ std::string ForwardIndexCollector::fetch()
 	
 	if (m_tagtypeiter.get())
 	{
-		rt.append( m_tagtypeiter->fetch());
+		ForwardIteratorInterface::Slice tag = m_tagtypeiter->fetchSlice();
+		rt.append( tag.ptr(), tag.size());
 		if (m_collectTags.empty() || m_collectTags.find( rt) != m_collectTags.end())
 		{
 			if (m_tagSeparator) rt.push_back( m_tagSeparator);
+			ForwardIteratorInterface::Slice value = m_valueiterar[ m_curidx]->fetchSlice();
 			if (m_stripCharacters.empty())
 			{
-				rt.append( m_valueiterar[ m_curidx]->fetch());
+				rt.append( value.ptr(), value.size());
 			}
 			else
 			{
-				rt.append( strus::stripForwardIndexText( m_valueiterar[ m_curidx]->fetch(), m_stripCharacters));
+				rt.append( strus::stripForwardIndexText( value.tostring(), m_stripCharacters));
 			}
 		}
 		else
@@ -102,9 +104,9 @@ std::string ForwardIndexCollector::fetch()
 	}
 	else
 	{
-		rt.append( m_valueiterar[ m_curidx]->fetch());
+		ForwardIteratorInterface::Slice value = m_valueiterar[ m_curidx]->fetchSlice();
+		rt.append( value.ptr(), value.size());
 	}
 	return rt;
 }
 
-
@@ -10,6 +10,7 @@
 #include "strus/errorBufferInterface.hpp"
 #include "strus/storageClientInterface.hpp"
 #include <limits>
+#include <cstring>
 
 using namespace strus;
 
@@ -21,6 +22,7 @@ ForwardIndexTextCollector::ForwardIndexTextCollector(
 		const std::string& entityType,
 		ErrorBufferInterface* errorhnd_)
 	:m_storage(storage_),m_textiter(),m_entityiter()
+	,m_texttokens(),m_entitytokens()
 	,m_errorhnd(errorhnd_)
 {
 	if (!textType.empty())
@@ -43,7 +45,8 @@ ForwardIndexTextCollector::ForwardIndexTextCollector(
 		const StorageClientInterface* storage_,
 		const std::string& textType,
 		ErrorBufferInterface* errorhnd_)
-	:m_storage(storage_),m_textiter(),m_entityiter(),m_errorhnd(errorhnd_)
+	:m_storage(storage_),m_textiter(),m_entityiter()
+	,m_texttokens(),m_entitytokens(),m_errorhnd(errorhnd_)
 {
 	if (!textType.empty())
 	{
@@ -68,28 +71,35 @@ static const char* g_closeEntityBracket = "]";
 std::string ForwardIndexTextCollector::fetch( const strus::IndexRange& field)
 {
 	std::string rt;
-	strus::Index pos = m_textiter->skipPos( field.start());
-	strus::Index endpos = field.defined() ? field.end() : std::numeric_limits<strus::Index>::max();
-	for (; pos && pos < endpos; pos = m_textiter->skipPos( pos+1))
+	m_textiter->fetchRange( field, 0/*no limit*/, m_texttokens);
+	if (m_entityiter.get())
+	{
+		m_entityiter->fetchRange( field, 0/*no limit*/, m_entitytokens);
+	}
+	else
+	{
+		m_entitytokens.clear();
+	}
+	std::vector<ForwardIteratorInterface::Token>::const_iterator
+		ti = m_texttokens.begin(), te = m_texttokens.end(),
+		ei = m_entitytokens.begin(), ee = m_entitytokens.end();
+	for (; ti != te; ++ti)
 	{
-		std::string textstr = m_textiter->fetch();
-		if (m_entityiter.get())
+		for (; ei != ee && ei->pos < ti->pos; ++ei){}
+		if (ei != ee && ei->pos == ti->pos)
 		{
-			strus::Index epos = m_entityiter->skipPos( pos);
-			if (pos == epos)
+			const ForwardIteratorInterface::Slice& text = ti->value;
+			const ForwardIteratorInterface::Slice& entity = ei->value;
+			if (text.size() != entity.size() || 0!=std::memcmp( text.ptr(), entity.ptr(), text.size()))
 			{
-				std::string entitystr = m_entityiter->fetch();
-				if (textstr != entitystr)
-				{
-					if (!rt.empty() && rt[ rt.size()-1] != ' ') rt.push_back(' ');
-					rt.append( g_openEntityBracket);
-					rt.append( entitystr);
-					rt.append( g_closeEntityBracket);
-				}
+				if (!rt.empty() && rt[ rt.size()-1] != ' ') rt.push_back(' ');
+				rt.append( g_openEntityBracket);
+				rt.append( entity.ptr(), entity.size());
+				rt.append( g_closeEntityBracket);
 			}
 		}
 		if (!rt.empty() && rt[ rt.size()-1] != ' ') rt.push_back(' ');
-		rt.append( textstr);
+		rt.append( ti->value.ptr(), ti->value.size());
 	}
 	return rt;
 }
@@ -39,6 +39,7 @@ public:
 	ForwardIndexTextCollector( const ForwardIndexTextCollector& o)
 		:m_storage(o.m_storage)
 		,m_textiter(o.m_textiter),m_entityiter(o.m_entityiter)
+		,m_texttokens(),m_entitytokens()
 		,m_errorhnd(o.m_errorhnd){}
 
 	void skipDoc( strus::Index docno);
@@ -51,6 +52,8 @@ private:
 	typedef strus::Reference<ForwardIteratorInterface> ForwardIteratorRef;
 	ForwardIteratorRef m_textiter;
 	ForwardIteratorRef m_entityiter;
+	std::vector<ForwardIteratorInterface::Token> m_texttokens;	///< buffer for the text tokens of a range fetched
+	std::vector<ForwardIteratorInterface::Token> m_entitytokens;	///< buffer for the entity tokens of a range fetched
 	ErrorBufferInterface* m_errorhnd;
 };
 
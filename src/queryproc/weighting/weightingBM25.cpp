@@ -16,6 +16,7 @@
 #include "strus/base/math.hpp"
 #include "viewUtils.hpp"
 #include <ctime>
+#include <limits>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -35,6 +36,8 @@ WeightingFunctionContextBM25::WeightingFunctionContextBM25(
 	,m_metadata(storage->createMetaDataReader())
 	,m_metadata_doclen(-1)
 	,m_lastResult()
+	,m_batchNorm()
+	,m_batchFf()
 	,m_errorhnd(errorhnd_)
 {
 	if (!m_metadata.get())
@@ -131,6 +134,142 @@ const std::vector<WeightedField>& WeightingFunctionContextBM25::call( const Inde
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, m_lastResult);
 }
 
+bool WeightingFunctionContextBM25::callBatch( const Index* docnos, std::size_t nofdocnos, double* weights)
+{
+	try
+	{
+		m_batchNorm.resize( nofdocnos);
+		m_batchFf.resize( nofdocnos);
+		double* norm = m_batchNorm.data();
+		double* ff = m_batchFf.data();
+		std::size_t di;
+
+		// Document length normalization of the denominator, same expression as in featureWeight:
+		if (m_parameter.b)
+		{
+			for (di=0; di < nofdocnos; ++di)
+			{
+				m_metadata->skipDoc( docnos[ di]);
+				norm[ di] = m_metadata->getValue( m_metadata_doclen);
+			}
+			for (di=0; di < nofdocnos; ++di)
+			{
+				double rel_doclen = norm[ di] / m_parameter.avgDocLength;
+				norm[ di] = m_parameter.k1 * (1.0 - m_parameter.b + m_parameter.b * rel_doclen);
+			}
+		}
+		else
+		{
+			for (di=0; di < nofdocnos; ++di)
+			{
+				norm[ di] = m_parameter.k1 * 1.0;
+			}
+		}
+		for (di=0; di < nofdocnos; ++di)
+		{
+			weights[ di] = 0.0;
+		}
+		std::vector<Feature>::const_iterator fi = m_featar.begin(), fe = m_featar.end();
+		for ( ;fi != fe; ++fi)
+		{
+			for (di=0; di < nofdocnos; ++di)
+			{
+				ff[ di] = (docnos[ di] == fi->itr->skipDoc( docnos[ di])) ? (double)fi->itr->frequency() : 0.0;
+			}
+			double featweight = fi->weight * fi->idf;
+			for (di=0; di < nofdocnos; ++di)
+			{
+				double fw = featweight * (ff[ di] * (m_parameter.k1 + 1.0)) / (ff[ di] + norm[ di]);
+				weights[ di] += (ff[ di] == 0.0) ? 0.0 : fw;
+			}
+		}
+		return true;
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, false);
+}
+
+/// \brief Evaluate if the term frequency part of the formula is bounded by (k1+1) with the parameters given
+/// \note A non positive average document length makes the document length normalization negative or undefined
+static bool isBoundedWeight( const WeightingFunctionParameterBM25& parameter)
+{
+	return parameter.b >= 0.0 && parameter.b <= 1.0 && parameter.k1 >= 0.0
+		&& (!parameter.b || parameter.avgDocLength > 0.0);
+}
+
+double WeightingFunctionContextBM25::maxWeight() const
+{
+	if (!isBoundedWeight( m_parameter))
+	{
+		// ... the term frequency part of the formula is not bounded by (k1+1) in this case
+		return std::numeric_limits<double>::infinity();
+	}
+	double rt = 0.0;
+	std::vector<Feature>::const_iterator fi = m_featar.begin(), fe = m_featar.end();
+	for ( ;fi != fe; ++fi)
+	{
+		double fw = fi->weight * fi->idf * (m_parameter.k1 + 1.0);
+		if (fw > 0.0) rt += fw;
+	}
+	return rt;
+}
+
+double WeightingFunctionContextBM25::maxWeightRange( const Index& docno, Index& lastdocno)
+{
+	try
+	{
+		lastdocno = std::numeric_limits<Index>::max();
+		if (!isBoundedWeight( m_parameter))
+		{
+			return std::numeric_limits<double>::infinity();
+		}
+		double rt = 0.0;
+		std::vector<Feature>::const_iterator fi = m_featar.begin(), fe = m_featar.end();
+		for ( ;fi != fe; ++fi)
+		{
+			if (fi->weight * fi->idf <= 0.0) continue;
+
+			// The iterator is positioned to inspect the block summary, its previous position is restored afterwards:
+			Index prevdn = fi->itr->docno();
+			Index dn = fi->itr->skipDoc( docno);
+			if (!dn)
+			{
+				//... no more matches, the feature does not contribute anymore
+			}
+			else if (dn > docno)
+			{
+				//... no match before dn, the feature does not contribute in the range [docno,dn-1]
+				if (lastdocno >= dn) lastdocno = dn-1;
+			}
+			else
+			{
+				PostingBlockSummary blksum = fi->itr->blockSummary();
+				if (blksum.defined())
+				{
+					// Use the maximum ff of the block and the document length lower bound 0:
+					double ff = blksum.maxff();
+					if (ff > 0.0)
+					{
+						rt += fi->weight * fi->idf
+							* (ff * (m_parameter.k1 + 1.0))
+							/ (ff + m_parameter.k1 * (1.0 - m_parameter.b));
+					}
+					if (lastdocno > blksum.lastdocno()) lastdocno = blksum.lastdocno();
+				}
+				else
+				{
+					rt += fi->weight * fi->idf * (m_parameter.k1 + 1.0);
+				}
+			}
+			if (prevdn && prevdn != dn)
+			{
+				fi->itr->skipDoc( prevdn);
+			}
+		}
+		return rt;
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, std::numeric_limits<double>::infinity());
+}
+
 static NumericVariant parameterValue( const std::string& name_, const std::string& value)
 {
 	NumericVariant rt;
@@ -77,6 +77,16 @@ public:
 
 	virtual const std::vector<WeightedField>& call( const Index& docno);
 
+	virtual bool batchCapable() const
+	{
+		return true;
+	}
+	virtual bool callBatch( const Index* docnos, std::size_t nofdocnos, double* weights);
+
+	virtual double maxWeight() const;
+
+	virtual double maxWeightRange( const Index& docno, Index& lastdocno);
+
 private:
 	double featureWeight( const Feature& feat, strus::Index docno);
 
@@ -87,6 +97,8 @@ private:
 	strus::Reference<MetaDataReaderInterface> m_metadata;
 	int m_metadata_doclen;					///< metadata element handle for the ducmnet length
 	std::vector<WeightedField> m_lastResult;		///< buffer for the last result calculated
+	std::vector<double> m_batchNorm;			///< buffer for the document length normalization of the documents of a batch
+	std::vector<double> m_batchFf;				///< buffer for the feature frequencies of the documents of a batch
 	ErrorBufferInterface* m_errorhnd;			///< buffer for error messages
 };
 
@@ -47,6 +47,9 @@ WeightingFunctionContextBM25pff::WeightingFunctionContextBM25pff(
 	,m_structno(0)
 	,m_nofCollectionDocuments(nofCollectionDocuments_)
 	,m_storage(storage)
+	,m_lastResult()
+	,m_batchDoclen()
+	,m_batchFf()
 	,m_errorhnd(errorhnd_)
 {
 	if (!m_structitr.get())
@@ -209,6 +212,58 @@ const std::vector<WeightedField>& WeightingFunctionContextBM25pff::call( const I
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, m_lastResult);
 }
 
+bool WeightingFunctionContextBM25pff::callBatch( const Index* docnos, std::size_t nofdocnos, double* weights)
+{
+	if (m_itrarsize > 1)
+	{
+		//... more than one relevant feature, the proximity weighting with fields is evaluated document by document
+		return WeightingFunctionContextInterface::callBatch( docnos, nofdocnos, weights);
+	}
+	try
+	{
+		//... only one relevant feature, fallback to BM25 as in 'call'
+		m_batchDoclen.resize( nofdocnos);
+		m_batchFf.resize( nofdocnos);
+		int* doclen = m_batchDoclen.data();
+		double* ff = m_batchFf.data();
+		std::size_t di;
+
+		for (di=0; di < nofdocnos; ++di)
+		{
+			m_metadata->skipDoc( docnos[ di]);
+			doclen[ di] = m_metadata->getValue( m_metadata_doclen).toint();
+			weights[ di] = 0.0;
+		}
+		std::size_t pi,pe;
+		for (pi=0,pe=m_itrarsize; pi<pe; ++pi)
+		{
+			for (di=0; di < nofdocnos; ++di)
+			{
+				m_itrar[ pi]->skipDoc( docnos[ di]);
+				ff[ di] = m_itrar[ pi]->frequency();
+			}
+			for (di=0; di < nofdocnos; ++di)
+			{
+				weights[ di] += m_parameter.postingsWeight( doclen[ di], m_weightar[ pi], ff[ di]);
+			}
+		}
+		for (pi=0,pe=m_stopword_itrarsize; pi<pe; ++pi)
+		{
+			for (di=0; di < nofdocnos; ++di)
+			{
+				m_stopword_itrar[ pi]->skipDoc( docnos[ di]);
+				ff[ di] = m_stopword_itrar[ pi]->frequency();
+			}
+			for (di=0; di < nofdocnos; ++di)
+			{
+				weights[ di] += m_parameter.postingsWeight( doclen[ di], m_stopword_weightar[ pi], ff[ di]);
+			}
+		}
+		return true;
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, false);
+}
+
 static NumericVariant parameterValue( const std::string& name_, const std::string& value)
 {
 	NumericVariant rt;
@@ -81,6 +81,13 @@ public:
 
 	virtual const std::vector<WeightedField>& call( const Index& docno);
 
+	virtual bool batchCapable() const
+	{
+		//... with more than one relevant feature the proximity weighting returns fields
+		return m_itrarsize <= 1;
+	}
+	virtual bool callBatch( const Index* docnos, std::size_t nofdocnos, double* weights);
+
 public:
 	enum {MaxNofArguments=ProximityWeightingContext::MaxNofArguments};	///< maximum number of arguments fix because of extensive use of fixed size arrays
 	typedef ProximityWeightingContext::FeatureWeights FeatureWeights;
@@ -103,6 +110,8 @@ private:
 	double m_nofCollectionDocuments;				///< number of documents in the collection
 	const StorageClientInterface* m_storage;			///< storage client interface
 	std::vector<WeightedField> m_lastResult;			///< buffer for the last result calculated
+	std::vector<int> m_batchDoclen;					///< buffer for the document lengths of the documents of a batch
+	std::vector<double> m_batchFf;					///< buffer for the feature frequencies of the documents of a batch
 	ErrorBufferInterface* m_errorhnd;				///< buffer for error reporting
 };
 
@@ -92,6 +92,57 @@ const std::vector<WeightedField>& WeightingFunctionContextConstant::call( const
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, m_lastResult);
 }
 
+bool WeightingFunctionContextConstant::callBatch( const Index* docnos, std::size_t nofdocnos, double* weights)
+{
+	try
+	{
+		std::size_t di;
+		if (m_precalc)
+		{
+			// ... the document numbers are ascending, so we can walk through the map instead of searching every document
+			std::map<Index,double>::const_iterator mi = m_precalcmap.begin(), me = m_precalcmap.end();
+			for (di=0; di < nofdocnos; ++di)
+			{
+				while (mi != me && mi->first < docnos[ di]) ++mi;
+				weights[ di] = (mi != me && mi->first == docnos[ di]) ? mi->second : 0.0;
+			}
+		}
+		else
+		{
+			for (di=0; di < nofdocnos; ++di)
+			{
+				weights[ di] = 0.0;
+			}
+			std::vector<Feature>::const_iterator fi = m_featar.begin(), fe = m_featar.end();
+			for (;fi != fe; ++fi)
+			{
+				double fw = fi->weight * m_weight;
+				for (di=0; di < nofdocnos; ++di)
+				{
+					if (docnos[ di]==fi->itr->skipDoc( docnos[ di]))
+					{
+						weights[ di] += fw;
+					}
+				}
+			}
+		}
+		return true;
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, false);
+}
+
+double WeightingFunctionContextConstant::maxWeight() const
+{
+	double rt = 0.0;
+	std::vector<Feature>::const_iterator fi = m_featar.begin(), fe = m_featar.end();
+	for (;fi != fe; ++fi)
+	{
+		double fw = fi->weight * m_weight;
+		if (fw > 0.0) rt += fw;
+	}
+	return rt;
+}
+
 static NumericVariant parameterValue( const std::string& name_, const std::string& value)
 {
 	NumericVariant rt;
@@ -56,6 +56,14 @@ public:
 
 	virtual const std::vector<WeightedField>& call( const Index& docno);
 
+	virtual bool batchCapable() const
+	{
+		return true;
+	}
+	virtual bool callBatch( const Index* docnos, std::size_t nofdocnos, double* weights);
+
+	virtual double maxWeight() const;
+
 private:
 	std::vector<Feature> m_featar;
 	float m_weight;
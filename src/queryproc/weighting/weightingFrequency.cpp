@@ -68,6 +68,31 @@ const std::vector<WeightedField>& WeightingFunctionContextTermFrequency::call( c
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, m_lastResult);
 }
 
+bool WeightingFunctionContextTermFrequency::callBatch( const Index* docnos, std::size_t nofdocnos, double* weights)
+{
+	try
+	{
+		std::size_t di;
+		for (di=0; di < nofdocnos; ++di)
+		{
+			weights[ di] = 0.0;
+		}
+		std::vector<Feature>::const_iterator fi = m_featar.begin(), fe = m_featar.end();
+		for (;fi != fe; ++fi)
+		{
+			for (di=0; di < nofdocnos; ++di)
+			{
+				if (docnos[ di]==fi->itr->skipDoc( docnos[ di]))
+				{
+					weights[ di] += fi->weight * fi->itr->frequency();
+				}
+			}
+		}
+		return true;
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, false);
+}
+
 static NumericVariant parameterValue( const std::string& name_, const std::string& value)
 {
 	NumericVariant rt;
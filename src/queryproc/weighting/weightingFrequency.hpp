@@ -50,6 +50,12 @@ public:
 
 	virtual const std::vector<WeightedField>& call( const Index& docno);
 
+	virtual bool batchCapable() const
+	{
+		return true;
+	}
+	virtual bool callBatch( const Index* docnos, std::size_t nofdocnos, double* weights);
+
 private:
 	std::vector<Feature> m_featar;
 	std::vector<WeightedField> m_lastResult;	///< buffer for the last result calculated
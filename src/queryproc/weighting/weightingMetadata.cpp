@@ -63,6 +63,20 @@ const std::vector<WeightedField>& WeightingFunctionContextMetadata::call( const
 	return m_lastResult;
 }
 
+bool WeightingFunctionContextMetadata::callBatch( const Index* docnos, std::size_t nofdocnos, double* weights)
+{
+	for (std::size_t di=0; di < nofdocnos; ++di)
+	{
+		m_metadata->skipDoc( docnos[ di]);
+		weights[ di] = (double)m_metadata->getValue( m_elementHandle);
+	}
+	for (std::size_t di=0; di < nofdocnos; ++di)
+	{
+		weights[ di] = m_weight * weights[ di];
+	}
+	return true;
+}
+
 static NumericVariant parameterValue( const std::string& name_, const std::string& value)
 {
 	NumericVariant rt;
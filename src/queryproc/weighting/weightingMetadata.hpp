@@ -48,6 +48,12 @@ public:
 
 	virtual const std::vector<WeightedField>& call( const Index& docno);
 
+	virtual bool batchCapable() const
+	{
+		return true;
+	}
+	virtual bool callBatch( const Index* docnos, std::size_t nofdocnos, double* weights);
+
 private:
 	strus::Reference<MetaDataReaderInterface> m_metadata;
 	Index m_elementHandle;
@@ -40,6 +40,7 @@ WeightingFunctionContextScalar::WeightingFunctionContextScalar(
 	,m_metadatahnd(metadatahnd_)
 	,m_nofCollectionDocuments(nofCollectionDocuments_)
 	,m_lastResult()
+	,m_batchParameter()
 	,m_errorhnd(errorhnd_)
 {
 	if (!m_func.get())
@@ -97,6 +98,38 @@ const std::vector<WeightedField>& WeightingFunctionContextScalar::call( const In
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, m_lastResult);
 }
 
+bool WeightingFunctionContextScalar::callBatch( const Index* docnos, std::size_t nofdocnos, double* weights)
+{
+	try
+	{
+		unsigned int nofParam = m_metadatahnd.size()+NOF_IMPLICIT_ARGUMENTS;
+		double param[ MaxNofParameter+NOF_IMPLICIT_ARGUMENTS];
+		if (m_metadatahnd.empty())
+		{
+			// ... no document dependent parameters, the result is the same for all documents
+			fillParameter( param);
+			double ww = m_func->call( param, nofParam);
+			for (std::size_t di=0; di < nofdocnos; ++di)
+			{
+				weights[ di] = ww;
+			}
+		}
+		else
+		{
+			// ... gather the argument tuples of all documents and evaluate the function for all of them in one call
+			m_batchParameter.resize( nofdocnos * nofParam);
+			for (std::size_t di=0; di < nofdocnos; ++di)
+			{
+				m_metadata->skipDoc( docnos[ di]);
+				fillParameter( m_batchParameter.data() + di * nofParam);
+			}
+			m_func->callBatch( m_batchParameter.data(), nofParam, nofdocnos, weights);
+		}
+		return true;
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error calling weighting function '%s': %s"), THIS_METHOD_NAME, *m_errorhnd, false);
+}
+
 void WeightingFunctionInstanceScalar::addStringParameter( const std::string& name_, const std::string& value)
 {
 	try
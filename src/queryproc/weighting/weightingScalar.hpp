@@ -58,6 +58,12 @@ public:
 
 	virtual const std::vector<WeightedField>& call( const Index& docno);
 
+	virtual bool batchCapable() const
+	{
+		return true;
+	}
+	virtual bool callBatch( const Index* docnos, std::size_t nofdocnos, double* weights);
+
 public:
 	enum {MaxNofParameter=64};				///< maximum number of arguments passed to the defined function
 
@@ -70,6 +76,7 @@ private:
 	std::vector<Index> m_metadatahnd;			///< array of meta data element handles feeded to the function
 	double m_nofCollectionDocuments;			///< document collection size
 	std::vector<WeightedField> m_lastResult;		///< buffer for the last result calculated
+	std::vector<double> m_batchParameter;			///< buffer for the argument tuples of a batch call
 	ErrorBufferInterface* m_errorhnd;			///< buffer for error messages
 };
 
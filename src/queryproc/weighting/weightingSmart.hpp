@@ -93,6 +93,11 @@ public:
 
 	virtual const std::vector<WeightedField>& call( const Index& docno);
 
+	virtual bool batchCapable() const
+	{
+		return true;
+	}
+
 public:
 	enum {MaxNofParameter=64};				///< maximum number of arguments passed to the defined function
 
@@ -23,11 +23,56 @@ void ScalarFunctionInstance::setVariableValue( const std::string& name_, double
 	try
 	{
 		m_valuear[ m_func->getVariableIndex( name_)] = value;
+		compile();
 	}
 	CATCH_ERROR_MAP( _TXT("error setting scalar function variable value: %s"), *m_errorhnd);
 }
 
+void ScalarFunctionInstance::compile()
+{
+	try
+	{
+		m_program.compile( m_func, m_valuear);
+		m_compiled = true;
+	}
+	catch (const std::runtime_error&)
+	{
+		//... functions that cannot be compiled are executed by the interpreter that reports the error on call
+		m_compiled = false;
+	}
+}
+
 double ScalarFunctionInstance::call( const double* args, unsigned int nofargs) const
+{
+	return execute( args, nofargs, m_compiled);
+}
+
+void ScalarFunctionInstance::callBatch( const double* args, unsigned int nofargs, std::size_t nofcalls, double* results) const
+{
+	try
+	{
+		if (nofargs < m_nof_args)
+		{
+			throw strus::runtime_error( _TXT("too few arguments passed to scalar function (%u < %u)"), (unsigned int)nofargs, (unsigned int)m_nof_args);
+		}
+		if (m_compiled)
+		{
+			m_program.callBatch( args, nofargs, nofcalls, results);
+		}
+		else for (std::size_t ci=0; ci < nofcalls; ++ci)
+		{
+			results[ ci] = interpret( args + ci * nofargs, nofargs);
+		}
+	}
+	CATCH_ERROR_MAP( _TXT("error executing scalar function: %s"), *m_errorhnd);
+}
+
+double ScalarFunctionInstance::interpret( const double* args, unsigned int nofargs) const
+{
+	return execute( args, nofargs, false);
+}
+
+double ScalarFunctionInstance::execute( const double* args, unsigned int nofargs, bool useProgram) const
 {
 	try
 	{
@@ -35,6 +80,10 @@ double ScalarFunctionInstance::call( const double* args, unsigned int nofargs) c
 		{
 			throw strus::runtime_error( _TXT("too few arguments passed to scalar function (%u < %u)"), (unsigned int)nofargs, (unsigned int)m_nof_args);
 		}
+		if (useProgram)
+		{
+			return m_program.call( args);
+		}
 		std::size_t ip = 0;
 		std::vector<double> stk;
 		std::size_t idxreg = 0;
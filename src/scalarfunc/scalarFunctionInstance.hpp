@@ -11,6 +11,7 @@
 #define _STRUS_SCALAR_FUNCTION_INSTANCE_IMPLEMENTATION_HPP_INCLUDED
 #include "strus/scalarFunctionInstanceInterface.hpp"
 #include "scalarFunction.hpp"
+#include "scalarFunctionProgram.hpp"
 
 namespace strus
 {
@@ -23,22 +24,42 @@ class ScalarFunctionInstance
 {
 public:
 	ScalarFunctionInstance( const ScalarFunction* func_, const std::vector<double>& valuear_, std::size_t nof_args_, ErrorBufferInterface* errorhnd_)
-		:m_errorhnd(errorhnd_),m_func(func_),m_valuear(valuear_),m_nof_args(nof_args_){}
+		:m_errorhnd(errorhnd_),m_func(func_),m_valuear(valuear_),m_nof_args(nof_args_),m_program(),m_compiled(false)
+	{
+		compile();
+	}
 
 	virtual ~ScalarFunctionInstance(){}
 
 	virtual void setVariableValue( const std::string& name, double value);
 
 	virtual double call( const double* args, unsigned int nofargs) const;
+	virtual void callBatch( const double* args, unsigned int nofargs, std::size_t nofcalls, double* results) const;
+
+	/// \brief Execute the function with the stack machine interpreter instead of the compiled program
+	/// \note Used as fallback and as reference for the compiled program
+	double interpret( const double* args, unsigned int nofargs) const;
+
+	/// \brief Evaluate if the function is executed as compiled program
+	bool compiled() const
+	{
+		return m_compiled;
+	}
 
 	virtual const char* name() const {return "scalar";}
 	virtual StructView view() const;
 
+private:
+	void compile();
+	double execute( const double* args, unsigned int nofargs, bool useProgram) const;
+
 private:
 	ErrorBufferInterface* m_errorhnd;
 	const ScalarFunction* m_func;
 	std::vector<double> m_valuear;
 	std::size_t m_nof_args;
+	ScalarFunctionProgram m_program;	///< function compiled with the current variable values
+	bool m_compiled;			///< true, if m_program is valid, false if the interpreter is used
 };
 
 } //namespace
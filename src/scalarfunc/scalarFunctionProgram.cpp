@@ -0,0 +1,325 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Scalar function compiled from the stack machine code to register code with constants folded
+/// \file scalarFunctionProgram.cpp
+#include "scalarFunctionProgram.hpp"
+#include "strus/base/math.hpp"
+#include "private/internationalization.hpp"
+#include <limits>
+#include <stdexcept>
+
+using namespace strus;
+
+/// \brief Number of argument tuples evaluated together in one pass through the instructions in a batch call
+#define BATCH_CHUNK_SIZE 64
+
+static inline bool isZero( double val)
+{
+	return strus::Math::abs( val) < std::numeric_limits<double>::epsilon();
+}
+
+/// \brief Division with the same rules as the interpreter (ScalarFunctionInstance::interpret)
+static inline double divide( double a1, double a2)
+{
+	if (isZero( a1))
+	{
+		return 0.0;
+	}
+	else if (isZero( a2))
+	{
+		throw std::runtime_error( _TXT("division by zero"));
+	}
+	return a1 / a2;
+}
+
+void ScalarFunctionProgram::emitArithmetic( std::vector<Operand>& stk, OpType op)
+{
+	if (stk.size() < 2) throw std::runtime_error( _TXT("illegal stack operation"));
+	std::size_t res = stk.size()-2;
+	const Operand& a1 = stk[ res];
+	const Operand& a2 = stk[ res+1];
+	if (a1.type == ConstOperand && a2.type == ConstOperand
+		&& (op != OpDiv || isZero( a1.value) || !isZero( a2.value)))
+	{
+		double value = 0.0;
+		switch (op)
+		{
+			case OpAdd: value = a1.value + a2.value; break;
+			case OpSub: value = a1.value - a2.value; break;
+			case OpDiv: value = divide( a1.value, a2.value); break;
+			case OpMul: value = a1.value * a2.value; break;
+			default: throw std::runtime_error( _TXT("illegal operation in scalar function compilation"));
+		}
+		stk.resize( res);
+		stk.push_back( Operand( ConstOperand, 0, value));
+	}
+	else
+	{
+		//... a division by a constant zero is not folded to report the error at runtime as the interpreter does
+		m_code.push_back( Instruction( op, res, a1, a2));
+		stk.resize( res);
+		stk.push_back( Operand( RegisterOperand, res, 0.0));
+	}
+}
+
+void ScalarFunctionProgram::compile( const ScalarFunction* func, const std::vector<double>& valuear)
+{
+	m_code.clear();
+	m_nofRegisters = 0;
+	m_result = Operand();
+
+	std::vector<Operand> stk;
+	std::size_t idxreg = 0;
+	for (std::size_t ip=0; func->hasInstruction(ip); ++ip)
+	{
+		switch (func->opCode(ip))
+		{
+			case ScalarFunction::OpLdCnt:
+			{
+				idxreg = func->getIndexOperand( ip, stk.size()+1);
+				break;
+			}
+			case ScalarFunction::OpPush:
+			{
+				std::size_t validx = func->getIndexOperand( ip, valuear.size());
+				stk.push_back( Operand( ConstOperand, 0, valuear[ validx]));
+				break;
+			}
+			case ScalarFunction::OpArg:
+			{
+				stk.push_back( Operand( ArgOperand, func->getIndexOperand( ip), 0.0));
+				break;
+			}
+			case ScalarFunction::OpNeg:
+			{
+				if (stk.size() < 1) throw std::runtime_error( _TXT("illegal stack operation"));
+				if (stk.back().type == ConstOperand)
+				{
+					stk.back().value = -stk.back().value;
+				}
+				else
+				{
+					std::size_t res = stk.size()-1;
+					m_code.push_back( Instruction( OpNeg, res, stk.back(), Operand()));
+					stk.back() = Operand( RegisterOperand, res, 0.0);
+				}
+				break;
+			}
+			case ScalarFunction::OpAdd:
+				emitArithmetic( stk, OpAdd);
+				break;
+			case ScalarFunction::OpSub:
+				emitArithmetic( stk, OpSub);
+				break;
+			case ScalarFunction::OpDiv:
+				emitArithmetic( stk, OpDiv);
+				break;
+			case ScalarFunction::OpMul:
+				emitArithmetic( stk, OpMul);
+				break;
+			case ScalarFunction::FuncUnary:
+			{
+				if (stk.size() < 1) throw std::runtime_error( _TXT("illegal stack operation"));
+				ScalarFunction::UnaryFunction unfunc = func->getUnaryFunctionOperand( ip);
+				if (stk.back().type == ConstOperand)
+				{
+					stk.back().value = unfunc( stk.back().value);
+				}
+				else
+				{
+					std::size_t res = stk.size()-1;
+					m_code.push_back( Instruction( OpUnary, res, stk.back(), Operand()));
+					m_code.back().unfunc = unfunc;
+					stk.back() = Operand( RegisterOperand, res, 0.0);
+				}
+				break;
+			}
+			case ScalarFunction::FuncBinary:
+			{
+				if (stk.size() < 2) throw std::runtime_error( _TXT("illegal stack operation"));
+				ScalarFunction::BinaryFunction binfunc = func->getBinaryFunctionOperand( ip);
+				std::size_t res = stk.size()-2;
+				const Operand& a1 = stk[ res];
+				const Operand& a2 = stk[ res+1];
+				if (a1.type == ConstOperand && a2.type == ConstOperand)
+				{
+					double value = binfunc( a1.value, a2.value);
+					stk.resize( res);
+					stk.push_back( Operand( ConstOperand, 0, value));
+				}
+				else
+				{
+					m_code.push_back( Instruction( OpBinary, res, a1, a2));
+					m_code.back().binfunc = binfunc;
+					stk.resize( res);
+					stk.push_back( Operand( RegisterOperand, res, 0.0));
+				}
+				break;
+			}
+			case ScalarFunction::FuncNary:
+			{
+				if (stk.size() < idxreg) throw std::runtime_error( _TXT("illegal stack operation"));
+				ScalarFunction::NaryFunction nfunc = func->getNaryFunctionOperand( ip);
+				std::size_t base = stk.size() - idxreg;
+				std::size_t ai = base, ae = stk.size();
+				for (; ai != ae && stk[ ai].type == ConstOperand; ++ai){}
+				if (ai == ae)
+				{
+					std::vector<double> args;
+					for (ai = base; ai != ae; ++ai)
+					{
+						args.push_back( stk[ ai].value);
+					}
+					double value = nfunc( idxreg, args.empty() ? 0 : args.data());
+					stk.resize( base);
+					stk.push_back( Operand( ConstOperand, 0, value));
+				}
+				else
+				{
+					// The arguments of an N-ary function have to be in consecutive registers:
+					for (ai = base; ai != ae; ++ai)
+					{
+						if (stk[ ai].type != RegisterOperand)
+						{
+							m_code.push_back( Instruction( OpLoad, ai, stk[ ai], Operand()));
+						}
+					}
+					if (ae > m_nofRegisters) m_nofRegisters = ae;
+					m_code.push_back( Instruction( OpNary, base, Operand(), Operand()));
+					m_code.back().nfunc = nfunc;
+					m_code.back().nofargs = idxreg;
+					stk.resize( base);
+					stk.push_back( Operand( RegisterOperand, base, 0.0));
+				}
+				break;
+			}
+		}
+		if (!m_code.empty() && m_code.back().res >= m_nofRegisters)
+		{
+			m_nofRegisters = m_code.back().res+1;
+		}
+	}
+	if (m_nofRegisters > (std::size_t)MaxNofRegisters)
+	{
+		throw std::runtime_error( _TXT("scalar function too complex to compile"));
+	}
+	if (!stk.empty())
+	{
+		m_result = stk.back();
+	}
+}
+
+double ScalarFunctionProgram::call( const double* args) const
+{
+	double registers[ MaxNofRegisters];
+	std::vector<Instruction>::const_iterator ci = m_code.begin(), ce = m_code.end();
+	for (; ci != ce; ++ci)
+	{
+		switch (ci->op)
+		{
+			case OpLoad:
+				registers[ ci->res] = ci->a.get( args, registers);
+				break;
+			case OpNeg:
+				registers[ ci->res] = -ci->a.get( args, registers);
+				break;
+			case OpAdd:
+				registers[ ci->res] = ci->a.get( args, registers) + ci->b.get( args, registers);
+				break;
+			case OpSub:
+				registers[ ci->res] = ci->a.get( args, registers) - ci->b.get( args, registers);
+				break;
+			case OpDiv:
+				registers[ ci->res] = divide( ci->a.get( args, registers), ci->b.get( args, registers));
+				break;
+			case OpMul:
+				registers[ ci->res] = ci->a.get( args, registers) * ci->b.get( args, registers);
+				break;
+			case OpUnary:
+				registers[ ci->res] = ci->unfunc( ci->a.get( args, registers));
+				break;
+			case OpBinary:
+				registers[ ci->res] = ci->binfunc( ci->a.get( args, registers), ci->b.get( args, registers));
+				break;
+			case OpNary:
+				registers[ ci->res] = ci->nfunc( ci->nofargs, registers + ci->res);
+				break;
+		}
+	}
+	return m_result.get( args, registers);
+}
+
+void ScalarFunctionProgram::callChunk( const double* args, unsigned int nofargs, std::size_t nofcalls, double* results, double* registers) const
+{
+	std::size_t ii;
+	std::vector<Instruction>::const_iterator ci = m_code.begin(), ce = m_code.end();
+	for (; ci != ce; ++ci)
+	{
+		double* res = registers + ci->res * BATCH_CHUNK_SIZE;
+		std::size_t astride;
+		std::size_t bstride;
+		const double* aptr = ci->a.array( astride, args, nofargs, registers, BATCH_CHUNK_SIZE);
+		const double* bptr = ci->b.array( bstride, args, nofargs, registers, BATCH_CHUNK_SIZE);
+		switch (ci->op)
+		{
+			case OpLoad:
+				for (ii=0; ii<nofcalls; ++ii) res[ ii] = aptr[ ii*astride];
+				break;
+			case OpNeg:
+				for (ii=0; ii<nofcalls; ++ii) res[ ii] = -aptr[ ii*astride];
+				break;
+			case OpAdd:
+				for (ii=0; ii<nofcalls; ++ii) res[ ii] = aptr[ ii*astride] + bptr[ ii*bstride];
+				break;
+			case OpSub:
+				for (ii=0; ii<nofcalls; ++ii) res[ ii] = aptr[ ii*astride] - bptr[ ii*bstride];
+				break;
+			case OpDiv:
+				for (ii=0; ii<nofcalls; ++ii) res[ ii] = divide( aptr[ ii*astride], bptr[ ii*bstride]);
+				break;
+			case OpMul:
+				for (ii=0; ii<nofcalls; ++ii) res[ ii] = aptr[ ii*astride] * bptr[ ii*bstride];
+				break;
+			case OpUnary:
+				for (ii=0; ii<nofcalls; ++ii) res[ ii] = ci->unfunc( aptr[ ii*astride]);
+				break;
+			case OpBinary:
+				for (ii=0; ii<nofcalls; ++ii) res[ ii] = ci->binfunc( aptr[ ii*astride], bptr[ ii*bstride]);
+				break;
+			case OpNary:
+			{
+				double nargs[ MaxNofRegisters];
+				for (ii=0; ii<nofcalls; ++ii)
+				{
+					for (std::size_t ai=0; ai<ci->nofargs; ++ai)
+					{
+						nargs[ ai] = res[ ai * BATCH_CHUNK_SIZE + ii];
+					}
+					res[ ii] = ci->nfunc( ci->nofargs, nargs);
+				}
+				break;
+			}
+		}
+	}
+	std::size_t rstride;
+	const double* rptr = m_result.array( rstride, args, nofargs, registers, BATCH_CHUNK_SIZE);
+	for (ii=0; ii<nofcalls; ++ii) results[ ii] = rptr[ ii*rstride];
+}
+
+void ScalarFunctionProgram::callBatch( const double* args, unsigned int nofargs, std::size_t nofcalls, double* results) const
+{
+	std::vector<double> registers( m_nofRegisters * BATCH_CHUNK_SIZE);
+	std::size_t ci = 0;
+	while (ci < nofcalls)
+	{
+		std::size_t chunksize = (nofcalls - ci < BATCH_CHUNK_SIZE) ? (nofcalls - ci) : BATCH_CHUNK_SIZE;
+		callChunk( args + ci * nofargs, nofargs, chunksize, results + ci, registers.data());
+		ci += chunksize;
+	}
+}
+
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Scalar function compiled from the stack machine code to register code with constants folded
+/// \file scalarFunctionProgram.hpp
+#ifndef _STRUS_SCALAR_FUNCTION_PROGRAM_HPP_INCLUDED
+#define _STRUS_SCALAR_FUNCTION_PROGRAM_HPP_INCLUDED
+#include "scalarFunction.hpp"
+#include <vector>
+#include <cstddef>
+
+namespace strus
+{
+
+/// \brief Scalar function compiled from the stack machine code of a ScalarFunction for one set of variable values
+/// \note Every value on the stack of the interpreter gets a register determined by its stack position.
+///	Operands that are constants, variables or arguments are referenced directly by the instructions and not pushed.
+///	Operations with constant operands only are evaluated at compile time.
+class ScalarFunctionProgram
+{
+public:
+	/// \brief Default constructor, creates a program returning 0.0
+	ScalarFunctionProgram()
+		:m_code(),m_nofRegisters(0),m_result(){}
+	/// \brief Copy constructor
+	ScalarFunctionProgram( const ScalarFunctionProgram& o)
+		:m_code(o.m_code),m_nofRegisters(o.m_nofRegisters),m_result(o.m_result){}
+
+	/// \brief Compile the code of a scalar function with variables bound to values
+	/// \param[in] func function to compile
+	/// \param[in] valuear values of the constants and variables of the function (variables bound)
+	/// \note Throws on invalid code or if the code needs more registers than supported
+	void compile( const ScalarFunction* func, const std::vector<double>& valuear);
+
+	/// \brief Execute the function
+	/// \param[in] args array of arguments, at least as many as referenced by the function
+	double call( const double* args) const;
+
+	/// \brief Execute the function for an array of argument tuples
+	/// \param[in] args array of 'nofcalls' argument tuples with 'nofargs' elements each, stored one after the other
+	/// \param[in] nofargs number of elements of an argument tuple
+	/// \param[in] nofcalls number of argument tuples
+	/// \param[out] results array of 'nofcalls' results
+	void callBatch( const double* args, unsigned int nofargs, std::size_t nofcalls, double* results) const;
+
+	/// \brief Get the number of instructions of the program
+	std::size_t size() const
+	{
+		return m_code.size();
+	}
+
+	enum {MaxNofRegisters=256};
+
+private:
+	enum OperandType
+	{
+		ConstOperand,		//< constant (constant folded, variable or literal)
+		ArgOperand,		//< argument of the call
+		RegisterOperand		//< result of a previous instruction
+	};
+	struct Operand
+	{
+		OperandType type;
+		std::size_t idx;
+		double value;
+
+		Operand()
+			:type(ConstOperand),idx(0),value(0.0){}
+		Operand( OperandType type_, std::size_t idx_, double value_)
+			:type(type_),idx(idx_),value(value_){}
+		Operand( const Operand& o)
+			:type(o.type),idx(o.idx),value(o.value){}
+
+		/// \brief Get the value of the operand in a single call
+		double get( const double* args, const double* registers) const
+		{
+			return type == ConstOperand ? value : (type == ArgOperand ? args[ idx] : registers[ idx]);
+		}
+		/// \brief Get the values of the operand in a batch call as array with a stride (0 for constants)
+		const double* array( std::size_t& stride, const double* args, unsigned int nofargs, const double* registers, std::size_t registerSize) const
+		{
+			switch (type)
+			{
+				case ConstOperand: stride = 0; return &value;
+				case ArgOperand: stride = nofargs; return args + idx;
+				case RegisterOperand: break;
+			}
+			stride = 1;
+			return registers + idx * registerSize;
+		}
+	};
+	enum OpType
+	{
+		OpLoad,			//< copy operand a to a register (to pass it to an N-ary function)
+		OpNeg,			//< negation of a
+		OpAdd,			//< a + b
+		OpSub,			//< a - b
+		OpDiv,			//< a / b with the rules for 0 of the interpreter
+		OpMul,			//< a * b
+		OpUnary,		//< unary function call with a
+		OpBinary,		//< binary function call with a and b
+		OpNary			//< N-ary function call with the registers starting from 'res'
+	};
+	struct Instruction
+	{
+		OpType op;
+		std::size_t res;
+		Operand a;
+		Operand b;
+		ScalarFunction::UnaryFunction unfunc;
+		ScalarFunction::BinaryFunction binfunc;
+		ScalarFunction::NaryFunction nfunc;
+		std::size_t nofargs;
+
+		Instruction( OpType op_, std::size_t res_, const Operand& a_, const Operand& b_)
+			:op(op_),res(res_),a(a_),b(b_),unfunc(0),binfunc(0),nfunc(0),nofargs(0){}
+		Instruction( const Instruction& o)
+			:op(o.op),res(o.res),a(o.a),b(o.b),unfunc(o.unfunc),binfunc(o.binfunc),nfunc(o.nfunc),nofargs(o.nofargs){}
+	};
+
+	void emitArithmetic( std::vector<Operand>& stk, OpType op);
+	void callChunk( const double* args, unsigned int nofargs, std::size_t nofcalls, double* results, double* registers) const;
+
+private:
+	std::vector<Instruction> m_code;	///< instructions
+	std::size_t m_nofRegisters;		///< number of registers needed
+	Operand m_result;			///< operand with the result
+};
+
+}//namespace
+#endif
+
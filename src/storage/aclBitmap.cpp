@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Compact bitmap of the document numbers a set of users is allowed to see
+/// \file "aclBitmap.cpp"
+#include "aclBitmap.hpp"
+#include "private/internationalization.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace strus;
+
+AclBitmap::AclBitmap( std::vector<Range>& ranges)
+	:m_containers(),m_values(),m_words()
+{
+	std::sort( ranges.begin(), ranges.end());
+	std::vector<Run> runs;
+	unsigned int key = 0;
+	std::vector<Range>::const_iterator ri = ranges.begin(), re = ranges.end();
+	while (ri != re)
+	{
+		// Join overlapping and adjacent ranges:
+		Index first = ri->first > 0 ? ri->first : 1;
+		Index last = ri->second;
+		for (++ri; ri != re && ri->first - 1 <= last; ++ri)
+		{
+			if (ri->second > last) last = ri->second;
+		}
+		if (last < first) continue;
+
+		// Split the range into runs of containers:
+		for (;;)
+		{
+			unsigned int firstkey = (unsigned int)first >> ContainerBits;
+			Index containerLast = (Index)(((firstkey + 1) << ContainerBits) - 1);
+			Index runLast = last < containerLast ? last : containerLast;
+			if (firstkey != key && !runs.empty())
+			{
+				addContainer( key, runs);
+				runs.clear();
+			}
+			key = firstkey;
+			runs.push_back( Run( (uint16_t)(first & (ContainerSize-1)), (uint16_t)(runLast & (ContainerSize-1))));
+			if (runLast >= last) break;
+			first = runLast + 1;
+		}
+	}
+	if (!runs.empty())
+	{
+		addContainer( key, runs);
+	}
+}
+
+void AclBitmap::addContainer( unsigned int key, const std::vector<Run>& runs)
+{
+	std::size_t cardinality = 0;
+	std::vector<Run>::const_iterator ri = runs.begin(), re = runs.end();
+	for (; ri != re; ++ri)
+	{
+		cardinality += (std::size_t)ri->second - ri->first + 1;
+	}
+	std::size_t runBytes = runs.size() * 2 * sizeof(uint16_t);
+	std::size_t arrayBytes = cardinality * sizeof(uint16_t);
+	std::size_t bitmapBytes = BitmapWords * sizeof(uint64_t);
+
+	if (runBytes <= arrayBytes && runBytes <= bitmapBytes)
+	{
+		m_containers.push_back( Container( key, RunContainer, m_values.size(), runs.size()));
+		for (ri = runs.begin(); ri != re; ++ri)
+		{
+			m_values.push_back( ri->first);
+			m_values.push_back( ri->second);
+		}
+	}
+	else if (arrayBytes <= bitmapBytes)
+	{
+		m_containers.push_back( Container( key, ArrayContainer, m_values.size(), cardinality));
+		for (ri = runs.begin(); ri != re; ++ri)
+		{
+			unsigned int vi = ri->first, ve = ri->second;
+			for (; vi <= ve; ++vi)
+			{
+				m_values.push_back( (uint16_t)vi);
+			}
+		}
+	}
+	else
+	{
+		m_containers.push_back( Container( key, BitmapContainer, m_words.size(), BitmapWords));
+		m_words.resize( m_words.size() + BitmapWords, 0);
+		uint64_t* words = m_words.data() + m_containers.back().ofs;
+		for (ri = runs.begin(); ri != re; ++ri)
+		{
+			unsigned int vi = ri->first, ve = ri->second;
+			for (; vi <= ve; ++vi)
+			{
+				words[ vi >> 6] |= (uint64_t)1 << (vi & 63);
+			}
+		}
+	}
+}
+
+int AclBitmap::skipContainer( const Container& container, unsigned int lowbits) const
+{
+	switch (container.type)
+	{
+		case ArrayContainer:
+		{
+			const uint16_t* ar = m_values.data() + container.ofs;
+			const uint16_t* ae = ar + container.size;
+			const uint16_t* ai = std::lower_bound( ar, ae, (uint16_t)lowbits);
+			return ai == ae ? -1 : (int)*ai;
+		}
+		case RunContainer:
+		{
+			// Binary search for the first run with the last element not smaller than lowbits:
+			const uint16_t* ar = m_values.data() + container.ofs;
+			std::size_t lo = 0, hi = container.size;
+			while (lo < hi)
+			{
+				std::size_t mid = (lo + hi) >> 1;
+				if (ar[ mid*2+1] < lowbits)
+				{
+					lo = mid+1;
+				}
+				else
+				{
+					hi = mid;
+				}
+			}
+			if (lo == container.size) return -1;
+			return ar[ lo*2] > lowbits ? (int)ar[ lo*2] : (int)lowbits;
+		}
+		case BitmapContainer:
+		{
+			const uint64_t* words = m_words.data() + container.ofs;
+			std::size_t wi = lowbits >> 6;
+			uint64_t word = words[ wi] & ((~(uint64_t)0) << (lowbits & 63));
+			for (;;)
+			{
+				if (word)
+				{
+					int bi = 0;
+					for (; 0==(word & 0xFF); word >>= 8, bi += 8){}
+					for (; 0==(word & 1); word >>= 1, ++bi){}
+					return (int)(wi << 6) + bi;
+				}
+				if (++wi == (std::size_t)BitmapWords) return -1;
+				word = words[ wi];
+			}
+		}
+	}
+	throw std::runtime_error( _TXT("corrupt ACL bitmap"));
+}
+
+Index AclBitmap::skip( const Index& docno) const
+{
+	unsigned int dn = docno > 0 ? (unsigned int)docno : 1;
+	unsigned int key = dn >> ContainerBits;
+	std::vector<Container>::const_iterator
+		ci = std::lower_bound( m_containers.begin(), m_containers.end(), key),
+		ce = m_containers.end();
+	if (ci == ce) return 0;
+	if (ci->key == key)
+	{
+		int lowbits = skipContainer( *ci, dn & (ContainerSize-1));
+		if (lowbits >= 0) return (Index)((key << ContainerBits) | (unsigned int)lowbits);
+		if (++ci == ce) return 0;
+	}
+	return (Index)((ci->key << ContainerBits) | (unsigned int)skipContainer( *ci, 0));
+}
+
+std::size_t AclBitmap::memoryUsage() const
+{
+	return sizeof(*this)
+		+ m_containers.size() * sizeof(Container)
+		+ m_values.size() * sizeof(uint16_t)
+		+ m_words.size() * sizeof(uint64_t);
+}
+
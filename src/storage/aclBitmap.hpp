@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Compact bitmap of the document numbers a set of users is allowed to see
+/// \file "aclBitmap.hpp"
+#ifndef _STRUS_STORAGE_ACL_BITMAP_HPP_INCLUDED
+#define _STRUS_STORAGE_ACL_BITMAP_HPP_INCLUDED
+#include "strus/storage/index.hpp"
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <stdint.h>
+
+namespace strus {
+
+/// \brief Immutable set of document numbers, partitioned into containers of 65536 document numbers like a roaring bitmap
+/// \note Each container is stored in the smallest of three representations:
+///	a sorted array of the lower 16 bits of the elements, a sorted array of runs (first and last element) or a bitmap.
+///	The ranges of the boolean blocks of the user ACL index map directly to runs.
+class AclBitmap
+{
+public:
+	typedef std::pair<Index,Index> Range;
+
+	/// \brief Default constructor, creates an empty set
+	AclBitmap()
+		:m_containers(),m_values(),m_words(){}
+	/// \brief Constructor
+	/// \param[in] ranges ranges of document numbers (first and last element) of the set, any order and overlapping allowed, sorted in place
+	explicit AclBitmap( std::vector<Range>& ranges);
+
+	/// \brief Get the smallest element of the set bigger than or equal to a document number
+	/// \param[in] docno document number to seek
+	/// \return the element found or 0 if there is none
+	Index skip( const Index& docno) const;
+
+	/// \brief Evaluate if a document number is an element of the set
+	bool test( const Index& docno) const
+	{
+		return docno > 0 && skip( docno) == docno;
+	}
+
+	/// \brief Evaluate if the set is empty
+	bool empty() const
+	{
+		return m_containers.empty();
+	}
+
+	/// \brief Get the number of bytes used by the set
+	std::size_t memoryUsage() const;
+
+private:
+	enum {ContainerBits=16, ContainerSize=(1<<ContainerBits), BitmapWords=(ContainerSize/64)};
+	enum ContainerType {ArrayContainer, RunContainer, BitmapContainer};
+
+	/// \brief Container of the elements with the same upper bits (key)
+	struct Container
+	{
+		unsigned int key;		///< upper bits of the elements
+		ContainerType type;		///< representation of the elements
+		std::size_t ofs;		///< offset of the elements in m_values (array and run container) or in m_words (bitmap container)
+		std::size_t size;		///< number of values (array container), runs (run container) or words (bitmap container)
+
+		Container( unsigned int key_, ContainerType type_, std::size_t ofs_, std::size_t size_)
+			:key(key_),type(type_),ofs(ofs_),size(size_){}
+		Container( const Container& o)
+			:key(o.key),type(o.type),ofs(o.ofs),size(o.size){}
+
+		bool operator < ( unsigned int key_) const
+		{
+			return key < key_;
+		}
+	};
+	typedef std::pair<uint16_t,uint16_t> Run;
+
+	void addContainer( unsigned int key, const std::vector<Run>& runs);
+	/// \brief Get the smallest element of a container bigger than or equal to the lower bits of a document number
+	/// \return the lower bits of the element found or -1 if there is none
+	int skipContainer( const Container& container, unsigned int lowbits) const;
+
+private:
+	std::vector<Container> m_containers;	///< containers sorted by key
+	std::vector<uint16_t> m_values;		///< elements of array containers and runs of run containers
+	std::vector<uint64_t> m_words;		///< elements of bitmap containers
+};
+
+}//namespace
+#endif
+
@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Size bounded cache of the ACL bitmaps of sets of users
+/// \file "aclBitmapCache.cpp"
+#include "aclBitmapCache.hpp"
+#include "private/internationalization.hpp"
+#include <stdexcept>
+
+using namespace strus;
+
+AclBitmapCache::BitmapRef AclBitmapCache::find( const std::string& key, unsigned int revision)
+{
+	strus::scoped_lock lock( m_mutex);
+	Map::iterator mi = m_map.find( key);
+	if (mi == m_map.end()) return BitmapRef();
+	if (mi->second.revision != revision)
+	{
+		eraseEntry( mi);
+		return BitmapRef();
+	}
+	m_lru.splice( m_lru.begin(), m_lru, mi->second.lruitr);
+	return mi->second.bitmap;
+}
+
+void AclBitmapCache::insert( const std::string& key, unsigned int revision, const BitmapRef& bitmap)
+{
+	std::size_t entrysize = bitmap->memoryUsage() + 2*key.size() + EntryMemoryOverhead;
+	if (entrysize > m_maxMemoryUsage) return;
+
+	strus::scoped_lock lock( m_mutex);
+	Map::iterator mi = m_map.find( key);
+	if (mi != m_map.end())
+	{
+		if (mi->second.revision == revision)
+		{
+			//... built concurrently by another query
+			m_lru.splice( m_lru.begin(), m_lru, mi->second.lruitr);
+			return;
+		}
+		eraseEntry( mi);
+	}
+	m_lru.push_front( key);
+	m_map.insert( Map::value_type( key, Entry( bitmap, revision, entrysize, m_lru.begin())));
+	m_memoryUsage += entrysize;
+
+	while (m_memoryUsage > m_maxMemoryUsage && !m_lru.empty())
+	{
+		Map::iterator li = m_map.find( m_lru.back());
+		if (li == m_map.end()) throw std::runtime_error(_TXT("corrupt ACL bitmap cache"));
+		eraseEntry( li);
+	}
+}
+
+void AclBitmapCache::eraseEntry( Map::iterator mi)
+{
+	m_memoryUsage -= mi->second.memsize;
+	m_lru.erase( mi->second.lruitr);
+	m_map.erase( mi);
+}
+
+void AclBitmapCache::clear()
+{
+	strus::scoped_lock lock( m_mutex);
+	m_map.clear();
+	m_lru.clear();
+	m_memoryUsage = 0;
+}
+
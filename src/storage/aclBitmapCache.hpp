@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Size bounded cache of the ACL bitmaps of sets of users
+/// \file "aclBitmapCache.hpp"
+#ifndef _STRUS_STORAGE_ACL_BITMAP_CACHE_HPP_INCLUDED
+#define _STRUS_STORAGE_ACL_BITMAP_CACHE_HPP_INCLUDED
+#include "aclBitmap.hpp"
+#include "strus/base/thread.hpp"
+#include "strus/base/shared_ptr.hpp"
+#include "strus/base/unordered_map.hpp"
+#include <list>
+#include <string>
+#include <cstddef>
+
+namespace strus {
+
+/// \brief Cache of the bitmaps of the documents visible for sets of users, shared by all queries of a storage
+/// \note Bitmaps are tagged with the revision of the storage they were built from.
+///	A bitmap of an outdated revision is not returned and replaced by the next insert for the same set of users.
+class AclBitmapCache
+{
+public:
+	typedef strus::shared_ptr<const AclBitmap> BitmapRef;
+
+	/// \brief Constructor
+	/// \param[in] maxMemoryUsage_ maximum number of bytes of bitmaps to hold in the cache
+	explicit AclBitmapCache( std::size_t maxMemoryUsage_)
+		:m_mutex(),m_map(),m_lru(),m_maxMemoryUsage(maxMemoryUsage_),m_memoryUsage(0){}
+	~AclBitmapCache(){}
+
+	/// \brief Find the bitmap of a set of users
+	/// \param[in] key canonical representation of the set of users (sorted list of names)
+	/// \param[in] revision current revision of the storage
+	/// \return the bitmap found or an empty reference if not found or outdated
+	BitmapRef find( const std::string& key, unsigned int revision);
+
+	/// \brief Insert the bitmap of a set of users
+	/// \param[in] key canonical representation of the set of users (sorted list of names)
+	/// \param[in] revision revision of the storage read before building the bitmap
+	/// \param[in] bitmap bitmap to insert
+	void insert( const std::string& key, unsigned int revision, const BitmapRef& bitmap);
+
+	/// \brief Remove all bitmaps from the cache
+	void clear();
+
+	/// \brief Get the maximum number of bytes of bitmaps held in the cache
+	std::size_t maxMemoryUsage() const
+	{
+		return m_maxMemoryUsage;
+	}
+
+private:
+	enum {EntryMemoryOverhead=96};
+
+	typedef std::list<std::string> LruList;
+
+	/// \brief Bitmap cached
+	struct Entry
+	{
+		BitmapRef bitmap;
+		unsigned int revision;
+		std::size_t memsize;
+		LruList::iterator lruitr;
+
+		Entry( const BitmapRef& bitmap_, unsigned int revision_, std::size_t memsize_, const LruList::iterator& lruitr_)
+			:bitmap(bitmap_),revision(revision_),memsize(memsize_),lruitr(lruitr_){}
+		Entry( const Entry& o)
+			:bitmap(o.bitmap),revision(o.revision),memsize(o.memsize),lruitr(o.lruitr){}
+	};
+	typedef strus::unordered_map<std::string,Entry> Map;
+
+	void eraseEntry( Map::iterator mi);
+
+private:
+	AclBitmapCache( const AclBitmapCache&){}	//... non copyable
+	void operator=( const AclBitmapCache&){}	//... non copyable
+
+private:
+	strus::mutex m_mutex;				///< mutex for all operations on the cache
+	Map m_map;					///< map of user set keys to bitmaps
+	LruList m_lru;					///< keys cached, least recently used last
+	std::size_t m_maxMemoryUsage;			///< maximum number of bytes of bitmaps held in the cache
+	std::size_t m_memoryUsage;			///< number of bytes of bitmaps held in the cache
+};
+
+}//namespace
+#endif
+
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#ifndef _STRUS_STORAGE_BLOCK_SUMMARY_HPP_INCLUDED
+#define _STRUS_STORAGE_BLOCK_SUMMARY_HPP_INCLUDED
+#include <limits>
+
+namespace strus {
+
+/// \brief Summary of a block of postings stored with the block for calculating upper bounds of weights without decoding the block
+/// \note Blocks written with an earlier version of strus have no summary stored
+struct BlockSummary
+{
+	unsigned int maxff;		///< maximum feature frequency of a document in the block
+	unsigned int mindoclen;		///< minimum lower bound of the length of a document in the block (highest position of the feature in a document or its ff, if no positions are stored)
+
+	BlockSummary()
+		:maxff(0),mindoclen(std::numeric_limits<unsigned int>::max()){}
+	BlockSummary( const BlockSummary& o)
+		:maxff(o.maxff),mindoclen(o.mindoclen){}
+
+	void add( unsigned int ff, unsigned int doclen)
+	{
+		if (ff > maxff) maxff = ff;
+		if (doclen < mindoclen) mindoclen = doclen;
+	}
+};
+
+}//namespace
+#endif
+
@@ -27,11 +27,8 @@ Index BrowsePostingIterator::skipDoc( const Index& docno_)
 {
 	Index dn = (docno_ == 0) ? 1 : docno_;
 	if (dn < 0 || dn > m_maxdocno) return m_docno = 0;
-	while (!m_restriction->match( dn))
-	{
-		++dn;
-		if (dn > m_maxdocno) return m_docno = 0;
-	}
+	dn = m_restriction->skipDoc( dn, m_maxdocno);
+	if (dn > m_maxdocno) return m_docno = 0;
 	return m_docno = dn;
 }
 
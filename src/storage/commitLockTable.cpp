@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Table of striped locks serializing the commits of transactions that modify the same storage items
+/// \file "commitLockTable.cpp"
+#include "commitLockTable.hpp"
+#include "private/internationalization.hpp"
+#include <stdexcept>
+
+using namespace strus;
+
+std::size_t CommitLockTable::stripeIndex( StripeClass cl, const Index& key1, const Index& key2)
+{
+	unsigned int hs = (unsigned int)key1 * 2654435761U;
+	hs ^= (unsigned int)key2 + 0x9e3779b9U + (hs << 6) + (hs >> 2);
+	return (std::size_t)cl * NofStripes + (hs % NofStripes);
+}
+
+void CommitLockTable::ScopedLock::lock( const std::set<std::size_t>& stripes)
+{
+	if (stripes.empty()) return;
+	if (!m_locked.empty() && *stripes.begin() <= m_locked.back())
+	{
+		throw std::logic_error( _TXT("commit lock stripes not acquired in ascending order"));
+	}
+	m_locked.reserve( m_locked.size() + stripes.size());
+	std::set<std::size_t>::const_iterator si = stripes.begin(), se = stripes.end();
+	for (; si != se; ++si)
+	{
+		m_table->m_ar[ *si].lock();
+		m_locked.push_back( *si);
+	}
+}
+
+void CommitLockTable::ScopedLock::unlock()
+{
+	std::vector<std::size_t>::const_reverse_iterator li = m_locked.rbegin(), le = m_locked.rend();
+	for (; li != le; ++li)
+	{
+		m_table->m_ar[ *li].unlock();
+	}
+	m_locked.clear();
+}
+
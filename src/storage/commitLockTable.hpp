@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Table of striped locks serializing the commits of transactions that modify the same storage items
+/// \file "commitLockTable.hpp"
+#ifndef _STRUS_STORAGE_COMMIT_LOCK_TABLE_HPP_INCLUDED
+#define _STRUS_STORAGE_COMMIT_LOCK_TABLE_HPP_INCLUDED
+#include "strus/storage/index.hpp"
+#include "strus/base/thread.hpp"
+#include <set>
+#include <vector>
+#include <cstddef>
+
+namespace strus {
+
+/// \brief Table of striped locks for the part of a transaction commit that builds the blocks to write
+/// \note Transactions modifying disjoint sets of items can build their blocks in parallel, transactions modifying the same items (or items mapped to the same stripe) are serialized
+/// \note Deadlocks are avoided by acquiring the stripes in ascending order. Stripe classes are ordered, so that the stripes of a class can be locked after reading data protected by the stripes of a lower class
+class CommitLockTable
+{
+public:
+	/// \brief Classes of items, in the order of their acquisition
+	enum StripeClass
+	{
+		DocumentStripe,		///< stripe of a document number (inverse terms, forward index, structures, attributes, document ACL)
+		MetaDataBlockStripe,	///< stripe of a meta data block number
+		UserStripe,		///< stripe of a user number (user ACL)
+		TermStripe		///< stripe of a term (posinfo, ff and document blocks, document frequency)
+	};
+	enum {NofStripeClasses=4, NofStripes=256};
+
+	CommitLockTable(){}
+
+	/// \brief Get the index of the stripe an item is mapped to
+	/// \param[in] cl class of the item
+	/// \param[in] key1 first element of the item key (document, block, user number or term type)
+	/// \param[in] key2 second element of the item key (term value number) or 0
+	static std::size_t stripeIndex( StripeClass cl, const Index& key1, const Index& key2=0);
+
+	/// \brief Set of stripes locked for a commit, all stripes are released in the destructor
+	class ScopedLock
+	{
+	public:
+		explicit ScopedLock( CommitLockTable* table_)
+			:m_table(table_),m_locked(){}
+		~ScopedLock()
+		{
+			unlock();
+		}
+
+		/// \brief Lock a set of stripes
+		/// \note All stripes in the set have to be greater than the stripes already locked
+		void lock( const std::set<std::size_t>& stripes);
+		/// \brief Release all stripes locked
+		void unlock();
+
+	private:
+		ScopedLock( const ScopedLock&){}	//... non copyable
+		void operator=( const ScopedLock&){}	//... non copyable
+
+	private:
+		CommitLockTable* m_table;
+		std::vector<std::size_t> m_locked;
+	};
+
+private:
+	CommitLockTable( const CommitLockTable&){}	//... non copyable
+	void operator=( const CommitLockTable&){}	//... non copyable
+
+private:
+	strus::mutex m_ar[ NofStripeClasses * NofStripes];
+};
+
+}//namespace
+#endif
+
@@ -74,6 +74,22 @@ public:
 	void append( const void* data, std::size_t datasize);
 	void fill( char ch, std::size_t datasize);
 
+	/// \brief Create the block inserted into the shared block cache for a block read from the database
+	/// \note Hidden by block classes with a costly decoding, that create the cache block decoded, ready for read only access by concurrent threads
+	static DataBlock* createCacheBlock( const DataBlock& blk)
+	{
+		return new DataBlock( blk.m_id, blk.m_ptr, blk.m_size, true/*allocated copy*/);
+	}
+	/// \brief Take the decoded data of a block of the shared block cache this block references the memory of
+	/// \note Hidden by block classes that create their cache block decoded
+	void attachCacheBlock( const DataBlock&)
+	{}
+	/// \brief Get the number of bytes of memory used by the block including its decoded data
+	virtual std::size_t memoryUsage() const
+	{
+		return m_size;
+	}
+
 	void setByte( std::size_t idx, unsigned char elem)
 	{
 		if (idx >= m_size) throw strus::runtime_error( _TXT( "array bound write (%s)"), __FUNCTION__);
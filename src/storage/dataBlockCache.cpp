@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Size bounded cache of posting, ff and forward index blocks shared by all queries of a storage
+/// \file "dataBlockCache.cpp"
+#include "dataBlockCache.hpp"
+#include "databaseKey.hpp"
+#include "indexPacker.hpp"
+#include "private/internationalization.hpp"
+#include <stdexcept>
+
+using namespace strus;
+
+DataBlockCache::DataBlockCache( std::size_t maxMemoryUsage_)
+	:m_maxMemoryUsage(maxMemoryUsage_),m_maxPartitionMemoryUsage(maxMemoryUsage_ / NofPartitions)
+{}
+
+bool DataBlockCache::isCachedPrefix( char prefix)
+{
+	return prefix == DatabaseKey::PosinfoBlockPrefix
+		|| prefix == DatabaseKey::FfBlockPrefix
+		|| prefix == DatabaseKey::ForwardIndexPrefix;
+}
+
+/// \brief Get the size of the domain key (prefix and two packed indices) of a database key of a block cached
+/// \return the size of the domain key or 0 if the key is not the key of a block cached or is too short
+static std::size_t getDomainKeySize( const char* key, std::size_t keysize)
+{
+	if (!keysize || !DataBlockCache::isCachedPrefix( key[0])) return 0;
+	char const* ki = key+1;
+	char const* ke = key+keysize;
+	if (ki == ke) return 0;
+	ki = skipIndex( ki, ke);
+	if (ki == ke) return 0;
+	ki = skipIndex( ki, ke);
+	return ki - key;
+}
+
+std::size_t DataBlockCache::partitionIndex( const char* domainkey, std::size_t domainkeysize)
+{
+	unsigned int hs = 2166136261U;
+	char const* ki = domainkey;
+	char const* ke = domainkey + domainkeysize;
+	for (; ki != ke; ++ki)
+	{
+		hs ^= (unsigned char)*ki;
+		hs *= 16777619U;
+	}
+	return hs % NofPartitions;
+}
+
+std::size_t DataBlockCache::entryMemoryUsage( const std::string& domainkey, const DataBlock& blk)
+{
+	return blk.memoryUsage() + 2*domainkey.size() + EntryMemoryOverhead;
+}
+
+unsigned int DataBlockCache::generation( const char* domainkey, std::size_t domainkeysize) const
+{
+	const Partition& part = m_ar[ partitionIndex( domainkey, domainkeysize)];
+	strus::scoped_lock lock( part.mutex);
+	return part.generation;
+}
+
+DataBlockCache::BlockRef DataBlockCache::findUpperBound( const char* domainkey, std::size_t domainkeysize, const Index& elemno)
+{
+	Partition& part = m_ar[ partitionIndex( domainkey, domainkeysize)];
+	strus::scoped_lock lock( part.mutex);
+	DomainMap::iterator di = part.domainMap.find( std::string( domainkey, domainkeysize));
+	if (di == part.domainMap.end()) return BlockRef();
+	BlockMap::iterator bi = di->second.lower_bound( elemno);
+	if (bi == di->second.end() || bi->second.rangeStart > elemno) return BlockRef();
+
+	part.lru.splice( part.lru.begin(), part.lru, bi->second.lruitr);
+	return bi->second.block;
+}
+
+void DataBlockCache::insert( const char* domainkey, std::size_t domainkeysize, const Index& rangeStart, const BlockRef& blk, unsigned int generation_)
+{
+	std::string domainkeystr( domainkey, domainkeysize);
+	std::size_t entrysize = entryMemoryUsage( domainkeystr, *blk);
+	if (entrysize > m_maxPartitionMemoryUsage) return;
+
+	Partition& part = m_ar[ partitionIndex( domainkey, domainkeysize)];
+	strus::scoped_lock lock( part.mutex);
+	if (part.generation != generation_) return;
+	//... the block might have been read before a write of the domain and is outdated
+
+	BlockMap& blockMap = part.domainMap[ domainkeystr];
+	BlockMap::iterator bi = blockMap.find( blk->id());
+	if (bi != blockMap.end())
+	{
+		if (bi->second.rangeStart > rangeStart)
+		{
+			bi->second.rangeStart = rangeStart;
+		}
+		part.lru.splice( part.lru.begin(), part.lru, bi->second.lruitr);
+		return;
+	}
+	part.lru.push_front( LruElem( domainkeystr, blk->id()));
+	blockMap.insert( BlockMap::value_type( blk->id(), Entry( blk, rangeStart, part.lru.begin())));
+	part.memoryUsage += entrysize;
+
+	while (part.memoryUsage > m_maxPartitionMemoryUsage && !part.lru.empty())
+	{
+		const LruElem& last = part.lru.back();
+		DomainMap::iterator di = part.domainMap.find( last.domainkey);
+		if (di == part.domainMap.end()) throw std::runtime_error(_TXT("corrupt data block cache"));
+		BlockMap::iterator li = di->second.find( last.id);
+		if (li == di->second.end()) throw std::runtime_error(_TXT("corrupt data block cache"));
+		eraseEntry( part, di, li);
+	}
+}
+
+void DataBlockCache::eraseEntry( Partition& part, DomainMap::iterator di, BlockMap::iterator bi)
+{
+	part.memoryUsage -= entryMemoryUsage( di->first, *bi->second.block);
+	part.lru.erase( bi->second.lruitr);
+	di->second.erase( bi);
+	if (di->second.empty())
+	{
+		part.domainMap.erase( di);
+	}
+}
+
+void DataBlockCache::invalidateBlock( const char* domainkey, std::size_t domainkeysize, const Index& id)
+{
+	Partition& part = m_ar[ partitionIndex( domainkey, domainkeysize)];
+	strus::scoped_lock lock( part.mutex);
+	++part.generation;
+
+	DomainMap::iterator di = part.domainMap.find( std::string( domainkey, domainkeysize));
+	if (di == part.domainMap.end()) return;
+	BlockMap::iterator bi = di->second.lower_bound( id);
+	if (bi == di->second.end()) return;
+	if (bi->first == id)
+	{
+		if (di->second.size() == 1)
+		{
+			eraseEntry( part, di, bi);
+			return;
+		}
+		BlockMap::iterator next = bi;
+		++next;
+		eraseEntry( part, di, bi);
+		if (next == di->second.end()) return;
+		bi = next;
+	}
+	// A block written with the id 'id' might be new, the successor block is not the upper bound of elements up to 'id' anymore:
+	if (bi->second.rangeStart <= id)
+	{
+		bi->second.rangeStart = id+1;
+	}
+}
+
+void DataBlockCache::invalidateDomain( const char* domainkey, std::size_t domainkeysize)
+{
+	Partition& part = m_ar[ partitionIndex( domainkey, domainkeysize)];
+	strus::scoped_lock lock( part.mutex);
+	++part.generation;
+
+	DomainMap::iterator di = part.domainMap.find( std::string( domainkey, domainkeysize));
+	if (di == part.domainMap.end()) return;
+	BlockMap::iterator bi = di->second.begin(), be = di->second.end();
+	for (; bi != be; ++bi)
+	{
+		part.memoryUsage -= entryMemoryUsage( di->first, *bi->second.block);
+		part.lru.erase( bi->second.lruitr);
+	}
+	part.domainMap.erase( di);
+}
+
+void DataBlockCache::invalidateKey( const char* key, std::size_t keysize)
+{
+	std::size_t domainkeysize = getDomainKeySize( key, keysize);
+	if (!domainkeysize || domainkeysize == keysize) return;
+
+	char const* ki = key + domainkeysize;
+	Index id = unpackIndex( ki, key + keysize);
+	invalidateBlock( key, domainkeysize, id);
+}
+
+void DataBlockCache::invalidateSubTree( const char* domainkey, std::size_t domainkeysize)
+{
+	if (domainkeysize && !isCachedPrefix( domainkey[0])) return;
+	std::size_t keydomainsize = getDomainKeySize( domainkey, domainkeysize);
+	if (keydomainsize && keydomainsize == domainkeysize)
+	{
+		invalidateDomain( domainkey, domainkeysize);
+	}
+	else
+	{
+		//... deletes of more than one domain are not expected on a storage in use, we simply drop all blocks
+		clear();
+	}
+}
+
+void DataBlockCache::clear()
+{
+	for (int pi = 0; pi < NofPartitions; ++pi)
+	{
+		Partition& part = m_ar[ pi];
+		strus::scoped_lock lock( part.mutex);
+		++part.generation;
+		part.domainMap.clear();
+		part.lru.clear();
+		part.memoryUsage = 0;
+	}
+}
+
+std::size_t DataBlockCache::memoryUsage() const
+{
+	std::size_t rt = 0;
+	for (int pi = 0; pi < NofPartitions; ++pi)
+	{
+		const Partition& part = m_ar[ pi];
+		strus::scoped_lock lock( part.mutex);
+		rt += part.memoryUsage;
+	}
+	return rt;
+}
+
+
+DatabaseCursorInterface* DataBlockCacheTransaction::createCursor( const DatabaseOptions& options) const
+{
+	return m_transaction->createCursor( options);
+}
+
+void DataBlockCacheTransaction::write( const char* key, std::size_t keysize, const char* value, std::size_t valuesize)
+{
+	if (keysize && DataBlockCache::isCachedPrefix( key[0]))
+	{
+		m_keys.push_back( std::string( key, keysize));
+	}
+	m_transaction->write( key, keysize, value, valuesize);
+}
+
+void DataBlockCacheTransaction::remove( const char* key, std::size_t keysize)
+{
+	if (keysize && DataBlockCache::isCachedPrefix( key[0]))
+	{
+		m_keys.push_back( std::string( key, keysize));
+	}
+	m_transaction->remove( key, keysize);
+}
+
+void DataBlockCacheTransaction::removeSubTree( const char* domainkey, std::size_t domainkeysize)
+{
+	if (!domainkeysize || DataBlockCache::isCachedPrefix( domainkey[0]))
+	{
+		m_subtrees.push_back( std::string( domainkey, domainkeysize));
+	}
+	m_transaction->removeSubTree( domainkey, domainkeysize);
+}
+
+bool DataBlockCacheTransaction::commit()
+{
+	if (!m_transaction->commit()) return false;
+	std::vector<std::string>::const_iterator ki = m_keys.begin(), ke = m_keys.end();
+	for (; ki != ke; ++ki)
+	{
+		m_cache->invalidateKey( ki->c_str(), ki->size());
+	}
+	std::vector<std::string>::const_iterator si = m_subtrees.begin(), se = m_subtrees.end();
+	for (; si != se; ++si)
+	{
+		m_cache->invalidateSubTree( si->c_str(), si->size());
+	}
+	m_keys.clear();
+	m_subtrees.clear();
+	return true;
+}
+
+void DataBlockCacheTransaction::rollback()
+{
+	m_keys.clear();
+	m_subtrees.clear();
+	m_transaction->rollback();
+}
+
@@ -0,0 +1,176 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Size bounded cache of posting, ff and forward index blocks shared by all queries of a storage
+/// \file "dataBlockCache.hpp"
+#ifndef _STRUS_STORAGE_DATA_BLOCK_CACHE_HPP_INCLUDED
+#define _STRUS_STORAGE_DATA_BLOCK_CACHE_HPP_INCLUDED
+#include "strus/storage/index.hpp"
+#include "strus/base/thread.hpp"
+#include "strus/base/shared_ptr.hpp"
+#include "strus/base/unordered_map.hpp"
+#include "strus/databaseTransactionInterface.hpp"
+#include "strus/reference.hpp"
+#include "dataBlock.hpp"
+#include <map>
+#include <list>
+#include <vector>
+#include <string>
+#include <cstddef>
+
+namespace strus {
+
+/// \brief Cache of immutable data blocks shared by the cursors of all queries of a storage
+/// \note Blocks with a costly decoding (posinfo blocks) are cached decoded, a hit does not repeat the decoding.
+/// \note Blocks are identified by their domain key (key prefix and term or document key) and their block id.
+///	Each block cached also stores the first element number it is known to be the upper bound block for.
+///	This makes it possible to answer the upper bound seek of a cursor from the cache without accessing the database.
+/// \note Blocks inserted by a cursor are rejected if the generation of the cache partition has changed
+///	since the creation of the cursor. This prevents blocks read from an outdated database iterator to be cached after an invalidation.
+class DataBlockCache
+{
+public:
+	typedef strus::shared_ptr<const DataBlock> BlockRef;
+
+	/// \brief Constructor
+	/// \param[in] maxMemoryUsage_ maximum number of bytes of blocks to hold in the cache
+	explicit DataBlockCache( std::size_t maxMemoryUsage_);
+	~DataBlockCache(){}
+
+	/// \brief Evaluate if blocks with a database key prefix are held in this cache
+	static bool isCachedPrefix( char prefix);
+
+	/// \brief Get the current generation of the partition of a domain, needed for inserting blocks
+	/// \param[in] domainkey pointer to the domain key (database key without block id)
+	/// \param[in] domainkeysize size of domainkey in bytes
+	unsigned int generation( const char* domainkey, std::size_t domainkeysize) const;
+
+	/// \brief Find the block with the smallest id greater than or equal to an element number
+	/// \param[in] domainkey pointer to the domain key (database key without block id)
+	/// \param[in] domainkeysize size of domainkey in bytes
+	/// \param[in] elemno element number to seek
+	/// \return the block found or an empty reference if the cache cannot answer the query
+	BlockRef findUpperBound( const char* domainkey, std::size_t domainkeysize, const Index& elemno);
+
+	/// \brief Insert a block read from the database
+	/// \param[in] domainkey pointer to the domain key (database key without block id)
+	/// \param[in] domainkeysize size of domainkey in bytes
+	/// \param[in] rangeStart smallest element number the block is known to be the upper bound block for
+	/// \param[in] blk block to insert, owning its memory and with its decoded data already prepared, not changed anymore after the insert
+	/// \param[in] generation_ generation of the partition of the domain before the block was read
+	void insert( const char* domainkey, std::size_t domainkeysize, const Index& rangeStart, const BlockRef& blk, unsigned int generation_);
+
+	/// \brief Invalidate the blocks affected by a write or delete of a database key
+	/// \param[in] key pointer to the database key written or deleted
+	/// \param[in] keysize size of key in bytes
+	void invalidateKey( const char* key, std::size_t keysize);
+	/// \brief Invalidate the blocks affected by a delete of all database keys with a prefix
+	/// \param[in] domainkey pointer to the key prefix deleted
+	/// \param[in] domainkeysize size of domainkey in bytes
+	void invalidateSubTree( const char* domainkey, std::size_t domainkeysize);
+
+	/// \brief Remove all blocks from the cache
+	void clear();
+
+	/// \brief Get the maximum number of bytes of blocks held in the cache
+	std::size_t maxMemoryUsage() const
+	{
+		return m_maxMemoryUsage;
+	}
+	/// \brief Get the number of bytes of blocks held in the cache
+	std::size_t memoryUsage() const;
+
+private:
+	enum {NofPartitions=16, EntryMemoryOverhead=96};
+
+	/// \brief Element of the LRU list of a partition
+	struct LruElem
+	{
+		std::string domainkey;
+		Index id;
+
+		LruElem( const std::string& domainkey_, const Index& id_)
+			:domainkey(domainkey_),id(id_){}
+		LruElem( const LruElem& o)
+			:domainkey(o.domainkey),id(o.id){}
+	};
+	typedef std::list<LruElem> LruList;
+
+	/// \brief Block cached with the range of element numbers it is the upper bound block for
+	struct Entry
+	{
+		BlockRef block;
+		Index rangeStart;
+		LruList::iterator lruitr;
+
+		Entry( const BlockRef& block_, const Index& rangeStart_, const LruList::iterator& lruitr_)
+			:block(block_),rangeStart(rangeStart_),lruitr(lruitr_){}
+		Entry( const Entry& o)
+			:block(o.block),rangeStart(o.rangeStart),lruitr(o.lruitr){}
+	};
+	typedef std::map<Index,Entry> BlockMap;
+	typedef strus::unordered_map<std::string,BlockMap> DomainMap;
+
+	/// \brief Partition of the cache with its own lock
+	struct Partition
+	{
+		mutable strus::mutex mutex;
+		DomainMap domainMap;
+		LruList lru;
+		std::size_t memoryUsage;
+		unsigned int generation;
+
+		Partition()
+			:mutex(),domainMap(),lru(),memoryUsage(0),generation(0){}
+	};
+
+	static std::size_t partitionIndex( const char* domainkey, std::size_t domainkeysize);
+	static std::size_t entryMemoryUsage( const std::string& domainkey, const DataBlock& blk);
+	void eraseEntry( Partition& part, DomainMap::iterator di, BlockMap::iterator bi);
+	void invalidateBlock( const char* domainkey, std::size_t domainkeysize, const Index& id);
+	void invalidateDomain( const char* domainkey, std::size_t domainkeysize);
+
+private:
+	DataBlockCache( const DataBlockCache&){}	//... non copyable
+	void operator=( const DataBlockCache&){}	//... non copyable
+
+private:
+	std::size_t m_maxMemoryUsage;			///< maximum number of bytes of blocks held
+	std::size_t m_maxPartitionMemoryUsage;		///< maximum number of bytes of blocks held per partition
+	Partition m_ar[ NofPartitions];			///< partitions selected by the hash of the domain key
+};
+
+
+/// \brief Database transaction recording the keys of the blocks cached that are written, invalidated in the cache after a successful commit
+class DataBlockCacheTransaction
+	:public DatabaseTransactionInterface
+{
+public:
+	/// \brief Constructor
+	/// \param[in] transaction_ transaction to forward all calls to (with ownership)
+	/// \param[in] cache_ cache to invalidate the blocks written in
+	DataBlockCacheTransaction( DatabaseTransactionInterface* transaction_, DataBlockCache* cache_)
+		:m_transaction(transaction_),m_cache(cache_),m_keys(),m_subtrees(){}
+	virtual ~DataBlockCacheTransaction(){}
+
+	virtual DatabaseCursorInterface* createCursor( const DatabaseOptions& options) const;
+	virtual void write( const char* key, std::size_t keysize, const char* value, std::size_t valuesize);
+	virtual void remove( const char* key, std::size_t keysize);
+	virtual void removeSubTree( const char* domainkey, std::size_t domainkeysize);
+	virtual bool commit();
+	virtual void rollback();
+
+private:
+	Reference<DatabaseTransactionInterface> m_transaction;	///< transaction forwarded to
+	DataBlockCache* m_cache;				///< cache to invalidate the blocks written in
+	std::vector<std::string> m_keys;			///< keys of blocks cached written or removed
+	std::vector<std::string> m_subtrees;			///< key prefixes of subtrees removed that contain blocks cached
+};
+
+}//namespace
+#endif
+
@@ -141,9 +141,8 @@ bool DatabaseAdapter_DataBlock::Reader::load( const Index& elemno, DataBlock& bl
 {
 	m_dbkey.resize( m_domainKeySize);
 	m_dbkey.addElem( elemno);
-	std::string blkstr;
-	if (!m_database->readValue( m_dbkey.ptr(), m_dbkey.size(), blkstr, DatabaseOptions())) return false;
-	blk.init( elemno, blkstr.c_str(), blkstr.size(), blkstr.size());
+	if (!m_database->readValuePinned( m_dbkey.ptr(), m_dbkey.size(), m_value, m_useCache?(DatabaseOptions().useCache()):(DatabaseOptions()))) return false;
+	blk.init( elemno, m_value.ptr(), m_value.size(), m_value.size());
 	return true;
 }
 
@@ -167,30 +166,67 @@ void DatabaseAdapter_DataBlock::Writer::removeSubTree( DatabaseTransactionInterf
 	transaction->removeSubTree( m_dbkey.ptr(), m_dbkey.size());
 }
 
-DatabaseAdapter_DataBlock::Cursor::Cursor( char prefix_, const DatabaseClientInterface* database_, const BlockKey& domainKey_, bool useCache_)
+DatabaseAdapter_DataBlock::Cursor::Cursor( char prefix_, const DatabaseClientInterface* database_, const BlockKey& domainKey_, bool useCache_, DataBlockCache* blockCache_, CreateCacheBlock createCacheBlock_)
 	:Base(prefix_,domainKey_)
 	,m_cursor(database_->createCursor( useCache_?(DatabaseOptions().useCache()):(DatabaseOptions())))
+	,m_blockCache(blockCache_),m_blockCacheGeneration(0),m_createCacheBlock(createCacheBlock_),m_cachedBlock(),m_lastElemno(0),m_positioned(true)
 {
 	if (!m_cursor.get()) throw std::runtime_error(_TXT("failed to create database cursor"));
+	if (m_blockCache)
+	{
+		// The generation is taken before the first read, blocks read by this cursor are not cached after a write on the domain:
+		m_blockCacheGeneration = m_blockCache->generation( m_dbkey.ptr(), m_domainKeySize);
+	}
 }
 
 bool DatabaseAdapter_DataBlock::Cursor::getBlock( const DatabaseCursorInterface::Slice& key, DataBlock& blk)
 {
-	if (!key.defined()) return false;
+	m_positioned = true;
+	if (!key.defined())
+	{
+		m_lastElemno = 0;
+		return false;
+	}
 	char const* ki = key.ptr()+m_domainKeySize;
 	char const* ke = ki + key.size()-m_domainKeySize;
 	Index elemno = unpackIndex( ki, ke);
 	DatabaseCursorInterface::Slice blkslice = m_cursor->value();
 	blk.init( elemno, blkslice.ptr(), blkslice.size());
+	m_cachedBlock.reset();
+	m_lastElemno = elemno;
+	return true;
+}
+
+bool DatabaseAdapter_DataBlock::Cursor::getCachedBlock( const Index& elemno, DataBlock& blk)
+{
+	DataBlockCache::BlockRef cached = m_blockCache->findUpperBound( m_dbkey.ptr(), m_domainKeySize, elemno);
+	if (!cached.get()) return false;
+	blk.init( cached->id(), cached->ptr(), cached->size());
+	//... the block references the memory of the block cached, that is kept alive by m_cachedBlock
+	m_cachedBlock = cached;
+	m_lastElemno = cached->id();
+	m_positioned = false;
 	return true;
 }
 
+void DatabaseAdapter_DataBlock::Cursor::cacheBlock( const Index& rangeStart, DataBlock& blk)
+{
+	DataBlockCache::BlockRef cached( m_createCacheBlock( blk));
+	m_blockCache->insert( m_dbkey.ptr(), m_domainKeySize, rangeStart, cached, m_blockCacheGeneration);
+	blk.init( cached->id(), cached->ptr(), cached->size());
+	//... the block returned references the block created for the cache, decoded only once, that is kept alive by m_cachedBlock
+	m_cachedBlock = cached;
+}
+
 bool DatabaseAdapter_DataBlock::Cursor::loadUpperBound( const Index& elemno, DataBlock& blk)
 {
 	m_dbkey.resize( m_domainKeySize);
+	if (m_blockCache && getCachedBlock( elemno, blk)) return true;
 	m_dbkey.addElem( elemno);
 	DatabaseCursorInterface::Slice key = m_cursor->seekUpperBound( m_dbkey.ptr(), m_dbkey.size(), m_domainKeySize);
-	return getBlock( key, blk);
+	if (!getBlock( key, blk)) return false;
+	if (m_blockCache) cacheBlock( elemno, blk);
+	return true;
 }
 
 bool DatabaseAdapter_DataBlock::Cursor::loadFirst( DataBlock& blk)
@@ -202,8 +238,17 @@ bool DatabaseAdapter_DataBlock::Cursor::loadFirst( DataBlock& blk)
 
 bool DatabaseAdapter_DataBlock::Cursor::loadNext( DataBlock& blk)
 {
+	if (!m_positioned)
+	{
+		// The last block was returned from the cache, the database cursor is not positioned on it:
+		if (!m_lastElemno) return false;
+		return loadUpperBound( m_lastElemno+1, blk);
+	}
+	Index prevElemno = m_lastElemno;
 	DatabaseCursorInterface::Slice key = m_cursor->seekNext();
-	return getBlock( key, blk);
+	if (!getBlock( key, blk)) return false;
+	if (m_blockCache && prevElemno) cacheBlock( prevElemno+1, blk);
+	return true;
 }
 
 bool DatabaseAdapter_DataBlock::Cursor::loadLast( DataBlock& blk)
@@ -235,15 +280,15 @@ bool DatabaseAdapter_DocMetaData::getBlock( const DatabaseCursorInterface::Slice
 
 bool DatabaseAdapter_DocMetaData::load( const Index& blockno, MetaDataBlock& blk)
 {
-	std::string blkstr;
 	DatabaseKey dbkey( KeyPrefix, blockno);
-	if (!m_database->readValue( dbkey.ptr(), dbkey.size(), blkstr, DatabaseOptions())) return false;
-	blk.init( m_descr, blockno, blkstr.c_str(), blkstr.size());
+	if (!m_database->readValuePinned( dbkey.ptr(), dbkey.size(), m_value, DatabaseOptions())) return false;
+	blk.init( m_descr, blockno, m_value.ptr(), m_value.size());
 	return true;
 }
 
 MetaDataBlock* DatabaseAdapter_DocMetaData::loadPtr( const Index& blockno)
 {
+	// ... called concurrently by the readers of the meta data block cache, the block created owns a copy of the value anyway
 	std::string blkstr;
 	DatabaseKey dbkey( KeyPrefix, blockno);
 	if (!m_database->readValue( dbkey.ptr(), dbkey.size(), blkstr, DatabaseOptions())) return 0;
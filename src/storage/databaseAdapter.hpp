@@ -12,6 +12,7 @@
 #include "strus/storage/databaseOptions.hpp"
 #include "strus/databaseClientInterface.hpp"
 #include "strus/databaseCursorInterface.hpp"
+#include "strus/storage/databasePinnedSlice.hpp"
 #include "strus/reference.hpp"
 #include "databaseKey.hpp"
 #include "dataBlock.hpp"
@@ -22,6 +23,7 @@
 #include "invTermBlock.hpp"
 #include "forwardIndexBlock.hpp"
 #include "blockKey.hpp"
+#include "dataBlockCache.hpp"
 #include <utility>
 #include <string>
 #include <cstring>
@@ -304,15 +306,18 @@ struct DatabaseAdapter_DataBlock
 	{
 	public:
 		Reader( char prefix_, const DatabaseClientInterface* database_, const BlockKey& domainKey_, bool useCache_)
-			:Base(prefix_,domainKey_),m_database(database_),m_useCache(useCache_){}
+			:Base(prefix_,domainKey_),m_database(database_),m_useCache(useCache_),m_value(){}
 		Reader( const Reader& o)
-			:Base(o),m_database(o.m_database),m_useCache(o.m_useCache){}
+			:Base(o),m_database(o.m_database),m_useCache(o.m_useCache),m_value(){}
 
+		/// \brief Load a block
+		/// \note The block loaded owns a copy of the value, it stays valid after the next call of load or the destruction of the reader
 		bool load( const Index& docno, DataBlock& blk);
 
 	private:
 		const DatabaseClientInterface* m_database;
 		bool m_useCache;
+		DatabasePinnedSlice m_value;			///< value of the last block loaded, its buffer is reused for the next read
 	};
 
 	class Writer
@@ -336,20 +341,45 @@ struct DatabaseAdapter_DataBlock
 		:public Base
 	{
 	public:
-		Cursor( char prefix_, const DatabaseClientInterface* database_, const BlockKey& domainKey_, bool useCache_);
+		/// \brief Function creating the block inserted into the cache for a block read from the database
+		typedef DataBlock* (*CreateCacheBlock)( const DataBlock& blk);
+
+		/// \brief Constructor
+		/// \param[in] blockCache_ cache of blocks shared by all cursors of the storage or NULL, if blocks are read from the database only
+		/// \param[in] createCacheBlock_ function creating the block inserted into the cache for a block read from the database
+		Cursor( char prefix_, const DatabaseClientInterface* database_, const BlockKey& domainKey_, bool useCache_, DataBlockCache* blockCache_=0, CreateCacheBlock createCacheBlock_=&DataBlock::createCacheBlock);
 		Cursor( const Cursor& o)
-			:Base(o),m_cursor(o.m_cursor){}
+			:Base(o),m_cursor(o.m_cursor)
+			,m_blockCache(o.m_blockCache),m_blockCacheGeneration(o.m_blockCacheGeneration),m_createCacheBlock(o.m_createCacheBlock),m_cachedBlock(o.m_cachedBlock)
+			,m_lastElemno(o.m_lastElemno),m_positioned(o.m_positioned){}
 
 		bool loadUpperBound( const Index& elemno, DataBlock& blk);
 		bool loadFirst( DataBlock& blk);
 		bool loadNext( DataBlock& blk);
 		bool loadLast( DataBlock& blk);
 
+	protected:
+		/// \brief Get the block of the cache the last block returned references the memory of or NULL if it references database memory
+		const DataBlock* cachedBlock() const
+		{
+			return m_cachedBlock.get();
+		}
+
 	private:
 		bool getBlock( const DatabaseCursorInterface::Slice& key, DataBlock& blk);
+		bool getCachedBlock( const Index& elemno, DataBlock& blk);
+		void cacheBlock( const Index& rangeStart, DataBlock& blk);
 
 	protected:
 		Reference<DatabaseCursorInterface> m_cursor;
+
+	private:
+		DataBlockCache* m_blockCache;			///< shared block cache or NULL
+		unsigned int m_blockCacheGeneration;		///< generation of the cache partition of the domain at creation of the cursor
+		CreateCacheBlock m_createCacheBlock;		///< function creating the block inserted into the cache
+		DataBlockCache::BlockRef m_cachedBlock;		///< reference to the block of the cache the last block returned references the memory of
+		Index m_lastElemno;				///< id of the last block returned or 0
+		bool m_positioned;				///< true if the database cursor is positioned on the last block returned
 	};
 };
 
@@ -394,8 +424,8 @@ struct DatabaseAdapter_TypedDataBlock
 		:public DatabaseAdapter_DataBlock::Cursor
 	{
 	public:
-		Cursor( const DatabaseClientInterface* database_, const BlockKey& domainKey_,bool useCache_=UseCache)
-			:DatabaseAdapter_DataBlock::Cursor(KeyPrefix,database_,domainKey_,useCache_){}
+		Cursor( const DatabaseClientInterface* database_, const BlockKey& domainKey_,bool useCache_=UseCache, DataBlockCache* blockCache_=0)
+			:DatabaseAdapter_DataBlock::Cursor(KeyPrefix,database_,domainKey_,useCache_,blockCache_,&DataBlockType::createCacheBlock){}
 		Cursor( const Cursor& o)
 			:DatabaseAdapter_DataBlock::Cursor(o){}
 
@@ -404,6 +434,8 @@ struct DatabaseAdapter_TypedDataBlock
 			DataBlock blk_;
 			if (!DatabaseAdapter_DataBlock::Cursor::loadUpperBound( elemno, blk_)) return false;
 			blk.swap( blk_);//... swap calls the final initialization of the block (including frame)
+			if (cachedBlock()) blk.attachCacheBlock( *cachedBlock());
+			//... the decoded data of a block of the cache is shared and not decoded again
 			return true;
 		}
 
@@ -420,6 +452,7 @@ struct DatabaseAdapter_TypedDataBlock
 			DataBlock blk_;
 			if (!DatabaseAdapter_DataBlock::Cursor::loadNext( blk_)) return false;
 			blk.swap( blk_);//... swap calls the final initialization of the block (including frame)
+			if (cachedBlock()) blk.attachCacheBlock( *cachedBlock());
 			return true;
 		}
 
@@ -463,8 +496,8 @@ struct DatabaseAdapter_ForwardIndex
 	{
 	public:
 		Cursor( const DatabaseClientInterface* database_,
-			const Index& typeno_, const Index& docno_)
-			:Parent::Cursor( database_, BlockKey(typeno_,docno_)){}
+			const Index& typeno_, const Index& docno_, DataBlockCache* blockCache_=0)
+			:Parent::Cursor( database_, BlockKey(typeno_,docno_), false, blockCache_){}
 		Cursor( const Cursor& o)
 			:Parent::Cursor(o){}
 	};
@@ -503,8 +536,8 @@ struct DatabaseAdapter_PosinfoBlock
 	{
 	public:
 		Cursor( const DatabaseClientInterface* database_,
-			const Index& typeno_, const Index& termno_)
-			:Parent::Cursor( database_, BlockKey(typeno_,termno_)){}
+			const Index& typeno_, const Index& termno_, DataBlockCache* blockCache_=0)
+			:Parent::Cursor( database_, BlockKey(typeno_,termno_), true/*use cache*/, blockCache_){}
 		Cursor( const Cursor& o)
 			:Parent::Cursor(o){}
 	};
@@ -554,8 +587,8 @@ struct DatabaseAdapter_FfBlock
 	{
 	public:
 		Cursor( const DatabaseClientInterface* database_,
-			const Index& typeno_, const Index& termno_)
-			:Parent::Cursor( database_, BlockKey(typeno_,termno_)){}
+			const Index& typeno_, const Index& termno_, DataBlockCache* blockCache_=0)
+			:Parent::Cursor( database_, BlockKey(typeno_,termno_), true/*use cache*/, blockCache_){}
 		Cursor( const Cursor& o)
 			:Parent::Cursor(o){}
 	};
@@ -858,7 +891,7 @@ class DatabaseAdapter_DocMetaData
 {
 public:
 	explicit DatabaseAdapter_DocMetaData( const DatabaseClientInterface* database_, const MetaDataDescription* descr_)
-		:m_database( database_),m_descr(descr_){}
+		:m_database( database_),m_descr(descr_),m_value(){}
 
 	MetaDataBlock* loadPtr( const Index& blockno);
 	bool load( const Index& blockno, MetaDataBlock& blk);
@@ -875,6 +908,7 @@ private:
 	const DatabaseClientInterface* m_database;
 	Reference<DatabaseCursorInterface> m_cursor;
 	const MetaDataDescription* m_descr;
+	DatabasePinnedSlice m_value;			///< value of the last block read with 'load', reused for the next read
 };
 
 
@@ -8,6 +8,7 @@
 #ifndef _STRUS_DOCUMENT_BLOCK_ITERATOR_TEMPLATE_HPP_INCLUDED
 #define _STRUS_DOCUMENT_BLOCK_ITERATOR_TEMPLATE_HPP_INCLUDED
 #include "strus/reference.hpp"
+#include "strus/storage/postingBlockSummary.hpp"
 #include "databaseAdapter.hpp"
 #include "docIndexNode.hpp"
 
@@ -105,6 +106,14 @@ public:
 
 	bool isCloseCandidate( const Index& docno_) const	{return m_docno_start <= docno_ && m_docno_end >= docno_;}
 	const BlockType& currentBlock() const			{return m_blk;}
+
+	/// \brief Get the summary of the current block, valid from the current document to the end of the block
+	/// \note Only defined for block types with a summary
+	PostingBlockSummary blockSummary() const
+	{
+		if (!m_docno || !m_blk.summary()) return PostingBlockSummary();
+		return PostingBlockSummary( m_docno_end, m_blk.summary()->maxff, m_blk.summary()->mindoclen);
+	}
 	BlockCursorType& currentBlockCursor()			{return m_blkCursor;}
 	const BlockCursorType& currentBlockCursor() const	{return m_blkCursor;}
 
@@ -58,6 +58,15 @@ void DocumentFrequencyMap::renameNewTermNumbers( const std::map<Index,Index>& re
 	}
 }
 
+void DocumentFrequencyMap::collectTerms( std::set<std::pair<Index,Index> >& termset) const
+{
+	Map::const_iterator mi = m_map.begin(), me = m_map.end();
+	for (; mi != me; ++mi)
+	{
+		termset.insert( mi->first);
+	}
+}
+
 void DocumentFrequencyMap::getWriteBatch(
 		DatabaseTransactionInterface* transaction,
 		StatisticsBuilderInterface* statisticsBuilder,
@@ -12,6 +12,7 @@
 #include "documentFrequencyCache.hpp"
 #include <cstdlib>
 #include <map>
+#include <set>
 
 namespace strus {
 
@@ -35,6 +36,9 @@ public:
 
 	void renameNewTermNumbers( const std::map<Index,Index>& renamemap);
 
+	/// \brief Collect all terms (typeno,termno) with a df change
+	void collectTerms( std::set<std::pair<Index,Index> >& termset) const;
+
 	void getWriteBatch(
 			DatabaseTransactionInterface* transaction,
 			StatisticsBuilderInterface* statisticsBuilder,
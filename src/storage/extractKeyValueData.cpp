@@ -406,6 +406,21 @@ ForwardIndexData::ForwardIndexData( const strus::DatabaseCursorInterface::Slice&
 	Index prevpos = 0;
 	for (; bi != be; bi = blk.nextItem( bi))
 	{
+		Index curpos = blk.position_at(bi);
+		if (curpos <= prevpos)
+		{
+			throw std::runtime_error( _TXT( "positions in forward index are not in strictly ascending order"));
+		}
+		if (curpos > pos)
+		{
+			throw std::runtime_error( _TXT( "position found in forward index that is bigger than the block id"));
+		}
+		Index termno = blk.termno_at( bi);
+		if (termno)
+		{
+			elements.push_back( Element( curpos, std::string(), termno));
+			continue;
+		}
 		std::string valuestr( blk.value_at( bi));
 		if (!strus::checkStringUtf8( valuestr.c_str(), valuestr.size()))
 		{
@@ -419,15 +434,6 @@ ForwardIndexData::ForwardIndexData( const strus::DatabaseCursorInterface::Slice&
 			std::string encvalue = encodeString( valuestr);
 			throw strus::runtime_error( _TXT( "value in forward index is not a valid UTF-8 string: '%s' [%s]"), valuestr.c_str(), encvalue.c_str());
 		}
-		Index curpos = blk.position_at(bi);
-		if (curpos <= prevpos)
-		{
-			throw std::runtime_error( _TXT( "positions in forward index are not in strictly ascending order"));
-		}
-		if (curpos > pos)
-		{
-			throw std::runtime_error( _TXT( "position found in forward index that is bigger than the block id"));
-		}
 		elements.push_back( Element( curpos, valuestr));
 	}
 }
@@ -440,9 +446,15 @@ void ForwardIndexData::print( std::ostream& out)
 
 	for (; ei != ee; ++ei)
 	{
-		out << ' ' << ei->pos
-			<< ' '
-			<< escapestr( ei->value.c_str(), ei->value.size());
+		out << ' ' << ei->pos << ' ';
+		if (ei->termno)
+		{
+			out << '#' << ei->termno;
+		}
+		else
+		{
+			out << escapestr( ei->value.c_str(), ei->value.size());
+		}
 	}
 	out << std::endl;
 }
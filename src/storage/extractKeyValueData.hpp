@@ -109,12 +109,13 @@ struct ForwardIndexData
 	{
 		Index pos;
 		std::string value;
+		Index termno;		///< term value number if the value is stored dictionary encoded, 0 else
 
-		Element() :pos(0){}
+		Element() :pos(0),termno(0){}
 		Element( const Element& o)
-			:pos(o.pos),value(o.value){}
-		Element( const Index& pos_, const std::string& value_)
-			:pos(pos_),value(value_){}
+			:pos(o.pos),value(o.value),termno(o.termno){}
+		Element( const Index& pos_, const std::string& value_, const Index& termno_=0)
+			:pos(pos_),value(value_),termno(termno_){}
 	};
 	std::vector<Element> elements;
 
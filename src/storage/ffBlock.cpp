@@ -6,6 +6,8 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "ffBlock.hpp"
+#include "memBlock.hpp"
+#include <cstring>
 
 using namespace strus;
 
@@ -14,11 +16,25 @@ void FfBlock::initFrame()
 	if (size() < sizeof(int))
 	{
 		m_ffIndexNodeArray.init( 0, 0);
+		m_summary = 0;
 	}
 	else
 	{
-		int nofFfIndexNodes = size() / sizeof( FfIndexNode);
-		const FfIndexNode* ffIndexNodes = (const FfIndexNode*)ptr();
+		unsigned int header = *(const unsigned int*)ptr();
+		const char* nodeptr = (const char*)ptr();
+		m_summary = 0;
+		if (header & FormatFlag)
+		{
+			nodeptr += sizeof(unsigned int);
+			if (header & SummaryFlag)
+			{
+				m_summary = (const BlockSummary*)(const void*)nodeptr;
+				nodeptr += sizeof(BlockSummary);
+			}
+		}
+		//... else block written with an earlier version without header and summary
+		int nofFfIndexNodes = (charend() - nodeptr) / sizeof( FfIndexNode);
+		const FfIndexNode* ffIndexNodes = (const FfIndexNode*)(const void*)nodeptr;
 		m_ffIndexNodeArray.init( ffIndexNodes, nofFfIndexNodes);
 	}
 }
@@ -224,8 +240,32 @@ FfBlock FfBlockBuilder::createBlock() const
 {
 	if (empty()) throw std::runtime_error(_TXT("tried to create empty posinfo block"));
 
-	std::size_t blksize = m_ffIndexNodeArray.size() * sizeof(FfIndexNode);
-	return FfBlock( m_id?m_id:m_lastDoc, m_ffIndexNodeArray.data(), blksize, true/*allocated, means copied*/);
+	std::size_t nodesize = m_ffIndexNodeArray.size() * sizeof(FfIndexNode);
+	std::size_t blksize = sizeof(unsigned int) + sizeof(BlockSummary) + nodesize;
+	MemBlock blkmem( blksize);
+	char* nodeptr = (char*)blkmem.ptr();
+	*(unsigned int*)(void*)nodeptr = (unsigned int)FfBlock::FormatFlag | (unsigned int)FfBlock::SummaryFlag;
+	nodeptr += sizeof(unsigned int);
+	*(BlockSummary*)(void*)nodeptr = summary();
+	nodeptr += sizeof(BlockSummary);
+	std::memcpy( nodeptr, m_ffIndexNodeArray.data(), nodesize);
+	return FfBlock( m_id?m_id:m_lastDoc, blkmem.ptr(), blksize, true/*allocated, means copied*/);
+}
+
+BlockSummary FfBlockBuilder::summary() const
+{
+	BlockSummary rt;
+	std::vector<FfIndexNode>::const_iterator ni = m_ffIndexNodeArray.begin(), ne = m_ffIndexNodeArray.end();
+	for (; ni != ne; ++ni)
+	{
+		std::size_t ei = 0, ee = ni->nofElements();
+		for (; ei != ee; ++ei)
+		{
+			unsigned int ff = ni->ff_at( ei);
+			rt.add( ff, ff/*a document has at least ff positions*/);
+		}
+	}
+	return rt;
 }
 
 
@@ -9,6 +9,7 @@
 #define _STRUS_FF_BLOCK_HPP_INCLUDED
 #include "dataBlock.hpp"
 #include "ffIndexNode.hpp"
+#include "blockSummary.hpp"
 #include "strus/constants.hpp"
 #include <vector>
 #include <algorithm>
@@ -17,12 +18,17 @@ namespace strus {
 
 /// \class FfBlock
 /// \brief Block for fast access of ff for initial query evaluation
+/// \note Layout: [FormatFlag|SummaryFlag] [BlockSummary (if SummaryFlag set)] [FfIndexNode array]
+/// \note Blocks written with an earlier version have no header and start with the FfIndexNode array, detected by the FormatFlag not set, because the first document number of a block never has the highest bit set
 class FfBlock
 	:public DataBlock
 {
+public:
+	enum {FormatFlag=0x80000000U, SummaryFlag=0x40000000U};
+
 public:
 	explicit FfBlock()
-		:DataBlock(),m_ffIndexNodeArray()
+		:DataBlock(),m_ffIndexNodeArray(),m_summary(0)
 	{}
 	FfBlock( const FfBlock& o)
 		:DataBlock(o)
@@ -99,11 +105,18 @@ public:
 		return m_ffIndexNodeArray;
 	}
 
+	/// \brief Get the summary of the block (max ff, min document length) or NULL if the block was written without
+	const BlockSummary* summary() const
+	{
+		return m_summary;
+	}
+
 private:
 	void initFrame();
 
 private:
 	FfIndexNodeArray m_ffIndexNodeArray;
+	const BlockSummary* m_summary;
 };
 
 
@@ -153,6 +166,7 @@ public:
 	const std::vector<FfIndexNode>& ffIndexNodeArray() const	{return m_ffIndexNodeArray;}
 
 	FfBlock createBlock() const;
+	BlockSummary summary() const;
 
 	void clear()
 	{
@@ -163,7 +177,7 @@ public:
 
 	int size() const
 	{
-		return sizeof(int) + (m_ffIndexNodeArray.size() * sizeof(FfIndexNode));
+		return sizeof(unsigned int) + sizeof(BlockSummary) + (m_ffIndexNodeArray.size() * sizeof(FfIndexNode));
 	}
 	strus::Index lastDoc() const
 	{
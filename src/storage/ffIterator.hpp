@@ -23,8 +23,8 @@ class FfIterator
 	:public DocumentBlockIteratorTemplate<DatabaseAdapter_FfBlock::Cursor,FfBlock,FfIndexNodeCursor>
 {
 public:
-	FfIterator( const StorageClient* storage_, const DatabaseClientInterface* database_, Index termtypeno_, Index termvalueno_, GlobalCounter df_)
-		:DocumentBlockIteratorTemplate<DatabaseAdapter_FfBlock::Cursor,FfBlock,FfIndexNodeCursor>( DatabaseAdapter_FfBlock::Cursor(database_,termtypeno_,termvalueno_))
+	FfIterator( const StorageClient* storage_, const DatabaseClientInterface* database_, DataBlockCache* blockCache_, Index termtypeno_, Index termvalueno_, GlobalCounter df_)
+		:DocumentBlockIteratorTemplate<DatabaseAdapter_FfBlock::Cursor,FfBlock,FfIndexNodeCursor>( DatabaseAdapter_FfBlock::Cursor(database_,termtypeno_,termvalueno_,blockCache_))
 		,m_storage(storage_)
 		,m_termtypeno(termtypeno_)
 		,m_termvalueno(termvalueno_)
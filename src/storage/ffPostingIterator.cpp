@@ -42,7 +42,7 @@ FfPostingIterator::FfPostingIterator(
 		ErrorBufferInterface* errorhnd_)
 #endif
 	:m_docnoIterator(database_, DatabaseKey::DocListBlockPrefix, BlockKey( termtypeno, termvalueno), true)
-	,m_ffIterator(storage_,database_, termtypeno, termvalueno, stats_.documentFrequency())
+	,m_ffIterator(storage_,database_, storage_->dataBlockCache(), termtypeno, termvalueno, stats_.documentFrequency())
 	,m_docno(0)
 	,m_termtypeno( termtypeno)
 	,m_termvalueno( termvalueno)
@@ -136,6 +136,19 @@ GlobalCounter FfPostingIterator::documentFrequency() const
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error in %s get document frequency: %s"), INTERFACE_NAME, *m_errorhnd, 0);
 }
 
+PostingBlockSummary FfPostingIterator::blockSummary()
+{
+	try
+	{
+		if (!m_docno || m_docno != m_ffIterator.skipDoc( m_docno))
+		{
+			return PostingBlockSummary();
+		}
+		return m_ffIterator.blockSummary();
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error in %s get block summary: %s"), INTERFACE_NAME, *m_errorhnd, PostingBlockSummary());
+}
+
 
 
 
@@ -157,7 +170,7 @@ FfNoIndexSetPostingIterator::FfNoIndexSetPostingIterator(
 		const TermStatistics& stats_,
 		ErrorBufferInterface* errorhnd_)
 #endif
-	:m_ffIterator(storage_,database_, termtypeno, termvalueno, stats_.documentFrequency())
+	:m_ffIterator(storage_,database_, storage_->dataBlockCache(), termtypeno, termvalueno, stats_.documentFrequency())
 	,m_docno(0)
 	,m_termtypeno( termtypeno)
 	,m_termvalueno( termvalueno)
@@ -227,3 +240,13 @@ GlobalCounter FfNoIndexSetPostingIterator::documentFrequency() const
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error in %s get document frequency: %s"), INTERFACE_NAME, *m_errorhnd, 0);
 }
 
+PostingBlockSummary FfNoIndexSetPostingIterator::blockSummary()
+{
+	try
+	{
+		if (!m_docno) return PostingBlockSummary();
+		return m_ffIterator.blockSummary();
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error in %s get block summary: %s"), INTERFACE_NAME, *m_errorhnd, PostingBlockSummary());
+}
+
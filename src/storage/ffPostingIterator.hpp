@@ -49,6 +49,8 @@ public:
 
 	virtual GlobalCounter documentFrequency() const;
 
+	virtual PostingBlockSummary blockSummary();
+
 	virtual Index docno() const
 	{
 		return m_docno;
@@ -107,6 +109,8 @@ public:
 
 	virtual GlobalCounter documentFrequency() const;
 
+	virtual PostingBlockSummary blockSummary();
+
 	virtual Index docno() const
 	{
 		return m_docno;
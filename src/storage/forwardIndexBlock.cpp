@@ -13,7 +13,7 @@
 
 using namespace strus;
 
-enum {EndItemMarker=(char)0xFE};
+enum {EndItemMarker=(char)0xFE, TermnoItemMarker=(char)0xFF};
 
 Index ForwardIndexBlock::position_at( const char* ref) const
 {
@@ -24,11 +24,45 @@ Index ForwardIndexBlock::position_at( const char* ref) const
 
 std::string ForwardIndexBlock::value_at( const char* ref) const
 {
-	if (ref == charend()) return 0;
+	std::size_t valuesize;
+	const char* value = value_at( ref, valuesize);
+	return std::string( value, valuesize);
+}
+
+const char* ForwardIndexBlock::value_at( const char* ref, std::size_t& valuesize) const
+{
+	if (ref == charend())
+	{
+		valuesize = 0;
+		return charend();
+	}
 	const char* namestart = skipIndex( ref, charend());
 	const char* nameend = (const char*)std::memchr( namestart, EndItemMarker, charend()-namestart);
 	if (!nameend) nameend = charend();
-	return std::string( namestart, nameend - namestart);
+	valuesize = nameend - namestart;
+	return namestart;
+}
+
+Index ForwardIndexBlock::termno_at( const char* ref) const
+{
+	std::size_t valuesize;
+	const char* value = value_at( ref, valuesize);
+	return termnoFromValue( value, valuesize);
+}
+
+std::string ForwardIndexBlock::termnoValue( strus::Index termno)
+{
+	std::string rt;
+	rt.push_back( TermnoItemMarker);
+	packIndex( rt, termno);
+	return rt;
+}
+
+Index ForwardIndexBlock::termnoFromValue( const char* value, std::size_t valuesize)
+{
+	if (!valuesize || *value != TermnoItemMarker) return 0;
+	char const* vi = value+1;
+	return unpackIndex( vi, value+valuesize);
 }
 
 const char* ForwardIndexBlock::nextItem( const char* ref) const
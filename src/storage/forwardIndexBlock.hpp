@@ -49,6 +49,20 @@ public:
 	void setId( strus::Index id_);
 	Index position_at( const char* ref) const;
 	std::string value_at( const char* ref) const;
+	/// \brief Get the value of an item without copying it
+	/// \param[out] valuesize size of the value in bytes
+	/// \return pointer to the value in the block
+	const char* value_at( const char* ref, std::size_t& valuesize) const;
+	/// \brief Get the term value number of an item with a dictionary encoded value
+	/// \return the term value number or 0 if the value of the item is stored as string
+	Index termno_at( const char* ref) const;
+
+	/// \brief Get the value to append for an item stored dictionary encoded as term value number
+	/// \note The marker byte 0xFF starting the value never occurs in an UTF-8 string
+	static std::string termnoValue( strus::Index termno);
+	/// \brief Get the term value number of a dictionary encoded item value
+	/// \return the term value number or 0 if the value is a string
+	static Index termnoFromValue( const char* value, std::size_t valuesize);
 
 	Index relativeIndexFromPosition( strus::Index pos_) const {return id()-pos_+1;}
 	Index positionFromRelativeIndex( strus::Index rel_) const {return id()-rel_+1;}
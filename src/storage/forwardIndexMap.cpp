@@ -136,6 +136,51 @@ void ForwardIndexMap::renameNewDocNumbers( const std::map<Index,Index>& renamema
 	}
 }
 
+void ForwardIndexMap::renameNewTermNumbers( ForwardIndexBlock& blk, const std::map<Index,Index>& renamemap) const
+{
+	bool hasUnknown = false;
+	char const* bi = blk.charptr();
+	const char* be = blk.charend();
+	for (; !hasUnknown && bi != be; bi = blk.nextItem( bi))
+	{
+		hasUnknown = KeyMap::isUnknown( blk.termno_at( bi));
+	}
+	if (!hasUnknown) return;
+
+	ForwardIndexBlock newblk;
+	newblk.setId( blk.id());
+	for (bi = blk.charptr(); bi != be; bi = blk.nextItem( bi))
+	{
+		Index termno = blk.termno_at( bi);
+		if (KeyMap::isUnknown( termno))
+		{
+			std::map<Index,Index>::const_iterator ri = renamemap.find( termno);
+			if (ri == renamemap.end())
+			{
+				throw strus::runtime_error( _TXT( "termno undefined (%s)"), "forward index map");
+			}
+			newblk.append( blk.position_at( bi), ForwardIndexBlock::termnoValue( ri->second));
+		}
+		else
+		{
+			newblk.append( blk.position_at( bi), blk.value_at( bi));
+		}
+	}
+	blk = newblk;
+}
+
+void ForwardIndexMap::renameNewTermNumbers( const std::map<Index,Index>& renamemap)
+{
+	if (renamemap.empty()) return;
+	closeCurblocks();
+
+	BlockList::iterator bi = m_blocklist.begin(), be = m_blocklist.end();
+	for (; bi != be; ++bi)
+	{
+		renameNewTermNumbers( *bi, renamemap);
+	}
+}
+
 void ForwardIndexMap::defineForwardIndexTerm(
 	const Index& typeno,
 	const Index& pos,
@@ -162,6 +207,14 @@ void ForwardIndexMap::defineForwardIndexTerm(
 	bi->second.push_back( CurblockElem( pos, m_strings.back()));
 }
 
+void ForwardIndexMap::defineForwardIndexTermno(
+	const Index& typeno,
+	const Index& pos,
+	const Index& termno)
+{
+	defineForwardIndexTerm( typeno, pos, ForwardIndexBlock::termnoValue( termno));
+}
+
 void ForwardIndexMap::deleteIndex( const Index& docno)
 {
 	if (docno == m_docno)
@@ -215,13 +268,13 @@ void ForwardIndexMap::deleteIndex( const Index& docno, const Index& typeno)
 	}
 }
 
-void ForwardIndexMap::getWriteBatch( DatabaseTransactionInterface* transaction)
+void ForwardIndexMap::getWriteBatch( DatabaseTransactionInterface* transaction, bool newDocumentsOnly)
 {
 	closeCurblocks();
 
-	// [1] Write deletes:
+	// [1] Write deletes (no blocks to delete, if all documents are new):
 	std::set<Index>::const_iterator di = m_docno_deletes.begin(), de = m_docno_deletes.end();
-	for (; di != de; ++di)
+	for (; !newDocumentsOnly && di != de; ++di)
 	{
 		Index ti = 1, te = m_maxtype+1;
 		for (; ti != te; ++ti)
@@ -253,7 +306,10 @@ void ForwardIndexMap::getWriteBatch( DatabaseTransactionInterface* transaction)
 		DatabaseAdapter_ForwardIndex::Writer dbadapter( m_database, key.elem(1), key.elem(2));
 
 		// [2.1] Delete all old blocks:
-		dbadapter.removeSubTree( transaction);
+		if (!newDocumentsOnly)
+		{
+			dbadapter.removeSubTree( transaction);
+		}
 
 		// [2.2] Write the new blocks:
 		for (; ei != ee; ++ei)
@@ -41,13 +41,25 @@ public:
 		const Index& pos,
 		const std::string& termstring);
 
+	/// \brief Define a forward index term stored dictionary encoded as term value number
+	/// \param[in] termno term value number, may be a number allocated by the transaction that is renamed on commit
+	void defineForwardIndexTermno(
+		const Index& typeno,
+		const Index& pos,
+		const Index& termno);
+
 	void closeForwardIndexDocument();
 
 	void deleteIndex( const Index& docno);
 	void deleteIndex( const Index& docno, const Index& typeno);
 
 	void renameNewDocNumbers( const std::map<Index,Index>& renamemap);
-	void getWriteBatch( DatabaseTransactionInterface* transaction);
+	/// \brief Rename the term value numbers allocated by the transaction in the dictionary encoded items
+	void renameNewTermNumbers( const std::map<Index,Index>& renamemap);
+	/// \brief Fill a transaction with the deletes and inserts of the map
+	/// \param[in] transaction transaction to fill
+	/// \param[in] newDocumentsOnly true, if all documents are new (bulk load mode), then the deletes of old blocks that do not exist are skipped
+	void getWriteBatch( DatabaseTransactionInterface* transaction, bool newDocumentsOnly=false);
 
 	void clear();
 	void reset( const Index& maxtype_);
@@ -85,6 +97,7 @@ private:
 private:
 	void closeCurblock( const Index& typeno, const CurblockElemList& blk);
 	void closeCurblocks();
+	void renameNewTermNumbers( ForwardIndexBlock& blk, const std::map<Index,Index>& renamemap) const;
 
 private:
 	DatabaseClientInterface* m_database;
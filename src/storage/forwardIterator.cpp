@@ -13,16 +13,22 @@
 #include "strus/databaseTransactionInterface.hpp"
 #include "private/internationalization.hpp"
 #include "private/errorUtils.hpp"
+#include <limits>
 
 using namespace strus;
 
 ForwardIterator::ForwardIterator( const StorageClient* storage_, const DatabaseClientInterface* database_, const std::string& type_, ErrorBufferInterface* errorhnd_)
 	:m_database(database_)
+	,m_blockCache(storage_->dataBlockCache())
+	,m_termValueCache(storage_->termValueCache())
 	,m_dbadapter()
 	,m_blockitr(0)
 	,m_docno(0)
 	,m_typeno(storage_->getTermType( type_))
 	,m_curpos(0)
+	,m_rangeText()
+	,m_dbadapter_termvalue(database_)
+	,m_termValueMap()
 	,m_errorhnd(errorhnd_)
 {
 	if (m_typeno == 0) throw strus::runtime_error( _TXT( "unknown term type name '%s'"), type_.c_str());
@@ -39,13 +45,18 @@ void ForwardIterator::skipDoc( const Index& docno_)
 		{
 			m_dbadapter.reset(
 				new DatabaseAdapter_ForwardIndex::Cursor(
-					m_database, m_typeno, docno_));
+					m_database, m_typeno, docno_, m_blockCache));
 			m_docno = docno_;
 			m_curblock.clear();
 			m_curblock_lastpos = 0;
 			m_curblock_firstpos = 0;
 			m_blockitr = 0;
 			m_curpos = 0;
+			if (m_termValueCache || m_termValueMap.size() > MaxTermValueMapSize)
+			{
+				//... with a shared cache only the values of the current document are kept here
+				m_termValueMap.clear();
+			}
 		}
 	}
 	CATCH_ERROR_MAP( _TXT("error forward iterator skip document: %s"), *m_errorhnd);
@@ -104,9 +115,102 @@ std::string ForwardIterator::fetch()
 		{
 			throw std::runtime_error( _TXT( "forward iterator fetch called without a term selected"));
 		}
-		return std::string( m_curblock.value_at( m_blockitr));
+		return valueAt( m_blockitr).tostring();
 	}
 	CATCH_ERROR_MAP_RETURN( _TXT("error forward iterator fetch value: %s"), *m_errorhnd, std::string());
 }
 
+ForwardIteratorInterface::Slice ForwardIterator::fetchSlice()
+{
+	try
+	{
+		if (!m_blockitr || m_curblock.empty())
+		{
+			throw std::runtime_error( _TXT( "forward iterator fetch called without a term selected"));
+		}
+		return valueAt( m_blockitr);
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error forward iterator fetch value: %s"), *m_errorhnd, Slice());
+}
+
+void ForwardIterator::fetchRange( const IndexRange& range, std::size_t maxNofTokens, std::vector<Token>& tokens)
+{
+	try
+	{
+		tokens.clear();
+		m_rangeText.clear();
+		std::size_t nofChecked = 0;	//... number of leading tokens checked for values referencing the memory of a block left
+
+		Index endpos = range.defined() ? range.end() : std::numeric_limits<Index>::max();
+		Index pos = skipPos( range.start());
+		for (; pos && pos < endpos; pos = skipPos( pos+1))
+		{
+			tokens.push_back( Token( pos, valueAt( m_blockitr)));
+			if (tokens.size() == maxNofTokens) break;
+
+			if (pos >= m_curblock_lastpos)
+			{
+				// The next item is in another block and the memory of the current block gets invalid with loading it,
+				// the values referencing the current block are copied and marked with a NULL pointer.
+				// Values decoded from term value numbers reference the decoding cache and stay valid:
+				for (; nofChecked < tokens.size(); ++nofChecked)
+				{
+					const Slice& value = tokens[ nofChecked].value;
+					if (value.ptr() >= m_curblock.charptr() && value.ptr() <= m_curblock.charend())
+					{
+						m_rangeText.append( value.ptr(), value.size());
+						tokens[ nofChecked].value = Slice( 0, value.size());
+					}
+				}
+			}
+		}
+		// Assign the values copied at the end, the buffer may get reallocated while appending:
+		std::size_t textofs = 0;
+		std::size_t ti = 0;
+		for (; ti < nofChecked; ++ti)
+		{
+			if (!tokens[ ti].value.ptr())
+			{
+				std::size_t valuesize = tokens[ ti].value.size();
+				tokens[ ti].value = Slice( m_rangeText.c_str() + textofs, valuesize);
+				textofs += valuesize;
+			}
+		}
+	}
+	CATCH_ERROR_MAP( _TXT("error forward iterator fetch range: %s"), *m_errorhnd);
+}
+
+ForwardIteratorInterface::Slice ForwardIterator::valueAt( const char* blkitr)
+{
+	std::size_t valuesize;
+	const char* value = m_curblock.value_at( blkitr, valuesize);
+	Index termno = ForwardIndexBlock::termnoFromValue( value, valuesize);
+	if (termno)
+	{
+		const std::string& termvalue = termValue( termno);
+		return Slice( termvalue.c_str(), termvalue.size());
+	}
+	return Slice( value, valuesize);
+}
+
+const std::string& ForwardIterator::termValue( const Index& termno)
+{
+	TermValueMap::const_iterator ci = m_termValueMap.find( termno);
+	if (ci != m_termValueMap.end()) return *ci->second;
+
+	TermValueCache::ValueRef value;
+	if (m_termValueCache) value = m_termValueCache->find( termno);
+	if (!value.get())
+	{
+		std::string termvalue;
+		if (!m_dbadapter_termvalue.load( termno, termvalue))
+		{
+			throw strus::runtime_error( _TXT( "term value number %d of forward index item not defined"), (int)termno);
+		}
+		value.reset( new std::string( termvalue));
+		if (m_termValueCache) m_termValueCache->insert( termno, value);
+	}
+	//... the map keeps the value referenced by the slices returned alive, if evicted from the shared cache
+	return *(m_termValueMap[ termno] = value);
+}
 
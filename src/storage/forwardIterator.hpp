@@ -12,6 +12,8 @@
 #include "storageClient.hpp"
 #include "forwardIndexBlock.hpp"
 #include <string>
+#include <vector>
+#include <map>
 
 namespace strus
 {
@@ -43,8 +45,21 @@ public:
 	/// \brief Fetch the item at the current position
 	virtual std::string fetch();
 
+	virtual Slice fetchSlice();
+
+	virtual void fetchRange( const IndexRange& range, std::size_t maxNofTokens, std::vector<Token>& tokens);
+
+private:
+	Slice valueAt( const char* blkitr);
+	const std::string& termValue( const Index& termno);
+
+	enum {MaxTermValueMapSize=(1<<16)};
+	typedef std::map<Index,TermValueCache::ValueRef> TermValueMap;
+
 private:
 	const DatabaseClientInterface* m_database;
+	DataBlockCache* m_blockCache;				///< shared block cache or NULL
+	TermValueCache* m_termValueCache;			///< shared cache of values decoded from term value numbers or NULL
 	Reference<DatabaseAdapter_ForwardIndex::Cursor> m_dbadapter;
 	ForwardIndexBlock m_curblock;
 	Index m_curblock_firstpos;
@@ -53,6 +68,9 @@ private:
 	Index m_docno;
 	Index m_typeno;
 	Index m_curpos;
+	std::string m_rangeText;				///< buffer for the values of a range fetched that are not in the current block anymore
+	DatabaseAdapter_TermValueInv::Reader m_dbadapter_termvalue;	///< db adapter for decoding values stored as term value numbers
+	TermValueMap m_termValueMap;				///< values decoded referenced by the slices returned, cleared when switching documents with a shared cache or with the map getting too big
 	ErrorBufferInterface* m_errorhnd;			///< error buffer for exception free interface
 };
 
@@ -0,0 +1,435 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Bulk loader for the inverted index writing the posinfo, ff and document list blocks of new documents in key order without reading back
+/// \file "invertedIndexBulkLoader.cpp"
+#include "invertedIndexBulkLoader.hpp"
+#include "booleanBlockBatchWrite.hpp"
+#include "ffBlockBatchWrite.hpp"
+#include "databaseAdapter.hpp"
+#include "indexPacker.hpp"
+#include "strus/databaseClientInterface.hpp"
+#include "strus/databaseTransactionInterface.hpp"
+#include "strus/reference.hpp"
+#include "strus/base/fileio.hpp"
+#include "strus/base/stdint.h"
+#include "strus/base/string_format.hpp"
+#include "strus/base/local_ptr.hpp"
+#include "private/internationalization.hpp"
+#include <algorithm>
+#include <queue>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+using namespace strus;
+
+#define MaxPositionsPerTransaction (1<<24)
+#define BulkLoadMarkerVariable "BulkLoad"
+
+InvertedIndexBulkLoader::InvertedIndexBulkLoader( DatabaseClientInterface* database_, const std::string& directory_, std::size_t memoryLimit_)
+	:m_mutex(),m_database(database_),m_directory(directory_),m_memoryLimit(memoryLimit_)
+	,m_postings(),m_posinfo(),m_runs(),m_nofPostings(0),m_markerWritten(false),m_postingsLost()
+{
+	int ec = strus::createDir( m_directory, false/*fail if exist*/);
+	if (ec == EEXIST)
+	{
+		throw strus::runtime_error( _TXT("bulk load directory '%s' exists, it may contain the runs of an interrupted bulk load, remove it to start a new bulk load"), m_directory.c_str());
+	}
+	else if (ec != 0)
+	{
+		throw strus::runtime_error( _TXT("error creating bulk load directory '%s': %s"), m_directory.c_str(), ::strerror(ec));
+	}
+}
+
+InvertedIndexBulkLoader::~InvertedIndexBulkLoader()
+{
+	//... runs not flushed are left in the directory for inspection, the marker in the storage prevents the storage from being opened
+}
+
+void InvertedIndexBulkLoader::getMarkerWriteBatch( DatabaseTransactionInterface* transaction)
+{
+	strus::scoped_lock lock( m_mutex);
+	DatabaseAdapter_Variable::Writer varstor( m_database);
+	varstor.store( transaction, BulkLoadMarkerVariable, 1);
+	m_markerWritten = true;
+}
+
+void InvertedIndexBulkLoader::declarePostingsLost( const std::string& reason)
+{
+	strus::scoped_lock lock( m_mutex);
+	if (m_postingsLost.empty()) m_postingsLost = reason;
+}
+
+void InvertedIndexBulkLoader::removeMarker( DatabaseTransactionInterface* transaction)
+{
+	DatabaseAdapter_Variable::Writer varstor( m_database);
+	varstor.remove( transaction, BulkLoadMarkerVariable);
+}
+
+bool InvertedIndexBulkLoader::interrupted( const DatabaseClientInterface* database)
+{
+	DatabaseAdapter_Variable::Reader varstor( database);
+	Index value = 0;
+	return varstor.load( BulkLoadMarkerVariable, value) && value != 0;
+}
+
+std::size_t InvertedIndexBulkLoader::memoryUsage() const
+{
+	return m_postings.size() * sizeof(Posting) + m_posinfo.size() * sizeof(PosinfoBlock::PositionType);
+}
+
+std::size_t InvertedIndexBulkLoader::nofPostings() const
+{
+	strus::scoped_lock lock( m_mutex);
+	return m_nofPostings;
+}
+
+void InvertedIndexBulkLoader::addPosting( const Index& typeno, const Index& termno, const Index& docno, const PosinfoBlock::PositionType* posar)
+{
+	strus::scoped_lock lock( m_mutex);
+	std::size_t posidx = m_posinfo.size();
+	m_posinfo.insert( m_posinfo.end(), posar, posar + posar[0] + 1);
+	m_postings.push_back( Posting( BlockKey( typeno, termno).index(), docno, posidx));
+	++m_nofPostings;
+	if (memoryUsage() >= m_memoryLimit)
+	{
+		writeRun();
+	}
+}
+
+static void writeRecord( std::FILE* file, std::string& recbuf, const std::string& filename)
+{
+	uint32_t recsize = recbuf.size();
+	if (1 != std::fwrite( &recsize, sizeof(recsize), 1, file)
+	||  1 != std::fwrite( recbuf.c_str(), recbuf.size(), 1, file))
+	{
+		throw strus::runtime_error( _TXT("error writing bulk load run file '%s': %s"), filename.c_str(), ::strerror( errno));
+	}
+}
+
+void InvertedIndexBulkLoader::writeRun()
+{
+	std::sort( m_postings.begin(), m_postings.end());
+	std::string filename = strus::joinFilePath( m_directory, strus::string_format( "bulkload%u.run", (unsigned int)m_runs.size()));
+	std::FILE* file = std::fopen( filename.c_str(), "wb");
+	if (!file)
+	{
+		throw strus::runtime_error( _TXT("error creating bulk load run file '%s': %s"), filename.c_str(), ::strerror( errno));
+	}
+	try
+	{
+		// Record format: [size][typeno][termno][docno][ff][positions...], all elements except size packed:
+		std::string recbuf;
+		std::vector<Posting>::const_iterator pi = m_postings.begin(), pe = m_postings.end();
+		for (; pi != pe; ++pi)
+		{
+			BlockKey blkkey( pi->termkey);
+			recbuf.clear();
+			packIndex( recbuf, blkkey.elem(1));
+			packIndex( recbuf, blkkey.elem(2));
+			packIndex( recbuf, pi->docno);
+			const PosinfoBlock::PositionType* posar = m_posinfo.data() + pi->posidx;
+			for (std::size_t ii=0,ie=posar[0]+1; ii != ie; ++ii)
+			{
+				packIndex( recbuf, (Index)posar[ ii]);
+			}
+			writeRecord( file, recbuf, filename);
+		}
+		if (0 != std::fclose( file))
+		{
+			file = 0;
+			throw strus::runtime_error( _TXT("error writing bulk load run file '%s': %s"), filename.c_str(), ::strerror( errno));
+		}
+		file = 0;
+	}
+	catch (...)
+	{
+		if (file) std::fclose( file);
+		(void)strus::removeFile( filename, false);
+		throw;
+	}
+	m_runs.push_back( filename);
+	m_postings.clear();
+	m_posinfo.clear();
+}
+
+/// \brief Sequential reader of the postings of a sorted run
+class InvertedIndexBulkLoader::RunReader
+{
+public:
+	explicit RunReader( const std::string& filename_)
+		:m_filename(filename_),m_file(std::fopen( filename_.c_str(), "rb"))
+		,m_termkey(0),m_docno(0),m_posar(),m_recbuf()
+	{
+		if (!m_file)
+		{
+			throw strus::runtime_error( _TXT("error opening bulk load run file '%s': %s"), m_filename.c_str(), ::strerror( errno));
+		}
+	}
+	~RunReader()
+	{
+		std::fclose( m_file);
+	}
+
+	/// \brief Read the next posting
+	/// \return false if the end of the run has been reached
+	bool next()
+	{
+		uint32_t recsize;
+		if (1 != std::fread( &recsize, sizeof(recsize), 1, m_file))
+		{
+			if (std::feof( m_file)) return false;
+			throwCorrupt();
+		}
+		m_recbuf.resize( recsize);
+		if (recsize == 0 || 1 != std::fread( &m_recbuf[0], recsize, 1, m_file)) throwCorrupt();
+
+		char const* ri = m_recbuf.c_str();
+		const char* re = ri + m_recbuf.size();
+		Index typeno = unpackIndex( ri, re);
+		Index termno = unpackIndex( ri, re);
+		m_termkey = BlockKey( typeno, termno).index();
+		m_docno = unpackIndex( ri, re);
+		m_posar.clear();
+		m_posar.push_back( unpackIndex( ri, re));
+		for (std::size_t ii=0; ii < m_posar[0]; ++ii)
+		{
+			if (ri == re) throwCorrupt();
+			m_posar.push_back( unpackIndex( ri, re));
+		}
+		if (ri != re) throwCorrupt();
+		return true;
+	}
+
+	const BlockKeyIndex& termkey() const				{return m_termkey;}
+	const Index& docno() const					{return m_docno;}
+	const PosinfoBlock::PositionType* posar() const			{return m_posar.data();}
+
+private:
+	void throwCorrupt() const
+	{
+		throw strus::runtime_error( _TXT("corrupt bulk load run file '%s'"), m_filename.c_str());
+	}
+
+private:
+	std::string m_filename;
+	std::FILE* m_file;
+	BlockKeyIndex m_termkey;
+	Index m_docno;
+	std::vector<PosinfoBlock::PositionType> m_posar;
+	std::string m_recbuf;
+};
+
+namespace {
+/// \brief Builder of the blocks of one term from postings appended in ascending order of document numbers
+class TermBlockWriter
+{
+public:
+	TermBlockWriter( DatabaseClientInterface* database_, const BlockKeyIndex& termkey_)
+		:m_database(database_),m_termkey(termkey_),m_posblk(),m_docrangear(),m_ffdeclar(){}
+
+	const BlockKeyIndex& termkey() const
+	{
+		return m_termkey;
+	}
+
+	void append( DatabaseTransactionInterface* transaction, DatabaseAdapter_PosinfoBlock::Writer& dbadapter_posinfo, const Index& docno, const PosinfoBlock::PositionType* posar)
+	{
+		if (!m_posblk.empty() && !m_posblk.fitsInto( posar[0] + 1))
+		{
+			dbadapter_posinfo.store( transaction, m_posblk.createBlock());
+			m_posblk.clear();
+		}
+		m_posblk.append( docno, posar);
+		if (!m_docrangear.empty() && m_docrangear.back().to + 1 == docno)
+		{
+			m_docrangear.back().to = docno;
+		}
+		else
+		{
+			m_docrangear.push_back( BooleanBlock::MergeRange( docno, docno, true));
+		}
+		m_ffdeclar.push_back( FfBlockBuilder::FfDeclaration( docno, posar[0]/*ff*/));
+	}
+
+	void finish( DatabaseTransactionInterface* transaction, DatabaseAdapter_PosinfoBlock::Writer& dbadapter_posinfo)
+	{
+		if (!m_posblk.empty())
+		{
+			dbadapter_posinfo.store( transaction, m_posblk.createBlock());
+			m_posblk.clear();
+		}
+		BlockKey blkkey( m_termkey);
+		Index typeno = blkkey.elem(1);
+		Index termno = blkkey.elem(2);
+		{
+			// The cursors are only used for writing, no block is read:
+			DatabaseAdapter_DocListBlock::WriteCursor dbadapter_doclist( m_database, typeno, termno);
+			BooleanBlock newdocblk;
+			std::vector<BooleanBlock::MergeRange>::iterator di = m_docrangear.begin(), de = m_docrangear.end();
+			BooleanBlockBatchWrite::insertNewElements( &dbadapter_doclist, di, de, newdocblk, transaction);
+		}{
+			DatabaseAdapter_FfBlock::WriteCursor dbadapter_ffblock( m_database, typeno, termno);
+			FfBlockBuilder newffblock;
+			std::vector<FfBlockBuilder::FfDeclaration>::iterator fi = m_ffdeclar.begin(), fe = m_ffdeclar.end();
+			FfBlockBatchWrite::insertNewElements( &dbadapter_ffblock, fi, fe, newffblock, transaction);
+		}
+		m_docrangear.clear();
+		m_ffdeclar.clear();
+	}
+
+private:
+	DatabaseClientInterface* m_database;
+	BlockKeyIndex m_termkey;
+	PosinfoBlockBuilder m_posblk;
+	std::vector<BooleanBlock::MergeRange> m_docrangear;
+	std::vector<FfBlockBuilder::FfDeclaration> m_ffdeclar;
+};
+
+/// \brief Element of the heap of runs ordered by the key of their current posting
+struct RunHeapElement
+{
+	BlockKeyIndex termkey;
+	Index docno;
+	std::size_t runidx;
+
+	RunHeapElement( const BlockKeyIndex& termkey_, const Index& docno_, std::size_t runidx_)
+		:termkey(termkey_),docno(docno_),runidx(runidx_){}
+	RunHeapElement( const RunHeapElement& o)
+		:termkey(o.termkey),docno(o.docno),runidx(o.runidx){}
+
+	/// \note Inverse order, as std::priority_queue returns the greatest element first
+	bool operator < (const RunHeapElement& o) const
+	{
+		if (termkey > o.termkey) return true;
+		if (termkey < o.termkey) return false;
+		return docno > o.docno;
+	}
+};
+}//anonymous namespace
+
+void InvertedIndexBulkLoader::mergeRuns()
+{
+	std::vector<Reference<RunReader> > readers;
+	std::priority_queue<RunHeapElement> heap;
+	std::vector<std::string>::const_iterator ri = m_runs.begin(), re = m_runs.end();
+	for (; ri != re; ++ri)
+	{
+		readers.push_back( Reference<RunReader>( new RunReader( *ri)));
+		if (readers.back()->next())
+		{
+			heap.push( RunHeapElement( readers.back()->termkey(), readers.back()->docno(), readers.size()-1));
+		}
+	}
+	strus::local_ptr<DatabaseTransactionInterface> transaction;
+	strus::local_ptr<TermBlockWriter> termwriter;
+	strus::local_ptr<DatabaseAdapter_PosinfoBlock::Writer> dbadapter_posinfo;
+	std::size_t nofPositions = 0;
+	Index lastdocno = 0;
+
+	while (!heap.empty())
+	{
+		RunHeapElement top = heap.top();
+		heap.pop();
+		RunReader& reader = *readers[ top.runidx];
+
+		if (!termwriter.get() || termwriter->termkey() != top.termkey)
+		{
+			if (termwriter.get())
+			{
+				termwriter->finish( transaction.get(), *dbadapter_posinfo);
+				if (nofPositions >= MaxPositionsPerTransaction)
+				{
+					// ... commit the blocks written so far at term boundaries to limit the size of a transaction
+					if (!transaction->commit()) throw std::runtime_error( _TXT("failed to commit blocks of bulk load"));
+					transaction.reset();
+					nofPositions = 0;
+				}
+			}
+			if (!transaction.get())
+			{
+				transaction.reset( m_database->createTransaction());
+				if (!transaction.get()) throw std::runtime_error( _TXT("failed to create transaction for bulk load"));
+			}
+			BlockKey blkkey( top.termkey);
+			termwriter.reset( new TermBlockWriter( m_database, top.termkey));
+			dbadapter_posinfo.reset( new DatabaseAdapter_PosinfoBlock::Writer( m_database, blkkey.elem(1), blkkey.elem(2)));
+		}
+		else if (top.docno <= lastdocno)
+		{
+			throw strus::runtime_error( _TXT("posting of document %d defined twice in bulk load"), (int)top.docno);
+		}
+		termwriter->append( transaction.get(), *dbadapter_posinfo, top.docno, reader.posar());
+		nofPositions += reader.posar()[0] + 1;
+		lastdocno = top.docno;
+
+		if (reader.next())
+		{
+			heap.push( RunHeapElement( reader.termkey(), reader.docno(), top.runidx));
+		}
+	}
+	if (termwriter.get())
+	{
+		termwriter->finish( transaction.get(), *dbadapter_posinfo);
+	}
+	else
+	{
+		transaction.reset( m_database->createTransaction());
+		if (!transaction.get()) throw std::runtime_error( _TXT("failed to create transaction for bulk load"));
+	}
+	// The marker of the bulk load in progress is removed with the last blocks written:
+	removeMarker( transaction.get());
+	if (!transaction->commit()) throw std::runtime_error( _TXT("failed to commit blocks of bulk load"));
+	m_markerWritten = false;
+}
+
+void InvertedIndexBulkLoader::removeRuns()
+{
+	std::vector<std::string>::const_iterator ri = m_runs.begin(), re = m_runs.end();
+	for (; ri != re; ++ri)
+	{
+		int ec = strus::removeFile( *ri, false);
+		if (ec != 0)
+		{
+			throw strus::runtime_error( _TXT("error removing bulk load run file '%s': %s"), ri->c_str(), ::strerror(ec));
+		}
+	}
+	m_runs.clear();
+}
+
+void InvertedIndexBulkLoader::flush()
+{
+	strus::scoped_lock lock( m_mutex);
+	if (!m_postingsLost.empty())
+	{
+		//... the marker stays set, the runs are left in the directory for inspection
+		throw strus::runtime_error( _TXT("postings of documents committed in bulk load mode were lost (%s), the storage has to be rebuilt"), m_postingsLost.c_str());
+	}
+	if (!m_postings.empty())
+	{
+		writeRun();
+	}
+	if (m_runs.empty())
+	{
+		if (m_markerWritten)
+		{
+			//... documents without postings committed
+			strus::local_ptr<DatabaseTransactionInterface> transaction( m_database->createTransaction());
+			if (!transaction.get()) throw std::runtime_error( _TXT("failed to create transaction for bulk load"));
+			removeMarker( transaction.get());
+			if (!transaction->commit()) throw std::runtime_error( _TXT("failed to commit end of bulk load"));
+			m_markerWritten = false;
+		}
+		return;
+	}
+	mergeRuns();
+	removeRuns();
+	m_nofPostings = 0;
+}
+
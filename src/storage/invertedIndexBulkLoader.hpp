@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Bulk loader for the inverted index writing the posinfo, ff and document list blocks of new documents in key order without reading back
+/// \file "invertedIndexBulkLoader.hpp"
+#ifndef _STRUS_STORAGE_INVERTED_INDEX_BULK_LOADER_HPP_INCLUDED
+#define _STRUS_STORAGE_INVERTED_INDEX_BULK_LOADER_HPP_INCLUDED
+#include "strus/storage/index.hpp"
+#include "strus/base/thread.hpp"
+#include "posinfoBlock.hpp"
+#include "blockKey.hpp"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+namespace strus {
+
+/// \brief Forward declaration
+class DatabaseClientInterface;
+/// \brief Forward declaration
+class DatabaseTransactionInterface;
+
+/// \brief Buffer for the postings of the inverted index of documents inserted in bulk load mode
+/// \note Postings are collected in memory and written as sorted runs to files in a directory when the memory limit is exceeded.
+///	The runs are merged on flush and the blocks of each term are built in key order and written without reading any block of the storage.
+/// \note Only documents with new document numbers can be loaded. Because new document numbers are greater than any document number
+///	in the storage, the blocks built can be appended to the blocks of a term already in the storage.
+/// \note The documents are committed before their postings are written. A marker variable is written with the first commit
+///	and removed with the last blocks written by flush. A storage with the marker set is not consistent and is refused on open.
+class InvertedIndexBulkLoader
+{
+public:
+	/// \brief Constructor
+	/// \param[in] database_ database to write the blocks to
+	/// \param[in] directory_ directory for the sorted runs, created if it does not exist
+	/// \param[in] memoryLimit_ maximum number of bytes of postings to buffer before writing them to a run
+	InvertedIndexBulkLoader( DatabaseClientInterface* database_, const std::string& directory_, std::size_t memoryLimit_=DefaultMemoryLimit);
+	~InvertedIndexBulkLoader();
+
+	enum {DefaultMemoryLimit=(1<<28)};
+
+	/// \brief Add the posting of a term in a document
+	/// \param[in] typeno term type number
+	/// \param[in] termno term value number
+	/// \param[in] docno document number
+	/// \param[in] posar array of positions with the number of positions (ff) as first element
+	void addPosting( const Index& typeno, const Index& termno, const Index& docno, const PosinfoBlock::PositionType* posar);
+
+	/// \brief Merge the runs and write the blocks of all postings added to the storage
+	/// \note The postings added are visible in the storage after flush
+	/// \note Removes the marker of a bulk load in progress with the last blocks written
+	void flush();
+
+	/// \brief Write the marker of a bulk load in progress into the transaction of a commit of documents loaded
+	/// \param[in] transaction transaction to write the marker to
+	void getMarkerWriteBatch( DatabaseTransactionInterface* transaction);
+
+	/// \brief Declare that postings of documents committed could not be added to the loader
+	/// \param[in] reason description of the error
+	/// \note The following flush fails and leaves the marker of the bulk load in progress set, so that the storage is refused on open
+	void declarePostingsLost( const std::string& reason);
+
+	/// \brief Evaluate if a storage contains documents of a bulk load with postings that were never written
+	/// \param[in] database database of the storage
+	/// \return true if the marker of a bulk load in progress is set
+	static bool interrupted( const DatabaseClientInterface* database);
+
+	/// \brief Get the number of postings added and not flushed yet
+	std::size_t nofPostings() const;
+
+	/// \brief Get the directory of the sorted runs
+	const std::string& directory() const	{return m_directory;}
+
+private:
+	/// \brief Posting referencing the positions in the buffer
+	struct Posting
+	{
+		BlockKeyIndex termkey;
+		Index docno;
+		std::size_t posidx;
+
+		Posting( const BlockKeyIndex& termkey_, const Index& docno_, std::size_t posidx_)
+			:termkey(termkey_),docno(docno_),posidx(posidx_){}
+		Posting( const Posting& o)
+			:termkey(o.termkey),docno(o.docno),posidx(o.posidx){}
+
+		bool operator < (const Posting& o) const
+		{
+			if (termkey < o.termkey) return true;
+			if (termkey > o.termkey) return false;
+			return docno < o.docno;
+		}
+	};
+
+	class RunReader;
+
+	void writeRun();
+	void mergeRuns();
+	void removeRuns();
+	void removeMarker( DatabaseTransactionInterface* transaction);
+	std::size_t memoryUsage() const;
+
+private:
+	InvertedIndexBulkLoader( const InvertedIndexBulkLoader&){}	//... non copyable
+	void operator=( const InvertedIndexBulkLoader&){}		//... non copyable
+
+private:
+	mutable strus::mutex m_mutex;				///< mutual exclusion of concurrent commits adding postings
+	DatabaseClientInterface* m_database;			///< database to write the blocks to
+	std::string m_directory;				///< directory of the sorted runs
+	std::size_t m_memoryLimit;				///< maximum size of the buffer in bytes
+	std::vector<Posting> m_postings;			///< postings buffered
+	std::vector<PosinfoBlock::PositionType> m_posinfo;	///< positions of the postings buffered, each preceded by its ff
+	std::vector<std::string> m_runs;			///< files of the sorted runs written
+	std::size_t m_nofPostings;				///< number of postings added and not flushed yet
+	bool m_markerWritten;					///< true if the marker of a bulk load in progress was written and not removed yet
+	std::string m_postingsLost;				///< error of adding the postings of documents committed or empty if all postings were added
+};
+
+}//namespace
+#endif
+
@@ -6,6 +6,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "invertedIndexMap.hpp"
+#include "invertedIndexBulkLoader.hpp"
 #include "booleanBlockBatchWrite.hpp"
 #include "ffBlockBatchWrite.hpp"
 #include "strus/databaseClientInterface.hpp"
@@ -20,8 +21,8 @@
 
 using namespace strus;
 
-InvertedIndexMap::InvertedIndexMap( DatabaseClientInterface* database_)
-	:m_dfmap(database_),m_database(database_),m_docno(0)
+InvertedIndexMap::InvertedIndexMap( DatabaseClientInterface* database_, InvertedIndexBulkLoader* bulkLoader_)
+	:m_dfmap(database_),m_database(database_),m_bulkLoader(bulkLoader_),m_docno(0)
 {
 	m_posinfo.push_back( 0);
 }
@@ -58,24 +59,13 @@ void InvertedIndexMap::definePosinfoPosting(
 	{
 		if (pos.size())
 		{
-			if (pos.size() > std::numeric_limits<PosinfoBlock::PositionType>::max())
-			{
-				throw strus::runtime_error( _TXT( "size of document out of range (max %u)"), 65535);
-			}
 			m_map[ key] = m_posinfo.size();
 
 			m_posinfo.push_back( (PosinfoBlock::PositionType)pos.size());	//... ff
 			std::vector<Index>::const_iterator pi = pos.begin(), pe = pos.end();
 			for (; pi != pe; ++pi)
 			{
-				if (*pi > std::numeric_limits<PosinfoBlock::PositionType>::max())
-				{
-					throw strus::runtime_error( _TXT( "token position out of range (max %u)"), 65535);
-				}
-				else
-				{
-					m_posinfo.push_back( (PosinfoBlock::PositionType)*pi);
-				}
+				m_posinfo.push_back( (PosinfoBlock::PositionType)*pi);
 			}
 		}
 		else
@@ -310,6 +300,56 @@ void InvertedIndexMap::renameNewNumbers(
 	}
 }
 
+void InvertedIndexMap::collectTerms( std::set<std::pair<Index,Index> >& termset) const
+{
+	DatabaseAdapter_InverseTerm::Reader dbadapter_inv( m_database);
+	// [1] Terms of the documents deleted (none in bulk load mode, where only new documents are inserted):
+	if (!m_bulkLoader)
+	{
+		std::set<Index>::const_iterator di = m_docno_deletes.begin(), de = m_docno_deletes.end();
+		for (; di != de; ++di)
+		{
+			InvTermBlock invblk;
+			if (dbadapter_inv.load( *di, invblk))
+			{
+				char const* ei = invblk.begin();
+				const char* ee = invblk.end();
+				for (;ei != ee; ei = invblk.next( ei))
+				{
+					InvTerm it = invblk.element_at( ei);
+					termset.insert( std::pair<Index,Index>( it.typeno, it.termno));
+				}
+			}
+		}
+	}{
+		std::map<Index, std::set<Index> >::const_iterator ui = m_docno_typeno_deletes.begin(), ue = m_docno_typeno_deletes.end();
+		for (; ui != ue; ++ui)
+		{
+			InvTermBlock invblk;
+			if (dbadapter_inv.load( ui->first, invblk))
+			{
+				char const* ei = invblk.begin();
+				const char* ee = invblk.end();
+				for (;ei != ee; ei = invblk.next( ei))
+				{
+					InvTerm it = invblk.element_at( ei);
+					termset.insert( std::pair<Index,Index>( it.typeno, it.termno));
+				}
+			}
+		}
+	}
+	// [2] Terms of the postings inserted and the df changes:
+	{
+		Map::const_iterator mi = m_map.begin(), me = m_map.end();
+		for (; mi != me; ++mi)
+		{
+			BlockKey blkkey( mi->first.termkey);
+			termset.insert( std::pair<Index,Index>( blkkey.elem(1), blkkey.elem(2)));
+		}
+	}
+	m_dfmap.collectTerms( termset);
+}
+
 void InvertedIndexMap::getWriteBatch(
 			DatabaseTransactionInterface* transaction,
 			StatisticsBuilderInterface* statisticsBuilder,
@@ -318,7 +358,12 @@ void InvertedIndexMap::getWriteBatch(
 			const KeyMapInv& termValueMapInv)
 {
 	DatabaseAdapter_InverseTerm::ReadWriter dbadapter_inv( m_database);
-	// [1] Get deletes:
+	if (m_bulkLoader && !m_docno_typeno_deletes.empty())
+	{
+		throw std::runtime_error( _TXT("partial update of documents not allowed in bulk load mode"));
+	}
+	// [1] Get deletes (only new documents are inserted in bulk load mode, so there is nothing to delete):
+	if (!m_bulkLoader)
 	{
 		std::set<Index>::const_iterator di = m_docno_deletes.begin(), de = m_docno_deletes.end();
 		for (; di != de; ++di)
@@ -408,8 +453,11 @@ void InvertedIndexMap::getWriteBatch(
 			}
 			dbadapter_inv.store( transaction, invblk);
 		}
-	}{
-		// [3] Get index inserts and term deletes (defined in [1]):
+	}
+	// [3] Get index inserts and term deletes (defined in [1]):
+	//	In bulk load mode the postings are passed to the bulk loader after commit
+	if (!m_bulkLoader)
+	{
 		Map::const_iterator mi = m_map.begin(), me = m_map.end();
 		while (mi != me)
 		{
@@ -464,6 +512,20 @@ void InvertedIndexMap::getWriteBatch(
 	}
 }
 
+void InvertedIndexMap::addPostingsToBulkLoader() const
+{
+	if (!m_bulkLoader) throw std::runtime_error( _TXT("logic error: bulk load mode not enabled"));
+	Map::const_iterator mi = m_map.begin(), me = m_map.end();
+	for (; mi != me; ++mi)
+	{
+		if (mi->second)
+		{
+			BlockKey blkkey( mi->first.termkey);
+			m_bulkLoader->addPosting( blkkey.elem(1), blkkey.elem(2), mi->first.docno, m_posinfo.data() + mi->second);
+		}
+	}
+}
+
 void InvertedIndexMap::defineDocnoRangeElement(
 		std::vector<BooleanBlock::MergeRange>& docrangear,
 		const Index& docno,
@@ -568,7 +630,7 @@ int InvertedIndexMap::estimatedPosBlockSize(
 	for (; ei != ee; ++ei)
 	{
 		int nofpos = m_posinfo[ ei->second];
-		rt += nofpos * sizeof(PosinfoBlock::PositionType);
+		rt += nofpos * PosinfoBlock::PositionElementSize;
 	}
 	return rt;
 }
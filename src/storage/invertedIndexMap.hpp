@@ -28,11 +28,17 @@ namespace strus {
 class DatabaseClientInterface;
 /// \brief Forward declaration
 class DatabaseTransactionInterface;
+/// \brief Forward declaration
+class InvertedIndexBulkLoader;
 
 class InvertedIndexMap
 {
 public:
-	explicit InvertedIndexMap( DatabaseClientInterface* database_);
+	/// \brief Constructor
+	/// \param[in] database_ database to read and write the blocks
+	/// \param[in] bulkLoader_ bulk loader the postings are passed to instead of merging them into the blocks of the storage or NULL
+	/// \note In bulk load mode only new documents are inserted, so no blocks of the storage are read
+	InvertedIndexMap( DatabaseClientInterface* database_, InvertedIndexBulkLoader* bulkLoader_=0);
 
 	void definePosinfoPosting(
 		const Index& typeno,
@@ -47,6 +53,10 @@ public:
 			const std::map<Index,Index>& docnoUnknownMap,
 			const std::map<Index,Index>& termUnknownMap);
 
+	/// \brief Collect all terms (typeno,termno) whose blocks are modified by getWriteBatch
+	/// \note Reads the inverse term blocks of the documents deleted
+	void collectTerms( std::set<std::pair<Index,Index> >& termset) const;
+
 	void getWriteBatch(
 			DatabaseTransactionInterface* transaction,
 			StatisticsBuilderInterface* statisticsBuilder,
@@ -54,6 +64,10 @@ public:
 			const KeyMapInv& termTypeMapInv,
 			const KeyMapInv& termValueMapInv);
 
+	/// \brief Pass the postings to the bulk loader
+	/// \note Called in bulk load mode after the successful commit of the transaction written with getWriteBatch
+	void addPostingsToBulkLoader() const;
+
 	void print( std::ostream& out) const;
 
 	void clear();
@@ -129,6 +143,7 @@ private:
 private:
 	DocumentFrequencyMap m_dfmap;
 	DatabaseClientInterface* m_database;
+	InvertedIndexBulkLoader* m_bulkLoader;
 	Map m_map;
 	std::vector<PosinfoBlock::PositionType> m_posinfo;
 	InvTermMap m_invtermmap;
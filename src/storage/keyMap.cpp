@@ -87,7 +87,7 @@ Index KeyMap::getOrCreate( const std::string& name)
 	return rt;
 }
 
-void KeyMap::deleteAllFromDeletedList( DatabaseTransactionInterface* transaction)
+void KeyMap::getDeletesWriteBatch( DatabaseTransactionInterface* transaction)
 {
 	SymbolVector::const_iterator di = m_deletedlist.begin(), de = m_deletedlist.end();
 	for (; di != de; ++di)
@@ -105,7 +105,7 @@ void KeyMap::deleteAllFromDeletedList( DatabaseTransactionInterface* transaction
 void KeyMap::getWriteBatch(
 	DatabaseTransactionInterface* transaction)
 {
-	deleteAllFromDeletedList( transaction);
+	getDeletesWriteBatch( transaction);
 	// Clear maps:
 	clear();
 }
@@ -121,14 +121,13 @@ std::map<Index,const char*> KeyMap::getInvMap() const
 	return rt;
 }
 
-void KeyMap::getWriteBatch(
+void KeyMap::allocate(
 		std::map<Index,Index>& rewriteUnknownMap,
-		DatabaseTransactionInterface* transaction,
+		KeyReservationTable& reservations,
 		int* nofNewItems,
 		int* nofChangedItems)
 {
-	deleteAllFromDeletedList( transaction);
-
+	m_newlist.clear();
 	Map::iterator mi = m_map.begin(), me = m_map.end();
 	for (; mi != me; ++mi)
 	{
@@ -137,13 +136,19 @@ void KeyMap::getWriteBatch(
 			Index idx = lookUp( mi->first);
 			if (!idx)
 			{
-				idx = m_allocator->alloc();
-				m_dbadapter.store( transaction, mi->first, idx);
-				if (m_dbadapterinv.defined())
+				idx = reservations.acquire( mi->first);
+				if (idx)
 				{
-					m_dbadapterinv.store( transaction, idx, mi->first);
+					//... allocated by a concurrent transaction not committed yet
+					if (nofChangedItems) ++*nofChangedItems;
 				}
-				if (nofNewItems) ++*nofNewItems;
+				else
+				{
+					idx = m_allocator->alloc();
+					reservations.reserve( mi->first, idx);
+					if (nofNewItems) ++*nofNewItems;
+				}
+				m_newlist.push_back( mi->first);
 			}
 			else
 			{
@@ -156,6 +161,39 @@ void KeyMap::getWriteBatch(
 	}
 }
 
+std::vector<std::pair<std::string,Index> > KeyMap::getNewKeysWriteBatch( DatabaseTransactionInterface* transaction)
+{
+	std::vector<std::pair<std::string,Index> > rt;
+	rt.reserve( m_newlist.size());
+	SymbolVector::const_iterator ni = m_newlist.begin(), ne = m_newlist.end();
+	for (; ni != ne; ++ni)
+	{
+		if (lookUp( *ni)) continue;
+		//... not written by a concurrent transaction sharing the reservation and committed before
+
+		Map::const_iterator mi = m_map.find( *ni);
+		if (mi == m_map.end()) continue;
+
+		m_dbadapter.store( transaction, mi->first, mi->second);
+		if (m_dbadapterinv.defined())
+		{
+			m_dbadapterinv.store( transaction, mi->second, mi->first);
+		}
+		rt.push_back( std::pair<std::string,Index>( mi->first, mi->second));
+	}
+	return rt;
+}
+
+void KeyMap::releaseReservations( KeyReservationTable& reservations)
+{
+	SymbolVector::const_iterator ni = m_newlist.begin(), ne = m_newlist.end();
+	for (; ni != ne; ++ni)
+	{
+		reservations.release( *ni);
+	}
+	m_newlist.clear();
+}
+
 void KeyMap::deleteKey( const std::string& name)
 {
 	if (m_invmap)
@@ -183,6 +221,7 @@ void KeyMap::clear()
 		m_invmap->clear();
 	}
 	m_deletedlist.clear();
+	m_newlist.clear();
 }
 
 void KeyMap::print( std::ostream& out)
@@ -10,12 +10,15 @@
 #include "strus/storage/index.hpp"
 #include "databaseAdapter.hpp"
 #include "keyAllocatorInterface.hpp"
+#include "keyReservationTable.hpp"
 #include "private/stringMap.hpp"
 #include "strus/base/symbolTable.hpp"
 #include <cstdlib>
 #include <string>
 #include <cstring>
 #include <map>
+#include <vector>
+#include <utility>
 #include <iostream>
 
 namespace strus {
@@ -49,13 +52,29 @@ public:
 	Index lookUp( const std::string& name);
 	Index getOrCreate( const std::string& name);
 
-	void getWriteBatch(
+	/// \brief Allocate the values of all new keys, reserving the values of keys not in the storage yet
+	/// \note Keys reserved by another transaction not committed yet get the value reserved by it and count as changed
+	/// \note Has to be called with the storage transaction lock held, the keys are written with getNewKeysWriteBatch( DatabaseTransactionInterface*)
+	void allocate(
 		std::map<Index,Index>& rewriteUnknownMap,
-		DatabaseTransactionInterface* transaction,
+		KeyReservationTable& reservations,
 		int* nofNewItems=0,
 		int* nofChangedItems=0);
+	/// \brief Write the keys reserved by the last call of allocate( std::map<Index,Index>&,KeyReservationTable&,int*,int*) that are not yet in the storage
+	/// \note Has to be called with the storage transaction lock held in the final write of the transaction
+	/// \return the keys written with their values
+	std::vector<std::pair<std::string,Index> > getNewKeysWriteBatch(
+		DatabaseTransactionInterface* transaction);
+	/// \brief Release the references to the keys reserved by the last call of allocate( std::map<Index,Index>&,KeyReservationTable&,int*,int*)
+	/// \note Has to be called with the storage transaction lock held, after the transaction committed or failed
+	void releaseReservations(
+		KeyReservationTable& reservations);
+	/// \brief Write the deletes and clear the map
 	void getWriteBatch(
 		DatabaseTransactionInterface* transaction);
+	/// \brief Write the deletes of keys
+	void getDeletesWriteBatch(
+		DatabaseTransactionInterface* transaction);
 
 	static bool isUnknown( const Index& value)
 	{
@@ -72,9 +91,6 @@ public:
 
 	std::map<Index,const char*> getInvMap() const;
 
-private:
-	void deleteAllFromDeletedList( DatabaseTransactionInterface* transaction);
-
 private:
 	enum {
 		UnknownValueHandleStart=(1<<30)
@@ -90,6 +106,7 @@ private:
 	KeyAllocatorInterface* m_allocator;
 	KeyMapInv* m_invmap;
 	SymbolVector m_deletedlist;
+	SymbolVector m_newlist;		///< keys reserved by the last allocation
 };
 
 }//namespace
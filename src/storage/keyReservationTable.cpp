@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Table of the values of keys allocated by transactions that are not committed yet
+/// \file "keyReservationTable.cpp"
+#include "keyReservationTable.hpp"
+
+using namespace strus;
+
+Index KeyReservationTable::acquire( const std::string& name)
+{
+	Map::iterator mi = m_map.find( name);
+	if (mi == m_map.end()) return 0;
+	++mi->second.second;
+	return mi->second.first;
+}
+
+void KeyReservationTable::reserve( const std::string& name, const Index& value)
+{
+	m_map[ name] = Reservation( value, 1);
+}
+
+void KeyReservationTable::release( const std::string& name)
+{
+	Map::iterator mi = m_map.find( name);
+	if (mi == m_map.end()) return;
+	if (--mi->second.second <= 0)
+	{
+		m_map.erase( mi);
+	}
+}
+
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Table of the values of keys allocated by transactions that are not committed yet
+/// \file "keyReservationTable.hpp"
+#ifndef _STRUS_STORAGE_KEY_RESERVATION_TABLE_HPP_INCLUDED
+#define _STRUS_STORAGE_KEY_RESERVATION_TABLE_HPP_INCLUDED
+#include "strus/storage/index.hpp"
+#include <map>
+#include <string>
+#include <utility>
+#include <cstddef>
+
+namespace strus {
+
+/// \brief Table of the values of keys (document ids, term values) allocated by transactions that are not committed yet
+/// \note Concurrent transactions allocating the same key get the same value, the key is written by the first of them that commits
+/// \note Not thread safe, all methods have to be called with the storage transaction lock held
+class KeyReservationTable
+{
+public:
+	KeyReservationTable(){}
+
+	/// \brief Get the value reserved for a key and add a reference to it
+	/// \param[in] name key
+	/// \return the value reserved or 0, if the key is not reserved
+	Index acquire( const std::string& name);
+
+	/// \brief Reserve a value for a key with one reference to it
+	/// \param[in] name key
+	/// \param[in] value value allocated for the key
+	void reserve( const std::string& name, const Index& value);
+
+	/// \brief Release a reference to a key reserved, the reservation is removed with the last reference
+	/// \param[in] name key
+	void release( const std::string& name);
+
+	/// \brief Get the number of keys reserved
+	std::size_t size() const
+	{
+		return m_map.size();
+	}
+
+private:
+	typedef std::pair<Index,int> Reservation;	///< value and reference count
+	typedef std::map<std::string,Reservation> Map;
+	Map m_map;
+};
+
+}//namespace
+#endif
+
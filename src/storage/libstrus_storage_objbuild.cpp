@@ -13,6 +13,7 @@
 #include "strus/lib/statsproc.hpp"
 #include "strus/lib/storage.hpp"
 #include "strus/lib/database_leveldb.hpp"
+#include "strus/lib/database_mmap.hpp"
 #include "strus/fileLocatorInterface.hpp"
 #include "strus/constants.hpp"
 #include "strus/queryProcessorInterface.hpp"
@@ -47,6 +48,7 @@ public:
 		:m_queryProcessor( strus::createQueryProcessor(filelocator_,errorhnd_))
 		,m_storage(strus::createStorageType_std( filelocator_, errorhnd_))
 		,m_db( strus::createDatabaseType_leveldb( filelocator_, errorhnd_))
+		,m_mmapdb( strus::createDatabaseType_mmap( filelocator_, errorhnd_))
 		,m_statsproc( strus::createStatisticsProcessor_std( filelocator_, errorhnd_))
 		,m_errorhnd(errorhnd_)
 		,m_filelocator(filelocator_)
@@ -54,6 +56,7 @@ public:
 		if (!m_queryProcessor.get()) throw std::runtime_error( _TXT("error creating query processor"));
 		if (!m_storage.get()) throw std::runtime_error( _TXT("error creating default storage"));
 		if (!m_db.get()) throw strus::runtime_error(_TXT("error creating default database '%s'"), "leveldb");
+		if (!m_mmapdb.get()) throw strus::runtime_error(_TXT("error creating database '%s'"), "mmap");
 		if (!m_statsproc.get()) throw std::runtime_error( _TXT("error creating default statistics processor"));
 	}
 
@@ -71,6 +74,10 @@ public:
 			{
 				return m_db.get();
 			}
+			else if (string_conv::tolower( name) == "mmap")
+			{
+				return m_mmapdb.get();
+			}
 			else
 			{
 				throw strus::runtime_error(_TXT("unknown database interface: '%s'"), name.c_str());
@@ -111,6 +118,7 @@ private:
 	Reference<QueryProcessorInterface> m_queryProcessor;	///< query processor handle
 	Reference<StorageInterface> m_storage;			///< storage handle
 	Reference<DatabaseInterface> m_db;			///< database handle
+	Reference<DatabaseInterface> m_mmapdb;			///< read only memory mapped database handle
 	Reference<StatisticsProcessorInterface> m_statsproc;	///< statistics processor handle
 	ErrorBufferInterface* m_errorhnd;			///< buffer for reporting errors
 	const FileLocatorInterface* m_filelocator;		///< file locator interface
@@ -50,7 +50,6 @@ public:
 
 public:
 	enum {
-		/// \remark This value limits the maximum docno possible to (MetaDataBlockCache::CacheSize * MetaDataBlockSize)
 		BlockSize=256		///< number of records in one meta data block
 	};
 private:
@@ -14,9 +14,18 @@
 
 using namespace strus;
 
-MetaDataBlockCache::MetaDataBlockCache( DatabaseClientInterface* database_, const MetaDataDescription& descr_)
+MetaDataBlockCache::MetaDataBlockCache( DatabaseClientInterface* database_, const MetaDataDescription& descr_, std::size_t maxMemoryUsage_)
 	:m_database(database_),m_descr(descr_),m_dbadapter(database_, &m_descr)
-{}
+	,m_maxMemoryUsage(maxMemoryUsage_),m_maxNofBlocks(0)
+	,m_nofBlocks(0),m_evictHand(0),m_generation(0),m_voidar()
+{
+	if (m_maxMemoryUsage)
+	{
+		std::size_t blockMemoryUsage = m_descr.bytesize() * MetaDataBlock::BlockSize + sizeof(MetaDataBlock);
+		m_maxNofBlocks = m_maxMemoryUsage / blockMemoryUsage;
+		if (!m_maxNofBlocks) m_maxNofBlocks = 1;
+	}
+}
 
 void MetaDataBlockCache::declareVoid( const Index& blockno)
 {
@@ -25,44 +34,102 @@ void MetaDataBlockCache::declareVoid( const Index& blockno)
 
 void MetaDataBlockCache::refresh()
 {
-	std::vector<unsigned int>::const_iterator vi = m_voidar.begin(), ve = m_voidar.end();
+	m_generation.increment();
+	std::vector<Index>::const_iterator vi = m_voidar.begin(), ve = m_voidar.end();
 	for (; vi != ve; ++vi)
 	{
 		resetBlock( *vi);
 	}
+	m_voidar.clear();
+}
+
+MetaDataBlockCache::PageRef MetaDataBlockCache::getPage( std::size_t pageidx, bool create)
+{
+	PageRef rt = atomic_load( &m_pages[ pageidx]);
+	if (rt.get() || !create) return rt;
+
+	PageRef newpage( new Page());
+	if (atomic_compare_exchange_strong( &m_pages[ pageidx], &rt, newpage))
+	{
+		return newpage;
+	}
+	//... another thread created the page meanwhile, 'rt' contains it now
+	return rt;
 }
 
 void MetaDataBlockCache::resetBlock( const Index& blockno)
 {
-	if (blockno > CacheSize || blockno <= 0) throw strus::runtime_error( _TXT( "block number out of range (%s)"), "meta data block cache");
+	if (blockno > MaxBlockno || blockno <= 0) throw strus::runtime_error( _TXT( "block number out of range (%s)"), "meta data block cache");
 	std::size_t blkidx = blockno-1;
 
-	m_ar[ blkidx].reset();
+	PageRef page = getPage( blkidx / PageSize, false);
+	if (!page.get()) return;
+	BlockRef old = atomic_exchange( &page->ar[ blkidx % PageSize], BlockRef());
+	if (old.get()) m_nofBlocks.decrement();
 }
 
-const MetaDataRecord MetaDataBlockCache::get( const Index& docno)
+void MetaDataBlockCache::evictBlocks()
 {
-	if (docno > MaxDocno || docno <= 0) throw strus::runtime_error( _TXT( "document number out of range (%s)"), "meta data block cache");
-	std::size_t docidx     = (std::size_t)(docno -1);
-	std::size_t blkidx     = docidx / MetaDataBlock::BlockSize;
-	Index blockno          = blkidx+1;
-
-	// The fact that the reference counting of shared_ptr is
-	// thread safe is used to implement some kind of RCU:
-	strus::shared_ptr<MetaDataBlock> blkref = m_ar[ blkidx];
-	while (!blkref.get())
+	unsigned int blkidx = m_evictHand.value();
+	unsigned int visited = 0;
+	while (m_nofBlocks.value() > m_maxNofBlocks && visited < (unsigned int)MaxBlockno)
 	{
-		MetaDataBlock* newblk = m_dbadapter.loadPtr( blockno);
-		if (newblk)
+		if (blkidx >= (unsigned int)MaxBlockno) blkidx = 0;
+		PageRef page = getPage( blkidx / PageSize, false);
+		if (!page.get())
 		{
-			m_ar[ blkidx].reset( newblk);
+			// ... no blocks in this page, continue with the next page
+			unsigned int skip = PageSize - (blkidx % PageSize);
+			blkidx += skip;
+			visited += skip;
+			continue;
 		}
-		else
+		BlockRef* slot = &page->ar[ blkidx % PageSize];
+		BlockRef blk = atomic_load( slot);
+		if (blk.get() && atomic_compare_exchange_strong( slot, &blk, BlockRef()))
 		{
-			m_ar[ blkidx].reset( new MetaDataBlock( &m_descr, blockno));
+			m_nofBlocks.decrement();
 		}
-		blkref = m_ar[ blkidx];
+		++blkidx;
+		++visited;
 	}
-	return (*blkref)[ MetaDataBlock::index( docno)];
+	m_evictHand.set( blkidx);
 }
 
+strus::shared_ptr<MetaDataBlock> MetaDataBlockCache::getBlock( const Index& blockno)
+{
+	if (blockno > MaxBlockno || blockno <= 0) throw strus::runtime_error( _TXT( "block number out of range (%s)"), "meta data block cache");
+	std::size_t blkidx = blockno-1;
+
+	PageRef page = getPage( blkidx / PageSize, true);
+	BlockRef* slot = &page->ar[ blkidx % PageSize];
+	BlockRef rt = atomic_load( slot);
+	if (rt.get()) return rt;
+
+	unsigned int generation = m_generation.value();
+	BlockRef newblk( m_dbadapter.loadPtr( blockno));
+	if (!newblk.get())
+	{
+		newblk.reset( new MetaDataBlock( &m_descr, blockno));
+	}
+	if (!atomic_compare_exchange_strong( slot, &rt, newblk))
+	{
+		//... another thread loaded the block meanwhile, 'rt' contains it now
+		return rt;
+	}
+	m_nofBlocks.increment();
+	if (generation != m_generation.value())
+	{
+		// ... the block might have been read before a refresh that did not see it in the cache yet, we do not keep it
+		BlockRef published = newblk;
+		if (atomic_compare_exchange_strong( slot, &published, BlockRef()))
+		{
+			m_nofBlocks.decrement();
+		}
+	}
+	else if (m_maxNofBlocks && m_nofBlocks.value() > m_maxNofBlocks)
+	{
+		evictBlocks();
+	}
+	return newblk;
+}
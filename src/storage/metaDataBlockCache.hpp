@@ -11,25 +11,39 @@
 #include "metaDataBlock.hpp"
 #include "metaDataRecord.hpp"
 #include "databaseAdapter.hpp"
+#include "strus/base/shared_ptr.hpp"
+#include "strus/base/atomic.hpp"
 #include <utility>
 #include <stdexcept>
 #include <cstdlib>
 #include <vector>
-#include "strus/base/shared_ptr.hpp"
 
 namespace strus {
 
 /// \brief Forward declaration
 class DatabaseClientInterface;
 
+/// \brief Read cache for the meta data blocks of a storage
+/// \note The blocks are held in a two level table: a directory of pages and pages of block slots allocated on first access.
+///	Pages and blocks are published with the atomic operations on shared_ptr, readers never lock.
+///	The reference counting of shared_ptr keeps a block alive as long as a reader holds it, even if it is evicted or reset meanwhile.
+/// \note If a memory budget is defined, the cache evicts blocks when the budget is exceeded.
+///	The victims are selected in round robin order over the block numbers (clock without reference bits).
 class MetaDataBlockCache
 {
 public:
-	MetaDataBlockCache( DatabaseClientInterface* database, const MetaDataDescription& descr_);
+	/// \brief Constructor
+	/// \param[in] database database to read the blocks from
+	/// \param[in] descr_ description of the meta data records
+	/// \param[in] maxMemoryUsage_ maximum number of bytes of blocks to hold in the cache, 0 for no limit
+	MetaDataBlockCache( DatabaseClientInterface* database, const MetaDataDescription& descr_, std::size_t maxMemoryUsage_=0);
 
 	~MetaDataBlockCache(){}
 
-	const MetaDataRecord get( const Index& docno);
+	/// \brief Get the block with a block number, loaded if not in the cache yet
+	/// \param[in] blockno block number (MetaDataBlock::blockno( docno))
+	/// \return the block (all records zero if the block does not exist in the storage)
+	strus::shared_ptr<MetaDataBlock> getBlock( const Index& blockno);
 
 	void declareVoid( const Index& blockno);
 	void refresh();
@@ -39,23 +53,54 @@ public:
 		return m_descr;
 	}
 
+	/// \brief Get the maximum number of bytes of blocks held in the cache, 0 for no limit
+	std::size_t maxMemoryUsage() const
+	{
+		return m_maxMemoryUsage;
+	}
+	/// \brief Get the number of blocks held in the cache
+	unsigned int nofBlocks() const
+	{
+		return m_nofBlocks.value();
+	}
+
 private:
 	void resetBlock( const Index& blockno);
+	void evictBlocks();
 
 private:
 	enum {
-		CacheSize=(1024*1024),				///< size of the cache in blocks
-		MaxDocno=(CacheSize*MetaDataBlock::BlockSize)	///< hardcode limit of maximum document number
+		PageSize=4096,					///< number of block slots in a page of the table
+		MaxBlockno=(int)(((unsigned int)1<<31)/(unsigned int)MetaDataBlock::BlockSize),	///< maximum block number for a positive document number
+		NofPages=(MaxBlockno/PageSize)			///< number of pages in the directory of the table
 	};
+	typedef strus::shared_ptr<MetaDataBlock> BlockRef;
+
+	/// \brief Page of block slots of the table
+	struct Page
+	{
+		BlockRef ar[ PageSize];
+	};
+	typedef strus::shared_ptr<Page> PageRef;
+
+	PageRef getPage( std::size_t pageidx, bool create);
+
+private:
+	MetaDataBlockCache( const MetaDataBlockCache&);	//... non copyable
+	void operator=( const MetaDataBlockCache&);		//... non copyable
 
 private:
 	DatabaseClientInterface* m_database;
 	MetaDataDescription m_descr;
 	DatabaseAdapter_DocMetaData m_dbadapter;
-	strus::shared_ptr<MetaDataBlock> m_ar[ CacheSize];
-	std::vector<unsigned int> m_voidar;
+	PageRef m_pages[ NofPages];				///< directory of the pages of block slots
+	std::size_t m_maxMemoryUsage;				///< maximum number of bytes of blocks held, 0 for no limit
+	unsigned int m_maxNofBlocks;				///< maximum number of blocks held, 0 for no limit
+	AtomicCounter<unsigned int> m_nofBlocks;		///< number of blocks held
+	AtomicCounter<unsigned int> m_evictHand;		///< block index where the search for the next block to evict starts
+	AtomicCounter<unsigned int> m_generation;		///< incremented on every refresh, for detecting blocks read before a refresh
+	std::vector<Index> m_voidar;				///< blocks declared to be reset on the next refresh
 };
 
 }
 #endif
-
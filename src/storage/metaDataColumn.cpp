@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Column of the values of one meta data element in a block for evaluating conditions on all documents of a block at once
+/// \file "metaDataColumn.cpp"
+#include "metaDataColumn.hpp"
+#include "floatConversions.hpp"
+#include "private/internationalization.hpp"
+#include <cstring>
+#include <stdexcept>
+
+using namespace strus;
+
+void MetaDataBlockBitmap::fill( bool value_)
+{
+	std::memset( m_ar, value_ ? 0xFF:0x00, sizeof(m_ar));
+}
+
+void MetaDataBlockBitmap::join( const MetaDataBlockBitmap& o)
+{
+	for (int wi=0; wi < NofWords; ++wi) m_ar[ wi] &= o.m_ar[ wi];
+}
+
+void MetaDataBlockBitmap::unite( const MetaDataBlockBitmap& o)
+{
+	for (int wi=0; wi < NofWords; ++wi) m_ar[ wi] |= o.m_ar[ wi];
+}
+
+bool MetaDataBlockBitmap::empty() const
+{
+	uint64_t rt = 0;
+	for (int wi=0; wi < NofWords; ++wi) rt |= m_ar[ wi];
+	return rt == 0;
+}
+
+int MetaDataBlockBitmap::next( std::size_t idx) const
+{
+	std::size_t wi = idx >> 6;
+	if (wi >= (std::size_t)NofWords) return -1;
+	uint64_t word = m_ar[ wi] & ((~(uint64_t)0) << (idx & 63));
+	for (;;)
+	{
+		if (word)
+		{
+			int bi = 0;
+			for (; 0==(word & 1); word >>= 1, ++bi){}
+			return (int)(wi << 6) + bi;
+		}
+		if (++wi == (std::size_t)NofWords) return -1;
+		word = m_ar[ wi];
+	}
+}
+
+template <typename ColumnType, typename ValueType>
+static void gatherColumn( ColumnType* col, const char* ptr, std::size_t recsize)
+{
+	for (int ri=0; ri < MetaDataBlock::BlockSize; ++ri, ptr += recsize)
+	{
+		ValueType val;
+		std::memcpy( &val, ptr, sizeof(val));
+		col[ ri] = (ColumnType)val;
+	}
+}
+
+static void gatherColumnFloat16( double* col, const char* ptr, std::size_t recsize)
+{
+	for (int ri=0; ri < MetaDataBlock::BlockSize; ++ri, ptr += recsize)
+	{
+		float16_t val;
+		std::memcpy( &val, ptr, sizeof(val));
+		col[ ri] = floatHalfToSinglePrecision( val);
+	}
+}
+
+void MetaDataColumn::load( const MetaDataBlock& blk, const MetaDataElement* elem)
+{
+	std::size_t recsize = blk.bytesize() / MetaDataBlock::BlockSize;
+	const char* ptr = blk.charptr() + elem->ofs();
+	switch (elem->type())
+	{
+		case MetaDataElement::Int8:
+			m_valueClass = IntValue;
+			gatherColumn<int64_t,int8_t>( m_ar.Int, ptr, recsize);
+			return;
+		case MetaDataElement::UInt8:
+			m_valueClass = UIntValue;
+			gatherColumn<uint64_t,uint8_t>( m_ar.UInt, ptr, recsize);
+			return;
+		case MetaDataElement::Int16:
+			m_valueClass = IntValue;
+			gatherColumn<int64_t,int16_t>( m_ar.Int, ptr, recsize);
+			return;
+		case MetaDataElement::UInt16:
+			m_valueClass = UIntValue;
+			gatherColumn<uint64_t,uint16_t>( m_ar.UInt, ptr, recsize);
+			return;
+		case MetaDataElement::Int32:
+			m_valueClass = IntValue;
+			gatherColumn<int64_t,int32_t>( m_ar.Int, ptr, recsize);
+			return;
+		case MetaDataElement::UInt32:
+			m_valueClass = UIntValue;
+			gatherColumn<uint64_t,uint32_t>( m_ar.UInt, ptr, recsize);
+			return;
+		case MetaDataElement::Float16:
+			m_valueClass = FloatValue;
+			m_epsilon = EPSILON_FLOAT16;
+			gatherColumnFloat16( m_ar.Float, ptr, recsize);
+			return;
+		case MetaDataElement::Float32:
+			m_valueClass = FloatValue;
+			m_epsilon = EPSILON_FLOAT32;
+			gatherColumn<double,float>( m_ar.Float, ptr, recsize);
+			return;
+	}
+	throw std::runtime_error( _TXT( "unknown meta data type"));
+}
+
+/// \brief Comparison operators on integers
+template <typename ValueType>
+struct ColumnLess		{static bool match( ValueType a, ValueType b)	{return a < b;}};
+template <typename ValueType>
+struct ColumnLessEqual		{static bool match( ValueType a, ValueType b)	{return a <= b;}};
+template <typename ValueType>
+struct ColumnEqual		{static bool match( ValueType a, ValueType b)	{return a == b;}};
+template <typename ValueType>
+struct ColumnNotEqual		{static bool match( ValueType a, ValueType b)	{return a != b;}};
+template <typename ValueType>
+struct ColumnGreater		{static bool match( ValueType a, ValueType b)	{return a > b;}};
+template <typename ValueType>
+struct ColumnGreaterEqual	{static bool match( ValueType a, ValueType b)	{return a >= b;}};
+
+template <template <typename> class Compare, typename ValueType>
+static void compareColumn( const ValueType* col, ValueType operand, uint64_t* bitmap)
+{
+	for (int wi=0; wi < MetaDataBlockBitmap::NofWords; ++wi, col += 64)
+	{
+		uint64_t word = 0;
+		for (int bi=0; bi < 64; ++bi)
+		{
+			word |= (uint64_t)Compare<ValueType>::match( col[ bi], operand) << bi;
+		}
+		bitmap[ wi] = word;
+	}
+}
+
+template <typename ValueType>
+static void compareColumn( MetaDataRestrictionInterface::CompareOperator opr, const ValueType* col, ValueType operand, uint64_t* bitmap)
+{
+	switch (opr)
+	{
+		case MetaDataRestrictionInterface::CompareLess:
+			compareColumn<ColumnLess,ValueType>( col, operand, bitmap);
+			return;
+		case MetaDataRestrictionInterface::CompareLessEqual:
+			compareColumn<ColumnLessEqual,ValueType>( col, operand, bitmap);
+			return;
+		case MetaDataRestrictionInterface::CompareEqual:
+			compareColumn<ColumnEqual,ValueType>( col, operand, bitmap);
+			return;
+		case MetaDataRestrictionInterface::CompareNotEqual:
+			compareColumn<ColumnNotEqual,ValueType>( col, operand, bitmap);
+			return;
+		case MetaDataRestrictionInterface::CompareGreater:
+			compareColumn<ColumnGreater,ValueType>( col, operand, bitmap);
+			return;
+		case MetaDataRestrictionInterface::CompareGreaterEqual:
+			compareColumn<ColumnGreaterEqual,ValueType>( col, operand, bitmap);
+			return;
+	}
+	throw std::runtime_error( _TXT( "unknown meta data compare function"));
+}
+
+/// \brief Comparison operators on floating point values with a tolerance
+struct ColumnFloatLess		{static bool match( double a, double b, double eps)	{return a + eps < b;}};
+struct ColumnFloatLessEqual	{static bool match( double a, double b, double eps)	{return a <= b + eps;}};
+struct ColumnFloatEqual	{static bool match( double a, double b, double eps)	{return (a + eps >= b) & (a <= b + eps);}};
+struct ColumnFloatNotEqual	{static bool match( double a, double b, double eps)	{return !((a + eps >= b) & (a <= b + eps));}};
+struct ColumnFloatGreater	{static bool match( double a, double b, double eps)	{return a > b + eps;}};
+struct ColumnFloatGreaterEqual	{static bool match( double a, double b, double eps)	{return a + eps >= b;}};
+
+template <class Compare>
+static void compareColumnFloat( const double* col, double operand, double epsilon, uint64_t* bitmap)
+{
+	for (int wi=0; wi < MetaDataBlockBitmap::NofWords; ++wi, col += 64)
+	{
+		uint64_t word = 0;
+		for (int bi=0; bi < 64; ++bi)
+		{
+			word |= (uint64_t)Compare::match( col[ bi], operand, epsilon) << bi;
+		}
+		bitmap[ wi] = word;
+	}
+}
+
+static void compareColumnFloat( MetaDataRestrictionInterface::CompareOperator opr, const double* col, double operand, double epsilon, uint64_t* bitmap)
+{
+	switch (opr)
+	{
+		case MetaDataRestrictionInterface::CompareLess:
+			compareColumnFloat<ColumnFloatLess>( col, operand, epsilon, bitmap);
+			return;
+		case MetaDataRestrictionInterface::CompareLessEqual:
+			compareColumnFloat<ColumnFloatLessEqual>( col, operand, epsilon, bitmap);
+			return;
+		case MetaDataRestrictionInterface::CompareEqual:
+			compareColumnFloat<ColumnFloatEqual>( col, operand, epsilon, bitmap);
+			return;
+		case MetaDataRestrictionInterface::CompareNotEqual:
+			compareColumnFloat<ColumnFloatNotEqual>( col, operand, epsilon, bitmap);
+			return;
+		case MetaDataRestrictionInterface::CompareGreater:
+			compareColumnFloat<ColumnFloatGreater>( col, operand, epsilon, bitmap);
+			return;
+		case MetaDataRestrictionInterface::CompareGreaterEqual:
+			compareColumnFloat<ColumnFloatGreaterEqual>( col, operand, epsilon, bitmap);
+			return;
+	}
+	throw std::runtime_error( _TXT( "unknown meta data compare function"));
+}
+
+void MetaDataColumn::compare( MetaDataRestrictionInterface::CompareOperator opr, const NumericVariant& operand, MetaDataBlockBitmap& bitmap) const
+{
+	switch (m_valueClass)
+	{
+		case IntValue:
+			compareColumn<int64_t>( opr, m_ar.Int, (int64_t)operand.toint(), bitmap.ar());
+			return;
+		case UIntValue:
+			compareColumn<uint64_t>( opr, m_ar.UInt, (uint64_t)operand.touint(), bitmap.ar());
+			return;
+		case FloatValue:
+			compareColumnFloat( opr, m_ar.Float, (double)operand, m_epsilon, bitmap.ar());
+			return;
+	}
+	throw std::runtime_error( _TXT( "unknown meta data compare function"));
+}
+
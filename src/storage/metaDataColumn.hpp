@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Column of the values of one meta data element in a block for evaluating conditions on all documents of a block at once
+/// \file "metaDataColumn.hpp"
+#ifndef _STRUS_STORAGE_METADATA_COLUMN_HPP_INCLUDED
+#define _STRUS_STORAGE_METADATA_COLUMN_HPP_INCLUDED
+#include "strus/metaDataRestrictionInterface.hpp"
+#include "strus/numericVariant.hpp"
+#include "strus/base/stdint.h"
+#include "metaDataBlock.hpp"
+#include "metaDataElement.hpp"
+#include <limits>
+
+/// \brief Tolerance for comparisons of float32 meta data elements
+#define EPSILON_FLOAT32 std::numeric_limits<float>::epsilon()
+/// \brief Tolerance for comparisons of float16 meta data elements
+#define EPSILON_FLOAT16 0.0004887581f
+
+namespace strus {
+
+/// \brief Bitmap with one bit per document of a meta data block
+class MetaDataBlockBitmap
+{
+public:
+	enum {
+		NofWords=(MetaDataBlock::BlockSize/64)	///< number of 64 bit words of the bitmap
+	};
+
+	/// \brief Set all bits to 'value_'
+	void fill( bool value_);
+	/// \brief Build the intersection with another bitmap
+	void join( const MetaDataBlockBitmap& o);
+	/// \brief Build the union with another bitmap
+	void unite( const MetaDataBlockBitmap& o);
+
+	/// \brief Test if a bit is set
+	/// \param[in] idx index of the record in the block
+	bool test( std::size_t idx) const
+	{
+		return 0!=(m_ar[ idx >> 6] & ((uint64_t)1 << (idx & 63)));
+	}
+	/// \brief Evaluate if no bit is set
+	bool empty() const;
+	/// \brief Get the index of the first bit set starting from 'idx'
+	/// \return the index or -1 if there is none
+	int next( std::size_t idx) const;
+
+	/// \brief Get the words of the bitmap for writing
+	uint64_t* ar()				{return m_ar;}
+
+private:
+	uint64_t m_ar[ NofWords];
+};
+
+/// \brief Values of one meta data element of all records in a block stored contiguously
+/// \note The values are converted to the type compared with in the restriction (int64, uint64 or double).
+///	This makes the comparison loops free of type switches and branches and allows the compiler to vectorize them.
+class MetaDataColumn
+{
+public:
+	/// \brief Class of value compared with
+	enum ValueClass {IntValue,UIntValue,FloatValue};
+
+	MetaDataColumn()
+		:m_valueClass(IntValue),m_epsilon(0.0){}
+
+	/// \brief Gather the values of one element of the records of a block
+	/// \param[in] blk block to read
+	/// \param[in] elem element to read
+	void load( const MetaDataBlock& blk, const MetaDataElement* elem);
+
+	/// \brief Compare all values of the column with an operand
+	/// \param[in] opr comparison operator
+	/// \param[in] operand operand to compare with
+	/// \param[out] bitmap bitmap with the bit set for the records matching
+	/// \note Implements the same semantics as the compare functions in "metaDataRestriction.cpp"
+	void compare( MetaDataRestrictionInterface::CompareOperator opr, const NumericVariant& operand, MetaDataBlockBitmap& bitmap) const;
+
+private:
+	enum {Size=MetaDataBlock::BlockSize};
+
+	ValueClass m_valueClass;		///< class of the values in the column
+	double m_epsilon;			///< tolerance for float comparison
+	union
+	{
+		int64_t Int[ Size];
+		uint64_t UInt[ Size];
+		double Float[ Size];
+	} m_ar;					///< values of the column
+};
+
+}//namespace
+#endif
+
@@ -17,7 +17,7 @@ using namespace strus;
 MetaDataReader::MetaDataReader(
 		const strus::shared_ptr<MetaDataBlockCache>& cache_,
 		ErrorBufferInterface* errorhnd_)
-	:m_cache(cache_),m_docno(0),m_errorhnd(errorhnd_)
+	:m_cache(cache_),m_block(),m_docno(0),m_errorhnd(errorhnd_)
 {
 	m_description = &m_cache->descr();
 	m_current = MetaDataRecord( &m_cache->descr(), 0);
@@ -38,7 +38,9 @@ void MetaDataReader::skipDoc( const Index& docno)
 	{
 		if (docno != m_docno)
 		{
-			m_current = m_cache->get( m_docno=docno);
+			m_block = m_cache->getBlock( MetaDataBlock::blockno( docno));
+			//... we hold a reference to the block, it might get evicted from the cache while we read the current record
+			m_current = (*m_block)[ MetaDataBlock::index( m_docno=docno)];
 		}
 	}
 	CATCH_ERROR_MAP( _TXT("error meta data skip document: %s"), *m_errorhnd);
@@ -41,6 +41,7 @@ public:
 private:
 	strus::shared_ptr<MetaDataBlockCache> m_cache;
 	const MetaDataDescription* m_description;
+	strus::shared_ptr<MetaDataBlock> m_block;		///< block of the current record
 	MetaDataRecord m_current;
 	Index m_docno;						///< current document number
 	ErrorBufferInterface* m_errorhnd;			///< error buffer for exception free interface
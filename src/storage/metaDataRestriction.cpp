@@ -6,9 +6,11 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "metaDataRestriction.hpp"
+#include "metaDataBlockCache.hpp"
+#include "metaDataDescription.hpp"
+#include "storageClient.hpp"
 #include "strus/metaDataReaderInterface.hpp"
 #include "strus/errorBufferInterface.hpp"
-#include "strus/storageClientInterface.hpp"
 #include "private/internationalization.hpp"
 #include "private/errorUtils.hpp"
 #include "strus/base/string_conv.hpp"
@@ -19,8 +21,6 @@
 
 using namespace strus;
 
-#define EPSILON_FLOAT32 std::numeric_limits<float>::epsilon()
-
 static bool compareFunctionEqualFloat32( const NumericVariant& op1, const NumericVariant& op2)
 {
 	double val1 = op1;
@@ -61,8 +61,6 @@ static bool compareFunctionGreaterEqualFloat32( const NumericVariant& op1, const
 	return (val1 + EPSILON_FLOAT32 >= val2);
 }
 
-#define EPSILON_FLOAT16 0.0004887581f
-
 static bool compareFunctionEqualFloat16( const NumericVariant& op1, const NumericVariant& op2)
 {
 	double val1 = op1;
@@ -269,9 +267,13 @@ std::string MetaDataCompareOperation::tostring() const
 MetaDataRestrictionInstance::MetaDataRestrictionInstance(
 		MetaDataReaderInterface* metadata_,
 		const std::vector<MetaDataCompareOperation>& opar_,
+		const Index& maxdocno_,
 		ErrorBufferInterface* errorhnd_)
 	:m_opar(opar_)
 	,m_metadata(metadata_)
+	,m_cache()
+	,m_maxdocno(maxdocno_)
+	,m_blockno(0)
 	,m_errorhnd(errorhnd_)
 {
 	if (!m_metadata.get())
@@ -280,7 +282,65 @@ MetaDataRestrictionInstance::MetaDataRestrictionInstance(
 	}
 }
 
-bool MetaDataRestrictionInstance::match( const Index& docno) const
+MetaDataRestrictionInstance::MetaDataRestrictionInstance(
+		const strus::shared_ptr<MetaDataBlockCache>& cache_,
+		const std::vector<MetaDataCompareOperation>& opar_,
+		const Index& maxdocno_,
+		ErrorBufferInterface* errorhnd_)
+	:m_opar(opar_)
+	,m_metadata()
+	,m_cache(cache_)
+	,m_maxdocno(maxdocno_)
+	,m_blockno(0)
+	,m_errorhnd(errorhnd_)
+{
+	if (!m_cache.get())
+	{
+		throw std::runtime_error( _TXT("no meta data block cache defined for metadata restriction"));
+	}
+}
+
+void MetaDataRestrictionInstance::matchBlock(
+		const MetaDataDescription* descr,
+		const MetaDataBlock& blk,
+		const std::vector<MetaDataCompareOperation>& opar,
+		MetaDataBlockBitmap& bitmap)
+{
+	MetaDataColumn column;
+	Index columnElementHandle = -1;
+	MetaDataBlockBitmap groupBitmap;
+	MetaDataBlockBitmap operationBitmap;
+
+	bitmap.fill( true);
+	std::vector<MetaDataCompareOperation>::const_iterator
+		oi = opar.begin(), oe = opar.end();
+	while (oi != oe)
+	{
+		groupBitmap.fill( false);
+		do
+		{
+			if (oi->elementHandle() != columnElementHandle)
+			{
+				column.load( blk, descr->get( columnElementHandle = oi->elementHandle()));
+			}
+			oi->matchColumn( column, operationBitmap);
+			groupBitmap.unite( operationBitmap);
+			++oi;
+		}
+		while (oi != oe && !oi->newGroup());
+		bitmap.join( groupBitmap);
+		if (bitmap.empty()) break;
+	}
+}
+
+void MetaDataRestrictionInstance::loadBlockBitmap( const Index& blockno) const
+{
+	strus::shared_ptr<MetaDataBlock> blk = m_cache->getBlock( blockno);
+	matchBlock( &m_cache->descr(), *blk, m_opar, m_bitmap);
+	m_blockno = blockno;
+}
+
+bool MetaDataRestrictionInstance::matchRecord( const Index& docno) const
 {
 	m_metadata->skipDoc( docno);
 	std::vector<MetaDataCompareOperation>::const_iterator
@@ -297,9 +357,60 @@ bool MetaDataRestrictionInstance::match( const Index& docno) const
 	return true;
 }
 
+bool MetaDataRestrictionInstance::match( const Index& docno) const
+{
+	try
+	{
+		if (!m_cache.get()) return matchRecord( docno);
+
+		Index blockno = MetaDataBlock::blockno( docno);
+		if (blockno != m_blockno)
+		{
+			loadBlockBitmap( blockno);
+		}
+		return m_bitmap.test( MetaDataBlock::index( docno));
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error matching meta data restriction: %s"), *m_errorhnd, false);
+}
+
+Index MetaDataRestrictionInstance::skipDoc( const Index& docno, const Index& maxdocno) const
+{
+	try
+	{
+		Index dn = docno > 0 ? docno : 1;
+		Index lastdocno = maxdocno < m_maxdocno ? maxdocno : m_maxdocno;
+		if (!m_cache.get())
+		{
+			for (; dn <= lastdocno; ++dn)
+			{
+				if (matchRecord( dn)) return dn;
+			}
+			return 0;
+		}
+		while (dn <= lastdocno)
+		{
+			Index blockno = MetaDataBlock::blockno( dn);
+			if (blockno != m_blockno)
+			{
+				loadBlockBitmap( blockno);
+			}
+			int idx = m_bitmap.next( MetaDataBlock::index( dn));
+			if (idx >= 0)
+			{
+				dn = (blockno-1) * MetaDataBlock::BlockSize + idx + 1;
+				return dn <= lastdocno ? dn : 0;
+			}
+			// ... no match in the rest of the block, continue with the first document of the next block
+			dn = blockno * MetaDataBlock::BlockSize + 1;
+		}
+		return 0;
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error skipping to next document matching meta data restriction: %s"), *m_errorhnd, 0);
+}
+
 
 MetaDataRestriction::MetaDataRestriction(
-		const StorageClientInterface* storage_,
+		const StorageClient* storage_,
 		ErrorBufferInterface* errorhnd_)
 	:m_opar()
 	,m_storage(storage_)
@@ -368,7 +479,7 @@ MetaDataRestrictionInstanceInterface* MetaDataRestriction::createInstance() cons
 {
 	try
 	{
-		return new MetaDataRestrictionInstance( m_storage->createMetaDataReader(), m_opar, m_errorhnd);
+		return new MetaDataRestrictionInstance( m_storage->getMetaDataBlockCacheRef(), m_opar, m_storage->maxDocumentNumber(), m_errorhnd);
 	}
 	CATCH_ERROR_MAP_RETURN( _TXT("failed to create meta data restriction instance: %s"), *m_errorhnd, 0);
 }
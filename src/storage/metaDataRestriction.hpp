@@ -12,13 +12,19 @@
 #include "strus/numericVariant.hpp"
 #include "strus/storage/index.hpp"
 #include "strus/reference.hpp"
+#include "strus/base/shared_ptr.hpp"
+#include "metaDataColumn.hpp"
 #include <vector>
 #include <string>
 
 namespace strus {
 
 /// \brief Forward declaration
-class StorageClientInterface;
+class StorageClient;
+/// \brief Forward declaration
+class MetaDataBlockCache;
+/// \brief Forward declaration
+class MetaDataDescription;
 /// \brief Forward declaration
 class MetaDataReaderInterface;
 /// \brief Forward declaration
@@ -61,6 +67,17 @@ public:
 	/// \return true if yes
 	bool match( const MetaDataReaderInterface* md) const;
 
+	/// \brief Try to match this condition on all records of a block
+	/// \param[in] column column of the element of this condition loaded from the block
+	/// \param[out] bitmap bitmap with the bit set for the records matching
+	void matchColumn( const MetaDataColumn& column, MetaDataBlockBitmap& bitmap) const
+	{
+		column.compare( m_opr, m_operand, bitmap);
+	}
+
+	/// \brief Get the handle of the element compared
+	const Index& elementHandle() const			{return m_elementHandle;}
+
 	/// \brief Return string representation of this operation
 	std::string tostring() const;
 
@@ -85,19 +102,53 @@ class MetaDataRestrictionInstance
 	:public MetaDataRestrictionInstanceInterface
 {
 public:
+	/// \brief Constructor for evaluating the restriction record by record with a meta data reader
 	/// \param[in] metadata_ metadata reader (ownership passed)
+	/// \param[in] opar_ list of comparison operations as CNF
+	/// \param[in] maxdocno_ maximum document number visited by skipDoc
 	MetaDataRestrictionInstance(
 			MetaDataReaderInterface* metadata_,
 			const std::vector<MetaDataCompareOperation>& opar_,
+			const Index& maxdocno_,
+			ErrorBufferInterface* errorhnd_);
+
+	/// \brief Constructor for evaluating the restriction block-wise on the columns of the meta data blocks
+	/// \param[in] cache_ meta data block cache to read the blocks from
+	/// \param[in] opar_ list of comparison operations as CNF
+	/// \param[in] maxdocno_ maximum document number visited by skipDoc
+	MetaDataRestrictionInstance(
+			const strus::shared_ptr<MetaDataBlockCache>& cache_,
+			const std::vector<MetaDataCompareOperation>& opar_,
+			const Index& maxdocno_,
 			ErrorBufferInterface* errorhnd_);
 
 	virtual ~MetaDataRestrictionInstance(){}
 
 	virtual bool match( const Index& docno) const;
+	virtual Index skipDoc( const Index& docno, const Index& maxdocno) const;
+
+	/// \brief Evaluate a restriction on all records of a block
+	/// \param[in] descr description of the meta data records
+	/// \param[in] blk block to evaluate
+	/// \param[in] opar list of comparison operations as CNF
+	/// \param[out] bitmap bitmap with the bit set for the records matching
+	static void matchBlock(
+			const MetaDataDescription* descr,
+			const MetaDataBlock& blk,
+			const std::vector<MetaDataCompareOperation>& opar,
+			MetaDataBlockBitmap& bitmap);
+
+private:
+	bool matchRecord( const Index& docno) const;
+	void loadBlockBitmap( const Index& blockno) const;
 
 private:
 	std::vector<MetaDataCompareOperation> m_opar;		///< list of comparison operations as CNF
 	mutable Reference<MetaDataReaderInterface> m_metadata;	///< we change it only when calling match and there is no other method accessing this metadata reader
+	strus::shared_ptr<MetaDataBlockCache> m_cache;		///< meta data block cache for the block-wise evaluation or empty if evaluated with m_metadata
+	Index m_maxdocno;					///< maximum document number visited by skipDoc
+	mutable Index m_blockno;				///< number of the block the bitmap m_bitmap was evaluated for
+	mutable MetaDataBlockBitmap m_bitmap;			///< bitmap of the records of the block m_blockno matching the restriction
 	ErrorBufferInterface* m_errorhnd;			///< buffer for reporting errors
 };
 
@@ -107,7 +158,7 @@ class MetaDataRestriction
 {
 public:
 	MetaDataRestriction(
-			const StorageClientInterface* storage_,
+			const StorageClient* storage_,
 			ErrorBufferInterface* errorhnd_);
 
 	virtual ~MetaDataRestriction()
@@ -125,7 +176,7 @@ public:
 
 private:
 	std::vector<MetaDataCompareOperation> m_opar;		///< list of comparison operations as CNF
-	const StorageClientInterface* m_storage;		///< storage reference
+	const StorageClient* m_storage;				///< storage reference
 	Reference<MetaDataReaderInterface> m_metadata;		///< meta data reader for inspecting the table elements
 	ErrorBufferInterface* m_errorhnd;			///< buffer for reporting errors
 };
@@ -8,6 +8,7 @@
 #include "posinfoBlock.hpp"
 #include "memBlock.hpp"
 #include "indexPacker.hpp"
+#include "positionStreamCodec.hpp"
 #include "private/internationalization.hpp"
 #include <cstring>
 #include <limits>
@@ -32,8 +33,7 @@ std::vector<Index> PosinfoBlock::positions_at( const DocIndexNodeCursor& cursor)
 
 unsigned int PosinfoBlock::frequency_at( const DocIndexNodeCursor& cursor) const
 {
-	const DocIndexNode& nd = m_docIndexNodeArray[ cursor];
-	return m_posinfoptr[ nd.ref[ cursor.docidx]];
+	return *posinfo_at( cursor);
 }
 
 Index PosinfoBlock::PositionScanner::skip( strus::Index pos)
@@ -49,8 +49,6 @@ Index PosinfoBlock::PositionScanner::skip( strus::Index pos)
 			return m_ar[ m_itr];
 		}
 	}
-	if (pos > (Index)std::numeric_limits<PositionType>::max()) return 0;
-
 	int fib1 = 1, fib2 = 1, ii = m_itr+1, nn = m_size;
 	while (ii < nn && (Index)m_ar[ ii] < pos)
 	{
@@ -59,25 +57,132 @@ Index PosinfoBlock::PositionScanner::skip( strus::Index pos)
 		ii = m_itr + fib1;
 	}
 	for (ii = m_itr+fib2; ii < nn && (Index)m_ar[ ii] < pos; ++ii){}
-	return ii < nn ? m_ar[ m_itr = (unsigned short)ii]:0;
+	return ii < nn ? m_ar[ m_itr = (unsigned int)ii]:0;
 }
 
 void PosinfoBlock::initFrame()
 {
+	m_encoding = RawEncoding;
+	m_encodedptr = 0;
+	m_encodedsize = 0;
+	m_nofPositionElements = 0;
+	m_posinfoptr = 0;//... decoded with the first access
+	m_decoded.clear();
 	if (size() < sizeof(unsigned int))
 	{
 		m_docIndexNodeArray.init( 0, 0);
-		m_posinfoptr = 0;
+		m_summary = 0;
 	}
 	else
 	{
-		int nofDocIndexNodes = *(const unsigned int*)ptr();
-		const DocIndexNode* docIndexNodes = (const DocIndexNode*)( (const unsigned int*)ptr()+1);
+		unsigned int header = *(const unsigned int*)ptr();
+		const char* nodeptr = (const char*)ptr() + sizeof(unsigned int);
+		if (header & SummaryFlag)
+		{
+			m_summary = (const BlockSummary*)(const void*)nodeptr;
+			nodeptr += sizeof(BlockSummary);
+			header &= ~(unsigned int)SummaryFlag;
+		}
+		else
+		{
+			//... block written without summary
+			m_summary = 0;
+		}
+		if (header & CompressedFlag)
+		{
+			m_encoding = (header & WidePositionFlag) ? WideEncoding : NarrowEncoding;
+		}
+		header &= ~(unsigned int)(CompressedFlag|WidePositionFlag);
+
+		int nofDocIndexNodes = header;
+		const DocIndexNode* docIndexNodes = (const DocIndexNode*)(const void*)nodeptr;
 		m_docIndexNodeArray.init( docIndexNodes, nofDocIndexNodes);
-		m_posinfoptr = (const PositionType*)(const void*)(docIndexNodes + nofDocIndexNodes);
+		const char* posinfoptr = (const char*)(const void*)(docIndexNodes + nofDocIndexNodes);
+		const char* blkend = (const char*)ptr() + size();
+		if (m_encoding == RawEncoding)
+		{
+			if (posinfoptr > blkend)
+			{
+				throw std::runtime_error( _TXT("corrupt posinfo block"));
+			}
+			m_encodedptr = (const unsigned char*)posinfoptr;
+			m_encodedsize = blkend - posinfoptr;
+			m_nofPositionElements = m_encodedsize / sizeof(unsigned short);
+		}
+		else
+		{
+			if (posinfoptr + sizeof(unsigned int) > blkend)
+			{
+				throw std::runtime_error( _TXT("corrupt compressed posinfo block"));
+			}
+			unsigned int nofPositionElements;
+			std::memcpy( &nofPositionElements, posinfoptr, sizeof(nofPositionElements));
+			m_nofPositionElements = nofPositionElements;
+			m_encodedptr = (const unsigned char*)(posinfoptr + sizeof(unsigned int));
+			m_encodedsize = blkend - (const char*)m_encodedptr;
+		}
 	}
 }
 
+DataBlock* PosinfoBlock::createCacheBlock( const DataBlock& blk)
+{
+	PosinfoBlock* rt = new PosinfoBlock( blk.id(), blk.ptr(), blk.size(), true/*allocated copy*/);
+	rt->decodePositions();
+	//... decoded before it gets visible to other threads, the block cached is not changed anymore
+	return rt;
+}
+
+void PosinfoBlock::attachCacheBlock( const DataBlock& cached)
+{
+	const PosinfoBlock* cachedPosinfo = dynamic_cast<const PosinfoBlock*>( &cached);
+	if (cachedPosinfo && cachedPosinfo->ptr() == ptr() && cachedPosinfo->m_posinfoptr)
+	{
+		m_posinfoptr = cachedPosinfo->m_posinfoptr;
+	}
+}
+
+void PosinfoBlock::decodePositions() const
+{
+	if (!m_encodedptr) return;
+	m_decoded.resize( m_nofPositionElements);
+	switch (m_encoding)
+	{
+		case RawEncoding:
+		{
+			// Widen the 16 bit elements of a block written with an earlier version of strus:
+			for (std::size_t pidx=0; pidx < m_nofPositionElements; ++pidx)
+			{
+				unsigned short pos;
+				std::memcpy( &pos, m_encodedptr + pidx * sizeof(unsigned short), sizeof(pos));
+				m_decoded[ pidx] = pos;
+			}
+			m_posinfoptr = m_decoded.data();
+			return;
+		}
+		case NarrowEncoding:
+			PositionStreamCodec::decode( m_decoded.data(), m_nofPositionElements, m_encodedptr, m_encodedsize);
+			break;
+		case WideEncoding:
+			PositionStreamCodec::decodeWide( m_decoded.data(), m_nofPositionElements, m_encodedptr, m_encodedsize);
+			break;
+	}
+	// Undo the delta encoding of the positions of each document, [ff][p1][p2-p1]..[pN-pN-1]:
+	PositionType* pi = m_decoded.data();
+	PositionType* pe = pi + m_decoded.size();
+	while (pi < pe)
+	{
+		if (*pi >= (std::size_t)(pe - pi)) throw std::runtime_error( _TXT("corrupt compressed posinfo block"));
+		PositionType* pn = pi + *pi + 1;
+		PositionType pos = 0;
+		for (++pi; pi < pn; ++pi)
+		{
+			pos += *pi;
+			*pi = pos;
+		}
+	}
+	m_posinfoptr = m_decoded.data();
+}
+
 
 PosinfoBlockBuilder::PosinfoBlockBuilder( const PosinfoBlock& o)
 	:m_id(o.id())
@@ -96,6 +201,10 @@ void PosinfoBlockBuilder::append( strus::Index docno, const PositionType* posar)
 {
 	if (m_id && m_id < docno) throw std::runtime_error(_TXT("assigned illegal id to block"));
 
+	if (m_posinfoArray.size() > std::numeric_limits<unsigned short>::max())
+	{
+		throw std::runtime_error( _TXT("position array reference out of range in posinfo block builder"));
+	}
 	if (m_docIndexNodeArray.empty()
 	||  !m_docIndexNodeArray.back().addDocument( docno, m_posinfoArray.size()))
 	{
@@ -179,27 +288,65 @@ void PosinfoBlockBuilder::merge( const PosinfoBlockBuilder& blk1, const PosinfoB
 
 bool PosinfoBlockBuilder::fitsInto( std::size_t nofpos) const
 {
-	return (int)(size() + nofpos * sizeof(PositionType)) <= Constants::maxPosInfoBlockSize();
+	return (int)(size() + nofpos * PosinfoBlock::PositionElementSize) <= Constants::maxPosInfoBlockSize();
 }
 
 bool PosinfoBlockBuilder::fitsIntoApproximately( std::size_t nofpos, float acceptedFillRatio) const
 {
-	return (int)(size() + nofpos * sizeof(PositionType) * acceptedFillRatio) <= Constants::maxPosInfoBlockSize();
+	return (int)(size() + nofpos * PosinfoBlock::PositionElementSize * acceptedFillRatio) <= Constants::maxPosInfoBlockSize();
+}
+
+std::string PosinfoBlockBuilder::compressedPosinfoArray( bool& wide) const
+{
+	// Delta encoding of the positions of each document, [ff][p1][p2-p1]..[pN-pN-1]:
+	std::vector<PositionType> deltaArray;
+	deltaArray.reserve( m_posinfoArray.size());
+	std::vector<PositionType>::const_iterator
+		pi = m_posinfoArray.begin(),
+		pe = m_posinfoArray.end();
+	while (pi != pe)
+	{
+		PositionType ff = *pi++;
+		deltaArray.push_back( ff);
+		PositionType prev = 0;
+		for (PositionType fi=0; fi < ff && pi != pe; ++fi,++pi)
+		{
+			deltaArray.push_back( (PositionType)(*pi - prev));//... modulo arithmetic, lossless also for unordered positions
+			prev = *pi;
+		}
+	}
+	std::string rt;
+	wide = !PositionStreamCodec::fitsNarrow( deltaArray.data(), deltaArray.size());
+	if (wide)
+	{
+		PositionStreamCodec::encodeWide( rt, deltaArray.data(), deltaArray.size());
+	}
+	else
+	{
+		PositionStreamCodec::encode( rt, deltaArray.data(), deltaArray.size());
+	}
+	return rt;
 }
 
 PosinfoBlock PosinfoBlockBuilder::createBlock() const
 {
 	if (empty()) throw std::runtime_error(_TXT("tried to create empty posinfo block"));
 
+	bool wide = false;
+	std::string posinfoStream = compressedPosinfoArray( wide);
 	std::size_t blksize =
-		sizeof( unsigned int)
-		+ m_posinfoArray.size() * sizeof( m_posinfoArray[0])
-		+ m_docIndexNodeArray.size() * sizeof( m_docIndexNodeArray[0]);
+		sizeof( unsigned int) + sizeof( BlockSummary)
+		+ m_docIndexNodeArray.size() * sizeof( m_docIndexNodeArray[0])
+		+ sizeof( unsigned int) + posinfoStream.size();
 
 	MemBlock blkmem( blksize);
-	unsigned int nofDocIndexNodes = *(unsigned int*)blkmem.ptr() = docIndexNodeArray().size();
-	DocIndexNode* docindexptr = (DocIndexNode*)( (const unsigned int*)blkmem.ptr()+1);
-	PositionType* posinfoptr = (PositionType*)(const void*)(docindexptr + nofDocIndexNodes);
+	unsigned int nofDocIndexNodes = docIndexNodeArray().size();
+	unsigned int header = nofDocIndexNodes | (unsigned int)PosinfoBlock::SummaryFlag | (unsigned int)PosinfoBlock::CompressedFlag;
+	if (wide) header |= (unsigned int)PosinfoBlock::WidePositionFlag;
+	*(unsigned int*)blkmem.ptr() = header;
+	char* nodeptr = (char*)blkmem.ptr() + sizeof(unsigned int);
+	*(BlockSummary*)(void*)nodeptr = summary();
+	DocIndexNode* docindexptr = (DocIndexNode*)(void*)(nodeptr + sizeof(BlockSummary));
 
 	std::vector<DocIndexNode>::const_iterator
 		di = m_docIndexNodeArray.begin(),
@@ -208,14 +355,23 @@ PosinfoBlock PosinfoBlockBuilder::createBlock() const
 	{
 		docindexptr[ didx] = *di;
 	}
-	std::vector<PositionType>::const_iterator
-		pi = m_posinfoArray.begin(),
-		pe = m_posinfoArray.end();
-	for (std::size_t pidx=0; pi != pe; ++pi,++pidx)
+	char* posinfoptr = (char*)(void*)(docindexptr + nofDocIndexNodes);
+	unsigned int nofPositionElements = m_posinfoArray.size();
+	std::memcpy( posinfoptr, &nofPositionElements, sizeof(nofPositionElements));
+	std::memcpy( posinfoptr + sizeof(unsigned int), posinfoStream.c_str(), posinfoStream.size());
+	return PosinfoBlock( m_id?m_id:m_lastDoc, blkmem.ptr(), blksize, true/*allocated, means copied*/);
+}
+
+BlockSummary PosinfoBlockBuilder::summary() const
+{
+	BlockSummary rt;
+	Cursor cursor( *this);
+	for (; cursor.docno; cursor.next())
 	{
-		posinfoptr[ pidx] = *pi;
+		const PositionType* posar = cursor.posinfo();
+		rt.add( posar[0]/*ff*/, posar[0] ? posar[ posar[0]]/*last position*/ : 0);
 	}
-	return PosinfoBlock( m_id?m_id:m_lastDoc, blkmem.ptr(), blksize, true/*allocated, means copied*/);
+	return rt;
 }
 
 void PosinfoBlockBuilder::clear()
@@ -9,23 +9,33 @@
 #define _STRUS_POSINFO_BLOCK_HPP_INCLUDED
 #include "dataBlock.hpp"
 #include "docIndexNode.hpp"
+#include "blockSummary.hpp"
 #include "strus/constants.hpp"
 #include <vector>
+#include <string>
 #include <utility>
 
 namespace strus {
 
 /// \class PosinfoBlock
 /// \brief Block of term occurrence positions
+/// \note Layout: [number of DocIndexNode elements|SummaryFlag|CompressedFlag|WidePositionFlag] [BlockSummary (if SummaryFlag set)] [DocIndexNode array] [posinfo array]
+/// \note Layout of the posinfo array if CompressedFlag is set: [number of elements] [elements delta encoded per document, compressed with the PositionStreamCodec, wide layout if WidePositionFlag is set]
+/// \note Layout of the posinfo array if CompressedFlag is not set (blocks written with an earlier version of strus): [array of 16 bit elements]
 class PosinfoBlock
 	:public DataBlock
 {
 public:
-	typedef unsigned short PositionType;
+	typedef unsigned int PositionType;
+	enum {SummaryFlag=0x80000000U, CompressedFlag=0x40000000U, WidePositionFlag=0x20000000U};
+	/// \brief Size of a position element in the measure of the block size used to decide on block splitting
+	/// \note Kept at the size of the 16 bit elements of the uncompressed format, so that the references of a DocIndexNode into the position array stay in range
+	enum {PositionElementSize=sizeof(unsigned short)};
 
 public:
 	explicit PosinfoBlock()
-		:DataBlock(),m_docIndexNodeArray(),m_posinfoptr(0)
+		:DataBlock(),m_docIndexNodeArray(),m_posinfoptr(0),m_summary(0)
+		,m_encoding(RawEncoding),m_encodedptr(0),m_encodedsize(0),m_nofPositionElements(0),m_decoded()
 	{}
 	PosinfoBlock( const PosinfoBlock& o)
 		:DataBlock(o)
@@ -46,14 +56,25 @@ public:
 		initFrame();
 	}
 
+	/// \brief Create the block inserted into the shared block cache with the position array decoded
+	static DataBlock* createCacheBlock( const DataBlock& blk);
+	/// \brief Take the decoded position array of the block of the shared block cache this block references the memory of
+	void attachCacheBlock( const DataBlock& cached);
+	virtual std::size_t memoryUsage() const
+	{
+		return size() + m_decoded.capacity() * sizeof(PositionType);
+	}
+
 	/// \brief Get the document number of the current DocIndexNodeCursor
 	Index docno_at( const DocIndexNodeCursor& cursor) const
 	{
 		return m_docIndexNodeArray.docno_at( cursor);
 	}
 	/// \brief Get the internal representation of the postions of the current DocIndexNodeCursor
+	/// \note Decodes the position array of the block with the first access
 	const PositionType* posinfo_at( const DocIndexNodeCursor& cursor) const
 	{
+		if (!m_posinfoptr) decodePositions();
 		return m_posinfoptr + m_docIndexNodeArray[ cursor].ref[ cursor.docidx];
 	}
 	/// \brief Get the list of the postions of the current DocIndexNodeCursor
@@ -94,6 +115,18 @@ public:
 		return (int)size() >= Constants::maxPosInfoBlockSize();
 	}
 
+	/// \brief Get the summary of the block (max ff, min document length) or NULL if the block was written without
+	const BlockSummary* summary() const
+	{
+		return m_summary;
+	}
+
+	/// \brief Evaluate if the positions of the block are stored compressed
+	bool compressed() const
+	{
+		return m_encoding != RawEncoding;
+	}
+
 	class PositionScanner
 	{
 	public:
@@ -129,8 +162,8 @@ public:
 
 	private:
 		const PositionType* m_ar;
-		unsigned short m_size;
-		unsigned short m_itr;
+		unsigned int m_size;
+		unsigned int m_itr;
 	};
 
 	PositionScanner positionScanner_at( const DocIndexNodeCursor& cursor) const
@@ -140,10 +173,19 @@ public:
 
 private:
 	void initFrame();
+	void decodePositions() const;
 
 private:
+	enum Encoding {RawEncoding, NarrowEncoding, WideEncoding};
+
 	DocIndexNodeArray m_docIndexNodeArray;
-	const PositionType* m_posinfoptr;
+	mutable const PositionType* m_posinfoptr;		///< position array, defined after the decoding with the first access
+	const BlockSummary* m_summary;
+	Encoding m_encoding;					///< encoding of the stored position array
+	const unsigned char* m_encodedptr;			///< stored position array or NULL if the block is empty
+	std::size_t m_encodedsize;				///< size of m_encodedptr in bytes
+	std::size_t m_nofPositionElements;			///< number of elements in the decoded position array
+	mutable std::vector<PositionType> m_decoded;		///< buffer for the decoded position array
 };
 
 class PosinfoBlockBuilder
@@ -211,19 +253,27 @@ public:
 	const std::vector<DocIndexNode>& docIndexNodeArray() const	{return m_docIndexNodeArray;}
 	const std::vector<PositionType>& posinfoArray() const		{return m_posinfoArray;}
 
+	/// \brief Create the block with the position array compressed
+	/// \note The wide layout of the compressed stream is chosen only if the block contains values not representable in 16 bits
 	PosinfoBlock createBlock() const;
+	BlockSummary summary() const;
 	void clear();
 
+	/// \brief Get the size of the block with the position array uncompressed (used as measure to decide on block splitting)
 	int size() const
 	{
-		return sizeof( unsigned int)
-			+ m_posinfoArray.size() * sizeof(PositionType)
+		return sizeof( unsigned int) + sizeof( BlockSummary)
+			+ m_posinfoArray.size() * PosinfoBlock::PositionElementSize
 			+ m_docIndexNodeArray.size() * sizeof(DocIndexNode);
 	}
 
 	static void merge( const PosinfoBlockBuilder& blk1, const PosinfoBlockBuilder& blk2, PosinfoBlockBuilder& newblk);
 
 private:
+	/// \brief Get the compressed position array
+	/// \param[out] wide true, if the array had to be encoded in the wide layout
+	std::string compressedPosinfoArray( bool& wide) const;
+
 	struct Cursor
 	{
 		std::size_t idx;
@@ -23,8 +23,8 @@ class PosinfoIterator
 	:public DocumentBlockIteratorTemplate<DatabaseAdapter_PosinfoBlock::Cursor,PosinfoBlock,DocIndexNodeCursor>
 {
 public:
-	PosinfoIterator( const StorageClient* storage_, const DatabaseClientInterface* database_, Index termtypeno_, Index termvalueno_, GlobalCounter df_)
-		:DocumentBlockIteratorTemplate<DatabaseAdapter_PosinfoBlock::Cursor,PosinfoBlock,DocIndexNodeCursor>( DatabaseAdapter_PosinfoBlock::Cursor(database_,termtypeno_,termvalueno_))
+	PosinfoIterator( const StorageClient* storage_, const DatabaseClientInterface* database_, DataBlockCache* blockCache_, Index termtypeno_, Index termvalueno_, GlobalCounter df_)
+		:DocumentBlockIteratorTemplate<DatabaseAdapter_PosinfoBlock::Cursor,PosinfoBlock,DocIndexNodeCursor>( DatabaseAdapter_PosinfoBlock::Cursor(database_,termtypeno_,termvalueno_,blockCache_))
 		,m_storage(storage_)
 		,m_positionScanner()
 		,m_termtypeno(termtypeno_)
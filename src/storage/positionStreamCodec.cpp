@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Byte oriented compression of streams of position values (StreamVByte style) used for compressed position blocks
+/// \file "positionStreamCodec.cpp"
+#include "positionStreamCodec.hpp"
+#include "private/internationalization.hpp"
+#include <stdexcept>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#define STRUS_POSITION_STREAM_CODEC_SSSE3
+#endif
+
+using namespace strus;
+
+static inline std::size_t controlSize( std::size_t arsize)
+{
+	return (arsize + 7) >> 3;
+}
+
+static inline std::size_t controlSizeWide( std::size_t arsize)
+{
+	return (arsize + 3) >> 2;
+}
+
+static void throwCorruptStream()
+{
+	throw std::runtime_error( _TXT("corrupt compressed position stream"));
+}
+
+bool PositionStreamCodec::fitsNarrow( const unsigned int* ar, std::size_t arsize)
+{
+	for (std::size_t ai=0; ai < arsize; ++ai)
+	{
+		if (ar[ ai] > 0xFFFF) return false;
+	}
+	return true;
+}
+
+void PositionStreamCodec::encode( std::string& dest, const unsigned int* ar, std::size_t arsize)
+{
+	std::size_t ctrlstart = dest.size();
+	dest.append( controlSize( arsize), '\0');
+	for (std::size_t ai=0; ai < arsize; ++ai)
+	{
+		unsigned int val = ar[ ai];
+		if (val > 0xFFFF) throw std::runtime_error( _TXT("value out of range for narrow position stream"));
+		dest.push_back( (char)(unsigned char)(val & 0xFF));
+		if (val > 0xFF)
+		{
+			dest[ ctrlstart + (ai >> 3)] |= (char)(1 << (ai & 7));
+			dest.push_back( (char)(unsigned char)(val >> 8));
+		}
+	}
+}
+
+void PositionStreamCodec::encodeWide( std::string& dest, const unsigned int* ar, std::size_t arsize)
+{
+	std::size_t ctrlstart = dest.size();
+	dest.append( controlSizeWide( arsize), '\0');
+	for (std::size_t ai=0; ai < arsize; ++ai)
+	{
+		unsigned int val = ar[ ai];
+		unsigned int len = (val > 0xFFFFFF) ? 4 : (val > 0xFFFF) ? 3 : (val > 0xFF) ? 2 : 1;
+		dest[ ctrlstart + (ai >> 2)] |= (char)((len-1) << ((ai & 3) << 1));
+		for (unsigned int li=0; li < len; ++li, val >>= 8)
+		{
+			dest.push_back( (char)(unsigned char)(val & 0xFF));
+		}
+	}
+}
+
+/// \brief Decode the narrow encoded values [ai,arsize) with the control bits in ctrl and the data starting at di
+static void decodeScalarTail( unsigned int* dest, std::size_t ai, std::size_t arsize, const unsigned char* ctrl, const unsigned char* di, const unsigned char* de)
+{
+	for (; ai < arsize; ++ai)
+	{
+		if (ctrl[ ai >> 3] & (1 << (ai & 7)))
+		{
+			if (di + 2 > de) throwCorruptStream();
+			dest[ ai] = (unsigned int)di[0] | ((unsigned int)di[1] << 8);
+			di += 2;
+		}
+		else
+		{
+			if (di >= de) throwCorruptStream();
+			dest[ ai] = *di++;
+		}
+	}
+	if (di != de) throwCorruptStream();
+}
+
+/// \brief Decode the wide encoded values [ai,arsize) with the control bits in ctrl and the data starting at di
+static void decodeWideScalarTail( unsigned int* dest, std::size_t ai, std::size_t arsize, const unsigned char* ctrl, const unsigned char* di, const unsigned char* de)
+{
+	for (; ai < arsize; ++ai)
+	{
+		unsigned int len = ((ctrl[ ai >> 2] >> ((ai & 3) << 1)) & 3) + 1;
+		if (di + len > de) throwCorruptStream();
+		unsigned int val = 0;
+		for (unsigned int li=0; li < len; ++li)
+		{
+			val |= (unsigned int)di[ li] << (li << 3);
+		}
+		dest[ ai] = val;
+		di += len;
+	}
+	if (di != de) throwCorruptStream();
+}
+
+void PositionStreamCodec::decodeScalar( unsigned int* dest, std::size_t arsize, const unsigned char* src, std::size_t srcsize)
+{
+	std::size_t ctrlsize = controlSize( arsize);
+	if (srcsize < ctrlsize + arsize) throwCorruptStream();
+	decodeScalarTail( dest, 0, arsize, src, src + ctrlsize, src + srcsize);
+}
+
+void PositionStreamCodec::decodeWideScalar( unsigned int* dest, std::size_t arsize, const unsigned char* src, std::size_t srcsize)
+{
+	std::size_t ctrlsize = controlSizeWide( arsize);
+	if (srcsize < ctrlsize + arsize) throwCorruptStream();
+	decodeWideScalarTail( dest, 0, arsize, src, src + ctrlsize, src + srcsize);
+}
+
+#ifdef STRUS_POSITION_STREAM_CODEC_SSSE3
+namespace {
+/// \brief Shuffle masks and consumed byte counts for decoding the values of one control byte
+struct ShuffleTable
+{
+	unsigned char mask[ 256][ 16];
+	unsigned char length[ 256];
+
+	/// \param[in] wide false for 8 values of 2 bytes with 1 control bit each, true for 4 values of 4 bytes with 2 control bits each
+	explicit ShuffleTable( bool wide)
+	{
+		unsigned int nofValues = wide ? 4 : 8;
+		unsigned int valueSize = wide ? 4 : 2;
+		for (unsigned int ctrl=0; ctrl < 256; ++ctrl)
+		{
+			unsigned char ofs = 0;
+			for (unsigned int vi=0; vi < nofValues; ++vi)
+			{
+				unsigned int len = wide ? (((ctrl >> (vi << 1)) & 3) + 1) : ((ctrl & (1 << vi)) ? 2 : 1);
+				for (unsigned int bi=0; bi < valueSize; ++bi)
+				{
+					mask[ ctrl][ vi*valueSize+bi] = (bi < len) ? ofs++ : 0x80/*zero*/;
+				}
+			}
+			length[ ctrl] = ofs;
+		}
+	}
+};
+}//anonymous namespace
+
+static const ShuffleTable g_shuffleTable( false);
+static const ShuffleTable g_shuffleTableWide( true);
+#endif
+
+void PositionStreamCodec::decode( unsigned int* dest, std::size_t arsize, const unsigned char* src, std::size_t srcsize)
+{
+#ifdef STRUS_POSITION_STREAM_CODEC_SSSE3
+	std::size_t ctrlsize = controlSize( arsize);
+	if (srcsize < ctrlsize + arsize) throwCorruptStream();
+	const unsigned char* ctrl = src;
+	const unsigned char* di = src + ctrlsize;
+	const unsigned char* de = src + srcsize;
+	std::size_t ai = 0;
+	__m128i zero = _mm_setzero_si128();
+
+	// Decode 8 values per control byte as long as 16 bytes can be loaded safely:
+	for (; ai + 8 <= arsize && di + 16 <= de; ai += 8)
+	{
+		unsigned char cb = ctrl[ ai >> 3];
+		__m128i data = _mm_loadu_si128( (const __m128i*)(const void*)di);
+		__m128i shuf = _mm_loadu_si128( (const __m128i*)(const void*)g_shuffleTable.mask[ cb]);
+		__m128i values = _mm_shuffle_epi8( data, shuf);
+		_mm_storeu_si128( (__m128i*)(void*)(dest + ai), _mm_unpacklo_epi16( values, zero));
+		_mm_storeu_si128( (__m128i*)(void*)(dest + ai + 4), _mm_unpackhi_epi16( values, zero));
+		di += g_shuffleTable.length[ cb];
+	}
+	// Decode the rest with the scalar implementation:
+	decodeScalarTail( dest, ai, arsize, ctrl, di, de);
+#else
+	decodeScalar( dest, arsize, src, srcsize);
+#endif
+}
+
+void PositionStreamCodec::decodeWide( unsigned int* dest, std::size_t arsize, const unsigned char* src, std::size_t srcsize)
+{
+#ifdef STRUS_POSITION_STREAM_CODEC_SSSE3
+	std::size_t ctrlsize = controlSizeWide( arsize);
+	if (srcsize < ctrlsize + arsize) throwCorruptStream();
+	const unsigned char* ctrl = src;
+	const unsigned char* di = src + ctrlsize;
+	const unsigned char* de = src + srcsize;
+	std::size_t ai = 0;
+
+	// Decode 4 values per control byte as long as 16 bytes can be loaded safely:
+	for (; ai + 4 <= arsize && di + 16 <= de; ai += 4)
+	{
+		unsigned char cb = ctrl[ ai >> 2];
+		__m128i data = _mm_loadu_si128( (const __m128i*)(const void*)di);
+		__m128i shuf = _mm_loadu_si128( (const __m128i*)(const void*)g_shuffleTableWide.mask[ cb]);
+		_mm_storeu_si128( (__m128i*)(void*)(dest + ai), _mm_shuffle_epi8( data, shuf));
+		di += g_shuffleTableWide.length[ cb];
+	}
+	// Decode the rest with the scalar implementation:
+	decodeWideScalarTail( dest, ai, arsize, ctrl, di, de);
+#else
+	decodeWideScalar( dest, arsize, src, srcsize);
+#endif
+}
+
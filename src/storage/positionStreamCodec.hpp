@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Byte oriented compression of streams of position values (StreamVByte style) used for compressed position blocks
+/// \file "positionStreamCodec.hpp"
+#ifndef _STRUS_STORAGE_POSITION_STREAM_CODEC_HPP_INCLUDED
+#define _STRUS_STORAGE_POSITION_STREAM_CODEC_HPP_INCLUDED
+#include <string>
+#include <cstddef>
+
+namespace strus {
+
+/// \brief Encoding of a stream of position values (StreamVByte style)
+/// \note Narrow layout (values < 2^16): [control bytes, 1 bit per value, set if the value needs 2 bytes][data bytes, little endian]
+/// \note Wide layout (values < 2^32): [control bytes, 2 bits per value, number of bytes of the value - 1][data bytes, little endian]
+/// \note The separation of control and data allows a branch free decoding of 8 (narrow) or 4 (wide) values per control byte with a byte shuffle (SSSE3)
+struct PositionStreamCodec
+{
+	/// \brief Evaluate if all values of an array can be encoded in the narrow layout
+	/// \param[in] ar array of values to check
+	/// \param[in] arsize number of values in ar
+	static bool fitsNarrow( const unsigned int* ar, std::size_t arsize);
+
+	/// \brief Append the narrow encoded stream to a buffer
+	/// \param[out] dest where to append the encoded stream to
+	/// \param[in] ar array of values to encode (all values must be smaller than 2^16)
+	/// \param[in] arsize number of values in ar
+	static void encode( std::string& dest, const unsigned int* ar, std::size_t arsize);
+
+	/// \brief Decode a narrow encoded stream
+	/// \param[out] dest where to write the decoded values to (buffer for arsize values)
+	/// \param[in] arsize number of values to decode
+	/// \param[in] src pointer to the encoded stream
+	/// \param[in] srcsize size of the encoded stream in bytes
+	/// \remark Throws if the encoded stream is corrupt
+	static void decode( unsigned int* dest, std::size_t arsize, const unsigned char* src, std::size_t srcsize);
+
+	/// \brief Decode a narrow encoded stream with the portable implementation, without using any SIMD instructions
+	/// \note Same interface as decode, used for testing
+	static void decodeScalar( unsigned int* dest, std::size_t arsize, const unsigned char* src, std::size_t srcsize);
+
+	/// \brief Append the wide encoded stream to a buffer
+	/// \param[out] dest where to append the encoded stream to
+	/// \param[in] ar array of values to encode
+	/// \param[in] arsize number of values in ar
+	static void encodeWide( std::string& dest, const unsigned int* ar, std::size_t arsize);
+
+	/// \brief Decode a wide encoded stream
+	/// \param[out] dest where to write the decoded values to (buffer for arsize values)
+	/// \param[in] arsize number of values to decode
+	/// \param[in] src pointer to the encoded stream
+	/// \param[in] srcsize size of the encoded stream in bytes
+	/// \remark Throws if the encoded stream is corrupt
+	static void decodeWide( unsigned int* dest, std::size_t arsize, const unsigned char* src, std::size_t srcsize);
+
+	/// \brief Decode a wide encoded stream with the portable implementation, without using any SIMD instructions
+	/// \note Same interface as decodeWide, used for testing
+	static void decodeWideScalar( unsigned int* dest, std::size_t arsize, const unsigned char* src, std::size_t srcsize);
+};
+
+}//namespace
+#endif
+
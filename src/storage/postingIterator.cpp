@@ -44,7 +44,7 @@ PostingIterator::PostingIterator(
 		ErrorBufferInterface* errorhnd_)
 #endif
 	:m_docnoIterator(database_, DatabaseKey::DocListBlockPrefix, BlockKey( termtypeno, termvalueno), true)
-	,m_posinfoIterator(storage_,database_, termtypeno, termvalueno, stats_.documentFrequency())
+	,m_posinfoIterator(storage_,database_, storage_->dataBlockCache(), termtypeno, termvalueno, stats_.documentFrequency())
 	,m_docno(0)
 	,m_termtypeno( termtypeno)
 	,m_termvalueno( termvalueno)
@@ -136,3 +136,16 @@ GlobalCounter PostingIterator::documentFrequency() const
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error in %s get document frequency: %s"), INTERFACE_NAME, *m_errorhnd, 0);
 }
 
+PostingBlockSummary PostingIterator::blockSummary()
+{
+	try
+	{
+		if (!m_docno || m_docno != m_posinfoIterator.skipDoc( m_docno))
+		{
+			return PostingBlockSummary();
+		}
+		return m_posinfoIterator.blockSummary();
+	}
+	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error in %s get block summary: %s"), INTERFACE_NAME, *m_errorhnd, PostingBlockSummary());
+}
+
@@ -50,6 +50,8 @@ public:
 
 	virtual GlobalCounter documentFrequency() const;
 
+	virtual PostingBlockSummary blockSummary();
+
 	virtual Index docno() const
 	{
 		return m_docno;
@@ -112,7 +112,7 @@ const char* Storage::getConfigDescription( const ConfigType& type) const
 	switch (type)
 	{
 		case CmdCreateClient:
-			return "cachedterms=<file with list of terms to cache>";
+			return "cachedterms=<file with list of terms to cache>\nbulkload=<directory for the sorted runs of postings, enables the bulk load of new documents written on close>\ntermdict=<yes/no for keeping the term type and value dictionaries in memory for lookups of existing terms without database access, terms not found are looked up in the database, default is no>\nblockcache=<size of the cache of posting, ff and forward index blocks shared by all queries, no block cache if not specified>\nmetadatacache=<maximum size of the meta data blocks held in memory, no limit if not specified>\naclcache=<size of the cache of the ACL bitmaps of sets of users shared by all queries, no ACL bitmap cache if not specified>\nfwdict=<comma separated list of forward index types with the values written as term value numbers decoded on read, shrinks the forward index of types like 'orig' or 'word'>\ntermvaluecache=<size of the cache of the values of forward index types listed in 'fwdict' shared by all queries, no cache if not specified>";
 
 		case CmdCreate:
 			return "acl=<yes/no, yes if users with different access rights exist>";
@@ -122,7 +122,7 @@ const char* Storage::getConfigDescription( const ConfigType& type) const
 
 const char** Storage::getConfigParameters( const ConfigType& type) const
 {
-	static const char* keys_CreateStorageClient[]	= {"cachedterms", 0};
+	static const char* keys_CreateStorageClient[]	= {"cachedterms", "bulkload", "termdict", "blockcache", "metadatacache", "aclcache", "fwdict", "termvaluecache", 0};
 	static const char* keys_CreateStorage[]		= {"acl", 0};
 	switch (type)
 	{
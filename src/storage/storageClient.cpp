@@ -52,11 +52,14 @@
 #include "valueIterator.hpp"
 #include "aclReader.hpp"
 #include "storageDump.hpp"
+#include "aclBitmap.hpp"
+#include "booleanBlock.hpp"
 #include <sstream>
 #include <iostream>
 #include <string>
 #include <vector>
 #include <cstring>
+#include <algorithm>
 #include <cstdio>
 
 using namespace strus;
@@ -65,6 +68,9 @@ using namespace strus;
 
 static char const** getConfigParamList( const DatabaseInterface* db);
 
+/// \brief Counter for assigning storage client instance identifiers, starting with 1 because 0 stands for no identifier
+static strus::AtomicCounter<unsigned int> g_instanceIdCounter( 1);
+
 StorageClient::StorageClient(
 		const DatabaseInterface* database_,
 		const StatisticsProcessorInterface* statisticsProc_,
@@ -80,8 +86,16 @@ StorageClient::StorageClient(
 	,m_next_userno(0)
 	,m_next_attribno(0)
 	,m_nof_documents(0)
+	,m_revision(0)
+	,m_instanceId(g_instanceIdCounter.allocIncrement())
 	,m_metaDataBlockCache()
 	,m_documentFrequencyCache()
+	,m_bulkLoader()
+	,m_termDictionary()
+	,m_dataBlockCache()
+	,m_aclBitmapCache()
+	,m_termValueCache()
+	,m_forwardIndexDictTypes()
 	,m_close_called(false)
 	,m_statisticsProc(statisticsProc_)
 	,m_statisticsPath()
@@ -98,6 +112,13 @@ static char const** getConfigParamList( const DatabaseInterface* db)
 	for (int ci = 0; cfg[ci]; ++ci) cfgar.push_back( cfg[ci]);
 	cfgar.push_back( "acl");
 	cfgar.push_back( "statsproc");
+	cfgar.push_back( "bulkload");
+	cfgar.push_back( "termdict");
+	cfgar.push_back( "blockcache");
+	cfgar.push_back( "metadatacache");
+	cfgar.push_back( "aclcache");
+	cfgar.push_back( "fwdict");
+	cfgar.push_back( "termvaluecache");
 	cfgar.push_back( "database");
 	rt = (char const**)std::malloc( (cfgar.size()+1) * sizeof(rt[0]));
 	if (rt == NULL) throw std::bad_alloc();
@@ -111,6 +132,38 @@ void StorageClient::init( const std::string& databaseConfig)
 	std::string databaseConfigCopy( databaseConfig);
 	removeKeyFromConfigString( databaseConfigCopy, "acl", m_errorhnd);
 	removeKeyFromConfigString( databaseConfigCopy, "statsproc", m_errorhnd);
+	std::string bulkLoadDir;
+	(void)extractStringFromConfigString( bulkLoadDir, databaseConfigCopy, "bulkload", m_errorhnd);
+	bool useTermDictionary = false;
+	(void)extractBooleanFromConfigString( useTermDictionary, databaseConfigCopy, "termdict", m_errorhnd);
+	unsigned int blockCacheSize = 0;
+	(void)extractUIntFromConfigString( blockCacheSize, databaseConfigCopy, "blockcache", m_errorhnd);
+	unsigned int metaDataCacheSize = 0;
+	(void)extractUIntFromConfigString( metaDataCacheSize, databaseConfigCopy, "metadatacache", m_errorhnd);
+	unsigned int aclCacheSize = 0;
+	(void)extractUIntFromConfigString( aclCacheSize, databaseConfigCopy, "aclcache", m_errorhnd);
+	std::string forwardIndexDictTypes;
+	(void)extractStringFromConfigString( forwardIndexDictTypes, databaseConfigCopy, "fwdict", m_errorhnd);
+	unsigned int termValueCacheSize = 0;
+	(void)extractUIntFromConfigString( termValueCacheSize, databaseConfigCopy, "termvaluecache", m_errorhnd);
+	std::string prefixCacheSize;
+	if (extractStringFromConfigString( prefixCacheSize, databaseConfigCopy, "prefix_cache", m_errorhnd))
+	{
+		// The prefix cache of the database is meant for the point lookups in the dictionaries of the storage,
+		// the prefixes of the dictionary keys are taken as default for the keys cached:
+		std::string prefixCacheKeys;
+		if (!extractStringFromConfigString( prefixCacheKeys, databaseConfigCopy, "prefix_cache_keys", m_errorhnd))
+		{
+			prefixCacheKeys.push_back( (char)DatabaseKey::TermTypePrefix);
+			prefixCacheKeys.push_back( (char)DatabaseKey::TermValuePrefix);
+			prefixCacheKeys.push_back( (char)DatabaseKey::StructTypePrefix);
+			prefixCacheKeys.push_back( (char)DatabaseKey::DocIdPrefix);
+		}
+		databaseConfigCopy.append( ";prefix_cache=");
+		databaseConfigCopy.append( prefixCacheSize);
+		databaseConfigCopy.append( ";prefix_cache_keys=");
+		databaseConfigCopy.append( prefixCacheKeys);
+	}
 
 	Reference<DatabaseClientInterface> db( m_dbtype->createClient( databaseConfigCopy));
 	if (!db.get()) throw strus::runtime_error(_TXT("failed to initialize database client: %s"), m_errorhnd->fetchError());
@@ -126,9 +179,50 @@ void StorageClient::init( const std::string& databaseConfig)
 	}
 	MetaDataDescription metadescr;
 	metadescr.load( m_database.get());
-	m_metaDataBlockCache.reset( new MetaDataBlockCache( m_database.get(), metadescr));
-
+	m_metaDataBlockCache.reset( new MetaDataBlockCache( m_database.get(), metadescr, metaDataCacheSize));
+	if (InvertedIndexBulkLoader::interrupted( m_database.get()))
+	{
+		throw std::runtime_error( _TXT("storage contains documents of an interrupted bulk load without their postings, please rebuild your storage"));
+	}
+	if (!bulkLoadDir.empty())
+	{
+		m_bulkLoader.reset( new InvertedIndexBulkLoader( m_database.get(), bulkLoadDir));
+	}
+	if (blockCacheSize)
+	{
+		m_dataBlockCache.reset( new DataBlockCache( blockCacheSize));
+	}
+	if (aclCacheSize)
+	{
+		m_aclBitmapCache.reset( new AclBitmapCache( aclCacheSize));
+	}
+	if (termValueCacheSize)
+	{
+		m_termValueCache.reset( new TermValueCache( termValueCacheSize));
+	}
+	m_forwardIndexDictTypes.clear();
+	if (!forwardIndexDictTypes.empty())
+	{
+		// Comma separated list of the forward index type names:
+		char const* ti = forwardIndexDictTypes.c_str();
+		while (*ti)
+		{
+			char const* te = std::strchr( ti, ',');
+			if (!te) te = ti + std::strlen( ti);
+			std::string typestr = string_conv::tolower( string_conv::trim( std::string( ti, te-ti)));
+			if (!typestr.empty()) m_forwardIndexDictTypes.insert( typestr);
+			ti = *te ? (te+1) : te;
+		}
+	}
 	loadVariables( m_database.get());
+	if (useTermDictionary)
+	{
+		m_termDictionary.reset( new TermDictionary());
+		if (!m_termDictionary->load( m_database.get()))
+		{
+			m_errorhnd->info( _TXT("term dictionary too big to be memory resident, lookups are done in the database"));
+		}
+	}
 }
 
 bool StorageClient::reload( const std::string& databaseConfig)
@@ -162,6 +256,8 @@ bool StorageClient::reload( const std::string& databaseConfig)
 		if (m_errorhnd->hasError()) return false;
 
 		close();
+		if (m_errorhnd->hasError()) return false;
+
 		m_next_typeno.set(0);
 		m_next_termno.set(0);
 		m_next_structno.set(0);
@@ -176,10 +272,16 @@ bool StorageClient::reload( const std::string& databaseConfig)
 		//... this assignment guarantees that m_metaDataBlockCache is initialized, event if 'init' throws
 
 		m_documentFrequencyCache.reset();
+		m_bulkLoader.reset();
+		m_termDictionary.reset();
+		m_dataBlockCache.reset();
+		m_aclBitmapCache.reset();
+		m_termValueCache.reset();
 		m_statisticsPath.clear();
 
 		init( databaseConfig);
 		if (fillDfCache) fillDocumentFrequencyCache();
+		m_revision.increment();
 		return true;
 	}
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error in instance of '%s' reloading configuration: %s"), MODULENAME, *m_errorhnd, false);
@@ -189,6 +291,7 @@ StorageClient::~StorageClient()
 {
 	if (!m_close_called) try
 	{
+		flushBulkLoad();
 		storeVariables();
 	}
 	CATCH_ERROR_MAP( _TXT("error closing storage client: %s"), *m_errorhnd);
@@ -256,6 +359,57 @@ std::string StorageClient::config() const
 			if (!rt.empty()) rt.push_back(';');
 			rt.append( "acl=true");
 		}
+		if (m_bulkLoader.get())
+		{
+			if (!rt.empty()) rt.push_back(';');
+			rt.append( "bulkload=");
+			rt.append( m_bulkLoader->directory());
+		}
+		if (m_termDictionary.get())
+		{
+			if (!rt.empty()) rt.push_back(';');
+			rt.append( "termdict=");
+			rt.append( m_termDictionary->enabled() ? "yes" : "no");
+		}
+		if (m_dataBlockCache.get())
+		{
+			if (!rt.empty()) rt.push_back(';');
+			std::ostringstream out;
+			out << "blockcache=" << ((m_dataBlockCache->maxMemoryUsage() + 1023) / 1024) << "K";
+			rt.append( out.str());
+		}
+		if (mt->maxMemoryUsage())
+		{
+			if (!rt.empty()) rt.push_back(';');
+			std::ostringstream out;
+			out << "metadatacache=" << ((mt->maxMemoryUsage() + 1023) / 1024) << "K";
+			rt.append( out.str());
+		}
+		if (m_aclBitmapCache.get())
+		{
+			if (!rt.empty()) rt.push_back(';');
+			std::ostringstream out;
+			out << "aclcache=" << ((m_aclBitmapCache->maxMemoryUsage() + 1023) / 1024) << "K";
+			rt.append( out.str());
+		}
+		if (m_termValueCache.get())
+		{
+			if (!rt.empty()) rt.push_back(';');
+			std::ostringstream out;
+			out << "termvaluecache=" << ((m_termValueCache->maxMemoryUsage() + 1023) / 1024) << "K";
+			rt.append( out.str());
+		}
+		if (!m_forwardIndexDictTypes.empty())
+		{
+			if (!rt.empty()) rt.push_back(';');
+			rt.append( "fwdict=");
+			std::set<std::string>::const_iterator fi = m_forwardIndexDictTypes.begin(), fe = m_forwardIndexDictTypes.end();
+			for (int fidx=0; fi != fe; ++fi,++fidx)
+			{
+				if (fidx) rt.push_back(',');
+				rt.append( *fi);
+			}
+		}
 		return rt;
 	}
 	CATCH_ERROR_ARG1_MAP_RETURN( _TXT("error in instance of '%s' mapping configuration to string: %s"), MODULENAME, *m_errorhnd, std::string());
@@ -271,11 +425,13 @@ void StorageClient::releaseTransaction( const std::vector<Index>& refreshList)
 		mt->declareVoid( *ri);
 	}
 	mt->refresh();
+	m_revision.increment();
 }
 
 void StorageClient::resetMetaDataBlockCache( const strus::shared_ptr<MetaDataBlockCache>& mdcache)
 {
 	m_metaDataBlockCache = mdcache;
+	m_revision.increment();
 }
 
 static Index versionNo( Index major, Index minor)
@@ -346,14 +502,55 @@ void StorageClient::loadVariables( DatabaseClientInterface* database_)
 	m_next_userno.set( next_userno_);
 }
 
+static bool variableChanged( const DatabaseAdapter_Variable::Reader& varstor, const char* name, const Index& value)
+{
+	Index storedValue = 0;
+	return !varstor.load( name, storedValue) || storedValue != value;
+}
+
+bool StorageClient::variablesChanged() const
+{
+	DatabaseAdapter_Variable::Reader varstor( m_database.get());
+	return variableChanged( varstor, "TermNo", m_next_termno.value())
+		|| variableChanged( varstor, "TypeNo", m_next_typeno.value())
+		|| variableChanged( varstor, "StructNo", m_next_structno.value())
+		|| variableChanged( varstor, "DocNo", m_next_docno.value())
+		|| variableChanged( varstor, "AttribNo", m_next_attribno.value())
+		|| variableChanged( varstor, "NofDocs", m_nof_documents.value())
+		|| (withAcl() && variableChanged( varstor, "UserNo", m_next_userno.value()));
+}
+
 void StorageClient::storeVariables()
 {
+	//... nothing to write if the variables are unchanged, e.g. for a read only database that does not allow transactions
+	if (!variablesChanged()) return;
 	Reference<DatabaseTransactionInterface> transaction( m_database->createTransaction());
 	if (!transaction.get()) throw std::runtime_error( _TXT("error storing variables"));
 	getVariablesWriteBatch( transaction.get(), 0);
 	transaction->commit();
 }
 
+void StorageClient::flushBulkLoad()
+{
+	if (m_bulkLoader.get())
+	{
+		m_bulkLoader->flush();
+		if (m_dataBlockCache.get())
+		{
+			// The blocks written by the bulk loader are not recorded, all blocks cached are dropped:
+			m_dataBlockCache->clear();
+		}
+	}
+}
+
+void StorageClient::declareNewTermValues( const std::vector<TermDictionarySnapshot::Entry>& values)
+{
+	if (m_termDictionary.get())
+	{
+		m_termDictionary->declareTermValues( values);
+	}
+}
+
 void StorageClient::getVariablesWriteBatch(
 		DatabaseTransactionInterface* transaction,
 		int nof_documents_incr)
@@ -373,12 +570,17 @@ void StorageClient::getVariablesWriteBatch(
 
 Index StorageClient::getTermValue( const std::string& name) const
 {
+	Index rt;
+	if (m_termDictionary.get() && m_termDictionary->getTermValue( name, rt)) return rt;
 	return DatabaseAdapter_TermValue::Reader( m_database.get()).get( name);
 }
 
 Index StorageClient::getTermType( const std::string& name) const
 {
-	return DatabaseAdapter_TermType::Reader( m_database.get()).get( string_conv::tolower( name));
+	Index rt;
+	std::string typestr = string_conv::tolower( name);
+	if (m_termDictionary.get() && m_termDictionary->getTermType( typestr, rt)) return rt;
+	return DatabaseAdapter_TermType::Reader( m_database.get()).get( typestr);
 }
 
 Index StorageClient::getStructType( const std::string& name) const
@@ -571,6 +773,90 @@ InvAclIteratorInterface*
 	CATCH_ERROR_MAP_RETURN( _TXT("error creating inverted ACL iterator: %s"), *m_errorhnd, 0);
 }
 
+class AclBitmapIterator
+	:public InvAclIteratorInterface
+{
+public:
+	explicit AclBitmapIterator( const AclBitmapCache::BitmapRef& bitmap_)
+		:m_bitmap(bitmap_){}
+	virtual ~AclBitmapIterator(){}
+
+	virtual Index skipDoc( const Index& docno_)
+	{
+		return m_bitmap->skip( docno_);
+	}
+private:
+	AclBitmapCache::BitmapRef m_bitmap;			///< union of the documents visible for a set of users
+};
+
+static void collectUserAclRanges( std::vector<AclBitmap::Range>& ranges, const DatabaseClientInterface* database, Index userno)
+{
+	DatabaseAdapter_BooleanBlock::Cursor dbadapter( DatabaseKey::UserAclBlockPrefix, database, BlockKey(userno), false/*useCache*/);
+	BooleanBlock blk;
+	bool more = dbadapter.loadFirst( blk);
+	for (; more; more = dbadapter.loadNext( blk))
+	{
+		BooleanBlock::NodeCursor cursor;
+		Index from_;
+		Index to_;
+		bool hasRange = blk.getFirstRange( cursor, from_, to_);
+		for (; hasRange; hasRange = blk.getNextRange( cursor, from_, to_))
+		{
+			ranges.push_back( AclBitmap::Range( from_, to_));
+		}
+	}
+}
+
+InvAclIteratorInterface*
+	StorageClient::createInvAclIterator(
+		const std::vector<std::string>& usernames) const
+{
+	try
+	{
+		if (!withAcl())
+		{
+			return 0;
+		}
+		std::vector<std::string> users( usernames);
+		std::sort( users.begin(), users.end());
+		users.erase( std::unique( users.begin(), users.end()), users.end());
+
+		std::string key;
+		std::vector<std::string>::const_iterator ui = users.begin(), ue = users.end();
+		for (; ui != ue; ++ui)
+		{
+			key.append( *ui);
+			key.push_back( '\0');
+		}
+		unsigned int revision_ = m_revision.value();
+		//... read before building the bitmap, a bitmap built during a commit is outdated after it
+		AclBitmapCache::BitmapRef bitmap;
+		if (m_aclBitmapCache.get())
+		{
+			bitmap = m_aclBitmapCache->find( key, revision_);
+		}
+		if (!bitmap.get())
+		{
+			std::vector<AclBitmap::Range> ranges;
+			for (ui = users.begin(); ui != ue; ++ui)
+			{
+				Index userno = getUserno( *ui);
+				if (userno)
+				{
+					collectUserAclRanges( ranges, m_database.get(), userno);
+				}
+			}
+			bitmap.reset( new AclBitmap( ranges));
+			if (m_aclBitmapCache.get())
+			{
+				m_aclBitmapCache->insert( key, revision_, bitmap);
+			}
+		}
+		return new AclBitmapIterator( bitmap);
+	}
+	CATCH_ERROR_MAP_RETURN( _TXT("error creating inverted ACL iterator for a set of users: %s"), *m_errorhnd, 0);
+}
+
 AclReaderInterface* StorageClient::createAclReader() const
 {
 	try
@@ -777,6 +1063,7 @@ Index StorageClient::allocTypenoImm( const std::string& name)
 	if (!stor.load( name, rt))
 	{
 		stor.storeImm( name, rt = m_next_typeno.allocIncrement());
+		if (m_termDictionary.get()) m_termDictionary->declareTermType( name, rt);
 	}
 	return rt;
 }
@@ -878,6 +1165,16 @@ Index StorageClient::maxDocumentNumber() const
 	return m_next_docno.value()-1;
 }
 
+unsigned int StorageClient::revision() const
+{
+	return m_revision.value();
+}
+
+unsigned int StorageClient::instanceId() const
+{
+	return m_instanceId;
+}
+
 Index StorageClient::documentNumber( const std::string& docid) const
 {
 	return getDocno( docid);
@@ -1037,6 +1334,7 @@ void StorageClient::loadTermnoMap( const char* termnomap_source)
 	Reference<DatabaseTransactionInterface> transaction( m_database->createTransaction());
 	if (!transaction.get()) throw std::runtime_error( _TXT("error loading termno map"));
 	strus::unordered_map<std::string,Index> termno_map;
+	std::vector<TermDictionarySnapshot::Entry> newTermValues;
 	try
 	{
 		unsigned char const* si = (const unsigned char*)termnomap_source;
@@ -1064,11 +1362,15 @@ void StorageClient::loadTermnoMap( const char* termnomap_source)
 				// ... create it if not
 				termno = allocTermno();
 				stor.store( transaction.get(), name, termno);
+				newTermValues.push_back( TermDictionarySnapshot::Entry( name, termno));
 			}
 			// [4] Register it in the map:
 			termno_map[ name] = termno;
 		}
-		transaction->commit();
+		if (transaction->commit())
+		{
+			declareNewTermValues( newTermValues);
+		}
 	}
 	catch (const std::runtime_error& err)
 	{
@@ -1395,18 +1697,33 @@ bool StorageClient::checkStorage( std::ostream& errorlog) const
 
 void StorageClient::close()
 {
+	if (m_close_called) return;
 	try
 	{
-		storeVariables();
+		flushBulkLoad();
 	}
-	CATCH_ERROR_MAP( _TXT("error storing variables in close of storage: %s"), *m_errorhnd);
-
-	if (!m_close_called)
+	catch (const std::bad_alloc&)
+	{
+		m_close_called = true;
+		//... the bulk load is not repeated by the destructor, the storage stays marked as interrupted bulk load
+		m_errorhnd->report( ErrorCodeOutOfMem, _TXT("out of memory writing the blocks of bulk load in close of storage, the storage has to be rebuilt"));
+		return;
+	}
+	catch (const std::runtime_error& err)
 	{
-		m_database->compactDatabase();
-		m_database->close();
 		m_close_called = true;
+		m_errorhnd->report( ErrorCodeRuntimeError, _TXT("error writing the blocks of bulk load in close of storage, the storage has to be rebuilt: %s"), err.what());
+		return;
+	}
+	try
+	{
+		storeVariables();
 	}
+	CATCH_ERROR_MAP( _TXT("error storing variables in close of storage: %s"), *m_errorhnd);
+
+	m_database->compactDatabase();
+	m_database->close();
+	m_close_called = true;
 }
 
 void StorageClient::compaction()
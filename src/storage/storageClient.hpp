@@ -16,8 +16,18 @@
 #include "strus/base/atomic.hpp"
 #include "strus/storage/termStatistics.hpp"
 #include "metaDataBlockCache.hpp"
+#include "commitLockTable.hpp"
+#include "keyReservationTable.hpp"
+#include "invertedIndexBulkLoader.hpp"
+#include "termDictionary.hpp"
+#include "dataBlockCache.hpp"
+#include "aclBitmapCache.hpp"
+#include "termValueCache.hpp"
 #include "indexSetIterator.hpp"
 #include "strus/statisticsProcessorInterface.hpp"
+#include <set>
+#include <string>
+
 namespace strus {
 
 /// \brief Forward declaration
@@ -105,6 +115,10 @@ public:
 			createInvAclIterator(
 				const std::string& username) const;
 
+	virtual InvAclIteratorInterface*
+			createInvAclIterator(
+				const std::vector<std::string>& usernames) const;
+
 	virtual AclReaderInterface* createAclReader() const;
 
 	virtual StorageTransactionInterface*
@@ -139,6 +153,10 @@ public:
 
 	virtual Index maxDocumentNumber() const;
 
+	virtual unsigned int revision() const;
+
+	virtual unsigned int instanceId() const;
+
 	virtual Index documentNumber( const std::string& docid) const;
 
 	virtual Index structTypeNumber( const std::string& structname) const;
@@ -213,6 +231,12 @@ public:/*StorageTransaction*/
 	KeyAllocatorInterface* createTermnoAllocator();
 
 	bool withAcl() const;
+	/// \brief Evaluate if the values of a forward index type are written dictionary encoded as term value numbers
+	/// \param[in] typestr name of the type (lowercase)
+	bool isForwardIndexDictType( const std::string& typestr) const
+	{
+		return m_forwardIndexDictTypes.find( typestr) != m_forwardIndexDictTypes.end();
+	}
 
 	Index allocTermno();
 	Index allocDocno();
@@ -224,7 +248,27 @@ public:/*StorageTransaction*/
 
 	StatisticsBuilderInterface* getStatisticsBuilder();
 
-public:/*StorageTransaction,StorageMetaDataTransaction*/
+	/// \brief Get the table of locks for building the blocks of a commit outside the transaction lock
+	CommitLockTable* commitLockTable()			{return &m_commitLockTable;}
+
+	/// \brief Get the table of document numbers allocated by transactions not committed yet
+	/// \note Access only with the transaction lock held
+	KeyReservationTable& docnoReservations()		{return m_docnoReservations;}
+	/// \brief Get the table of term value numbers allocated by transactions not committed yet
+	/// \note Access only with the transaction lock held
+	KeyReservationTable& termnoReservations()		{return m_termnoReservations;}
+
+	/// \brief Get the bulk loader of the inverted index, if the storage client was configured for bulk load, NULL else
+	InvertedIndexBulkLoader* bulkLoader()			{return m_bulkLoader.get();}
+
+	/// \brief Get the cache of posting, ff and forward index blocks shared by all queries, if configured, NULL else
+	DataBlockCache* dataBlockCache() const			{return m_dataBlockCache.get();}
+	TermValueCache* termValueCache() const			{return m_termValueCache.get();}
+
+	/// \brief Declare the term values allocated by a transaction, to update the memory resident term dictionary
+	void declareNewTermValues( const std::vector<TermDictionarySnapshot::Entry>& values);
+
+public:/*StorageTransaction,StorageMetaDataTransaction,MetaDataRestriction*/
 	friend class TransactionLock;
 	class TransactionLock
 	{
@@ -276,7 +320,9 @@ public:/*strusResizeBlocks,StorageDocumentChecker,StorageTransaction*/
 private:
 	void init( const std::string& databaseConfig);
 	void loadVariables( DatabaseClientInterface* database_);
+	bool variablesChanged() const;
 	void storeVariables();
+	void flushBulkLoad();
 	// \brief Filling document frequency cache
 	// \note Neither this method nor the document frequency cache is ever used -- dead code
 	void fillDocumentFrequencyCache();
@@ -292,8 +338,13 @@ private:
 	strus::AtomicCounter<Index> m_next_userno;		///< next index to assign to a new user id
 	strus::AtomicCounter<Index> m_next_attribno;		///< next index to assign to a new attribute name
 	strus::AtomicCounter<Index> m_nof_documents;		///< number of documents inserted
+	strus::AtomicCounter<unsigned int> m_revision;		///< revision of the storage content, incremented with every change visible to queries
+	unsigned int m_instanceId;				///< identifier of this storage client instance unique in the process
 
-	strus::mutex m_transaction_mutex;			///< mutual exclusion in the critical part of a transaction
+	strus::mutex m_transaction_mutex;			///< mutual exclusion in the critical part of a transaction (number allocation and final write)
+	CommitLockTable m_commitLockTable;			///< striped locks for building the blocks of transactions modifying the same items
+	KeyReservationTable m_docnoReservations;		///< document numbers allocated by transactions not committed yet (protected by m_transaction_mutex)
+	KeyReservationTable m_termnoReservations;		///< term value numbers allocated by transactions not committed yet (protected by m_transaction_mutex)
 	strus::mutex m_immalloc_typeno_mutex;			///< mutual exclusion in the critical part of immediate allocation of typeno
 	strus::mutex m_immalloc_structno_mutex;			///< mutual exclusion in the critical part of immediate allocation of structno
 	strus::mutex m_immalloc_attribno_mutex;			///< mutual exclusion in the critical part of immediate allocation of attribno
@@ -301,6 +352,12 @@ private:
 
 	strus::shared_ptr<MetaDataBlockCache> m_metaDataBlockCache;///< read cache for meta data blocks
 	Reference<DocumentFrequencyCache> m_documentFrequencyCache; ///< reference to document frequency cache
+	Reference<InvertedIndexBulkLoader> m_bulkLoader;	///< bulk loader of the inverted index in bulk load mode
+	Reference<TermDictionary> m_termDictionary;		///< memory resident term type and value dictionary, if configured
+	Reference<DataBlockCache> m_dataBlockCache;		///< cache of posting, ff and forward index blocks shared by all queries, if configured
+	Reference<AclBitmapCache> m_aclBitmapCache;		///< cache of the ACL bitmaps of sets of users shared by all queries, if configured
+	Reference<TermValueCache> m_termValueCache;		///< cache of the values of the forward index items stored as term value numbers shared by all queries, if configured
+	std::set<std::string> m_forwardIndexDictTypes;		///< forward index types with values written dictionary encoded as term value numbers, if configured
 
 	bool m_close_called;					///< true if close was already called
 	const StatisticsProcessorInterface* m_statisticsProc;	///< statistics message processor
@@ -11,6 +11,7 @@
 #include "private/internationalization.hpp"
 #include "private/errorUtils.hpp"
 #include "strus/errorBufferInterface.hpp"
+#include "strus/constants.hpp"
 #include <string>
 #include <cstring>
 #include <limits>
@@ -61,10 +62,15 @@ void StorageDocument::addSearchIndexTerm(
 			{
 				m_maxpos = position_;
 			}
-			if (position_ <= (strus::Index)Constants::storage_max_position_info())
+			TermMapKey key( termMapKey( type_, value_));
+			TermMapValue& ref = m_terms[ key];
+			if (ref.pos.size() >= (std::size_t)Constants::storage_max_position_info() && ref.pos.find( position_) == ref.pos.end())
+			{
+				// ... the positions of a term in a document are referenced with 16 bits in a posinfo block
+				m_errorhnd->report( ErrorCodeMaxNofItemsExceeded, _TXT( "number of occurrencies of a term in a document out of range (max %d, term %s '%s')"), (int)Constants::storage_max_position_info(), type_.c_str(), value_.c_str());
+			}
+			else
 			{
-				TermMapKey key( termMapKey( type_, value_));
-				TermMapValue& ref = m_terms[ key];
 				ref.pos.insert( position_);
 			}
 		}
@@ -89,7 +95,7 @@ void StorageDocument::addSearchIndexStructure(
 		}
 		if (sink_.end() > m_maxpos)
 		{
-			m_maxpos = source_.end();
+			m_maxpos = sink_.end();
 		}
 		if (source_.end() <= std::numeric_limits<StructBlock::PositionType>::max()
 		&&  sink_.end() <= std::numeric_limits<StructBlock::PositionType>::max())
@@ -122,11 +128,8 @@ void StorageDocument::addForwardIndexTerm(
 			{
 				m_maxpos = position_;
 			}
-			if (position_ <= (strus::Index)Constants::storage_max_position_info())
-			{
-				Index typeno = m_transaction->getOrCreateTermType( type_);
-				m_invs[ InvMapKey( typeno, position_)] = value_;
-			}
+			Index typeno = m_transaction->getOrCreateTermType( type_);
+			m_invs[ InvMapKey( typeno, position_)] = value_;
 		}
 	}
 	CATCH_ERROR_ARG1_MAP( _TXT("error adding forward index structure to document %s: %s"), m_docid.c_str(), *m_errorhnd);
@@ -168,9 +171,9 @@ void StorageDocument::done()
 {
 	try
 	{
-		if (m_maxpos >= (strus::Index)Constants::storage_max_position_info())
+		if (m_nofStructuresIgnored)
 		{
-			m_errorhnd->info( _TXT("token positions are out of range (document too big, only %d of %d token positions assigned), %d structures dropped"), (int)(strus::Index)Constants::storage_max_position_info(), (int)m_maxpos, (int)m_nofStructuresIgnored);
+			m_errorhnd->info( _TXT("structure positions are out of range (document too big, %d token positions), %d structures dropped"), (int)m_maxpos, (int)m_nofStructuresIgnored);
 		}
 		//[1.1] Delete old metadata:
 		m_transaction->deleteMetaData( m_docno);
@@ -12,6 +12,7 @@
 #include "storage.hpp"
 #include "indexSetIterator.hpp"
 #include "strus/base/uintCompaction.hpp"
+#include "structBlock.hpp"
 #include "structBlockDeclaration.hpp"
 #include "strus/lib/structs.hpp"
 #include "strus/databaseClientInterface.hpp"
@@ -22,6 +23,7 @@
 #include "strus/valueIteratorInterface.hpp"
 #include "strus/structureIteratorInterface.hpp"
 #include "strus/errorBufferInterface.hpp"
+#include "strus/constants.hpp"
 #include "private/internationalization.hpp"
 #include "private/errorUtils.hpp"
 #include "strus/base/snprintf.h"
@@ -31,6 +33,7 @@
 #include <sstream>
 #include <algorithm>
 #include <fstream>
+#include <limits>
 
 using namespace strus;
 
@@ -75,18 +78,23 @@ void StorageDocumentChecker::addSearchIndexTerm(
 			{
 				m_maxpos = position_;
 			}
-			if (position_ <= (strus::Index)Constants::storage_max_position_info())
+			TermMap::iterator ti = m_termMap.find( Term( type_, value_));
+			TermAttributes* attributes = 0;
+			if (ti == m_termMap.end())
+			{
+				attributes = &m_termMap[ Term( type_, value_)];
+			}
+			else
+			{
+				attributes = &ti->second;
+			}
+			if (attributes->poset.size() >= (std::size_t)Constants::storage_max_position_info() && attributes->poset.find( position_) == attributes->poset.end())
+			{
+				// ... the positions of a term in a document are referenced with 16 bits in a posinfo block
+				m_errorhnd->report( ErrorCodeMaxNofItemsExceeded, _TXT( "number of occurrencies of a term in a document out of range (max %d, term %s '%s')"), (int)Constants::storage_max_position_info(), type_.c_str(), value_.c_str());
+			}
+			else
 			{
-				TermMap::iterator ti = m_termMap.find( Term( type_, value_));
-				TermAttributes* attributes = 0;
-				if (ti == m_termMap.end())
-				{
-					attributes = &m_termMap[ Term( type_, value_)];
-				}
-				else
-				{
-					attributes = &ti->second;
-				}
 				attributes->poset.insert( position_);
 			}
 		}
@@ -107,8 +115,16 @@ void StorageDocumentChecker::addSearchIndexStructure(
 		}
 		else
 		{
-			if (source_.end() <= (strus::Index)Constants::storage_max_position_info()
-			&&  sink_.end() <= (strus::Index)Constants::storage_max_position_info())
+			if (source_.end() > m_maxpos)
+			{
+				m_maxpos = source_.end();
+			}
+			if (sink_.end() > m_maxpos)
+			{
+				m_maxpos = sink_.end();
+			}
+			if (source_.end() <= std::numeric_limits<StructBlock::PositionType>::max()
+			&&  sink_.end() <= std::numeric_limits<StructBlock::PositionType>::max())
 			{
 				std::string structnam = strus::string_conv::tolower( struct_);
 				m_structurelist.insert( Structure( structnam, source_, sink_));
@@ -139,10 +155,7 @@ void StorageDocumentChecker::addForwardIndexTerm(
 			{
 				m_maxpos = position_;
 			}
-			if (position_ <= (strus::Index)Constants::storage_max_position_info())
-			{
-				m_invTermMap[ InvKey( type_, position_)] = value_;
-			}
+			m_invTermMap[ InvKey( type_, position_)] = value_;
 		}
 	}
 	CATCH_ERROR_MAP( _TXT("error adding forward index term: %s"), *m_errorhnd);
@@ -465,9 +478,9 @@ void StorageDocumentChecker::done()
 {
 	try
 	{
-		if (m_maxpos >= (strus::Index)Constants::storage_max_position_info())
+		if (m_nofStructuresIgnored)
 		{
-			m_errorhnd->info( _TXT("token positions are out of range (document too big, only %d of %d token positions assigned), %d structures dropped"), (int)(strus::Index)Constants::storage_max_position_info(), (int)m_maxpos, (int)m_nofStructuresIgnored);
+			m_errorhnd->info( _TXT("structure positions are out of range (document too big, %d token positions), %d structures dropped"), (int)m_maxpos, (int)m_nofStructuresIgnored);
 		}
 		if (m_logfile == "-")
 		{
@@ -11,9 +11,11 @@
 #include "private/internationalization.hpp"
 #include "private/errorUtils.hpp"
 #include "strus/errorBufferInterface.hpp"
+#include "strus/constants.hpp"
 #include "strus/base/string_format.hpp"
 #include <string>
 #include <cstring>
+#include <limits>
 #include <set>
 
 using namespace strus;
@@ -31,6 +33,8 @@ StorageDocumentUpdate::StorageDocumentUpdate(
 	,m_add_userlist(),m_del_userlist()
 	,m_doClearUserList(false)
 	,m_doClearStructureList(false)
+	,m_maxpos(0)
+	,m_nofStructuresIgnored(0)
 	,m_errorhnd(errorhnd_)
 {}
 
@@ -59,7 +63,15 @@ void StorageDocumentUpdate::addSearchIndexTerm(
 		{
 			TermMapKey key( termMapKey( type_, value_));
 			TermMapValue& ref = m_terms[ key];
-			ref.pos.insert( position_);
+			if (ref.pos.size() >= (std::size_t)Constants::storage_max_position_info() && ref.pos.find( position_) == ref.pos.end())
+			{
+				// ... the positions of a term in a document are referenced with 16 bits in a posinfo block
+				m_errorhnd->report( ErrorCodeMaxNofItemsExceeded, _TXT( "number of occurrencies of a term in a document out of range (max %d, term %s '%s')"), (int)Constants::storage_max_position_info(), type_.c_str(), value_.c_str());
+			}
+			else
+			{
+				ref.pos.insert( position_);
+			}
 			m_delete_search_typenolist.insert( key.first);
 		}
 	}
@@ -73,26 +85,30 @@ void StorageDocumentUpdate::addSearchIndexStructure(
 {
 	try
 	{
-		if (source_.end() > std::numeric_limits<StructBlock::PositionType>::max())
-		{
-			throw strus::runtime_error(_TXT("structure %s exceeds maximum position stored"), "source");
-		}
-		if (sink_.end() > std::numeric_limits<StructBlock::PositionType>::max())
-		{
-			throw strus::runtime_error(_TXT("structure %s exceeds maximum position stored"), "sink");
-		}
 		if (source_.start() <= 0 || source_.end() <= 0 || sink_.start() <= 0 || sink_.end() <= 0)
 		{
 			m_errorhnd->report( ErrorCodeInvalidArgument, _TXT( "structure range positions must be >= 1 (structure '%s')"), struct_.c_str());
 		}
 		else
 		{
-			if (source_.end() <= (strus::Index)Constants::storage_max_position_info()
-			&&  sink_.end() <= (strus::Index)Constants::storage_max_position_info())
+			if (source_.end() > m_maxpos)
+			{
+				m_maxpos = source_.end();
+			}
+			if (sink_.end() > m_maxpos)
+			{
+				m_maxpos = sink_.end();
+			}
+			if (source_.end() <= std::numeric_limits<StructBlock::PositionType>::max()
+			&&  sink_.end() <= std::numeric_limits<StructBlock::PositionType>::max())
 			{
 				Index structno = m_transaction->getOrCreateStructType( struct_);
 				m_structBuilder.append( structno, source_, sink_);
 			}
+			else
+			{
+				m_nofStructuresIgnored += 1;
+			}
 			m_doClearStructureList = false;
 		}
 	}
@@ -245,6 +261,10 @@ void StorageDocumentUpdate::done()
 {
 	try
 	{
+		if (m_nofStructuresIgnored)
+		{
+			m_errorhnd->info( _TXT("structure positions are out of range (document too big, %d token positions), %d structures dropped"), (int)m_maxpos, (int)m_nofStructuresIgnored);
+		}
 		//[1] Delete old index elements (forward index and inverted index):
 		{
 			std::set<Index>::const_iterator si = m_delete_search_typenolist.begin(), se = m_delete_search_typenolist.end();
@@ -259,7 +279,7 @@ void StorageDocumentUpdate::done()
 				m_transaction->deleteDocForwardIndexType( m_docno, *fi);
 			}
 		}{
-			if (m_doClearStructureList || !m_structBuilder.empty())
+			if (m_doClearStructureList || !m_structBuilder.empty() || m_nofStructuresIgnored)
 			{
 				m_transaction->deleteStructures( m_docno);
 			}
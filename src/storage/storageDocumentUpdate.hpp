@@ -121,6 +121,8 @@ private:
 	std::vector<Index> m_del_userlist;			///< list of users to remove from this document access
 	bool m_doClearUserList;					///< true if the list of all users should be cleared before this transaction
 	bool m_doClearStructureList;				///< true if the list of all structures should be cleared before this transaction
+	Index m_maxpos;						///< maximum position of a structure added
+	int m_nofStructuresIgnored;				///< number of structures ignored
 	ErrorBufferInterface* m_errorhnd;			///< error buffer for exception free interface
 };
 
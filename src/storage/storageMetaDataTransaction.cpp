@@ -84,7 +84,7 @@ bool StorageMetaDataTransaction::commit()
 		MetaDataMap blockmap( m_storage->databaseClient(), m_storage->getMetaDataBlockCacheRef());
 		blockmap.rewriteMetaData( trmap, m_metadescr_new, transaction.get());
 		m_metadescr_new.store( transaction.get());
-		new_mdcache.reset( new MetaDataBlockCache( m_storage->databaseClient(), m_metadescr_new));
+		new_mdcache.reset( new MetaDataBlockCache( m_storage->databaseClient(), m_metadescr_new, m_storage->getMetaDataBlockCacheRef()->maxMemoryUsage()));
 	
 		if (!transaction->commit()) return false;
 		m_storage->resetMetaDataBlockCache( new_mdcache);
@@ -36,7 +36,7 @@ StorageTransaction::StorageTransaction(
 	:m_storage(storage_)
 	,m_attributeMap(storage_->databaseClient())
 	,m_metaDataMap(storage_->databaseClient(),storage_->getMetaDataBlockCacheRef())
-	,m_invertedIndexMap(storage_->databaseClient())
+	,m_invertedIndexMap(storage_->databaseClient(),storage_->bulkLoader())
 	,m_structIndexMap(storage_->databaseClient(),errorhnd_)
 	,m_forwardIndexMap(storage_->databaseClient(),maxtypeno_)
 	,m_userAclMap(storage_->databaseClient())
@@ -49,6 +49,8 @@ StorageTransaction::StorageTransaction(
 	,m_termTypeMapInv()
 	,m_termValueMapInv()
 	,m_explicit_dfmap(storage_->databaseClient())
+	,m_docnoset()
+	,m_forwardIndexDictTypes()
 	,m_nofDeletedDocuments(0)
 	,m_nofOperations(0)
 	,m_errorhnd(errorhnd_)
@@ -77,7 +79,13 @@ Index StorageTransaction::getOrCreateTermValue( const std::string& name)
 
 Index StorageTransaction::getOrCreateTermType( const std::string& name)
 {
-	return m_termTypeMap.getOrCreate( string_conv::tolower( name));
+	std::string typestr = string_conv::tolower( name);
+	Index rt = m_termTypeMap.getOrCreate( typestr);
+	if (m_storage->isForwardIndexDictType( typestr))
+	{
+		m_forwardIndexDictTypes.insert( rt);
+	}
+	return rt;
 }
 
 Index StorageTransaction::getOrCreateStructType( const std::string& name)
@@ -176,7 +184,14 @@ void StorageTransaction::defineForwardIndexTerm(
 	strus::Index pos,
 	const std::string& termstring)
 {
-	m_forwardIndexMap.defineForwardIndexTerm( typeno, pos, termstring);
+	if (!termstring.empty() && m_forwardIndexDictTypes.find( typeno) != m_forwardIndexDictTypes.end())
+	{
+		m_forwardIndexMap.defineForwardIndexTermno( typeno, pos, getOrCreateTermValue( termstring));
+	}
+	else
+	{
+		m_forwardIndexMap.defineForwardIndexTerm( typeno, pos, termstring);
+	}
 }
 
 void StorageTransaction::closeForwardIndexDocument()
@@ -220,6 +235,10 @@ void StorageTransaction::deleteDocument( const std::string& docid)
 {
 	try
 	{
+		if (m_storage->bulkLoader())
+		{
+			throw strus::runtime_error_ec( ErrorCodeNotAllowed, _TXT("deleting documents is not allowed in bulk load mode"));
+		}
 		Index docno = m_docIdMap.lookUp( docid);
 		if (docno == 0) return;
 
@@ -237,6 +256,7 @@ void StorageTransaction::deleteDocument( const std::string& docid)
 
 		//[5] Delete the document id
 		m_docIdMap.deleteKey( docid);
+		m_docnoset.insert( docno);
 		m_nofDeletedDocuments += 1;
 		++m_nofOperations;
 	}
@@ -250,6 +270,7 @@ StorageDocumentInterface*
 	try
 	{
 		Index dn = m_docIdMap.getOrCreate( docid);
+		m_docnoset.insert( dn);
 		++m_nofOperations;
 		return new StorageDocument( this, docid, dn, m_errorhnd);
 	}
@@ -262,6 +283,11 @@ StorageDocumentUpdateInterface*
 {
 	try
 	{
+		if (m_storage->bulkLoader())
+		{
+			throw strus::runtime_error_ec( ErrorCodeNotAllowed, _TXT("updating documents is not allowed in bulk load mode"));
+		}
+		m_docnoset.insert( docno_);
 		++m_nofOperations;
 		return new StorageDocumentUpdate( this, docno_, m_errorhnd);
 	}
@@ -273,6 +299,7 @@ void StorageTransaction::updateMetaData(
 {
 	try
 	{
+		m_docnoset.insert( docno);
 		++m_nofOperations;
 		defineMetaData( docno, varname, value);
 	}
@@ -304,12 +331,131 @@ StorageMetaDataTableUpdateInterface* StorageTransaction::createMetaDataTableUpda
 	CATCH_ERROR_MAP_RETURN( _TXT("error creating meta data table structure update: %s"), *m_errorhnd, 0);
 }
 
+static void renameNewDocNumbers( std::set<Index>& docnoset, const std::map<Index,Index>& renamemap)
+{
+	std::set<Index> new_docnoset;
+	std::set<Index>::const_iterator di = docnoset.begin(), de = docnoset.end();
+	for (; di != de; ++di)
+	{
+		if (KeyMap::isUnknown( *di))
+		{
+			std::map<Index,Index>::const_iterator ri = renamemap.find( *di);
+			if (ri == renamemap.end())
+			{
+				throw strus::runtime_error( _TXT( "%s value undefined (%s)"), "docno", "document set");
+			}
+			new_docnoset.insert( ri->second);
+		}
+		else
+		{
+			new_docnoset.insert( *di);
+		}
+	}
+	docnoset.swap( new_docnoset);
+}
+
+void StorageTransaction::lockModifiedItems( CommitLockTable::ScopedLock& lock) const
+{
+	{
+		// [1] Documents, meta data blocks and users, all known without reading the storage:
+		std::set<std::size_t> stripes;
+		std::set<Index>::const_iterator di = m_docnoset.begin(), de = m_docnoset.end();
+		for (; di != de; ++di)
+		{
+			stripes.insert( CommitLockTable::stripeIndex( CommitLockTable::DocumentStripe, *di));
+			stripes.insert( CommitLockTable::stripeIndex( CommitLockTable::MetaDataBlockStripe, MetaDataBlock::blockno( *di)));
+		}
+		std::set<Index> userset;
+		m_userAclMap.collectUsers( userset);
+		std::set<Index>::const_iterator ui = userset.begin(), ue = userset.end();
+		for (; ui != ue; ++ui)
+		{
+			stripes.insert( CommitLockTable::stripeIndex( CommitLockTable::UserStripe, *ui));
+		}
+		lock.lock( stripes);
+	}{
+		// [2] Terms, reading the inverse term blocks of deleted documents protected by the document stripes locked in [1]:
+		std::set<std::size_t> stripes;
+		std::set<std::pair<Index,Index> > termset;
+		m_invertedIndexMap.collectTerms( termset);
+		m_explicit_dfmap.collectTerms( termset);
+		std::set<std::pair<Index,Index> >::const_iterator ti = termset.begin(), te = termset.end();
+		for (; ti != te; ++ti)
+		{
+			stripes.insert( CommitLockTable::stripeIndex( CommitLockTable::TermStripe, ti->first, ti->second));
+		}
+		lock.lock( stripes);
+	}
+}
+
+void StorageTransaction::releaseReservations()
+{
+	StorageClient::TransactionLock lock( m_storage);
+	m_termValueMap.releaseReservations( m_storage->termnoReservations());
+	m_docIdMap.releaseReservations( m_storage->docnoReservations());
+}
+
 StorageCommitResult StorageTransaction::commit_contentTransaction()
 {
-	if (m_storage->getMetaDataBlockCacheRef().get() != m_metaDataMap.metaDataBlockCache().get())
+	// [1] Allocate the numbers of new terms and documents:
+	//	The numbers are only reserved in memory, so that concurrent transactions see them,
+	//	the keys are written with the content in the final database transaction
+	std::map<Index,Index> termnoUnknownMap;
+	std::map<Index,Index> docnoUnknownMap;
+	int nof_new_documents = 0;
+	int nof_chg_documents = 0;
+	{
+		StorageClient::TransactionLock lock( m_storage);
+		//... allocation needs a lock because it has to see the allocations of the transactions committed before or running in parallel
+
+		if (m_storage->getMetaDataBlockCacheRef().get() != m_metaDataMap.metaDataBlockCache().get())
+		{
+			throw std::runtime_error(_TXT("transaction rollback because meta data structure changed during lifetime of transaction"));
+		}
+		m_termValueMap.allocate( termnoUnknownMap, m_storage->termnoReservations());
+		m_docIdMap.allocate( docnoUnknownMap, m_storage->docnoReservations(), &nof_new_documents, &nof_chg_documents);
+	}
+	try
+	{
+		StorageCommitResult result = commit_contentTransaction( termnoUnknownMap, docnoUnknownMap, nof_new_documents, nof_chg_documents);
+		releaseReservations();
+		if (result.success()) reset();
+		return result;
+	}
+	catch (...)
+	{
+		releaseReservations();
+		throw;
+	}
+}
+
+StorageCommitResult StorageTransaction::commit_contentTransaction(
+		const std::map<Index,Index>& termnoUnknownMap,
+		const std::map<Index,Index>& docnoUnknownMap,
+		int nof_new_documents,
+		int nof_chg_documents)
+{
+	if (m_storage->bulkLoader() && nof_chg_documents)
 	{
-		throw std::runtime_error(_TXT("transaction rollback because meta data structure changed during lifetime of transaction"));
+		throw strus::runtime_error_ec( ErrorCodeNotAllowed, _TXT("inserting documents already in the storage is not allowed in bulk load mode"));
 	}
+
+	// [2] Rename the new numbers allocated:
+	renameNewDocNumbers( m_docnoset, docnoUnknownMap);
+	m_attributeMap.renameNewDocNumbers( docnoUnknownMap);
+	m_metaDataMap.renameNewDocNumbers( docnoUnknownMap);
+	m_invertedIndexMap.renameNewNumbers( docnoUnknownMap, termnoUnknownMap);
+	m_structIndexMap.renameNewDocNumbers( docnoUnknownMap);
+	m_forwardIndexMap.renameNewDocNumbers( docnoUnknownMap);
+	m_forwardIndexMap.renameNewTermNumbers( termnoUnknownMap);
+	m_explicit_dfmap.renameNewTermNumbers( termnoUnknownMap);
+	m_userAclMap.renameNewDocNumbers( docnoUnknownMap);
+
+	// [3] Lock the items modified, transactions modifying disjoint sets of items build their blocks in parallel:
+	CommitLockTable::ScopedLock itemlock( m_storage->commitLockTable());
+	lockModifiedItems( itemlock);
+
+	// [4] Build the blocks to write outside the transaction lock:
 	const StatisticsProcessorInterface* statsproc = m_storage->getStatisticsProcessor();
 	Reference<StatisticsBuilderInterface> statisticsBuilder;
 	if (statsproc)
@@ -324,22 +470,18 @@ StorageCommitResult StorageTransaction::commit_contentTransaction()
 		m_errorhnd->explain( _TXT( "error creating transaction: %s"));
 		return StorageCommitResult();
 	}
-	std::map<Index,Index> termnoUnknownMap;
-	m_termValueMap.getWriteBatch( termnoUnknownMap, transaction.get());
-	std::map<Index,Index> docnoUnknownMap;
-	int nof_new_documents = 0;
-	int nof_chg_documents = 0;
-	m_docIdMap.getWriteBatch( docnoUnknownMap, transaction.get(), &nof_new_documents, &nof_chg_documents);
-	int nof_documents_incr = nof_new_documents - m_nofDeletedDocuments;
+	if (m_storage->dataBlockCache())
+	{
+		// Record the keys of the blocks written, to invalidate them in the block cache shared by the queries after the commit:
+		DatabaseTransactionInterface* cachetransaction = new DataBlockCacheTransaction( transaction.get(), m_storage->dataBlockCache());
+		(void)transaction.release();//... ownership passed to cachetransaction
+		transaction.reset( cachetransaction);
+	}
+	m_docIdMap.getDeletesWriteBatch( transaction.get());
 	std::vector<Index> refreshList;
-	m_attributeMap.renameNewDocNumbers( docnoUnknownMap);
 	m_attributeMap.getWriteBatch( transaction.get());
-	m_metaDataMap.renameNewDocNumbers( docnoUnknownMap);
 	m_metaDataMap.getWriteBatch( transaction.get(), refreshList);
 
-	m_invertedIndexMap.renameNewNumbers( docnoUnknownMap, termnoUnknownMap);
-	m_structIndexMap.renameNewDocNumbers( docnoUnknownMap);
-
 	DocumentFrequencyCache::Batch dfbatch;
 
 	m_invertedIndexMap.getWriteBatch(
@@ -348,50 +490,84 @@ StorageCommitResult StorageTransaction::commit_contentTransaction()
 			m_termTypeMapInv, m_termValueMapInv);
 	m_structIndexMap.getWriteBatch( transaction.get());
 
-	if (statsproc)
-	{
-		statisticsBuilder->addNofDocumentsInsertedChange( nof_documents_incr);
-	}
-	m_forwardIndexMap.renameNewDocNumbers( docnoUnknownMap);
-	m_forwardIndexMap.getWriteBatch( transaction.get());
+	m_forwardIndexMap.getWriteBatch( transaction.get(), m_storage->bulkLoader() != 0/*new documents only*/);
 
-	m_explicit_dfmap.renameNewTermNumbers( termnoUnknownMap);
 	m_explicit_dfmap.getWriteBatch( transaction.get(), statisticsBuilder.get(),
 					dfcache?&dfbatch:(DocumentFrequencyCache::Batch*)0,
 					m_termTypeMapInv, m_termValueMapInv);
 
-	m_userAclMap.renameNewDocNumbers( docnoUnknownMap);
 	m_userAclMap.getWriteBatch( transaction.get());
-
-	m_storage->getVariablesWriteBatch( transaction.get(), nof_documents_incr);
 	if (m_errorhnd->hasError())
 	{
 		m_errorhnd->explain(_TXT("error in transaction commit gathering data: %s"));
 		return StorageCommitResult();
 	}
-	if (statsproc)
+
+	// [5] Write the batch:
+	std::vector<TermDictionarySnapshot::Entry> newTermValues;
 	{
-		if (!statisticsBuilder->commit())
+		StorageClient::TransactionLock lock( m_storage);
+		//... we need a lock because the final writes of transactions need to be sequentialized
+
+		if (m_storage->getMetaDataBlockCacheRef().get() != m_metaDataMap.metaDataBlockCache().get())
+		{
+			throw std::runtime_error(_TXT("transaction rollback because meta data structure changed during lifetime of transaction"));
+		}
+		// Write the keys allocated that were not written by a concurrent transaction sharing them and committed before:
+		newTermValues = m_termValueMap.getNewKeysWriteBatch( transaction.get());
+		int nof_documents_incr = (int)m_docIdMap.getNewKeysWriteBatch( transaction.get()).size() - m_nofDeletedDocuments;
+
+		m_storage->getVariablesWriteBatch( transaction.get(), nof_documents_incr);
+		if (m_storage->bulkLoader())
+		{
+			// The storage is not consistent until the postings of the documents committed are written by the flush of the bulk loader:
+			m_storage->bulkLoader()->getMarkerWriteBatch( transaction.get());
+		}
+		if (statsproc)
+		{
+			statisticsBuilder->addNofDocumentsInsertedChange( nof_documents_incr);
+			if (!statisticsBuilder->commit())
+			{
+				m_errorhnd->explain( _TXT("error in statistics message builder commit: %s"));
+				return StorageCommitResult();
+			}
+		}
+		if (!transaction->commit())
 		{
-			m_errorhnd->explain( _TXT("error in statistics message builder commit: %s"));
+			m_errorhnd->explain(_TXT("error in database transaction commit: %s"));
 			return StorageCommitResult();
 		}
+		if (dfcache)
+		{
+			dfcache->writeBatch( dfbatch);
+		}
+		m_storage->declareNofDocumentsInserted( nof_documents_incr);
+		m_storage->releaseTransaction( refreshList);
 	}
-	if (!transaction->commit())
-	{
-		m_errorhnd->explain(_TXT("error in database transaction commit: %s"));
-		return StorageCommitResult();
-	}
-	if (dfcache)
+	// Declare the new term values outside the transaction lock, the update of the term dictionary might rebuild its trie.
+	// Lookups of the values in between are answered by the database:
+	m_storage->declareNewTermValues( newTermValues);
+	if (m_storage->bulkLoader())
 	{
-		dfcache->writeBatch( dfbatch);
+		// [6] Pass the postings committed to the bulk loader, they are written on close of the storage.
+		//	The documents are committed already, so an error here does not fail the commit. The flush on close
+		//	fails instead and the storage stays marked as an interrupted bulk load:
+		try
+		{
+			m_invertedIndexMap.addPostingsToBulkLoader();
+		}
+		catch (const std::bad_alloc&)
+		{
+			m_storage->bulkLoader()->declarePostingsLost( _TXT("out of memory"));
+			m_errorhnd->info( _TXT("postings of documents committed could not be added to the bulk loader: %s"), _TXT("out of memory"));
+		}
+		catch (const std::exception& err)
+		{
+			m_storage->bulkLoader()->declarePostingsLost( err.what());
+			m_errorhnd->info( _TXT("postings of documents committed could not be added to the bulk loader: %s"), err.what());
+		}
 	}
-	m_storage->declareNofDocumentsInserted( nof_documents_incr);
-	m_storage->releaseTransaction( refreshList);
-
-	StorageCommitResult result( true, nof_new_documents + nof_chg_documents + m_nofDeletedDocuments);
-	reset();
-	return result;
+	return StorageCommitResult( true, nof_new_documents + nof_chg_documents + m_nofDeletedDocuments);
 }
 
 StorageCommitResult StorageTransaction::commit()
@@ -407,9 +583,6 @@ StorageCommitResult StorageTransaction::commit()
 	}
 	try
 	{
-		StorageClient::TransactionLock lock( m_storage);
-		//... we need a lock because transactions need to be sequentialized
-
 		if (m_nofOperations)
 		{
 			m_nofOperations = 0;
@@ -428,6 +601,9 @@ StorageCommitResult StorageTransaction::commit()
 		{
 			if (m_metadataTransaction.get())
 			{
+				StorageClient::TransactionLock lock( m_storage);
+				//... we need a lock because transactions altering the meta data table need to be sequentialized with the others
+
 				StorageCommitResult result( m_metadataTransaction->commit(), 0);
 				reset();
 				return result;
@@ -471,6 +647,7 @@ void StorageTransaction::reset()
 	m_termValueMapInv.clear();
 
 	m_explicit_dfmap.clear();
+	m_docnoset.clear();
 
 	m_nofDeletedDocuments = 0;
 	m_nofOperations = 0;
@@ -26,6 +26,7 @@
 #include "keyMap.hpp"
 #include "keyMapInv.hpp"
 #include "keyAllocatorInterface.hpp"
+#include "commitLockTable.hpp"
 #include "private/stringMap.hpp"
 #include <vector>
 #include <string>
@@ -126,6 +127,15 @@ public:/*Document,DocumentUpdate*/
 private:
 	void reset();
 	StorageCommitResult commit_contentTransaction();
+	StorageCommitResult commit_contentTransaction(
+			const std::map<Index,Index>& termnoUnknownMap,
+			const std::map<Index,Index>& docnoUnknownMap,
+			int nof_new_documents,
+			int nof_chg_documents);
+	/// \brief Lock the stripes of all items modified by this transaction in the commit lock table of the storage
+	void lockModifiedItems( CommitLockTable::ScopedLock& lock) const;
+	/// \brief Release the numbers of new terms and documents reserved for this transaction after commit or failure
+	void releaseReservations();
 
 private:
 	StorageClient* m_storage;				///< storage to call refresh after commit or rollback
@@ -150,6 +160,8 @@ private:
 	KeyMapInv m_termValueMapInv;				///< inverse map of term values
 
 	DocumentFrequencyMap m_explicit_dfmap;			///< df map for features not in search index with explicit df change
+	std::set<Index> m_docnoset;				///< set of documents modified by this transaction
+	std::set<Index> m_forwardIndexDictTypes;		///< forward index types with values stored dictionary encoded as term value numbers
 
 	int m_nofDeletedDocuments;				///< total adjustment for the number of documents deleted
 	int m_nofOperations;					///< number of atering operations in this transaction without counting meta data table structure operations, used to decide wheter this transaction in changing meta data or content */
@@ -30,6 +30,8 @@ namespace strus {
 
 /// \class StructBlock
 /// \brief Block of structures defined as unidirectional relation between position ranges in a document with the relation source ranges not overlapping.
+/// \note The positions of structures are stored with 16 bits (PositionType), unlike the positions of posinfo blocks.
+///	Structures with positions beyond this range are dropped when the document is added and reported with an info message.
 class StructBlock
 	:public DataBlock
 {
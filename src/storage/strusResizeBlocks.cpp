@@ -15,12 +15,17 @@
 #include "strus/versionStorage.hpp"
 #include "strus/databaseTransactionInterface.hpp"
 #include "strus/databaseInterface.hpp"
+#include "strus/databaseCursorInterface.hpp"
+#include "strus/storage/databaseOptions.hpp"
 #include "private/errorUtils.hpp"
 #include "private/internationalization.hpp"
 #include "databaseAdapter.hpp"
 #include "storageClient.hpp"
 #include "forwardIndexBlock.hpp"
 #include "forwardIndexMap.hpp"
+#include "posinfoBlock.hpp"
+#include "databaseKey.hpp"
+#include "indexPacker.hpp"
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -34,7 +39,8 @@ static void printUsage()
 {
 	std::cout << "strusResizeBlocks [options] <config> <blocktype> <newsize>" << std::endl;
 	std::cout << "Description: Patches a storage index (currently forward index)," << std::endl;
-	std::cout << "  resizeing the size of blocks." << std::endl;
+	std::cout << "  resizeing the size of blocks, or converts blocks to the current" << std::endl;
+	std::cout << "  block format (currently posinfo blocks to the compressed format)." << std::endl;
 	std::cout << "Options:" << std::endl;
 	std::cout << "-h|--help" << std::endl;
 	std::cout << "    " << _TXT("Print this usage and do nothing else") << std::endl;
@@ -49,7 +55,9 @@ static void printUsage()
 	std::cout << "<config>     : " << _TXT("configuration string of the key/value store database") << std::endl;
 	std::cout << "<blocktype>  : " << _TXT("storage block type. One of the following:") << std::endl;
 	std::cout << "               forwardindex:" << _TXT("forward index block type") << std::endl;
+	std::cout << "               posinfo:" << _TXT("posinfo block type (conversion to compressed format)") << std::endl;
 	std::cout << "<newsize>    : " << _TXT("new size of the blocks, unit depends on block type.") << std::endl;
+	std::cout << "               " << _TXT("0 for block types that are converted and not resized.") << std::endl;
 }
 
 static strus::ErrorBufferInterface* g_errorBuffer = 0;	// error buffer
@@ -192,6 +200,52 @@ static void resizeBlocks(
 			::fflush( stdout);
 		}
 	}
+	else if (strus::caseInsensitiveEquals( blocktype, "posinfo"))
+	{
+		if (newsize) throw strus::runtime_error(_TXT("size of blocks of type '%s' cannot be changed, only a conversion to the compressed format (size 0) is implemented"), blocktype.c_str());
+
+		strus::Reference<strus::DatabaseCursorInterface> cursor( storage.databaseClient()->createCursor( strus::DatabaseOptions()));
+		if (!cursor.get()) throw std::runtime_error( _TXT("failed to create database cursor"));
+		char prefix = strus::DatabaseKey::PosinfoBlockPrefix;
+		strus::DatabaseCursorInterface::Slice key = cursor->seekFirst( &prefix, 1);
+		for (; key.defined(); key = cursor->seekNext())
+		{
+			char const* ki = key.ptr()+1;
+			char const* ke = key.ptr()+key.size();
+			strus::Index typeno = strus::unpackIndex( ki, ke);
+			strus::Index termno = strus::unpackIndex( ki, ke);
+			strus::Index docno = strus::unpackIndex( ki, ke);
+			if (termtypeno && typeno != termtypeno) continue;
+			if (docnorange.first && docno < (strus::Index)docnorange.first) continue;
+			if (docnorange.second && docno > (strus::Index)docnorange.second) continue;
+
+			strus::DatabaseCursorInterface::Slice value = cursor->value();
+			strus::PosinfoBlock blk( docno, value.ptr(), value.size());
+			if (blk.compressed()) continue;
+
+			strus::PosinfoBlockBuilder builder( blk);
+			if (builder.empty()) continue;
+			strus::DatabaseAdapter_PosinfoBlock::Writer writer( storage.databaseClient(), typeno, termno);
+			writer.store( transaction.get(), builder.createBlock());
+
+			if (++transactionidx == transactionsize)
+			{
+				commitTransaction( *storage.databaseClient(), transaction);
+				blockcount += transactionidx;
+				transactionidx = 0;
+				::printf( "\rconverted %u        ", blockcount);
+				::fflush( stdout);
+			}
+		}
+		if (transactionidx)
+		{
+			commitTransaction( *storage.databaseClient(), transaction);
+			blockcount += transactionidx;
+			transactionidx = 0;
+			::printf( "\rconverted %u        ", blockcount);
+			::fflush( stdout);
+		}
+	}
 	else
 	{
 		throw strus::runtime_error(_TXT("block resize is not implemented for blocktype '%s'"), blocktype.c_str());
@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Memory resident snapshot of the term type and term value dictionaries for lookups without database access
+/// \file "termDictionary.cpp"
+#include "termDictionary.hpp"
+#include "databaseAdapter.hpp"
+#include "strus/databaseClientInterface.hpp"
+
+using namespace strus;
+
+strus::shared_ptr<TermDictionarySnapshot> TermDictionarySnapshot::create( const std::vector<Entry>& entries)
+{
+	strus::shared_ptr<Trie> trie( new Trie());
+	std::size_t triesize = 0;
+	std::vector<Entry>::const_iterator ei = entries.begin(), ee = entries.end();
+	for (; ei != ee; ++ei)
+	{
+		if (!isValidKey( ei->first)) continue;
+		if (!trie->set( ei->first.c_str(), ei->second)) return strus::shared_ptr<TermDictionarySnapshot>();
+		++triesize;
+	}
+	return strus::shared_ptr<TermDictionarySnapshot>(
+		new TermDictionarySnapshot( trie, triesize, std::vector<strus::shared_ptr<DeltaMap> >(), 0));
+}
+
+strus::shared_ptr<TermDictionarySnapshot> TermDictionarySnapshot::merge( const std::vector<Entry>& entries) const
+{
+	std::vector<Entry> all;
+	all.reserve( size() + entries.size());
+	Trie::const_iterator ti = m_trie->begin(), te = m_trie->end();
+	for (; ti != te; ++ti)
+	{
+		all.push_back( Entry( ti.key(), ti.data()));
+	}
+	std::vector<strus::shared_ptr<DeltaMap> >::const_iterator di = m_deltas.begin(), de = m_deltas.end();
+	for (; di != de; ++di)
+	{
+		all.insert( all.end(), (*di)->begin(), (*di)->end());
+	}
+	all.insert( all.end(), entries.begin(), entries.end());
+	return create( all);
+}
+
+strus::shared_ptr<TermDictionarySnapshot> TermDictionarySnapshot::add( const std::vector<Entry>& entries) const
+{
+	std::size_t nofNewEntries = 0;
+	std::vector<Entry>::const_iterator ei = entries.begin(), ee = entries.end();
+	for (; ei != ee; ++ei)
+	{
+		if (isValidKey( ei->first)) ++nofNewEntries;
+	}
+	if (m_deltasize + nofNewEntries >= MinMergeSize + m_triesize / 4)
+	{
+		// ... rebuild the trie if the delta maps get too big compared with it, the amortized cost of an entry added stays constant
+		return merge( entries);
+	}
+	std::vector<strus::shared_ptr<DeltaMap> > deltas;
+	strus::shared_ptr<DeltaMap> delta( new DeltaMap());
+	if (m_deltas.size() >= MaxNofDeltas)
+	{
+		// ... join the delta maps, to limit the number of maps visited by a lookup
+		std::vector<strus::shared_ptr<DeltaMap> >::const_iterator di = m_deltas.begin(), de = m_deltas.end();
+		for (; di != de; ++di)
+		{
+			delta->insert( (*di)->begin(), (*di)->end());
+		}
+	}
+	else
+	{
+		deltas = m_deltas;
+	}
+	for (ei = entries.begin(); ei != ee; ++ei)
+	{
+		if (isValidKey( ei->first)) (*delta)[ ei->first] = ei->second;
+	}
+	deltas.push_back( delta);
+	return strus::shared_ptr<TermDictionarySnapshot>(
+		new TermDictionarySnapshot( m_trie, m_triesize, deltas, m_deltasize + nofNewEntries));
+}
+
+bool TermDictionarySnapshot::get( const std::string& key, Index& value) const
+{
+	if (!isValidKey( key)) return false;
+	std::vector<strus::shared_ptr<DeltaMap> >::const_reverse_iterator di = m_deltas.rbegin(), de = m_deltas.rend();
+	for (; di != de; ++di)
+	{
+		DeltaMap::const_iterator mi = (*di)->find( key);
+		if (mi != (*di)->end())
+		{
+			value = mi->second;
+			return true;
+		}
+	}
+	Trie::NodeData data;
+	if (!m_trie->get( key.c_str(), data)) return false;
+	//... a key not found might have been written by another client, the answer is left to the database
+	value = (Index)data;
+	return true;
+}
+
+template <class DatabaseAdapter>
+static void loadDictionary( std::vector<TermDictionarySnapshot::Entry>& entries, const DatabaseClientInterface* database)
+{
+	typename DatabaseAdapter::Cursor cursor( database);
+	Index value;
+	std::string key;
+	for (bool more=cursor.loadFirst( key, value); more; more=cursor.loadNext( key, value))
+	{
+		entries.push_back( TermDictionarySnapshot::Entry( key, value));
+	}
+}
+
+bool TermDictionary::load( const DatabaseClientInterface* database)
+{
+	strus::scoped_lock updateLock( m_updateMutex);
+	SnapshotRef types;
+	SnapshotRef values;
+	{
+		std::vector<TermDictionarySnapshot::Entry> entries;
+		loadDictionary<DatabaseAdapter_TermType>( entries, database);
+		types = TermDictionarySnapshot::create( entries);
+	}
+	if (types.get())
+	{
+		std::vector<TermDictionarySnapshot::Entry> entries;
+		loadDictionary<DatabaseAdapter_TermValue>( entries, database);
+		values = TermDictionarySnapshot::create( entries);
+	}
+	strus::scoped_lock lock( m_mutex);
+	if (types.get() && values.get())
+	{
+		m_types = types;
+		m_values = values;
+		return true;
+	}
+	else
+	{
+		m_types.reset();
+		m_values.reset();
+		return false;
+	}
+}
+
+bool TermDictionary::getTermType( const std::string& name, Index& typeno) const
+{
+	SnapshotRef dict;
+	{
+		strus::scoped_lock lock( m_mutex);
+		dict = m_types;
+	}
+	return dict.get() && dict->get( name, typeno);
+}
+
+bool TermDictionary::getTermValue( const std::string& name, Index& termno) const
+{
+	SnapshotRef dict;
+	{
+		strus::scoped_lock lock( m_mutex);
+		dict = m_values;
+	}
+	return dict.get() && dict->get( name, termno);
+}
+
+void TermDictionary::update( SnapshotRef& dict, const std::vector<TermDictionarySnapshot::Entry>& entries)
+{
+	strus::scoped_lock updateLock( m_updateMutex);
+	SnapshotRef cur;
+	{
+		strus::scoped_lock lock( m_mutex);
+		cur = dict;
+	}
+	if (!cur.get()) return;
+	SnapshotRef next = cur->add( entries);
+
+	strus::scoped_lock lock( m_mutex);
+	if (next.get())
+	{
+		dict = next;
+	}
+	else
+	{
+		// ... overflow of the trie, all lookups go to the database from now on
+		m_types.reset();
+		m_values.reset();
+	}
+}
+
+void TermDictionary::declareTermType( const std::string& name, const Index& typeno)
+{
+	update( m_types, std::vector<TermDictionarySnapshot::Entry>( 1, TermDictionarySnapshot::Entry( name, typeno)));
+}
+
+void TermDictionary::declareTermValues( const std::vector<TermDictionarySnapshot::Entry>& values)
+{
+	if (values.empty()) return;
+	update( m_values, values);
+}
+
+bool TermDictionary::enabled() const
+{
+	strus::scoped_lock lock( m_mutex);
+	return m_types.get() && m_values.get();
+}
+
+std::pair<std::size_t,std::size_t> TermDictionary::size() const
+{
+	strus::scoped_lock lock( m_mutex);
+	return std::pair<std::size_t,std::size_t>(
+			m_types.get() ? m_types->size() : 0,
+			m_values.get() ? m_values->size() : 0);
+}
+
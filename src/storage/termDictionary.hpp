@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Memory resident snapshot of the term type and term value dictionaries for lookups without database access
+/// \file "termDictionary.hpp"
+#ifndef _STRUS_STORAGE_TERM_DICTIONARY_HPP_INCLUDED
+#define _STRUS_STORAGE_TERM_DICTIONARY_HPP_INCLUDED
+#include "strus/storage/index.hpp"
+#include "strus/base/shared_ptr.hpp"
+#include "strus/base/unordered_map.hpp"
+#include "strus/base/thread.hpp"
+#include "compactNodeTrie.hpp"
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstddef>
+
+namespace strus {
+
+/// \brief Forward declaration
+class DatabaseClientInterface;
+
+/// \brief Immutable state of one dictionary (term types or term values)
+/// \note The entries are stored in a compact node trie and a list of small hash maps with the entries added after the trie was built.
+///	Adding entries creates a new snapshot sharing the trie and the maps of its predecessor, so readers never see a structure modified.
+class TermDictionarySnapshot
+{
+public:
+	typedef std::pair<std::string,Index> Entry;
+	typedef strus::unordered_map<std::string,Index> DeltaMap;
+
+	/// \brief Build a snapshot from a list of entries
+	/// \return the snapshot or NULL if the entries do not fit into the address space of the trie
+	static strus::shared_ptr<TermDictionarySnapshot> create( const std::vector<Entry>& entries);
+
+	/// \brief Create a new snapshot with entries added to this
+	/// \return the snapshot or NULL if the entries do not fit into the address space of the trie
+	strus::shared_ptr<TermDictionarySnapshot> add( const std::vector<Entry>& entries) const;
+
+	/// \brief Lookup a key
+	/// \param[in] key key to lookup
+	/// \param[out] value value of the key, if found
+	/// \return true if the key was found, false if the key is not in the dictionary or cannot be represented in it and has to be looked up in the database
+	bool get( const std::string& key, Index& value) const;
+
+	/// \brief Number of entries
+	std::size_t size() const			{return m_triesize + m_deltasize;}
+
+	/// \brief Evaluate if a key can be represented in the dictionary
+	static bool isValidKey( const std::string& key)
+	{
+		return !key.empty() && key.find( '\0') == std::string::npos;
+	}
+
+private:
+	typedef conotrie::CompactNodeTrie Trie;
+
+	TermDictionarySnapshot( const strus::shared_ptr<Trie>& trie_, std::size_t triesize_, const std::vector<strus::shared_ptr<DeltaMap> >& deltas_, std::size_t deltasize_)
+		:m_trie(trie_),m_triesize(triesize_),m_deltas(deltas_),m_deltasize(deltasize_){}
+
+	strus::shared_ptr<TermDictionarySnapshot> merge( const std::vector<Entry>& entries) const;
+
+	enum {
+		MaxNofDeltas=8,			///< maximum number of delta maps before they are joined
+		MinMergeSize=(1<<16)		///< minimum number of delta map entries before they are merged into the trie
+	};
+
+private:
+	strus::shared_ptr<Trie> m_trie;				///< trie with the entries of the last merge
+	std::size_t m_triesize;					///< number of entries in the trie
+	std::vector<strus::shared_ptr<DeltaMap> > m_deltas;	///< maps of the entries added after the last merge
+	std::size_t m_deltasize;				///< number of entries in the delta maps
+};
+
+/// \brief Memory resident snapshot of the term type and term value dictionaries of a storage
+/// \note Built on open and updated with the entries allocated by the commits, so that lookups of existing terms on the query path do not access the database
+/// \note Only positive answers are given, a key not found is looked up in the database. Keys written by another client of the database or by a commit not yet declared are found this way.
+/// \note The dictionary gets disabled if it overflows, all lookups return false then and have to be done in the database
+class TermDictionary
+{
+public:
+	TermDictionary()
+		:m_mutex(),m_updateMutex(),m_types(),m_values(){}
+
+	/// \brief Load all term types and term values of the storage
+	/// \param[in] database database to load the dictionaries from
+	/// \return false if the dictionary does not fit into memory and is disabled
+	bool load( const DatabaseClientInterface* database);
+
+	/// \brief Lookup a term type number
+	/// \param[in] name name of the type (lowercase)
+	/// \param[out] typeno the type number, if found
+	/// \return true if found, false if the type has to be looked up in the database
+	bool getTermType( const std::string& name, Index& typeno) const;
+
+	/// \brief Lookup a term value number
+	/// \param[in] name term value string
+	/// \param[out] termno the term value number, if found
+	/// \return true if found, false if the term has to be looked up in the database
+	bool getTermValue( const std::string& name, Index& termno) const;
+
+	/// \brief Declare a new term type written to the database
+	void declareTermType( const std::string& name, const Index& typeno);
+
+	/// \brief Declare new term values written to the database
+	void declareTermValues( const std::vector<TermDictionarySnapshot::Entry>& values);
+
+	/// \brief Evaluate if the dictionary is in use
+	bool enabled() const;
+
+	/// \brief Get the number of term types and term values in the dictionary
+	std::pair<std::size_t,std::size_t> size() const;
+
+private:
+	typedef strus::shared_ptr<TermDictionarySnapshot> SnapshotRef;
+
+	void update( SnapshotRef& dict, const std::vector<TermDictionarySnapshot::Entry>& entries);
+
+private:
+	TermDictionary( const TermDictionary&){}	//... non copyable
+	void operator=( const TermDictionary&){}	//... non copyable
+
+private:
+	mutable strus::mutex m_mutex;			///< mutex for accessing the current snapshots
+	strus::mutex m_updateMutex;			///< mutual exclusion of updates
+	SnapshotRef m_types;				///< current snapshot of the term type dictionary or NULL if disabled
+	SnapshotRef m_values;				///< current snapshot of the term value dictionary or NULL if disabled
+};
+
+}//namespace
+#endif
+
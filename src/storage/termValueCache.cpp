@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Size bounded cache of the term value strings of term value numbers
+/// \file "termValueCache.cpp"
+#include "termValueCache.hpp"
+#include "private/internationalization.hpp"
+#include <stdexcept>
+
+using namespace strus;
+
+TermValueCache::ValueRef TermValueCache::find( const Index& termno)
+{
+	Partition& part = m_ar[ partitionIndex( termno)];
+	strus::scoped_lock lock( part.mutex);
+	Map::iterator mi = part.map.find( termno);
+	if (mi == part.map.end()) return ValueRef();
+	part.lru.splice( part.lru.begin(), part.lru, mi->second.lruitr);
+	return mi->second.value;
+}
+
+void TermValueCache::insert( const Index& termno, const ValueRef& value)
+{
+	std::size_t entrysize = entryMemoryUsage( *value);
+	if (entrysize > m_maxPartitionMemoryUsage) return;
+
+	Partition& part = m_ar[ partitionIndex( termno)];
+	strus::scoped_lock lock( part.mutex);
+	Map::iterator mi = part.map.find( termno);
+	if (mi != part.map.end())
+	{
+		//... read concurrently by another query
+		part.lru.splice( part.lru.begin(), part.lru, mi->second.lruitr);
+		return;
+	}
+	part.lru.push_front( termno);
+	part.map.insert( Map::value_type( termno, Entry( value, part.lru.begin())));
+	part.memoryUsage += entrysize;
+
+	while (part.memoryUsage > m_maxPartitionMemoryUsage && !part.lru.empty())
+	{
+		Map::iterator li = part.map.find( part.lru.back());
+		if (li == part.map.end()) throw std::runtime_error(_TXT("corrupt term value cache"));
+		eraseEntry( part, li);
+	}
+}
+
+void TermValueCache::eraseEntry( Partition& part, Map::iterator mi)
+{
+	part.memoryUsage -= entryMemoryUsage( *mi->second.value);
+	part.lru.erase( mi->second.lruitr);
+	part.map.erase( mi);
+}
+
+void TermValueCache::clear()
+{
+	for (int pi = 0; pi < NofPartitions; ++pi)
+	{
+		Partition& part = m_ar[ pi];
+		strus::scoped_lock lock( part.mutex);
+		part.map.clear();
+		part.lru.clear();
+		part.memoryUsage = 0;
+	}
+}
+
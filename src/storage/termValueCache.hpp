@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Size bounded cache of the term value strings of term value numbers
+/// \file "termValueCache.hpp"
+#ifndef _STRUS_STORAGE_TERM_VALUE_CACHE_HPP_INCLUDED
+#define _STRUS_STORAGE_TERM_VALUE_CACHE_HPP_INCLUDED
+#include "strus/storage/index.hpp"
+#include "strus/base/thread.hpp"
+#include "strus/base/shared_ptr.hpp"
+#include "strus/base/unordered_map.hpp"
+#include <list>
+#include <string>
+#include <cstddef>
+
+namespace strus {
+
+/// \brief Cache of the term value strings of term value numbers, shared by the forward iterators of all queries of a storage
+/// \note Decodes the values of the forward index types written as term value numbers (configuration 'fwdict') without a database read for the values frequently used.
+/// \note Term value numbers are never reassigned to another value, entries cached never get outdated and the cache has no invalidation.
+class TermValueCache
+{
+public:
+	typedef strus::shared_ptr<const std::string> ValueRef;
+
+	/// \brief Constructor
+	/// \param[in] maxMemoryUsage_ maximum number of bytes of values to hold in the cache
+	explicit TermValueCache( std::size_t maxMemoryUsage_)
+		:m_maxMemoryUsage(maxMemoryUsage_),m_maxPartitionMemoryUsage(maxMemoryUsage_ / NofPartitions){}
+	~TermValueCache(){}
+
+	/// \brief Find the value of a term value number
+	/// \param[in] termno term value number
+	/// \return the value found or an empty reference if not found
+	ValueRef find( const Index& termno);
+
+	/// \brief Insert the value of a term value number read from the database
+	/// \param[in] termno term value number
+	/// \param[in] value value to insert
+	void insert( const Index& termno, const ValueRef& value);
+
+	/// \brief Remove all values from the cache
+	void clear();
+
+	/// \brief Get the maximum number of bytes of values held in the cache
+	std::size_t maxMemoryUsage() const
+	{
+		return m_maxMemoryUsage;
+	}
+
+private:
+	enum {NofPartitions=16, EntryMemoryOverhead=80};
+
+	typedef std::list<Index> LruList;
+
+	/// \brief Value cached
+	struct Entry
+	{
+		ValueRef value;
+		LruList::iterator lruitr;
+
+		Entry( const ValueRef& value_, const LruList::iterator& lruitr_)
+			:value(value_),lruitr(lruitr_){}
+		Entry( const Entry& o)
+			:value(o.value),lruitr(o.lruitr){}
+	};
+	typedef strus::unordered_map<Index,Entry> Map;
+
+	/// \brief Partition of the cache with its own lock
+	struct Partition
+	{
+		strus::mutex mutex;
+		Map map;
+		LruList lru;
+		std::size_t memoryUsage;
+
+		Partition()
+			:mutex(),map(),lru(),memoryUsage(0){}
+	};
+
+	static std::size_t entryMemoryUsage( const std::string& value)
+	{
+		return value.size() + EntryMemoryOverhead;
+	}
+	static std::size_t partitionIndex( const Index& termno)
+	{
+		return ((unsigned int)termno * 2654435761U) % NofPartitions;
+	}
+	void eraseEntry( Partition& part, Map::iterator mi);
+
+private:
+	TermValueCache( const TermValueCache&){}	//... non copyable
+	void operator=( const TermValueCache&){}	//... non copyable
+
+private:
+	std::size_t m_maxMemoryUsage;			///< maximum number of bytes of values held
+	std::size_t m_maxPartitionMemoryUsage;		///< maximum number of bytes of values held per partition
+	Partition m_ar[ NofPartitions];			///< partitions selected by the hash of the term value number
+};
+
+}//namespace
+#endif
+
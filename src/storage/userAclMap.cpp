@@ -188,6 +188,16 @@ static void defineRangeElement(
 	}
 }
 
+void UserAclMap::collectUsers( std::set<Index>& userset) const
+{
+	userset.insert( m_usr_deletes.begin(), m_usr_deletes.end());
+	UsrDocMap::const_iterator mi = m_usrdocmap.begin(), me = m_usrdocmap.end();
+	for (; mi != me; ++mi)
+	{
+		userset.insert( mi->first.usrno);
+	}
+}
+
 void UserAclMap::getWriteBatch( DatabaseTransactionInterface* transaction)
 {
 	std::vector<Index>::const_iterator di = m_usr_deletes.begin(), de = m_usr_deletes.end();
@@ -12,6 +12,7 @@
 #include "private/localStructAllocator.hpp"
 #include "blockKey.hpp"
 #include <cstdlib>
+#include <set>
 
 namespace strus {
 
@@ -66,6 +67,10 @@ public:
 		strus::Index docno);
 
 	void renameNewDocNumbers( const std::map<Index,Index>& renamemap);
+
+	/// \brief Collect all users whose access blocks are modified by getWriteBatch
+	void collectUsers( std::set<Index>& userset) const;
+
 	void getWriteBatch( DatabaseTransactionInterface* transaction);
 
 	void clear();
@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Test of the bitmap of the documents visible for a set of users against a reference set
+#include "strus/storage/index.hpp"
+#include "aclBitmap.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <ctime>
+#include <set>
+#include <vector>
+
+#undef STRUS_LOWLEVEL_DEBUG
+
+static void initRand()
+{
+	time_t nowtime;
+	struct tm* now;
+
+	::time( &nowtime);
+	now = ::localtime( &nowtime);
+
+	::srand( ((now->tm_year+1) * (now->tm_mon+100) * (now->tm_mday+1)));
+}
+#define RANDINT(MIN,MAX) ((rand()%(MAX-MIN))+MIN)
+
+/// \brief Get the smallest element of the reference set bigger than or equal to docno or 0
+static strus::Index expectedSkip( const std::set<strus::Index>& indexSet, strus::Index docno)
+{
+	std::set<strus::Index>::const_iterator si = indexSet.lower_bound( docno);
+	return si == indexSet.end() ? 0 : *si;
+}
+
+static void checkSkip( const strus::AclBitmap& bitmap, const std::set<strus::Index>& indexSet, strus::Index docno)
+{
+	strus::Index expected = expectedSkip( indexSet, docno);
+	strus::Index output = bitmap.skip( docno);
+#ifdef STRUS_LOWLEVEL_DEBUG
+	std::cout << "\tQUERY " << docno << " => " << output << " expected " << expected << std::endl;
+#endif
+	if (output != expected)
+	{
+		std::ostringstream msg;
+		msg << "skip " << docno << " in ACL bitmap returns " << output << " instead of " << expected;
+		throw std::runtime_error( msg.str());
+	}
+}
+
+static void testAclBitmap( unsigned int times, unsigned int nofUsers, unsigned int nofQueries)
+{
+	unsigned int tt=0;
+	for (; tt<times; ++tt)
+	{
+		std::set<strus::Index> indexSet;
+		std::vector<strus::AclBitmap::Range> ranges;
+		strus::Index maxElemNo = 0;
+
+		// Users with elements of different density to get all container representations (array, bitmap and runs):
+		unsigned int ui=0;
+		for (; ui<nofUsers; ++ui)
+		{
+			strus::Index elemItr = ui * 150000 + RANDINT( 1, 100000);
+			unsigned int nofRanges = 0;
+			int maxGap = 0;
+			int maxRange = 0;
+			switch (ui % 3)
+			{
+				case 0: nofRanges = RANDINT( 1, 2000); maxGap = 6; maxRange = 2; break;
+				case 1: nofRanges = RANDINT( 5000, 20000); maxGap = 3; maxRange = 2; break;
+				case 2: nofRanges = RANDINT( 1, 500); maxGap = 400; maxRange = 300; break;
+			}
+			unsigned int ri=0;
+			for (; ri<nofRanges; ++ri)
+			{
+				elemItr += RANDINT( 1, maxGap);
+				strus::Index range = RANDINT( 1, maxRange);
+				strus::Index ei = 0;
+				for (; ei < range; ++ei)
+				{
+					indexSet.insert( elemItr + ei);
+				}
+				ranges.push_back( strus::AclBitmap::Range( elemItr, elemItr + range - 1));
+				elemItr += range - 1;
+				if (elemItr > maxElemNo) maxElemNo = elemItr;
+			}
+		}
+		strus::AclBitmap bitmap( ranges);
+
+		std::set<strus::Index>::const_iterator si = indexSet.begin(), se = indexSet.end();
+		for (; si != se; ++si)
+		{
+			if (!bitmap.test( *si))
+			{
+				std::ostringstream msg;
+				msg << "element " << *si << " missing in ACL bitmap";
+				throw std::runtime_error( msg.str());
+			}
+			checkSkip( bitmap, indexSet, *si + 1);
+		}
+		checkSkip( bitmap, indexSet, 0);
+		checkSkip( bitmap, indexSet, 1);
+		checkSkip( bitmap, indexSet, maxElemNo + 1);
+		unsigned int qi=0;
+		for (; qi<nofQueries; ++qi)
+		{
+			checkSkip( bitmap, indexSet, RANDINT( 1, maxElemNo+2));
+		}
+		std::cerr << "ACL bitmap with " << indexSet.size() << " elements uses " << bitmap.memoryUsage() << " bytes" << std::endl;
+	}
+	std::cerr << "tested ACL bitmap " << times << " times with " << nofUsers << " users and " << nofQueries << " queries with success" << std::endl;
+}
+
+static void testEmptyAclBitmap()
+{
+	std::vector<strus::AclBitmap::Range> ranges;
+	strus::AclBitmap bitmap( ranges);
+	if (!bitmap.empty() || bitmap.skip( 1) != 0 || bitmap.test( 1))
+	{
+		throw std::runtime_error( "empty ACL bitmap is not empty");
+	}
+}
+
+int main( int, const char**)
+{
+	try
+	{
+		initRand();
+		testEmptyAclBitmap();
+		testAclBitmap( 10, 12, 10000);
+		return 0;
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << "EXCEPTION " << err.what() << std::endl;
+	}
+	return -1;
+}
+
@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Test of the bulk loaders of meta data, attribute and user right assignments against the sequential loaders
+#include "strus/lib/error.hpp"
+#include "strus/lib/database_leveldb.hpp"
+#include "strus/lib/storage.hpp"
+#include "strus/lib/storage_prgload_std.hpp"
+#include "strus/lib/filelocator.hpp"
+#include "strus/base/fileio.hpp"
+#include "strus/base/string_format.hpp"
+#include "strus/base/local_ptr.hpp"
+#include "strus/base/shared_ptr.hpp"
+#include "strus/errorBufferInterface.hpp"
+#include "strus/fileLocatorInterface.hpp"
+#include "strus/databaseInterface.hpp"
+#include "strus/storageInterface.hpp"
+#include "strus/storageClientInterface.hpp"
+#include "strus/storageTransactionInterface.hpp"
+#include "strus/storageMetaDataTableUpdateInterface.hpp"
+#include "strus/storageDocumentInterface.hpp"
+#include "strus/metaDataReaderInterface.hpp"
+#include "strus/attributeReaderInterface.hpp"
+#include "strus/aclReaderInterface.hpp"
+#include "strus/numericVariant.hpp"
+#include "private/errorUtils.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+
+static strus::ErrorBufferInterface* g_errorhnd = 0;
+static strus::FileLocatorInterface* g_fileLocator = 0;
+static bool g_verbose = false;
+
+#define NofDocuments 1000
+#define NofLines 5000
+#define InputFile "testBulkLoadValues.txt"
+#define ErrorLine 4321
+
+typedef std::multimap<std::string,strus::Index> KeyDocnoMap;
+
+class Storage
+{
+public:
+	Storage(){}
+	~Storage(){}
+
+	strus::shared_ptr<strus::DatabaseInterface> dbi;
+	strus::shared_ptr<strus::StorageInterface> sti;
+	strus::shared_ptr<strus::StorageClientInterface> sci;
+
+	void create( const std::string& config);
+	void close()
+	{
+		sci.reset();
+		sti.reset();
+		dbi.reset();
+	}
+};
+
+void Storage::create( const std::string& config)
+{
+	dbi.reset( strus::createDatabaseType_leveldb( g_fileLocator, g_errorhnd));
+	if (!dbi.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	sti.reset( strus::createStorageType_std( g_fileLocator, g_errorhnd));
+	if (!sti.get() || g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	(void)dbi->destroyDatabase( config);
+	(void)g_errorhnd->fetchError();
+	if (!sti->createStorage( config + ";acl=true", dbi.get())) throw std::runtime_error( g_errorhnd->fetchError());
+	sci.reset( sti->createClient( config, dbi.get(), 0/*statistics processor*/));
+	if (!sci.get()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	// Define the meta data element assigned:
+	strus::local_ptr<strus::StorageTransactionInterface> transaction( sci->createTransaction());
+	if (!transaction.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	strus::local_ptr<strus::StorageMetaDataTableUpdateInterface> update( transaction->createMetaDataTableUpdate());
+	if (!update.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	update->addElement( "weight", "UINT32");
+	update->done();
+	if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	// Insert the documents, the document numbers are assigned in the order of insertion:
+	transaction.reset( sci->createTransaction());
+	if (!transaction.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	int di = 0;
+	for (; di < NofDocuments; ++di)
+	{
+		strus::local_ptr<strus::StorageDocumentInterface> doc( transaction->createDocument( strus::string_format( "D%d", di)));
+		if (!doc.get()) throw std::runtime_error( g_errorhnd->fetchError());
+		doc->addSearchIndexTerm( "word", "hello", 1);
+		doc->done();
+	}
+	if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+}
+
+static void destroyStorage( const std::string& config)
+{
+	strus::local_ptr<strus::DatabaseInterface> dbi( strus::createDatabaseType_leveldb( g_fileLocator, g_errorhnd));
+	if (dbi.get()) (void)dbi->destroyDatabase( config);
+	(void)g_errorhnd->fetchError();
+}
+
+enum ValueType {MetaDataValue, AttributeValue, UserRightsValue};
+
+/// \brief Get the key of a line of the input: document ids, document numbers and ids not in the storage
+static std::string lineKey( int li, bool withAttributeMap)
+{
+	if (withAttributeMap)
+	{
+		return strus::string_format( "K%d", (li * 13) % (NofDocuments / 2 + 10));
+	}
+	else if (li % 97 == 0)
+	{
+		return strus::string_format( "X%d", li);
+	}
+	else if (li % 11 == 0)
+	{
+		return strus::string_format( "_%d", (li * 7) % NofDocuments + 1);
+	}
+	else if (li % 17 == 0)
+	{
+		return strus::string_format( "%d", (li * 3) % NofDocuments + 1);
+	}
+	else
+	{
+		return strus::string_format( "D%d", (li * 37) % NofDocuments);
+	}
+}
+
+static std::string lineValue( int li, ValueType valueType)
+{
+	switch (valueType)
+	{
+		case MetaDataValue:
+			return strus::string_format( "%d", li * 11);
+		case AttributeValue:
+			return strus::string_format( "v%d", li);
+		case UserRightsValue:
+			switch (li % 4)
+			{
+				case 0: return strus::string_format( "u%d,u%d", li % 5, (li + 1) % 5);
+				case 1: return strus::string_format( "-u%d", li % 5);
+				case 2: return strus::string_format( "-, +u%d", li % 3);
+				case 3: return strus::string_format( "u%d", li % 7);
+			}
+	}
+	return std::string();
+}
+
+/// \brief Write the input file, the lines have mixed LF and CRLF line ends and the last line has no line end
+static void writeInputFile( ValueType valueType, bool withAttributeMap, bool withError)
+{
+	std::string content;
+	int li = 1;
+	for (; li <= NofLines; ++li)
+	{
+		if (withError && li == ErrorLine)
+		{
+			content.append( "\"D5 unterminated");
+		}
+		else
+		{
+			content.append( lineKey( li, withAttributeMap));
+			content.push_back( ' ');
+			content.append( lineValue( li, valueType));
+		}
+		if (li < NofLines)
+		{
+			content.append( (li % 3 == 0) ? "\r\n" : "\n");
+		}
+	}
+	int ec = strus::writeFile( InputFile, content);
+	if (ec) throw strus::runtime_error( "error writing file '%s': %s", InputFile, ::strerror(ec));
+}
+
+static KeyDocnoMap createAttributeMap()
+{
+	KeyDocnoMap rt;
+	int ki = 0;
+	for (; ki < NofDocuments / 2; ++ki)
+	{
+		std::string key = strus::string_format( "K%d", ki);
+		rt.insert( KeyDocnoMap::value_type( key, ki + 1));
+		rt.insert( KeyDocnoMap::value_type( key, ki + 1 + NofDocuments / 2));
+	}
+	return rt;
+}
+
+/// \brief Load the input file, sequentially if nofThreads is 0
+/// \return the number of assignments or -1 with the error message in 'error'
+static int loadInputFile( strus::StorageClientInterface* storage, ValueType valueType, const KeyDocnoMap* attributemap, int commitSize, int nofThreads, std::string& error)
+{
+	int rt = -1;
+	switch (valueType)
+	{
+		case MetaDataValue:
+			rt = nofThreads
+				? strus::load_metadata_assignments_bulk( *storage, "weight", attributemap, InputFile, commitSize, nofThreads, g_errorhnd)
+				: strus::load_metadata_assignments( *storage, "weight", attributemap, InputFile, commitSize, g_errorhnd);
+			break;
+		case AttributeValue:
+			rt = nofThreads
+				? strus::load_attribute_assignments_bulk( *storage, "title", attributemap, InputFile, commitSize, nofThreads, g_errorhnd)
+				: strus::load_attribute_assignments( *storage, "title", attributemap, InputFile, commitSize, g_errorhnd);
+			break;
+		case UserRightsValue:
+			rt = nofThreads
+				? strus::load_user_assignments_bulk( *storage, attributemap, InputFile, commitSize, nofThreads, g_errorhnd)
+				: strus::load_user_assignments( *storage, attributemap, InputFile, commitSize, g_errorhnd);
+			break;
+	}
+	const char* errmsg = g_errorhnd->fetchError();
+	error = errmsg ? errmsg : "";
+	return rt;
+}
+
+/// \brief Get the values assigned of all documents as string for comparison
+static std::string storageValues( const strus::StorageClientInterface* storage, ValueType valueType)
+{
+	std::ostringstream out;
+	strus::Index docno = 1, maxdocno = storage->maxDocumentNumber();
+	switch (valueType)
+	{
+		case MetaDataValue:
+		{
+			strus::local_ptr<strus::MetaDataReaderInterface> reader( storage->createMetaDataReader());
+			if (!reader.get()) throw std::runtime_error( g_errorhnd->fetchError());
+			strus::Index handle = reader->elementHandle( "weight");
+			for (; docno <= maxdocno; ++docno)
+			{
+				reader->skipDoc( docno);
+				out << docno << " " << reader->getValue( handle).touint() << "\n";
+			}
+			break;
+		}
+		case AttributeValue:
+		{
+			strus::local_ptr<strus::AttributeReaderInterface> reader( storage->createAttributeReader());
+			if (!reader.get()) throw std::runtime_error( g_errorhnd->fetchError());
+			strus::Index handle = reader->elementHandle( "title");
+			for (; docno <= maxdocno; ++docno)
+			{
+				reader->skipDoc( docno);
+				out << docno << " '" << (handle ? reader->getValue( handle) : std::string()) << "'\n";
+			}
+			break;
+		}
+		case UserRightsValue:
+		{
+			strus::local_ptr<strus::AclReaderInterface> reader( storage->createAclReader());
+			if (!reader.get()) throw std::runtime_error( g_errorhnd->fetchError());
+			for (; docno <= maxdocno; ++docno)
+			{
+				reader->skipDoc( docno);
+				std::vector<std::string> users = reader->getReadAccessList();
+				std::sort( users.begin(), users.end());
+				out << docno;
+				std::vector<std::string>::const_iterator ui = users.begin(), ue = users.end();
+				for (; ui != ue; ++ui) out << " " << *ui;
+				out << "\n";
+			}
+			break;
+		}
+	}
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+	return out.str();
+}
+
+static const char* valueTypeName( ValueType valueType)
+{
+	static const char* ar[] = {"meta data","attribute","user rights"};
+	return ar[ valueType];
+}
+
+/// \brief Compare the values assigned by the bulk loader with the values assigned by the sequential loader
+/// \note commitSize 0 loads all in one transaction, the commits of the loaders split the assignments of a document differently
+static void testLoadValues( ValueType valueType, bool withAttributeMap, int commitSize)
+{
+	KeyDocnoMap attributemap = createAttributeMap();
+	const KeyDocnoMap* attributemapref = withAttributeMap ? &attributemap : 0;
+	writeInputFile( valueType, withAttributeMap, false/*with error*/);
+
+	// Load the input sequentially as reference:
+	Storage reference;
+	reference.create( "path=storage");
+	std::string error;
+	int nofAssignments = loadInputFile( reference.sci.get(), valueType, attributemapref, commitSize, 0/*nofThreads*/, error);
+	if (nofAssignments < 0) throw strus::runtime_error( "sequential loader failed: %s", error.c_str());
+	std::string expected = storageValues( reference.sci.get(), valueType);
+	reference.close();
+
+	// Load the input with the bulk loader with different numbers of threads and compare:
+	static const int nofThreadsAr[] = {1, 2, 3, 7, 0};
+	int ti = 0;
+	for (; nofThreadsAr[ ti]; ++ti)
+	{
+		Storage storage;
+		storage.create( "path=storage_bulk");
+		int nofBulkAssignments = loadInputFile( storage.sci.get(), valueType, attributemapref, commitSize, nofThreadsAr[ ti], error);
+		if (nofBulkAssignments < 0) throw strus::runtime_error( "bulk loader failed: %s", error.c_str());
+		if (nofBulkAssignments != nofAssignments)
+		{
+			throw strus::runtime_error( "number of %s assignments of bulk loader with %d threads differs: %d != %d", valueTypeName( valueType), nofThreadsAr[ ti], nofBulkAssignments, nofAssignments);
+		}
+		std::string output = storageValues( storage.sci.get(), valueType);
+		if (output != expected)
+		{
+			if (g_verbose) std::cerr << "EXPECTED:\n" << expected << "\nOUTPUT:\n" << output << std::endl;
+			throw strus::runtime_error( "%s assigned by bulk loader with %d threads differ from sequential loader", valueTypeName( valueType), nofThreadsAr[ ti]);
+		}
+		storage.close();
+		if (g_verbose) std::cerr << strus::string_format( "loaded %d %s assignments with %d threads", nofBulkAssignments, valueTypeName( valueType), nofThreadsAr[ ti]) << std::endl;
+	}
+}
+
+static void testLoadError( ValueType valueType)
+{
+	writeInputFile( valueType, false/*with attribute map*/, true/*with error*/);
+
+	Storage reference;
+	reference.create( "path=storage");
+	std::string expected;
+	if (0 <= loadInputFile( reference.sci.get(), valueType, 0, 1000/*commit size*/, 0/*nofThreads*/, expected))
+	{
+		throw std::runtime_error( "sequential loader did not fail on syntax error");
+	}
+	reference.close();
+	if (std::strstr( expected.c_str(), strus::string_format( "line %d", ErrorLine).c_str()) == 0)
+	{
+		throw strus::runtime_error( "sequential loader reports error '%s' not on line %d", expected.c_str(), ErrorLine);
+	}
+	static const int nofThreadsAr[] = {1, 4, 0};
+	int ti = 0;
+	for (; nofThreadsAr[ ti]; ++ti)
+	{
+		Storage storage;
+		storage.create( "path=storage_bulk");
+		std::string error;
+		if (0 <= loadInputFile( storage.sci.get(), valueType, 0, 1000/*commit size*/, nofThreadsAr[ ti], error))
+		{
+			throw strus::runtime_error( "bulk loader with %d threads did not fail on syntax error", nofThreadsAr[ ti]);
+		}
+		if (error != expected)
+		{
+			throw strus::runtime_error( "bulk loader with %d threads reports error '%s' instead of '%s'", nofThreadsAr[ ti], error.c_str(), expected.c_str());
+		}
+		storage.close();
+	}
+}
+
+static void testLoadMetaData()			{testLoadValues( MetaDataValue, false, 1000);}
+static void testLoadAttributes()		{testLoadValues( AttributeValue, false, 1000);}
+static void testLoadUserRights()		{testLoadValues( UserRightsValue, false, 0);}
+static void testLoadMetaDataAttributeMap()	{testLoadValues( MetaDataValue, true, 1000);}
+static void testLoadAttributesAttributeMap()	{testLoadValues( AttributeValue, true, 0);}
+static void testLoadMetaDataError()		{testLoadError( MetaDataValue);}
+static void testLoadUserRightsError()		{testLoadError( UserRightsValue);}
+
+#define RUN_TEST( idx, TestName)\
+	try\
+	{\
+		test ## TestName();\
+		std::cerr << "executing test (" << idx << ") " << #TestName << " [OK]" << std::endl;\
+	}\
+	catch (const std::runtime_error& err)\
+	{\
+		std::cerr << "error in test (" << idx << ") " << #TestName << ": " << err.what() << std::endl;\
+		rt = -1;\
+		goto TESTS_DONE;\
+	}\
+	catch (const std::bad_alloc& err)\
+	{\
+		std::cerr << "out of memory in test (" << idx << ") " << #TestName << std::endl;\
+		rt = -1;\
+		goto TESTS_DONE;\
+	}\
+
+
+int main( int argc, const char* argv[])
+{
+	int rt = 0;
+	bool do_cleanup = true;
+	unsigned int ii = 1;
+	unsigned int test_index = 0;
+	for (; argc > (int)ii; ++ii)
+	{
+		if (std::strcmp( argv[ii], "-K") == 0)
+		{
+			do_cleanup = false;
+		}
+		else if (std::strcmp( argv[ii], "-V") == 0)
+		{
+			g_verbose = true;
+		}
+		else if (std::strcmp( argv[ii], "-T") == 0)
+		{
+			++ii;
+			if (argc == (int)ii)
+			{
+				std::cerr << "option -T expects an argument" << std::endl;
+				return -1;
+			}
+			test_index = atoi( argv[ ii]);
+		}
+		else if (std::strcmp( argv[ii], "-h") == 0)
+		{
+			std::cerr << "usage: testBulkLoadValues [options]" << std::endl;
+			std::cerr << "options:" << std::endl;
+			std::cerr << "  -h      :print usage" << std::endl;
+			std::cerr << "  -V      :verbose output" << std::endl;
+			std::cerr << "  -K      :keep artefacts, do not clean up" << std::endl;
+			std::cerr << "  -T <i>  :execute only test with index <i>" << std::endl;
+			return 0;
+		}
+		else if (argv[ii][0] == '-')
+		{
+			std::cerr << "unknown option " << argv[ii] << std::endl;
+			return -1;
+		}
+		else
+		{
+			std::cerr << "unexpected argument" << std::endl;
+			return -1;
+		}
+	}
+	g_errorhnd = strus::createErrorBuffer_standard( stderr, 2, NULL/*debug trace interface*/);
+	if (!g_errorhnd) {std::cerr << "FAILED " << "strus::createErrorBuffer_standard" << std::endl; return -1;}
+	g_fileLocator = strus::createFileLocator_std( g_errorhnd);
+	if (!g_fileLocator) {std::cerr << "FAILED " << "strus::createFileLocator_std" << std::endl; return -1;}
+
+	unsigned int ti=test_index?test_index:1;
+	for (;;++ti)
+	{
+		switch (ti)
+		{
+			case 1: RUN_TEST( ti, LoadMetaData ) break;
+			case 2: RUN_TEST( ti, LoadAttributes ) break;
+			case 3: RUN_TEST( ti, LoadUserRights ) break;
+			case 4: RUN_TEST( ti, LoadMetaDataAttributeMap ) break;
+			case 5: RUN_TEST( ti, LoadAttributesAttributeMap ) break;
+			case 6: RUN_TEST( ti, LoadMetaDataError ) break;
+			case 7: RUN_TEST( ti, LoadUserRightsError ) break;
+			default: goto TESTS_DONE;
+		}
+		if (test_index) break;
+	}
+TESTS_DONE:
+	if (do_cleanup)
+	{
+		destroyStorage( "path=storage");
+		destroyStorage( "path=storage_bulk");
+		(void)strus::removeFile( InputFile, false);
+	}
+	delete g_fileLocator;
+	delete g_errorhnd;
+	return rt;
+}
+
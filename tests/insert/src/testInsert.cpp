@@ -51,6 +51,7 @@
 static strus::ErrorBufferInterface* g_errorhnd = 0;
 static strus::FileLocatorInterface* g_fileLocator = 0;
 static bool g_verbose = false;
+static bool g_bulkLoad = false;
 static strus::PseudoRandom g_random;
 
 typedef strus::test::PrimeFactorCollection PrimeFactorCollection;
@@ -82,6 +83,11 @@ static void testInsert( int nofNumbers, int commitSize, const std::string& obser
 	Storage storage( g_fileLocator, g_errorhnd);
 	storage.open( "path=storage", true);
 	storage.defineMetaData( PrimeFactorDocumentBuilder::metadata());
+	if (g_bulkLoad)
+	{
+		storage.close();
+		storage.open( "path=storage;bulkload=bulkload", false);
+	}
 
 	PrimeFactorDocumentBuilder documentBuilder( nofNumbers, g_verbose, g_errorhnd);
 	buildObserved( documentBuilder, observed);
@@ -90,6 +96,13 @@ static void testInsert( int nofNumbers, int commitSize, const std::string& obser
 	documentBuilder.insertCollection(
 		storage.sci.get(), g_random, commitSize, 
 		PrimeFactorDocumentBuilder::InsertMode, true/*is last*/);
+	if (g_bulkLoad)
+	{
+		if (g_verbose) std::cerr << "* write postings of bulk load and reopen storage" << std::endl;
+		storage.close();
+		if (g_errorhnd->hasError()) throw std::runtime_error( "error writing the postings of bulk load");
+		storage.open( "path=storage", false);
+	}
 	if (g_verbose)
 	{
 		if (nofNumbers)
@@ -123,6 +136,7 @@ static void printUsage()
 	std::cerr << "  -h             :print usage" << std::endl;
 	std::cerr << "  -V             :verbose output" << std::endl;
 	std::cerr << "  -K             :keep artefacts, do not clean up" << std::endl;
+	std::cerr << "  -B             :insert documents in bulk load mode" << std::endl;
 	std::cerr << "<nofdocs>     :number of documents inserted in each (re-)insert cycle" << std::endl;
 	std::cerr << "<commitsize>  :number of documents inserted per transaction" << std::endl;
 	std::cerr << "<observed>    :list of ':' separated docid:value pairs describing" << std::endl;
@@ -145,6 +159,10 @@ int main( int argc, const char* argv[])
 		{
 			g_verbose = true;
 		}
+		else if (std::strcmp( argv[argi], "-B") == 0)
+		{
+			g_bulkLoad = true;
+		}
 		else if (std::strcmp( argv[argi], "-h") == 0)
 		{
 			printUsage();
@@ -219,6 +237,7 @@ TESTS_DONE:
 	if (do_cleanup)
 	{
 		Storage::destroy( "path=storage", g_fileLocator, g_errorhnd);
+		if (g_bulkLoad) (void)strus::removeDirRecursive( "bulkload");
 	}
 	delete g_fileLocator;
 	delete g_errorhnd;
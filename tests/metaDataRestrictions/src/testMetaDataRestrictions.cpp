@@ -9,6 +9,8 @@
 #include "metaDataDescription.hpp"
 #include "metaDataElement.hpp"
 #include "metaDataRecord.hpp"
+#include "metaDataBlock.hpp"
+#include "metaDataColumn.hpp"
 #include "strus/metaDataReaderInterface.hpp"
 #include "strus/metaDataRestrictionInterface.hpp"
 #include "strus/numericVariant.hpp"
@@ -19,6 +21,7 @@
 #include <iostream>
 #include <sstream>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <map>
 #include <set>
@@ -387,9 +390,8 @@ static strus::MetaDataCompareOperation
 			elem->typeName(), opr, hnd, elemName, operand, newGroup);
 }
 
-static strus::Reference<strus::MetaDataRestrictionInstanceInterface>
+static std::vector<strus::MetaDataCompareOperation>
 	randomMetaDataRestriction(
-		strus::MetaDataReaderInterface* reader,
 		const strus::MetaDataDescription* descr,
 		const strus::MetaDataRecord& rec,
 		bool positiveResult,
@@ -418,9 +420,31 @@ static strus::Reference<strus::MetaDataRestrictionInstanceInterface>
 			expressionstr.append( ops.back().tostring());
 		}
 	}
-	strus::Reference<strus::MetaDataRestrictionInstanceInterface>
-		rt( new strus::MetaDataRestrictionInstance( reader, ops, g_errorbuf.get()));
-	return rt;
+	return ops;
+}
+
+/// \brief Check the block-wise evaluation of a restriction against the expected result for a block with all records equal to the record tested
+static bool checkMetaDataBlockRestriction(
+		const strus::MetaDataDescription* descr,
+		const char* data,
+		const std::vector<strus::MetaDataCompareOperation>& ops,
+		bool expectedResult)
+{
+	std::size_t recsize = descr->bytesize();
+	std::vector<char> blkdata( recsize * strus::MetaDataBlock::BlockSize);
+	std::size_t ri = 0, re = strus::MetaDataBlock::BlockSize;
+	for (; ri != re; ++ri)
+	{
+		std::memcpy( &blkdata[0] + ri * recsize, data, recsize);
+	}
+	strus::MetaDataBlock blk( descr, 1, &blkdata[0], blkdata.size());
+	strus::MetaDataBlockBitmap bitmap;
+	strus::MetaDataRestrictionInstance::matchBlock( descr, blk, ops, bitmap);
+	for (ri = 0; ri != re; ++ri)
+	{
+		if (bitmap.test( ri) != expectedResult) return false;
+	}
+	return true;
 }
 
 static void reportTest(
@@ -541,9 +565,11 @@ int main( int argc, const char* argv[])
 					{
 						std::string expressionstr;
 						bool expectedResult = (bool)randuint(0,2);
+						std::vector<strus::MetaDataCompareOperation>
+							ops = randomMetaDataRestriction( &descr, rc, expectedResult, expressionstr);
 						strus::Reference<MetaDataReader> mdreader( new MetaDataReader( &descr, data));
 						strus::Reference<strus::MetaDataRestrictionInstanceInterface>
-							restriction( randomMetaDataRestriction( mdreader.get(), &descr, rc, expectedResult, expressionstr));
+							restriction( new strus::MetaDataRestrictionInstance( mdreader.get(), ops, 1/*maxdocno*/, g_errorbuf.get()));
 						mdreader.release();
 						// ... mdreader passed with ownership to MetaDataRestrictionInstance
 #ifdef STRUS_LOWLEVEL_DEBUG
@@ -559,6 +585,24 @@ int main( int argc, const char* argv[])
 							std::cout << "query no " << queryCount << " failed" << std::endl;
 							throw std::runtime_error( "test failed");
 						}
+						if ((restriction->skipDoc( 1, 1) == 1) != expectedResult)
+						{
+							reportTest( std::cerr, restriction, expressionstr, rc, expectedResult);
+							std::cout << "skip of query no " << queryCount << " failed" << std::endl;
+							throw std::runtime_error( "test failed");
+						}
+						if (restriction->skipDoc( 1, 0) != 0)
+						{
+							reportTest( std::cerr, restriction, expressionstr, rc, expectedResult);
+							std::cout << "skip of query no " << queryCount << " beyond the upper bound" << std::endl;
+							throw std::runtime_error( "test failed");
+						}
+						if (!checkMetaDataBlockRestriction( &descr, data, ops, expectedResult))
+						{
+							reportTest( std::cerr, restriction, expressionstr, rc, expectedResult);
+							std::cout << "block evaluation of query no " << queryCount << " failed" << std::endl;
+							throw std::runtime_error( "test failed");
+						}
 					}
 					catch (const RandomDataException&)
 					{
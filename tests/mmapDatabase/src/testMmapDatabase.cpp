@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Test of the cursor on a memory mapped frozen database file against a reference map
+#include "strus/lib/error.hpp"
+#include "strus/errorBufferInterface.hpp"
+#include "strus/databaseBackupCursorInterface.hpp"
+#include "strus/base/local_ptr.hpp"
+#include "mmapFrozenFile.hpp"
+#include "mmapDatabaseCursor.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+#include <ctime>
+#include <map>
+#include <string>
+
+#undef STRUS_LOWLEVEL_DEBUG
+
+static void initRand()
+{
+	time_t nowtime;
+	struct tm* now;
+
+	::time( &nowtime);
+	now = ::localtime( &nowtime);
+
+	::srand( ((now->tm_year+1) * (now->tm_mon+100) * (now->tm_mday+1)));
+}
+#define RANDINT(MIN,MAX) ((rand()%(MAX-MIN))+MIN)
+
+typedef std::map<std::string,std::string> KeyValueMap;
+
+/// \brief Backup cursor fetching the elements of a map in ascending order
+class MapBackupCursor
+	:public strus::DatabaseBackupCursorInterface
+{
+public:
+	explicit MapBackupCursor( const KeyValueMap& map_)
+		:m_itr(map_.begin()),m_end(map_.end()){}
+
+	virtual bool fetch(
+			const char*& keyptr,
+			std::size_t& keysize,
+			const char*& blkptr,
+			std::size_t& blksize)
+	{
+		if (m_itr == m_end) return false;
+		keyptr = m_itr->first.c_str();
+		keysize = m_itr->first.size();
+		blkptr = m_itr->second.c_str();
+		blksize = m_itr->second.size();
+		++m_itr;
+		return true;
+	}
+
+private:
+	KeyValueMap::const_iterator m_itr;
+	KeyValueMap::const_iterator m_end;
+};
+
+static std::string randomKey()
+{
+	static const char* prefixes = "abcxyz";
+	std::string rt;
+	rt.push_back( prefixes[ RANDINT( 0, 6)]);
+	unsigned int ki = 0, ke = RANDINT( 0, 9);
+	for (; ki < ke; ++ki)
+	{
+		rt.push_back( (char)RANDINT( 0, 4));
+	}
+	return rt;
+}
+
+static std::string randomValue()
+{
+	std::string rt;
+	unsigned int vi = 0, ve = RANDINT( 0, 40);
+	for (; vi < ve; ++vi)
+	{
+		rt.push_back( (char)RANDINT( 'A', 'Z'));
+	}
+	return rt;
+}
+
+/// \brief Get the first key of the reference bigger than or equal to a key and starting with its domain prefix
+static std::string expectedUpperBound( const KeyValueMap& map, const std::string& key, std::size_t domainkeysize)
+{
+	KeyValueMap::const_iterator mi = map.lower_bound( key);
+	if (mi == map.end() || 0!=mi->first.compare( 0, domainkeysize, key, 0, domainkeysize)) return std::string();
+	return mi->first;
+}
+
+/// \brief Get the last key of the reference starting with a domain prefix
+static std::string expectedLast( const KeyValueMap& map, const std::string& domain)
+{
+	std::string rt;
+	KeyValueMap::const_iterator mi = map.lower_bound( domain), me = map.end();
+	for (; mi != me && 0==mi->first.compare( 0, domain.size(), domain); ++mi)
+	{
+		rt = mi->first;
+	}
+	return rt;
+}
+
+static void checkResult( const char* method, const std::string& arg, const strus::DatabaseCursorInterface::Slice& output, const std::string& expected)
+{
+#ifdef STRUS_LOWLEVEL_DEBUG
+	std::cout << "\t" << method << " '" << arg << "' => '" << output.tostring() << "' expected '" << expected << "'" << std::endl;
+#endif
+	if (output.tostring() != expected || output.defined() == expected.empty())
+	{
+		std::ostringstream msg;
+		msg << method << " returns '" << output.tostring() << "' instead of '" << expected << "'";
+		throw std::runtime_error( msg.str());
+	}
+}
+
+static void testMmapDatabase( strus::ErrorBufferInterface* errorhnd, unsigned int nofRecords, unsigned int nofQueries)
+{
+	const char* filename = "testMmapDatabase.mmf";
+	KeyValueMap map;
+	while (map.size() < nofRecords)
+	{
+		map[ randomKey()] = randomValue();
+	}
+	MapBackupCursor backup( map);
+	strus::MmapFrozenFile::write( filename, &backup, 10, "ab");
+	strus::MmapFrozenFileRef file( new strus::MmapFrozenFile( filename));
+	if (file->nofRecords() != map.size()) throw std::runtime_error( "number of records written does not match");
+
+	// Check the records fetched by a backup cursor:
+	strus::MmapDatabaseBackupCursor backupCursor( file);
+	KeyValueMap::const_iterator mi = map.begin(), me = map.end();
+	const char* key;
+	std::size_t keysize;
+	const char* blk;
+	std::size_t blksize;
+	for (; backupCursor.fetch( key, keysize, blk, blksize); ++mi)
+	{
+		if (mi == me || mi->first != std::string( key, keysize) || mi->second != std::string( blk, blksize))
+		{
+			throw std::runtime_error( "record fetched by backup cursor does not match");
+		}
+	}
+	if (mi != me) throw std::runtime_error( "backup cursor did not fetch all records");
+
+	// Check point lookups of all records:
+	strus::MmapDatabaseCursor cursor( file, errorhnd);
+	for (mi = map.begin(); mi != me; ++mi)
+	{
+		if (!file->mayContain( mi->first.c_str(), mi->first.size()))
+		{
+			throw std::runtime_error( "bloom filter rejects key of a record inserted");
+		}
+		strus::DatabaseCursorInterface::Slice value = cursor.seekKeyValue( mi->first.c_str(), mi->first.size());
+		if (!value.defined() || value.tostring() != mi->second)
+		{
+			throw std::runtime_error( "value of point lookup does not match");
+		}
+	}
+
+	// Check random seeks:
+	unsigned int qi = 0;
+	for (; qi < nofQueries; ++qi)
+	{
+		std::string qkey = randomKey();
+		std::size_t domainkeysize = RANDINT( 0, 3);
+		if (domainkeysize > qkey.size()) domainkeysize = qkey.size();
+
+		checkResult( "seek upper bound", qkey, cursor.seekUpperBound( qkey.c_str(), qkey.size(), domainkeysize), expectedUpperBound( map, qkey, domainkeysize));
+
+		std::string domain( qkey, 0, domainkeysize);
+		std::string expected = expectedLast( map, domain);
+		checkResult( "seek last", domain, cursor.seekLast( domain.c_str(), domain.size()), expected);
+
+		// Iterate backwards through the domain and compare with the reference:
+		KeyValueMap::const_iterator ri = map.find( expected);
+		for (int pi = 0; pi < 5 && ri != map.end(); ++pi)
+		{
+			std::string prevkey;
+			if (ri != map.begin())
+			{
+				--ri;
+				if (0==ri->first.compare( 0, domain.size(), domain)) prevkey = ri->first; else ri = map.end();
+			}
+			else
+			{
+				ri = map.end();
+			}
+			checkResult( "seek prev", domain, cursor.seekPrev(), prevkey);
+			if (prevkey.empty()) break;
+		}
+		checkResult( "seek first", domain, cursor.seekFirst( domain.c_str(), domain.size()), expectedUpperBound( map, domain, domain.size()));
+		if (cursor.key().defined() && cursor.value().tostring() != map[ cursor.key().tostring()])
+		{
+			throw std::runtime_error( "value of cursor does not match");
+		}
+	}
+	file.reset();
+	std::remove( filename);
+	std::cerr << "tested memory mapped database with " << nofRecords << " records and " << nofQueries << " queries with success" << std::endl;
+}
+
+int main( int, const char**)
+{
+	strus::local_ptr<strus::ErrorBufferInterface> errorhnd( strus::createErrorBuffer_standard( stderr, 1, NULL/*debug trace interface*/));
+	try
+	{
+		if (!errorhnd.get()) throw std::runtime_error( "failed to create error buffer");
+		initRand();
+		testMmapDatabase( errorhnd.get(), 1, 100);
+		testMmapDatabase( errorhnd.get(), 100, 1000);
+		testMmapDatabase( errorhnd.get(), 10000, 10000);
+		if (errorhnd->hasError()) throw std::runtime_error( errorhnd->fetchError());
+		return 0;
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << "EXCEPTION " << err.what() << std::endl;
+	}
+	return -1;
+}
+
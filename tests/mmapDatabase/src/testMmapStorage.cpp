@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Test of a storage opened, queried and closed on a memory mapped database exported from a LevelDB storage
+#include "strus/lib/error.hpp"
+#include "strus/lib/database_leveldb.hpp"
+#include "strus/lib/database_mmap.hpp"
+#include "strus/lib/storage.hpp"
+#include "strus/lib/filelocator.hpp"
+#include "strus/base/local_ptr.hpp"
+#include "strus/base/string_format.hpp"
+#include "strus/errorBufferInterface.hpp"
+#include "strus/fileLocatorInterface.hpp"
+#include "strus/databaseInterface.hpp"
+#include "strus/databaseClientInterface.hpp"
+#include "strus/databaseBackupCursorInterface.hpp"
+#include "strus/storageInterface.hpp"
+#include "strus/storageClientInterface.hpp"
+#include "strus/storageTransactionInterface.hpp"
+#include "strus/storageDocumentInterface.hpp"
+#include "strus/postingIteratorInterface.hpp"
+#include "strus/attributeReaderInterface.hpp"
+#include "strus/storage/termStatistics.hpp"
+#include "private/errorUtils.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#define NofDocuments 100
+#define SourceConfig "path=storage_mmap_src"
+#define MmapConfig "path=storage_mmap"
+
+static strus::ErrorBufferInterface* g_errorhnd = 0;
+static strus::FileLocatorInterface* g_fileLocator = 0;
+
+/// \brief Create a LevelDB storage with documents with the terms "even" or "odd" and a title attribute
+static void createSourceStorage( const strus::DatabaseInterface* dbi, const strus::StorageInterface* sti)
+{
+	(void)dbi->destroyDatabase( SourceConfig);
+	(void)g_errorhnd->fetchError();
+	if (!sti->createStorage( SourceConfig, dbi)) throw std::runtime_error( g_errorhnd->fetchError());
+	strus::local_ptr<strus::StorageClientInterface> storage( sti->createClient( SourceConfig, dbi, 0/*statistics processor*/));
+	if (!storage.get()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	strus::local_ptr<strus::StorageTransactionInterface> transaction( storage->createTransaction());
+	if (!transaction.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	int di = 1;
+	for (; di <= NofDocuments; ++di)
+	{
+		strus::local_ptr<strus::StorageDocumentInterface> doc( transaction->createDocument( strus::string_format( "D%d", di)));
+		if (!doc.get()) throw std::runtime_error( g_errorhnd->fetchError());
+		doc->addSearchIndexTerm( "word", (di % 2 == 0) ? "even" : "odd", 1);
+		doc->addSearchIndexTerm( "word", "all", 2);
+		doc->setAttribute( "title", strus::string_format( "title %d", di));
+		doc->done();
+	}
+	if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+	storage->close();
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+}
+
+static void exportStorage( const strus::DatabaseInterface* srcdbi, const strus::DatabaseInterface* dstdbi)
+{
+	(void)dstdbi->destroyDatabase( MmapConfig);
+	(void)g_errorhnd->fetchError();
+	strus::local_ptr<strus::DatabaseClientInterface> srcdb( srcdbi->createClient( SourceConfig));
+	if (!srcdb.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	strus::local_ptr<strus::DatabaseBackupCursorInterface> cursor( srcdb->createBackupCursor());
+	if (!cursor.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	if (!dstdbi->restoreDatabase( MmapConfig, cursor.get())) throw std::runtime_error( g_errorhnd->fetchError());
+}
+
+static void queryStorage( const strus::StorageClientInterface* storage)
+{
+	if (storage->nofDocumentsInserted() != NofDocuments)
+	{
+		throw strus::runtime_error( "number of documents of storage on memory mapped database %d, expected %d", (int)storage->nofDocumentsInserted(), (int)NofDocuments);
+	}
+	if (storage->documentFrequency( "word", "even") != NofDocuments / 2)
+	{
+		throw strus::runtime_error( "document frequency of term 'even' %d, expected %d", (int)storage->documentFrequency( "word", "even"), (int)NofDocuments / 2);
+	}
+	strus::local_ptr<strus::PostingIteratorInterface> itr( storage->createTermPostingIterator( "word", "all", 1, strus::TermStatistics()));
+	strus::local_ptr<strus::AttributeReaderInterface> attributeReader( storage->createAttributeReader());
+	if (!itr.get() || !attributeReader.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	strus::Index title = attributeReader->elementHandle( "title");
+
+	int di = 1;
+	for (; di <= NofDocuments; ++di)
+	{
+		std::string docid = strus::string_format( "D%d", di);
+		strus::Index docno = storage->documentNumber( docid);
+		if (!docno) throw strus::runtime_error( "document '%s' not found in storage on memory mapped database", docid.c_str());
+		if (itr->skipDoc( docno) != docno || itr->skipPos( 0) != 2)
+		{
+			throw strus::runtime_error( "posting of term 'all' in document '%s' not found", docid.c_str());
+		}
+		attributeReader->skipDoc( docno);
+		std::string expected = strus::string_format( "title %d", di);
+		if (attributeReader->getValue( title) != expected)
+		{
+			throw strus::runtime_error( "attribute title of document '%s' is '%s', expected '%s'", docid.c_str(), attributeReader->getValue( title).c_str(), expected.c_str());
+		}
+	}
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+}
+
+static void testMmapStorage()
+{
+	strus::local_ptr<strus::DatabaseInterface> srcdbi( strus::createDatabaseType_leveldb( g_fileLocator, g_errorhnd));
+	strus::local_ptr<strus::DatabaseInterface> dbi( strus::createDatabaseType_mmap( g_fileLocator, g_errorhnd));
+	strus::local_ptr<strus::StorageInterface> sti( strus::createStorageType_std( g_fileLocator, g_errorhnd));
+	if (!srcdbi.get() || !dbi.get() || !sti.get() || g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	createSourceStorage( srcdbi.get(), sti.get());
+	exportStorage( srcdbi.get(), dbi.get());
+
+	// Open, query and close explicitely:
+	strus::local_ptr<strus::StorageClientInterface> storage( sti->createClient( MmapConfig, dbi.get(), 0/*statistics processor*/));
+	if (!storage.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	queryStorage( storage.get());
+	storage->close();
+	if (g_errorhnd->hasError())
+	{
+		throw strus::runtime_error( "error closing storage on memory mapped database: %s", g_errorhnd->fetchError());
+	}
+	storage.reset();
+	if (g_errorhnd->hasError())
+	{
+		throw strus::runtime_error( "error destroying storage on memory mapped database after close: %s", g_errorhnd->fetchError());
+	}
+	// Open, query and destroy without close:
+	storage.reset( sti->createClient( MmapConfig, dbi.get(), 0/*statistics processor*/));
+	if (!storage.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	queryStorage( storage.get());
+	storage.reset();
+	if (g_errorhnd->hasError())
+	{
+		throw strus::runtime_error( "error destroying storage on memory mapped database: %s", g_errorhnd->fetchError());
+	}
+	(void)dbi->destroyDatabase( MmapConfig);
+	(void)srcdbi->destroyDatabase( SourceConfig);
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+	std::cerr << "tested storage on memory mapped database with " << NofDocuments << " documents with success" << std::endl;
+}
+
+int main( int, const char**)
+{
+	int rt = -1;
+	g_errorhnd = strus::createErrorBuffer_standard( stderr, 1, NULL/*debug trace interface*/);
+	if (!g_errorhnd) {std::cerr << "FAILED " << "strus::createErrorBuffer_standard" << std::endl; return -1;}
+	g_fileLocator = strus::createFileLocator_std( g_errorhnd);
+	if (!g_fileLocator) {std::cerr << "FAILED " << "strus::createFileLocator_std" << std::endl; delete g_errorhnd; return -1;}
+	try
+	{
+		testMmapStorage();
+		rt = 0;
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << "EXCEPTION " << err.what() << std::endl;
+	}
+	delete g_fileLocator;
+	delete g_errorhnd;
+	return rt;
+}
+
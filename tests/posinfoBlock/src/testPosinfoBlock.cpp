@@ -32,7 +32,7 @@ static void initRand()
 }
 #define RANDINT(MIN,MAX) ((rand()%(MAX-MIN))+MIN)
 
-static std::vector<strus::Index> randPosinfo()
+static std::vector<strus::Index> randPosinfo( unsigned int maxPosIncr)
 {
 	std::vector<strus::Index> rt;
 	unsigned int tt=0,nofElements=RANDINT(1,25);
@@ -40,7 +40,7 @@ static std::vector<strus::Index> randPosinfo()
 	
 	for (; tt<nofElements; ++tt)
 	{
-		rt.push_back( pp += RANDINT(1,25));
+		rt.push_back( pp += RANDINT(1,maxPosIncr));
 	}
 	return rt;
 }
@@ -75,7 +75,7 @@ static std::string indexVectorToString( const std::vector<strus::Index>& ar)
 	return rt.str();
 }
 
-static void testPosinfoBlock( unsigned int times, unsigned int minNofDocs, unsigned int nofQueries)
+static void testPosinfoBlock( unsigned int times, unsigned int minNofDocs, unsigned int nofQueries, unsigned int maxPosIncr)
 {
 	unsigned int tt=0;
 	
@@ -95,7 +95,7 @@ static void testPosinfoBlock( unsigned int times, unsigned int minNofDocs, unsig
 		for (; ii<nofDocs; ++ii)
 		{
 			maxDocNo += RANDINT(1,25);
-			pmap[ maxDocNo] = randPosinfo();
+			pmap[ maxDocNo] = randPosinfo( maxPosIncr);
 			docnoar.push_back( maxDocNo);
 		}
 		PosinfoMap::const_iterator pi = pmap.begin(), pe = pmap.end();
@@ -167,6 +167,19 @@ static void testPosinfoBlock( unsigned int times, unsigned int minNofDocs, unsig
 			{
 				throw std::runtime_error( std::string( "posinfo block build failed, mismatch in positions: {") + indexVectorToString( pos) + "} != {" + indexVectorToString( pi->second) + "}");
 			}
+			const strus::BlockSummary* summary = bi->summary();
+			if (!summary)
+			{
+				throw std::runtime_error( "posinfo block built without summary");
+			}
+			if (!bi->compressed())
+			{
+				throw std::runtime_error( "posinfo block built without compression of the positions");
+			}
+			if (pos.size() > summary->maxff || (!pos.empty() && (unsigned int)pos.back() < summary->mindoclen))
+			{
+				throw std::runtime_error( "posinfo block summary (max ff, min document length) does not bound the postings of the block");
+			}
 			blkdn = bi->nextDoc( bidx);
 			if (!blkdn)
 			{
@@ -236,7 +249,7 @@ static void testPosinfoBlock( unsigned int times, unsigned int minNofDocs, unsig
 			}
 		}
 	}
-	std::cerr << "tested posinfo block " << times << " times with " << minNofDocs << " documents with success" << std::endl;
+	std::cerr << "tested posinfo block " << times << " times with " << minNofDocs << " documents and positions up to " << (25 * maxPosIncr) << " with success" << std::endl;
 }
 
 
@@ -246,7 +259,8 @@ int main( int, const char**)
 	{
 		initRand();
 		testDataBlockBuild( 1);
-		testPosinfoBlock( 100, 3000, 1000);
+		testPosinfoBlock( 100, 3000, 1000, 25);
+		testPosinfoBlock( 20, 3000, 1000, 20000/*positions beyond 65535*/);
 		return 0;
 	}
 	catch (const std::exception& err)
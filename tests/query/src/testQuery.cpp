@@ -22,6 +22,7 @@
 #include "strus/queryEvalInterface.hpp"
 #include "strus/queryInterface.hpp"
 #include "strus/storage/queryResult.hpp"
+#include "strus/storage/resultDocument.hpp"
 #include "strus/storage/summaryElement.hpp"
 #include "strus/storageInterface.hpp"
 #include "strus/storageClientInterface.hpp"
@@ -37,10 +38,15 @@
 #include "strus/summarizerFunctionInstanceInterface.hpp"
 #include "strus/weightingFunctionInterface.hpp"
 #include "strus/weightingFunctionInstanceInterface.hpp"
+#include "strus/weightingFunctionContextInterface.hpp"
+#include "strus/storage/globalStatistics.hpp"
+#include "strus/storage/termStatistics.hpp"
+#include "strus/storage/weightedField.hpp"
 #include "strus/storage/index.hpp"
 #include "private/errorUtils.hpp"
 #include "strus/base/shared_ptr.hpp"
 #include <string>
+#include <vector>
 #include <cstring>
 #include <stdio.h>
 #include <iostream>
@@ -54,6 +60,8 @@ static strus::ErrorBufferInterface* g_errorhnd = 0;
 static strus::FileLocatorInterface* g_fileLocator = 0;
 static bool g_verbose = false;
 
+#define NOF_QUERY_THREADS 4
+
 class Storage
 {
 public:
@@ -434,6 +442,466 @@ static void testSingleTermQueryWithSelectionAndRestriction( const strus::QueryPr
 	}
 }
 
+/// \brief Fetch the contents of the debug trace events of the query with a given identifier, dropping all other messages
+static std::vector<std::string> fetchQueryTraceEvents( const char* id)
+{
+	std::vector<std::string> rt;
+	std::vector<strus::DebugTraceMessage> msglist = g_dbgtrace->fetchMessages();
+	std::vector<strus::DebugTraceMessage>::const_iterator
+		mi = msglist.begin(), me = msglist.end();
+	for (; mi != me; ++mi)
+	{
+		if (g_verbose) std::cerr << strus::string_format( "trace %s %s %s '%s'", mi->typeName(), mi->id(), mi->component(), mi->content().c_str()) << std::endl;
+		if (0==std::strcmp( mi->id(), id))
+		{
+			rt.push_back( mi->content());
+		}
+	}
+	return rt;
+}
+
+static void testPlanEmptyResult( const strus::QueryProcessorInterface* qpi)
+{
+	g_dbgtrace->enable( "query");
+	{
+		// Selection feature matching no document:
+		QueryEvaluationEnv queryenv( qpi);
+		strus::QueryInterface* query = queryenv.query.get();
+
+		query->pushTerm( "word", "hello", 1);
+		query->defineFeature( "qry");
+		query->pushTerm( "word", "nonexistent", 1);
+		query->defineFeature( "sel");
+
+		strus::QueryResult result = query->evaluate();
+		std::vector<std::string> events = fetchQueryTraceEvents( "plan-empty");
+		if (!result.ranks().empty() || result.nofRanked() != 0 || result.nofVisited() != 0)
+		{
+			throw std::runtime_error("query with a selection feature matching no document has a non empty result");
+		}
+		if (events.size() != 1)
+		{
+			throw std::runtime_error("query with a selection feature matching no document not detected as empty by the planner");
+		}
+	}
+	{
+		// Restriction feature matching no document:
+		QueryEvaluationEnv queryenv( qpi);
+		strus::QueryInterface* query = queryenv.query.get();
+
+		query->pushTerm( "word", "hello", 1);
+		query->defineFeature( "qry");
+		query->pushTerm( "word", "hello", 1);
+		query->defineFeature( "sel");
+		query->pushTerm( "word", "nonexistent", 1);
+		query->defineFeature( "res");
+
+		strus::QueryResult result = query->evaluate();
+		std::vector<std::string> events = fetchQueryTraceEvents( "plan-empty");
+		if (!result.ranks().empty() || result.nofRanked() != 0)
+		{
+			throw std::runtime_error("query with a restriction feature matching no document has a non empty result");
+		}
+		if (events.size() != 1)
+		{
+			throw std::runtime_error("query with a restriction feature matching no document not detected as empty by the planner");
+		}
+	}
+}
+
+static void testPlanSkipEmptyFeatures( const strus::QueryProcessorInterface* qpi)
+{
+	g_dbgtrace->enable( "query");
+	QueryEvaluationEnv queryenv( qpi);
+	strus::QueryInterface* query = queryenv.query.get();
+
+	query->pushTerm( "word", "hello", 1);
+	query->defineFeature( "qry");
+	query->pushTerm( "word", "hello", 1);
+	query->defineFeature( "sel");
+	query->pushTerm( "word", "nonexistent", 1);
+	query->defineFeature( "sel");
+	query->pushTerm( "prim", "2", 1);
+	query->defineFeature( "exc");
+	query->pushTerm( "prim", "11", 1);
+	query->defineFeature( "exc");
+
+	strus::QueryResult result = query->evaluate();
+	std::vector<std::string> events = fetchQueryTraceEvents( "plan-skip");
+
+	if (g_verbose) std::cerr << "result testPlanSkipEmptyFeatures:" << std::endl;
+	if (g_verbose) printQueryResult( result);
+
+	std::string res = getQueryResultMembersString( result);
+	std::string exp = "0,1,3,5,7,9";
+
+	if (g_verbose) std::cerr << "packed result: (" << res << ")" << std::endl;
+	if (g_verbose) std::cerr << "expected: (" << exp << ")" << std::endl;
+
+	if (res != exp)
+	{
+		throw std::runtime_error("query result not as expected");
+	}
+	std::sort( events.begin(), events.end());
+	if (events.size() != 2 || events[0] != "exclusion set=exc" || events[1] != "selector set=sel")
+	{
+		throw std::runtime_error("features matching no document not dropped by the planner");
+	}
+}
+
+static void testPlanRestrictionOrder( const strus::QueryProcessorInterface* qpi)
+{
+	g_dbgtrace->enable( "query");
+	QueryEvaluationEnv queryenv( qpi);
+	strus::QueryInterface* query = queryenv.query.get();
+
+	query->pushTerm( "word", "hello", 1);
+	query->defineFeature( "qry");
+	query->pushTerm( "word", "hello", 1);
+	query->defineFeature( "sel");
+	query->pushTerm( "word", "hello", 1);
+	query->defineFeature( "res");
+	query->pushTerm( "prim", "2", 1);
+	query->defineFeature( "res");
+	query->pushTerm( "prim", "3", 1);
+	query->defineFeature( "res");
+
+	strus::QueryResult result = query->evaluate();
+	std::vector<std::string> events = fetchQueryTraceEvents( "feature-restriction");
+
+	if (g_verbose) std::cerr << "result testPlanRestrictionOrder:" << std::endl;
+	if (g_verbose) printQueryResult( result);
+
+	std::string res = getQueryResultMembersString( result);
+	std::string exp = "6";
+
+	if (g_verbose) std::cerr << "packed result: (" << res << ")" << std::endl;
+	if (g_verbose) std::cerr << "expected: (" << exp << ")" << std::endl;
+
+	if (res != exp)
+	{
+		throw std::runtime_error("query result not as expected");
+	}
+	// ... the restrictions are evaluated in ascending order of their document frequency ('prim 3':3, 'prim 2':4, 'word hello':10):
+	if (events.size() != 3 || events[0] != "name=res df=3" || events[1] != "name=res df=4" || events[2] != "name=res df=10")
+	{
+		throw std::runtime_error("feature restrictions not ordered by ascending document frequency");
+	}
+}
+
+
+struct WeightingFunctionDef
+{
+	const char* name;
+	const char* paramname;
+	const char* paramvalue;
+	const char* prim[2];
+};
+
+static strus::WeightingFunctionContextInterface* createWeightingContext(
+		const strus::QueryProcessorInterface* qpi, const strus::StorageClientInterface* storage,
+		const WeightingFunctionDef& def, std::vector<strus::Reference<strus::PostingIteratorInterface> >& itrs)
+{
+	const strus::WeightingFunctionInterface* function = qpi->getWeightingFunction( def.name);
+	if (!function) throw strus::runtime_error( "failed to get weighting function %s", def.name);
+	strus::local_ptr<strus::WeightingFunctionInstanceInterface> instance( function->createInstance( qpi));
+	if (!instance.get()) throw strus::runtime_error( "failed to create instance of weighting function %s", def.name);
+	if (def.paramname) instance->addStringParameter( def.paramname, def.paramvalue);
+	strus::local_ptr<strus::WeightingFunctionContextInterface> context( instance->createFunctionContext( storage, strus::GlobalStatistics()));
+	if (!context.get()) throw strus::runtime_error( "failed to create context of weighting function %s: %s", def.name, g_errorhnd->fetchError());
+	for (int pi=0; pi < 2 && def.prim[pi]; ++pi)
+	{
+		strus::Reference<strus::PostingIteratorInterface> itr( storage->createTermPostingIterator( "prim", def.prim[pi], 1, strus::TermStatistics()));
+		if (!itr.get()) throw std::runtime_error( g_errorhnd->fetchError());
+		context->addWeightingFeature( "match", itr.get(), 1.0);
+		itrs.push_back( itr);
+	}
+	if (g_errorhnd->hasError())
+	{
+		throw strus::runtime_error( "failed to initialize context of weighting function %s: %s", def.name, g_errorhnd->fetchError());
+	}
+	return context.release();
+}
+
+static void testWeightingBatch( const strus::QueryProcessorInterface* qpi)
+{
+	QueryEvaluationEnv queryenv( qpi);
+	const strus::StorageClientInterface* storage = queryenv.storage.sci.get();
+	static const WeightingFunctionDef functions[] = {
+		{"frequency", 0, 0, {"2","3"}},
+		{"constant", 0, 0, {"2","3"}},
+		{"bm25", "metadata_doclen", "docno", {"2","3"}},
+		{"bm25pff", "metadata_doclen", "docno", {"2",0}},
+		{"metadata", "name", "docno", {0,0}},
+		{0,0,0,{0,0}}
+	};
+	std::vector<strus::Index> docnos;
+	for (strus::Index docno = 1; docno <= (strus::Index)storage->maxDocumentNumber(); ++docno)
+	{
+		docnos.push_back( docno);
+	}
+	// The weights of a batch have to be exactly the same as the weights of the calls document by document:
+	for (int fi=0; functions[fi].name; ++fi)
+	{
+		std::vector<strus::Reference<strus::PostingIteratorInterface> > itrs;
+		strus::local_ptr<strus::WeightingFunctionContextInterface> batchContext( createWeightingContext( qpi, storage, functions[fi], itrs));
+		strus::local_ptr<strus::WeightingFunctionContextInterface> callContext( createWeightingContext( qpi, storage, functions[fi], itrs));
+		if (!batchContext->batchCapable())
+		{
+			throw strus::runtime_error( "weighting function %s expected to be capable of weighting a batch", functions[fi].name);
+		}
+		std::vector<double> weights( docnos.size(), -1.0);
+		if (!batchContext->callBatch( docnos.data(), docnos.size(), weights.data()))
+		{
+			throw strus::runtime_error( "batch call of weighting function %s failed: %s", functions[fi].name, g_errorhnd->fetchError());
+		}
+		for (std::size_t di=0; di < docnos.size(); ++di)
+		{
+			const std::vector<strus::WeightedField>& wf = callContext->call( docnos[ di]);
+			double expected = wf.empty() ? 0.0 : wf[0].weight();
+			if (wf.size() > 1 || weights[ di] != expected)
+			{
+				throw strus::runtime_error( "batch weight of weighting function %s for document %d is %f, expected %f", functions[fi].name, (int)docnos[ di], weights[ di], expected);
+			}
+		}
+	}
+	{
+		// Proximity weighting with more than one feature returns fields and is evaluated document by document:
+		static const WeightingFunctionDef proximity = {"bm25pff", "metadata_doclen", "docno", {"2","3"}};
+		std::vector<strus::Reference<strus::PostingIteratorInterface> > itrs;
+		strus::local_ptr<strus::WeightingFunctionContextInterface> context( createWeightingContext( qpi, storage, proximity, itrs));
+		if (context->batchCapable())
+		{
+			throw std::runtime_error( "proximity weighting not expected to be capable of weighting a batch");
+		}
+	}
+	if (g_errorhnd->hasError())
+	{
+		throw strus::runtime_error( "error in batch weighting test: %s", g_errorhnd->fetchError());
+	}
+}
+
+static unsigned int getResultCacheCounter( const strus::QueryEvalInterface* qeval, const char* name)
+{
+	strus::StructView view = qeval->view();
+	const strus::StructView* cacheview = view.get( "resultcache");
+	const strus::StructView* counter = cacheview ? cacheview->get( name) : 0;
+	if (!counter) throw strus::runtime_error( "result cache counter '%s' not found in view of query evaluation", name);
+	return atoi( counter->tostring().c_str());
+}
+
+static std::string evaluateResultCacheQuery( const strus::QueryEvalInterface* qeval, const strus::StorageClientInterface* storage)
+{
+	strus::local_ptr<strus::QueryInterface> query( qeval->createQuery( storage));
+	if (!query.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	query->pushTerm( "word", "hello", 1);
+	query->defineFeature( "qry");
+	query->pushTerm( "word", "hello", 1);
+	query->defineFeature( "sel");
+	strus::QueryResult result = query->evaluate();
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	std::ostringstream out;
+	out << getQueryResultMembersString( result);
+	std::vector<strus::ResultDocument>::const_iterator ri = result.ranks().begin(), re = result.ranks().end();
+	for (; ri != re; ++ri)
+	{
+		out << ";" << ri->weight();
+	}
+	return out.str();
+}
+
+static void checkResultCacheCounters( const strus::QueryEvalInterface* qeval, unsigned int hits, unsigned int misses, const char* statestr)
+{
+	unsigned int nofHits = getResultCacheCounter( qeval, "hits");
+	unsigned int nofMisses = getResultCacheCounter( qeval, "misses");
+	if (nofHits != hits || nofMisses != misses)
+	{
+		throw strus::runtime_error( "result cache %s has %u hits and %u misses, expected %u hits and %u misses", statestr, nofHits, nofMisses, hits, misses);
+	}
+}
+
+static void testResultCache( const strus::QueryProcessorInterface* qpi)
+{
+	QueryEvaluationEnv queryenv( qpi);
+	const strus::StorageClientInterface* storage = queryenv.storage.sci.get();
+	queryenv.qeval->defineResultCache( 1<<20);
+
+	// The second evaluation of the same query is a hit:
+	std::string res = evaluateResultCacheQuery( queryenv.qeval.get(), storage);
+	checkResultCacheCounters( queryenv.qeval.get(), 0, 1, "after the first query");
+	if (evaluateResultCacheQuery( queryenv.qeval.get(), storage) != res)
+	{
+		throw std::runtime_error( "cached query result does not match");
+	}
+	checkResultCacheCounters( queryenv.qeval.get(), 1, 1, "after the repeated query");
+
+	// A commit outdates the cached result:
+	strus::local_ptr<strus::StorageTransactionInterface> transaction( queryenv.storage.sci->createTransaction());
+	if (!transaction.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	strus::local_ptr<strus::StorageDocumentInterface> doc( transaction->createDocument( "DOC10"));
+	doc->addSearchIndexTerm( "word", "hello", 1);
+	doc->setAttribute( "docid", "DOC10");
+	doc->done();
+	if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	std::string res_commit = evaluateResultCacheQuery( queryenv.qeval.get(), storage);
+	checkResultCacheCounters( queryenv.qeval.get(), 1, 2, "after the commit");
+	std::string exp_commit = "0,1,10,2,3,4,5,6,7,8,9;";
+	if (res_commit.compare( 0, exp_commit.size(), exp_commit) != 0)
+	{
+		throw strus::runtime_error( "query result after commit not as expected: %s", res_commit.c_str());
+	}
+	(void)evaluateResultCacheQuery( queryenv.qeval.get(), storage);
+	checkResultCacheCounters( queryenv.qeval.get(), 2, 2, "after the repeated query after the commit");
+
+	// A change of the query evaluation program outdates the cached result:
+	const strus::WeightingFunctionInterface* weighting = qpi->getWeightingFunction( "constant");
+	if (!weighting) throw std::runtime_error( "failed to get weighting function");
+	strus::WeightingFunctionInstanceInterface* weightingInstance = weighting->createInstance( qpi);
+	if (!weightingInstance) throw std::runtime_error( "failed to create weighting function instance");
+	weightingInstance->addNumericParameter( "weight", strus::NumericVariant( 2.0));
+	std::vector<strus::QueryEvalInterface::FeatureParameter> weightingFeatures;
+	weightingFeatures.push_back( strus::QueryEvalInterface::FeatureParameter( "match", "qry"));
+	queryenv.qeval->addWeightingFunction( weightingInstance, weightingFeatures);
+
+	std::string res_program = evaluateResultCacheQuery( queryenv.qeval.get(), storage);
+	checkResultCacheCounters( queryenv.qeval.get(), 2, 3, "after the change of the program");
+	if (res_program == res_commit)
+	{
+		throw std::runtime_error( "query result after the change of the program not expected to match the result before");
+	}
+	if (g_errorhnd->hasError())
+	{
+		throw strus::runtime_error( "error in result cache test: %s", g_errorhnd->fetchError());
+	}
+}
+
+static strus::QueryEvalInterface* createParallelRankingQueryEval( const strus::QueryProcessorInterface* qpi, int nofThreads)
+{
+	strus::local_ptr<strus::QueryEvalInterface> qeval( strus::createQueryEval( g_errorhnd));
+	if (!qeval.get()) throw std::runtime_error( "failed to create query eval");
+	const strus::SummarizerFunctionInterface* summarizer = qpi->getSummarizerFunction( "attribute");
+	if (!summarizer) throw std::runtime_error( "failed to get summarizer");
+	strus::SummarizerFunctionInstanceInterface* summarizerInstance = summarizer->createInstance( qpi);
+	if (!summarizerInstance) throw std::runtime_error( "failed to create summarizer instance");
+	summarizerInstance->addStringParameter( "name", "docid");
+	qeval->addSummarizerFunction( "docid", summarizerInstance, std::vector<strus::QueryEvalInterface::FeatureParameter>());
+	qeval->addSelectionFeature( "sel");
+
+	std::vector<strus::QueryEvalInterface::FeatureParameter> weightingFeatures;
+	weightingFeatures.push_back( strus::QueryEvalInterface::FeatureParameter( "match", "qry"));
+	// ... the match summarizer reads the feature postings after the ranking
+	const strus::SummarizerFunctionInterface* matches = qpi->getSummarizerFunction( "listmatch");
+	if (!matches) throw std::runtime_error( "failed to get summarizer");
+	strus::SummarizerFunctionInstanceInterface* matchesInstance = matches->createInstance( qpi);
+	if (!matchesInstance) throw std::runtime_error( "failed to create summarizer instance");
+	qeval->addSummarizerFunction( "match", matchesInstance, weightingFeatures);
+	const strus::WeightingFunctionInterface* frequency = qpi->getWeightingFunction( "frequency");
+	const strus::WeightingFunctionInterface* metadata = qpi->getWeightingFunction( "metadata");
+	if (!frequency || !metadata) throw std::runtime_error( "failed to get weighting function");
+	strus::WeightingFunctionInstanceInterface* frequencyInstance = frequency->createInstance( qpi);
+	strus::WeightingFunctionInstanceInterface* metadataInstance = metadata->createInstance( qpi);
+	if (!frequencyInstance || !metadataInstance) throw std::runtime_error( "failed to create weighting function instance");
+	metadataInstance->addStringParameter( "name", "score");
+	qeval->addWeightingFunction( frequencyInstance, weightingFeatures);
+	qeval->addWeightingFunction( metadataInstance, std::vector<strus::QueryEvalInterface::FeatureParameter>());
+	qeval->defineParallelism( nofThreads);
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+	return qeval.release();
+}
+
+static strus::QueryResult evaluateParallelRankingQuery( const strus::QueryEvalInterface* qeval, const strus::StorageClientInterface* storage, const char* term, int minRank, int maxNofRanks)
+{
+	strus::local_ptr<strus::QueryInterface> query( qeval->createQuery( storage));
+	if (!query.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	query->pushTerm( "word", term, 1);
+	query->defineFeature( "qry");
+	query->pushTerm( "word", term, 1);
+	query->defineFeature( "sel");
+	strus::QueryResult rt = query->evaluate( minRank, maxNofRanks);
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+	return rt;
+}
+
+static void compareQueryResults( const strus::QueryResult& serial, const strus::QueryResult& parallel, const char* term, int minRank)
+{
+	if (serial.nofRanked() != parallel.nofRanked() || serial.nofVisited() != parallel.nofVisited() || serial.evaluationPass() != parallel.evaluationPass())
+	{
+		throw strus::runtime_error( "counters of parallel ranking of '%s' from %d differ: ranked %d/%d visited %d/%d", term, minRank, serial.nofRanked(), parallel.nofRanked(), serial.nofVisited(), parallel.nofVisited());
+	}
+	if (serial.ranks().empty() || serial.ranks().size() != parallel.ranks().size())
+	{
+		throw strus::runtime_error( "number of ranks of parallel ranking of '%s' from %d differ: %d/%d", term, minRank, (int)serial.ranks().size(), (int)parallel.ranks().size());
+	}
+	std::vector<strus::ResultDocument>::const_iterator
+		si = serial.ranks().begin(), se = serial.ranks().end(),
+		pi = parallel.ranks().begin();
+	for (int ridx=minRank; si != se; ++si,++pi,++ridx)
+	{
+		if (si->docno() != pi->docno() || si->weight() != pi->weight())
+		{
+			throw strus::runtime_error( "rank %d of parallel ranking of '%s' differs: docno %d/%d weight %f/%f", ridx, term, (int)si->docno(), (int)pi->docno(), si->weight(), pi->weight());
+		}
+		std::vector<strus::SummaryElement>::const_iterator
+			ei = si->summaryElements().begin(), ee = si->summaryElements().end(),
+			ej = pi->summaryElements().begin(), ej_end = pi->summaryElements().end();
+		for (; ei != ee && ej != ej_end; ++ei,++ej)
+		{
+			if (ei->name() != ej->name() || ei->value() != ej->value()) break;
+		}
+		if (ei != ee || ej != ej_end)
+		{
+			throw strus::runtime_error( "summary of rank %d of parallel ranking of '%s' differs", ridx, term);
+		}
+		for (ei = si->summaryElements().begin(); ei != ee && ei->name().compare( 0, 5, "match") != 0; ++ei){}
+		if (ei == ee)
+		{
+			throw strus::runtime_error( "summary of rank %d of ranking of '%s' has no match", ridx, term);
+		}
+	}
+}
+
+static void testParallelRanking( const strus::QueryProcessorInterface* qpi)
+{
+	enum {NofDocs=3*4096+100};
+	Storage storage;
+	storage.open( "path=storage");
+	const Storage::MetaDataDef metadata[] = {{"score", "UINT16"},{0,0}};
+	storage.defineMetaData( metadata);
+	strus::local_ptr<strus::StorageTransactionInterface> transaction( storage.sci->createTransaction());
+	if (!transaction.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	for (unsigned int di=0; di < NofDocs; ++di)
+	{
+		std::string docid = strus::string_format( "DOC%u", di);
+		strus::local_ptr<strus::StorageDocumentInterface> doc( transaction->createDocument( docid));
+		doc->addSearchIndexTerm( "word", "hello", 1);
+		if (di % 3 == 0) doc->addSearchIndexTerm( "word", "three", 2);
+		// ... distinct scores, so that the ranking does not depend on the order of documents with equal weights
+		doc->setMetaData( "score", (strus::NumericVariant::UIntType)((di * 7919) % 65521));
+		doc->setAttribute( "docid", docid);
+		doc->done();
+	}
+	if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	strus::local_ptr<strus::QueryEvalInterface> serialEval( createParallelRankingQueryEval( qpi, 1));
+	strus::local_ptr<strus::QueryEvalInterface> parallelEval( createParallelRankingQueryEval( qpi, NOF_QUERY_THREADS));
+	static const char* terms[] = {"hello", "three", 0};
+	static const int minRanks[] = {0, 7, -1};
+	for (int ti=0; terms[ti]; ++ti)
+	{
+		for (int mi=0; minRanks[mi] >= 0; ++mi)
+		{
+			strus::QueryResult serial = evaluateParallelRankingQuery( serialEval.get(), storage.sci.get(), terms[ti], minRanks[mi], 40);
+			strus::QueryResult parallel = evaluateParallelRankingQuery( parallelEval.get(), storage.sci.get(), terms[ti], minRanks[mi], 40);
+			compareQueryResults( serial, parallel, terms[ti], minRanks[mi]);
+		}
+	}
+	if (g_errorhnd->hasError())
+	{
+		throw strus::runtime_error( "error in parallel ranking test: %s", g_errorhnd->fetchError());
+	}
+}
 
 #define RUN_TEST( idx, TestName, qpi, rt)\
 	try\
@@ -515,7 +983,7 @@ int main( int argc, const char* argv[])
 				return -1;
 			}
 		}
-		g_errorhnd = strus::createErrorBuffer_standard( stderr, 2/*maxNofThreads*/, g_dbgtrace);
+		g_errorhnd = strus::createErrorBuffer_standard( stderr, NOF_QUERY_THREADS+1/*maxNofThreads*/, g_dbgtrace);
 		if (!g_errorhnd) {std::cerr << "FAILED " << "strus::createErrorBuffer_standard" << std::endl; return -1;}
 		g_fileLocator = strus::createFileLocator_std( g_errorhnd);
 		if (!g_fileLocator) {std::cerr << "FAILED " << "strus::createFileLocator_std" << std::endl; return -1;}
@@ -539,6 +1007,12 @@ int main( int argc, const char* argv[])
 				case 3: RUN_TEST( ti, SingleTermQueryWithRestriction, qpi.get(), rt ) break;
 				case 4: RUN_TEST( ti, SingleTermQueryWithRestrictionInclMetadata, qpi.get(), rt ) break;
 				case 5: RUN_TEST( ti, SingleTermQueryWithSelectionAndRestriction, qpi.get(), rt ) break;
+				case 6: RUN_TEST( ti, PlanEmptyResult, qpi.get(), rt ) break;
+				case 7: RUN_TEST( ti, PlanSkipEmptyFeatures, qpi.get(), rt ) break;
+				case 8: RUN_TEST( ti, PlanRestrictionOrder, qpi.get(), rt ) break;
+				case 9: RUN_TEST( ti, WeightingBatch, qpi.get(), rt ) break;
+				case 10: RUN_TEST( ti, ResultCache, qpi.get(), rt ) break;
+				case 11: RUN_TEST( ti, ParallelRanking, qpi.get(), rt ) break;
 				default: goto TESTS_DONE;
 			}
 			if (test_index) break;
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Microbenchmark comparing the implementation strategies of the ranker for different result windows
+#include "private/ranker.hpp"
+#include "strus/storage/index.hpp"
+#include "strus/storage/weightedDocument.hpp"
+#include "strus/base/math.hpp"
+#include "strus/base/pseudoRandom.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <ctime>
+
+static strus::PseudoRandom g_random;
+static strus::Index g_docnum = 0;
+
+static std::string doubleToString( double val_)
+{
+	unsigned int val = (unsigned int)strus::Math::floor( val_ * 1000);
+	unsigned int val_sec = val / 1000;
+	unsigned int val_ms = val % 1000;
+	std::ostringstream val_str;
+	val_str << val_sec << "." << std::setfill('0') << std::setw(3) << val_ms;
+	return val_str.str();
+}
+
+static strus::WeightedDocument randomWeightedDocument()
+{
+	float weight = (float)g_random.get(0,10000) / g_random.get(1,10000);
+	return strus::WeightedDocument( ++g_docnum, strus::IndexRange(), weight);
+}
+
+static const char* strategyName( strus::Ranker<strus::WeightedDocument>::Strategy strategy)
+{
+	switch (strategy)
+	{
+		case strus::Ranker<strus::WeightedDocument>::AutoStrategy: return "auto";
+		case strus::Ranker<strus::WeightedDocument>::BruteForceStrategy: return "brute force";
+		case strus::Ranker<strus::WeightedDocument>::MultiSetStrategy: return "multiset";
+		case strus::Ranker<strus::WeightedDocument>::HeapStrategy: return "heap";
+	}
+	return "unknown";
+}
+
+static std::vector<strus::WeightedDocument> rank(
+		const std::vector<strus::WeightedDocument>& docs,
+		strus::Ranker<strus::WeightedDocument>::Strategy strategy,
+		std::size_t minRank, std::size_t maxNofRanks)
+{
+	std::clock_t start = std::clock();
+	strus::Ranker<strus::WeightedDocument> ranker( minRank + maxNofRanks, strategy);
+	std::vector<strus::WeightedDocument>::const_iterator di = docs.begin(), de = docs.end();
+	for (; di != de; ++di)
+	{
+		ranker.insert( *di);
+	}
+	std::vector<strus::WeightedDocument> rt = ranker.result( minRank);
+	double duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
+	std::cerr << "ranking of " << docs.size() << " documents with " << strategyName( strategy)
+			<< " ranker for ranks " << minRank << " to " << (minRank + maxNofRanks)
+			<< " in " << doubleToString( duration) << " seconds" << std::endl;
+	return rt;
+}
+
+static bool compareResults( const std::vector<strus::WeightedDocument>& res, const std::vector<strus::WeightedDocument>& expected)
+{
+	if (res.size() != expected.size())
+	{
+		std::cerr << "size of ranklist does not match " << res.size() << " != " << expected.size() << std::endl;
+		return false;
+	}
+	std::vector<strus::WeightedDocument>::const_iterator ri = res.begin(), re = res.end();
+	std::vector<strus::WeightedDocument>::const_iterator ei = expected.begin();
+	for (int ridx=0; ri != re; ++ri,++ei,++ridx)
+	{
+		if (ri->docno() != ei->docno() || !strus::Math::isequal( ri->weight(), ei->weight()))
+		{
+			std::cerr << "rank does not match [" << ridx << "] "
+					<< " docno " << ri->docno() << "/" << ei->docno()
+					<< " weight " << ri->weight() << "/" << ei->weight()
+					<< std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+int main( int , const char** )
+{
+	try
+	{
+		typedef strus::Ranker<strus::WeightedDocument> Ranker;
+		enum {NofWeightedDocs=1000000};
+		struct Window {std::size_t minRank; std::size_t maxNofRanks;};
+		static const Window windows[] = {{0,10},{0,100},{1000,100},{10000,100},{0,0}};
+
+		std::vector<strus::WeightedDocument> docs;
+		docs.reserve( NofWeightedDocs);
+		for (std::size_t ii=0; ii<NofWeightedDocs; ++ii)
+		{
+			docs.push_back( randomWeightedDocument());
+		}
+		int rt = 0;
+		for (int widx=0; windows[widx].maxNofRanks; ++widx)
+		{
+			const Window& window = windows[ widx];
+			std::vector<strus::WeightedDocument> expected
+				= rank( docs, Ranker::MultiSetStrategy, window.minRank, window.maxNofRanks);
+			if (window.minRank + window.maxNofRanks < 128)
+			{
+				if (!compareResults( rank( docs, Ranker::BruteForceStrategy, window.minRank, window.maxNofRanks), expected)) rt = 1;
+			}
+			if (!compareResults( rank( docs, Ranker::HeapStrategy, window.minRank, window.maxNofRanks), expected)) rt = 1;
+		}
+		if (rt == 0) std::cerr << "OK" << std::endl;
+		return rt;
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << "EXCEPTION " << err.what() << std::endl;
+	}
+	return -1;
+}
+
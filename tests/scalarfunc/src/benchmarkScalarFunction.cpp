@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2020 Patrick P. Frey
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+/// \brief Microbenchmark comparing the stack machine interpreter of scalar functions with the compiled program for single and batch calls
+#include "strus/lib/error.hpp"
+#include "strus/scalarFunctionInterface.hpp"
+#include "strus/scalarFunctionInstanceInterface.hpp"
+#include "strus/errorBufferInterface.hpp"
+#include "strus/base/local_ptr.hpp"
+#include "strus/base/math.hpp"
+#include "strus/base/pseudoRandom.hpp"
+#include "scalarFunctionParser.hpp"
+#include "scalarFunctionInstance.hpp"
+#include <stdexcept>
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <ctime>
+
+static strus::PseudoRandom g_random;
+static strus::ErrorBufferInterface* g_errorhnd = 0;
+
+static std::string doubleToString( double val_)
+{
+	unsigned int val = (unsigned int)strus::Math::floor( val_ * 1000);
+	unsigned int val_sec = val / 1000;
+	unsigned int val_ms = val % 1000;
+	std::ostringstream val_str;
+	val_str << val_sec << "." << std::setfill('0') << std::setw(3) << val_ms;
+	return val_str.str();
+}
+
+struct VariableDef
+{
+	const char* name;
+	double value;
+};
+
+struct Benchmark
+{
+	const char* name;
+	const char* formula;
+	const char* argumentnames[ 10];
+	const VariableDef variables[ 10];
+	unsigned int nofargs;
+	int argrange[ 10];
+};
+
+static const Benchmark benchmarks[] =
+{
+	{
+		"linear combination",
+		"x * _0 - y * _1 + 0.5 * _2",
+		{0},
+		{{"x",2.2},{"y",1.1},{0,0.0}},
+		3,
+		{100,100,100}
+	},
+	{
+		"normalized log",
+		"log( x*x - y + _0) * (3 + 6 + 3 -1)",
+		{0},
+		{{"x",2.0},{"y",3.0},{0,0.0}},
+		1,
+		{1000}
+	},
+	{
+		"conditional",
+		"if_gt( _0, _1, _0 / (_1 + 1), _1 / (_0 + 1))",
+		{0},
+		{{0,0.0}},
+		2,
+		{1000,1000}
+	},
+	{
+		"BM25",
+		"w * log( (N - df + 0.5) / (df + 0.5)) * (ff * (k1 + 1.0)) / (ff + k1 * (1.0 - b + b * ((doclen+1) / avgdoclen)))",
+		{"ff","df","doclen",0},
+		{{"w",1.3},{"N",100000},{"k1",1.5},{"b",0.75},{"avgdoclen",200},{0,0.0}},
+		3,
+		{20,50000,1000}
+	},
+	{0,0,{0},{{0,0.0}},0,{0}}
+};
+
+static std::vector<double> randomArguments( const Benchmark& bm, std::size_t nofcalls)
+{
+	std::vector<double> rt;
+	rt.reserve( nofcalls * bm.nofargs);
+	for (std::size_t ci=0; ci < nofcalls; ++ci)
+	{
+		for (unsigned int ai=0; ai < bm.nofargs; ++ai)
+		{
+			rt.push_back( (double)g_random.get( 1, bm.argrange[ ai]));
+		}
+	}
+	return rt;
+}
+
+static void printDuration( const char* name, const char* method, std::size_t nofcalls, std::clock_t start)
+{
+	double duration = (std::clock() - start) / (double) CLOCKS_PER_SEC;
+	std::cerr << "evaluation of '" << name << "' with " << method << " for " << nofcalls << " argument tuples"
+			<< " in " << doubleToString( duration) << " seconds" << std::endl;
+}
+
+static bool compareResults( const char* method, const std::vector<double>& res, const std::vector<double>& expected)
+{
+	std::vector<double>::const_iterator ri = res.begin(), re = res.end();
+	std::vector<double>::const_iterator ei = expected.begin();
+	for (int ridx=0; ri != re; ++ri,++ei,++ridx)
+	{
+		if (!strus::Math::isequal( *ri, *ei))
+		{
+			std::cerr << "result of " << method << " does not match [" << ridx << "] " << *ri << " != " << *ei << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool run( const strus::ScalarFunctionParser& parser, const Benchmark& bm, std::size_t nofcalls)
+{
+	std::vector<std::string> argumentNames;
+	for (std::size_t ai=0; bm.argumentnames[ai]; ++ai)
+	{
+		argumentNames.push_back( bm.argumentnames[ai]);
+	}
+	strus::local_ptr<strus::ScalarFunctionInterface> funcdef( parser.createFunction( bm.formula, argumentNames));
+	if (!funcdef.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	strus::local_ptr<strus::ScalarFunctionInstanceInterface> funcinst( funcdef->createInstance());
+	if (!funcinst.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	const VariableDef* vi = bm.variables;
+	for (;vi->name; ++vi)
+	{
+		funcinst->setVariableValue( vi->name, vi->value);
+	}
+	const strus::ScalarFunctionInstance* func = dynamic_cast<const strus::ScalarFunctionInstance*>( funcinst.get());
+	if (!func) throw std::runtime_error( "scalar function instance of unexpected type");
+	if (!func->compiled())
+	{
+		std::cerr << "function '" << bm.name << "' has not been compiled" << std::endl;
+		return false;
+	}
+	std::vector<double> args = randomArguments( bm, nofcalls);
+	std::vector<double> expected( nofcalls);
+	std::vector<double> res( nofcalls);
+	std::clock_t start;
+
+	start = std::clock();
+	for (std::size_t ci=0; ci < nofcalls; ++ci)
+	{
+		expected[ ci] = func->interpret( args.data() + ci * bm.nofargs, bm.nofargs);
+	}
+	printDuration( bm.name, "interpreter", nofcalls, start);
+
+	start = std::clock();
+	for (std::size_t ci=0; ci < nofcalls; ++ci)
+	{
+		res[ ci] = func->call( args.data() + ci * bm.nofargs, bm.nofargs);
+	}
+	printDuration( bm.name, "compiled program", nofcalls, start);
+	if (!compareResults( "compiled program", res, expected)) return false;
+
+	start = std::clock();
+	func->callBatch( args.data(), bm.nofargs, nofcalls, res.data());
+	printDuration( bm.name, "compiled program batch call", nofcalls, start);
+	if (!compareResults( "compiled program batch call", res, expected)) return false;
+
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+	return true;
+}
+
+int main( int , const char** )
+{
+	g_errorhnd = strus::createErrorBuffer_standard( 0, 1, NULL/*debug trace interface*/);
+	if (!g_errorhnd)
+	{
+		std::cerr << "failed to create error buffer for scalar function benchmark" << std::endl;
+		return -1;
+	}
+	try
+	{
+		enum {NofCalls=1000000};
+		strus::ScalarFunctionParser parser( g_errorhnd);
+		int rt = 0;
+		for (int bidx=0; benchmarks[ bidx].name; ++bidx)
+		{
+			if (!run( parser, benchmarks[ bidx], NofCalls)) rt = 1;
+		}
+		if (rt == 0) std::cerr << "OK" << std::endl;
+		delete g_errorhnd;
+		return rt;
+	}
+	catch (const std::exception& err)
+	{
+		std::cerr << "EXCEPTION " << err.what() << std::endl;
+	}
+	return -1;
+}
+
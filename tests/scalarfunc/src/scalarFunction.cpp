@@ -88,8 +88,25 @@ static bool run( const ScalarFunctionParserInterface* parser, unsigned int testi
 	{
 		throw strus::runtime_error( "failed to execute test '%s': %s", test.name, g_errorhnd->fetchError());
 	}
+	double batchResult[ 2];
+	double batchParameter[ 20];
+	for (std::size_t pi=0; pi < test.nofparameter; ++pi)
+	{
+		batchParameter[ pi] = batchParameter[ test.nofparameter + pi] = test.parameter[ pi];
+	}
+	func->callBatch( batchParameter, test.nofparameter, 2, batchResult);
+	if (g_errorhnd->hasError())
+	{
+		throw strus::runtime_error( "failed to execute test '%s' as batch: %s", test.name, g_errorhnd->fetchError());
+	}
 	double xx = (result - test.result);
 	bool rt = (xx * xx < (std::numeric_limits<double>::epsilon()*10));
+	if (batchResult[ 0] != result || batchResult[ 1] != result)
+	{
+		std::cerr << "[" << testidx << "] test '" << test.name << "' batch call result differs: "
+				<< batchResult[ 0] << ", " << batchResult[ 1] << " != " << result << std::endl;
+		rt = false;
+	}
 	if (!rt)
 	{
 		std::cerr << "[" << testidx << "] test '" << test.name << "'" << std::endl;
@@ -20,11 +20,13 @@
 #include "strus/base/shared_ptr.hpp"
 #include "strus/base/configParser.hpp"
 #include "strus/base/pseudoRandom.hpp"
+#include "strus/base/thread.hpp"
 #include "strus/errorBufferInterface.hpp"
 #include "strus/fileLocatorInterface.hpp"
 #include "strus/queryProcessorInterface.hpp"
 #include "strus/postingJoinOperatorInterface.hpp"
 #include "strus/postingIteratorInterface.hpp"
+#include "strus/forwardIteratorInterface.hpp"
 #include "strus/storageInterface.hpp"
 #include "strus/storageClientInterface.hpp"
 #include "strus/storageTransactionInterface.hpp"
@@ -33,6 +35,7 @@
 #include "strus/storageDocumentUpdateInterface.hpp"
 #include "strus/storageDumpInterface.hpp"
 #include "strus/metaDataReaderInterface.hpp"
+#include "strus/invAclIteratorInterface.hpp"
 #include "strus/valueIteratorInterface.hpp"
 #include "private/errorUtils.hpp"
 #include <string>
@@ -50,6 +53,8 @@ static strus::FileLocatorInterface* g_fileLocator = 0;
 static strus::PseudoRandom g_random;
 static bool g_verbose = false;
 
+#define NOF_COMMIT_THREADS 4
+
 class Storage
 {
 public:
@@ -1099,8 +1104,592 @@ static void testReloadConfig()
 	{
 		throw std::runtime_error("altered configuration does not match");
 	}
+	strus::Index docno_new = storage.sci->documentNumber( "D01");
+	if (!storage.sci->reload(
+			"path=storage; cache=112K; bloom_filter=10; prefix_cache=64K; paranoid_checks=yes; verify_checksums=yes"))
+	{
+		throw std::runtime_error( g_errorhnd->fetchError());
+	}
+	std::string config_tuned = storage.sci->config();
+	if (config_tuned != "path='storage';cache=112K;bloom_filter=10;prefix_cache=64K;prefix_cache_keys='TISD';paranoid_checks=Y;verify_checksums=Y")
+	{
+		throw std::runtime_error("tuned configuration does not match");
+	}
+	// Lookups served by the prefix cache have to return the same as the first lookup that filled it:
+	for (int ii=0; ii<2; ++ii)
+	{
+		if (storage.sci->documentNumber( "D01") != docno_new || docno_new == 0)
+		{
+			throw std::runtime_error("document number lookup with prefix cache does not match");
+		}
+		if (storage.sci->documentNumber( "NOT_EXISTING_DOCID") != 0)
+		{
+			throw std::runtime_error("unknown document number lookup with prefix cache does not match");
+		}
+	}
 	if (g_verbose) std::cerr << "config orig:\n" << config_orig << std::endl;
 	if (g_verbose) std::cerr << "config new:\n" << config_new << std::endl;
+	if (g_verbose) std::cerr << "config tuned:\n" << config_tuned << std::endl;
+}
+
+static void insertTermDictionaryDocument( strus::StorageClientInterface* storage, const std::string& docid, unsigned int firstTerm, unsigned int nofTerms)
+{
+	strus::local_ptr<strus::StorageTransactionInterface> transaction( storage->createTransaction());
+	strus::local_ptr<strus::StorageDocumentInterface> doc( transaction->createDocument( docid));
+	for (unsigned int ti=firstTerm; ti < firstTerm + nofTerms; ++ti)
+	{
+		doc->addSearchIndexTerm( featureString( "t", ti % 3), featureString( "v", ti), ti+1);
+	}
+	doc->done();
+	if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+}
+
+static void testTermDictionary()
+{
+	enum {NofTerms=40};
+	Storage storage;
+	storage.open( "path=storage", true);
+	storage.close();
+
+	// Insert with the memory resident term dictionary, the dictionary is updated by the commits:
+	storage.open( "path=storage; termdict=yes", false);
+	insertTermDictionaryDocument( storage.sci.get(), "D1", 0, NofTerms/2);
+	insertTermDictionaryDocument( storage.sci.get(), "D2", NofTerms/4, NofTerms/2);
+	std::vector<strus::Index> termnoar;
+	std::vector<strus::Index> typenoar;
+	for (unsigned int ti=0; ti < NofTerms; ++ti)
+	{
+		strus::Index termno = storage.sci->termValueNumber( featureString( "v", ti));
+		strus::Index typeno = storage.sci->termTypeNumber( featureString( "T", ti % 3));
+		if ((termno == 0) != (ti >= NofTerms/4 + NofTerms/2) || typeno == 0)
+		{
+			throw std::runtime_error( "term dictionary lookup after insert does not match");
+		}
+		termnoar.push_back( termno);
+		typenoar.push_back( typeno);
+	}
+	if (storage.sci->termValueNumber( "NOT_EXISTING_TERM") != 0)
+	{
+		throw std::runtime_error( "term dictionary lookup of unknown term does not match");
+	}
+	{
+		// A term not in the dictionary is looked up in the database, it might have been written by another client:
+		strus::local_ptr<strus::StorageClientInterface> writer( storage.sti->createClient( "path=storage", storage.dbi.get(), 0/*statistics processor*/));
+		if (!writer.get()) throw std::runtime_error( g_errorhnd->fetchError());
+		insertTermDictionaryDocument( writer.get(), "D3", NofTerms, 1);
+	}
+	if (storage.sci->termValueNumber( featureString( "v", NofTerms)) == 0)
+	{
+		throw std::runtime_error( "term dictionary lookup of term written by another client does not match");
+	}
+	storage.close();
+
+	// The lookups without the dictionary have to return the same:
+	storage.open( "path=storage", false);
+	for (unsigned int ti=0; ti < NofTerms; ++ti)
+	{
+		if (storage.sci->termValueNumber( featureString( "v", ti)) != termnoar[ ti]
+		||  storage.sci->termTypeNumber( featureString( "t", ti % 3)) != typenoar[ ti])
+		{
+			throw std::runtime_error( "term dictionary lookup does not match database");
+		}
+	}
+	storage.close();
+
+	// The lookups with the dictionary loaded on open have to return the same:
+	storage.open( "path=storage; termdict=yes", false);
+	for (unsigned int ti=0; ti < NofTerms; ++ti)
+	{
+		if (storage.sci->termValueNumber( featureString( "v", ti)) != termnoar[ ti]
+		||  storage.sci->termTypeNumber( featureString( "t", ti % 3)) != typenoar[ ti])
+		{
+			throw std::runtime_error( "term dictionary loaded does not match database");
+		}
+	}
+	storage.close();
+	if (g_errorhnd->hasError())
+	{
+		throw std::runtime_error( g_errorhnd->fetchError());
+	}
+}
+
+static unsigned int countTermPostings( strus::StorageClientInterface* storage, const std::string& type, const std::string& value)
+{
+	strus::local_ptr<strus::PostingIteratorInterface> itr( storage->createTermPostingIterator( type, value, 1, strus::TermStatistics()));
+	if (!itr.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	unsigned int rt = 0;
+	strus::Index docno = itr->skipDoc( 1);
+	for (; docno; docno = itr->skipDoc( docno+1))
+	{
+		if (itr->skipPos( 0) != 1) throw std::runtime_error( "unexpected position of posting");
+		++rt;
+	}
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+	return rt;
+}
+
+static void insertBlockCacheDocument( strus::StorageClientInterface* storage, unsigned int docidx)
+{
+	strus::local_ptr<strus::StorageTransactionInterface> transaction( storage->createTransaction());
+	strus::local_ptr<strus::StorageDocumentInterface> doc( transaction->createDocument( featureString( "D", docidx)));
+	doc->addSearchIndexTerm( "word", "common", 1);
+	doc->addSearchIndexTerm( "word", featureString( "v", docidx % 7), 2);
+	doc->addForwardIndexTerm( "word", featureString( "v", docidx), 1);
+	doc->done();
+	if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+}
+
+static void checkBlockCacheForwardIndex( strus::StorageClientInterface* storage, unsigned int docidx)
+{
+	strus::local_ptr<strus::ForwardIteratorInterface> fwd( storage->createForwardIterator( "word"));
+	if (!fwd.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	fwd->skipDoc( storage->documentNumber( featureString( "D", docidx)));
+	if (fwd->skipPos( 1) != 1 || fwd->fetch() != featureString( "v", docidx))
+	{
+		throw std::runtime_error( "forward index read with block cache does not match");
+	}
+}
+
+static void testBlockCache()
+{
+	enum {NofDocuments=200};
+	Storage storage;
+	storage.open( "path=storage", true);
+	storage.close();
+
+	storage.open( "path=storage; blockcache=1M", false);
+	unsigned int di = 0;
+	for (; di < NofDocuments/2; ++di)
+	{
+		insertBlockCacheDocument( storage.sci.get(), di);
+	}
+	// The second pass reads the blocks cached in the first pass:
+	for (int pass=0; pass < 2; ++pass)
+	{
+		if (countTermPostings( storage.sci.get(), "word", "common") != NofDocuments/2)
+		{
+			throw std::runtime_error( "number of postings read with block cache does not match");
+		}
+		checkBlockCacheForwardIndex( storage.sci.get(), 1);
+	}
+	// The commits invalidate the blocks cached that they rewrite:
+	for (; di < NofDocuments; ++di)
+	{
+		insertBlockCacheDocument( storage.sci.get(), di);
+	}
+	strus::local_ptr<strus::StorageTransactionInterface> transaction( storage.sci->createTransaction());
+	transaction->deleteDocument( featureString( "D", 0));
+	if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	for (int pass=0; pass < 2; ++pass)
+	{
+		if (countTermPostings( storage.sci.get(), "word", "common") != NofDocuments-1)
+		{
+			throw std::runtime_error( "number of postings read with block cache after update does not match");
+		}
+		if (countTermPostings( storage.sci.get(), "word", "v0") != (NofDocuments+6)/7 - 1)
+		{
+			throw std::runtime_error( "number of postings read with block cache after delete does not match");
+		}
+		checkBlockCacheForwardIndex( storage.sci.get(), NofDocuments-1);
+	}
+	storage.close();
+	if (g_errorhnd->hasError())
+	{
+		throw std::runtime_error( g_errorhnd->fetchError());
+	}
+}
+
+static void checkForwardIndexRange( strus::ForwardIteratorInterface* fwd, unsigned int nofTokens, const strus::IndexRange& range, std::size_t maxNofTokens)
+{
+	std::vector<strus::ForwardIteratorInterface::Token> tokens;
+	fwd->fetchRange( range, maxNofTokens, tokens);
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	// Tokens are inserted at every second position, the position 2*i+1 has the value "t<i>":
+	strus::Index endpos = range.defined() ? range.end() : (strus::Index)(2*nofTokens+1);
+	if (endpos > (strus::Index)(2*nofTokens+1)) endpos = 2*nofTokens+1;
+	strus::Index pos = range.start() > 1 ? (range.start() | 1) : 1;
+	std::size_t nofExpected = pos < endpos ? (endpos - pos + 1) / 2 : 0;
+	if (maxNofTokens && nofExpected > maxNofTokens) nofExpected = maxNofTokens;
+	if (tokens.size() != nofExpected) throw std::runtime_error( "number of tokens of forward index range fetched does not match");
+
+	std::vector<strus::ForwardIteratorInterface::Token>::const_iterator ti = tokens.begin(), te = tokens.end();
+	for (; ti != te; pos += 2, ++ti)
+	{
+		if (ti->pos != pos || ti->value.tostring() != featureString( "t", (pos-1)/2))
+		{
+			throw std::runtime_error( "forward index range fetched does not match");
+		}
+	}
+}
+
+static void testForwardIndexRange()
+{
+	enum {NofTokens=1000};
+	Storage storage;
+	storage.open( "path=storage", true);
+	{
+		strus::local_ptr<strus::StorageTransactionInterface> transaction( storage.sci->createTransaction());
+		strus::local_ptr<strus::StorageDocumentInterface> doc( transaction->createDocument( "D"));
+		unsigned int ti = 0;
+		for (; ti < NofTokens; ++ti)
+		{
+			doc->addForwardIndexTerm( "word", featureString( "t", ti), 2*ti+1);
+		}
+		doc->addSearchIndexTerm( "word", "t0", 1);
+		doc->done();
+		if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+	}
+	strus::local_ptr<strus::ForwardIteratorInterface> fwd( storage.sci->createForwardIterator( "word"));
+	if (!fwd.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	fwd->skipDoc( storage.sci->documentNumber( "D"));
+
+	// Ranges within a block and spanning several blocks (block size is 128 tokens):
+	checkForwardIndexRange( fwd.get(), NofTokens, strus::IndexRange(), 0);
+	checkForwardIndexRange( fwd.get(), NofTokens, strus::IndexRange( 1, 20), 0);
+	checkForwardIndexRange( fwd.get(), NofTokens, strus::IndexRange( 200, 700), 0);
+	checkForwardIndexRange( fwd.get(), NofTokens, strus::IndexRange( 100, 1800), 40);
+	checkForwardIndexRange( fwd.get(), NofTokens, strus::IndexRange( 2*NofTokens, 3*NofTokens), 0);
+
+	// Single items fetched without copy:
+	if (fwd->skipPos( 400) != 401 || fwd->fetchSlice().tostring() != featureString( "t", 200))
+	{
+		throw std::runtime_error( "forward index item fetched as slice does not match");
+	}
+	storage.close();
+	if (g_errorhnd->hasError())
+	{
+		throw std::runtime_error( g_errorhnd->fetchError());
+	}
+}
+
+static void insertForwardIndexDictDocument( strus::StorageTransactionInterface* transaction, unsigned int docidx, unsigned int nofTokens)
+{
+	strus::local_ptr<strus::StorageDocumentInterface> doc( transaction->createDocument( featureString( "D", docidx)));
+	unsigned int ti = 0;
+	for (; ti < nofTokens; ++ti)
+	{
+		// The values of type 'orig' repeat and are stored dictionary encoded, the values of type 'word' are stored as strings:
+		doc->addForwardIndexTerm( "orig", featureString( "v", (ti * (docidx+1)) % 17), ti+1);
+		doc->addForwardIndexTerm( "word", featureString( "w", ti), ti+1);
+	}
+	doc->addSearchIndexTerm( "word", "v1", 1);
+	doc->done();
+}
+
+static void checkForwardIndexDictDocument( const strus::StorageClientInterface* storage, unsigned int docidx, unsigned int nofTokens)
+{
+	strus::Index docno = storage->documentNumber( featureString( "D", docidx));
+	strus::local_ptr<strus::ForwardIteratorInterface> orig( storage->createForwardIterator( "orig"));
+	strus::local_ptr<strus::ForwardIteratorInterface> word( storage->createForwardIterator( "word"));
+	if (!orig.get() || !word.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	orig->skipDoc( docno);
+	word->skipDoc( docno);
+
+	unsigned int ti = 0;
+	strus::Index pos = orig->skipPos( 0);
+	for (; pos; pos = orig->skipPos( pos+1), ++ti)
+	{
+		if (pos != (strus::Index)(ti+1)
+		||  orig->fetch() != featureString( "v", (ti * (docidx+1)) % 17)
+		||  word->skipPos( pos) != pos
+		||  word->fetchSlice().tostring() != featureString( "w", ti))
+		{
+			throw std::runtime_error( "dictionary encoded forward index item fetched does not match");
+		}
+	}
+	if (ti != nofTokens) throw std::runtime_error( "number of dictionary encoded forward index items does not match");
+
+	std::vector<strus::ForwardIteratorInterface::Token> tokens;
+	orig->fetchRange( strus::IndexRange( 100, 2*nofTokens), 0, tokens);
+	if (g_errorhnd->hasError()) throw std::runtime_error( g_errorhnd->fetchError());
+	if (tokens.size() != nofTokens - 99) throw std::runtime_error( "number of dictionary encoded forward index items in range does not match");
+	std::vector<strus::ForwardIteratorInterface::Token>::const_iterator ki = tokens.begin(), ke = tokens.end();
+	for (ti = 99; ki != ke; ++ki, ++ti)
+	{
+		if (ki->pos != (strus::Index)(ti+1) || ki->value.tostring() != featureString( "v", (ti * (docidx+1)) % 17))
+		{
+			throw std::runtime_error( "dictionary encoded forward index range fetched does not match");
+		}
+	}
+}
+
+static void testForwardIndexDictionary()
+{
+	enum {NofDocuments=4, NofTokens=300};
+	Storage storage;
+	storage.open( "path=storage", true);
+	storage.close();
+
+	storage.open( "path=storage; fwdict=orig", false);
+	{
+		// The term value numbers allocated by the transaction are renamed in the forward index blocks on commit:
+		strus::local_ptr<strus::StorageTransactionInterface> transaction( storage.sci->createTransaction());
+		unsigned int di = 0;
+		for (; di < NofDocuments/2; ++di)
+		{
+			insertForwardIndexDictDocument( transaction.get(), di, NofTokens);
+		}
+		if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+	}{
+		// Values already defined:
+		strus::local_ptr<strus::StorageTransactionInterface> transaction( storage.sci->createTransaction());
+		unsigned int di = NofDocuments/2;
+		for (; di < NofDocuments; ++di)
+		{
+			insertForwardIndexDictDocument( transaction.get(), di, NofTokens);
+		}
+		if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+	}
+	unsigned int di = 0;
+	for (; di < NofDocuments; ++di)
+	{
+		checkForwardIndexDictDocument( storage.sci.get(), di, NofTokens);
+	}
+	storage.close();
+
+	// Reading does not depend on the configuration:
+	storage.open( "path=storage", false);
+	for (di = 0; di < NofDocuments; ++di)
+	{
+		checkForwardIndexDictDocument( storage.sci.get(), di, NofTokens);
+	}
+	storage.close();
+
+	// Values decoded with a shared cache, small enough for evicting values referenced by the slices of a range fetched:
+	storage.open( "path=storage; termvaluecache=2K", false);
+	for (int pass=0; pass < 2; ++pass)
+	{
+		for (di = 0; di < NofDocuments; ++di)
+		{
+			checkForwardIndexDictDocument( storage.sci.get(), di, NofTokens);
+		}
+	}
+	storage.close();
+	if (g_errorhnd->hasError())
+	{
+		throw std::runtime_error( g_errorhnd->fetchError());
+	}
+}
+
+/// \brief Thread committing transactions with documents that share terms with the documents of the other threads
+static void checkAclUserSet( const strus::StorageClientInterface* storage, const std::vector<std::string>& users, unsigned int nofDocuments, bool (*visible)( unsigned int), const char* statestr)
+{
+	strus::local_ptr<strus::InvAclIteratorInterface> itr( storage->createInvAclIterator( users));
+	if (!itr.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	unsigned int di = 0;
+	for (; di < nofDocuments; ++di)
+	{
+		strus::Index docno = storage->documentNumber( featureString( "D", di));
+		if (!docno) throw strus::runtime_error( "document %u not found in storage", di);
+		if ((itr->skipDoc( docno) == docno) != visible( di))
+		{
+			throw strus::runtime_error( "access of the user set to document %u does not match %s", di, statestr);
+		}
+	}
+}
+
+static bool isVisibleUserSetInitial( unsigned int di)
+{
+	return di % 2 == 0 || di % 3 == 0;
+}
+
+static bool isVisibleUserSetUpdated( unsigned int di)
+{
+	return di % 2 == 0 || di % 5 == 0;
+}
+
+static void testAclUserSet()
+{
+	enum {NofDocuments=120};
+	Storage storage;
+	storage.open( "path=storage; acl=true", true);
+	storage.close();
+
+	storage.open( "path=storage; aclcache=1M", false);
+	strus::local_ptr<strus::StorageTransactionInterface> transaction( storage.sci->createTransaction());
+	if (!transaction.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	unsigned int di = 0;
+	for (; di < NofDocuments; ++di)
+	{
+		strus::local_ptr<strus::StorageDocumentInterface> doc( transaction->createDocument( featureString( "D", di)));
+		doc->addSearchIndexTerm( "word", "common", 1);
+		if (di % 2 == 0) doc->setUserAccessRight( "a");
+		if (di % 3 == 0) doc->setUserAccessRight( "b");
+		doc->setUserAccessRight( "c");
+		doc->done();
+	}
+	if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+
+	// Duplicates and unknown users do not change the union, the second pass reads the cached bitmap:
+	std::vector<std::string> users;
+	users.push_back( "b");
+	users.push_back( "x");
+	users.push_back( "a");
+	users.push_back( "b");
+	for (int pass=0; pass < 2; ++pass)
+	{
+		checkAclUserSet( storage.sci.get(), users, NofDocuments, &isVisibleUserSetInitial, "before the update");
+	}
+	// A commit changing the access rights outdates the cached bitmap:
+	transaction.reset( storage.sci->createTransaction());
+	if (!transaction.get()) throw std::runtime_error( g_errorhnd->fetchError());
+	for (di = 0; di < NofDocuments; ++di)
+	{
+		if (di % 3 != 0 && di % 5 != 0) continue;
+		strus::local_ptr<strus::StorageDocumentUpdateInterface> update( transaction->createDocumentUpdate( storage.sci->documentNumber( featureString( "D", di))));
+		if (!update.get()) throw std::runtime_error( g_errorhnd->fetchError());
+		if (di % 5 == 0)
+		{
+			update->setUserAccessRight( "b");
+		}
+		else
+		{
+			update->clearUserAccessRight( "b");
+		}
+		update->done();
+	}
+	if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+	for (int pass=0; pass < 2; ++pass)
+	{
+		checkAclUserSet( storage.sci.get(), users, NofDocuments, &isVisibleUserSetUpdated, "after the update");
+	}
+	storage.close();
+	if (g_errorhnd->hasError())
+	{
+		throw std::runtime_error( g_errorhnd->fetchError());
+	}
+}
+
+class CommitThread
+{
+public:
+	enum {NofCommits=20, NofDocumentsPerCommit=5, NofSharedTerms=7};
+
+	CommitThread( strus::StorageClientInterface* storage_, unsigned int threadidx_)
+		:m_storage(storage_),m_threadidx(threadidx_),m_error(){}
+
+	static std::string documentId( unsigned int threadidx, unsigned int docidx)
+	{
+		return strus::string_format( "D%u_%u", threadidx, docidx);
+	}
+	static std::string sharedTerm( unsigned int docidx)
+	{
+		return featureString( "s", docidx % NofSharedTerms);
+	}
+
+	void run()
+	{
+		try
+		{
+			unsigned int docidx = 0;
+			for (unsigned int ci=0; ci < NofCommits; ++ci)
+			{
+				strus::local_ptr<strus::StorageTransactionInterface> transaction( m_storage->createTransaction());
+				if (!transaction.get()) throw std::runtime_error( g_errorhnd->fetchError());
+				for (unsigned int di=0; di < NofDocumentsPerCommit; ++di,++docidx)
+				{
+					strus::local_ptr<strus::StorageDocumentInterface> doc( transaction->createDocument( documentId( m_threadidx, docidx)));
+					if (!doc.get()) throw std::runtime_error( g_errorhnd->fetchError());
+					doc->addSearchIndexTerm( "word", "common", 1);
+					doc->addSearchIndexTerm( "word", sharedTerm( docidx), 1);
+					doc->addSearchIndexTerm( "word", featureString( "t", m_threadidx), 1);
+					doc->done();
+				}
+				if (!transaction->commit()) throw std::runtime_error( g_errorhnd->fetchError());
+			}
+		}
+		catch (const std::exception& err)
+		{
+			m_error = err.what();
+		}
+	}
+
+	const std::string& error() const
+	{
+		return m_error;
+	}
+
+private:
+	strus::StorageClientInterface* m_storage;
+	unsigned int m_threadidx;
+	std::string m_error;
+};
+
+static void testConcurrentCommit()
+{
+	enum {NofDocumentsPerThread=CommitThread::NofCommits * CommitThread::NofDocumentsPerCommit};
+	enum {NofDocuments=NOF_COMMIT_THREADS * NofDocumentsPerThread};
+	Storage storage;
+	storage.open( "path=storage", true);
+
+	// The commits of transactions sharing terms build their blocks serialized by the stripes of the commit lock table:
+	std::vector<strus::shared_ptr<CommitThread> > commitThreads;
+	std::vector<strus::shared_ptr<strus::thread> > threads;
+	unsigned int ti = 0;
+	for (; ti < NOF_COMMIT_THREADS; ++ti)
+	{
+		commitThreads.push_back( strus::shared_ptr<CommitThread>( new CommitThread( storage.sci.get(), ti)));
+	}
+	for (ti = 0; ti < NOF_COMMIT_THREADS; ++ti)
+	{
+		threads.push_back( strus::shared_ptr<strus::thread>( new strus::thread( &CommitThread::run, commitThreads[ ti].get())));
+	}
+	for (ti = 0; ti < NOF_COMMIT_THREADS; ++ti)
+	{
+		threads[ ti]->join();
+	}
+	for (ti = 0; ti < NOF_COMMIT_THREADS; ++ti)
+	{
+		if (!commitThreads[ ti]->error().empty())
+		{
+			throw strus::runtime_error( "error in commit thread %u: %s", ti, commitThreads[ ti]->error().c_str());
+		}
+	}
+	if (storage.sci->nofDocumentsInserted() != NofDocuments)
+	{
+		throw strus::runtime_error( "number of documents after concurrent commits %d, expected %d", (int)storage.sci->nofDocumentsInserted(), (int)NofDocuments);
+	}
+	std::map<std::string,unsigned int> dfmap;
+	dfmap[ "common"] = NofDocuments;
+	for (ti = 0; ti < NOF_COMMIT_THREADS; ++ti)
+	{
+		dfmap[ featureString( "t", ti)] = NofDocumentsPerThread;
+		for (unsigned int di = 0; di < NofDocumentsPerThread; ++di)
+		{
+			++dfmap[ CommitThread::sharedTerm( di)];
+		}
+	}
+	std::map<std::string,unsigned int>::const_iterator fi = dfmap.begin(), fe = dfmap.end();
+	for (; fi != fe; ++fi)
+	{
+		strus::Index df = storage.sci->documentFrequency( "word", fi->first);
+		unsigned int nofPostings = countTermPostings( storage.sci.get(), "word", fi->first);
+		if (df != (strus::Index)fi->second || nofPostings != fi->second)
+		{
+			throw strus::runtime_error( "document frequency of term '%s' after concurrent commits %d, number of postings %u, expected %u", fi->first.c_str(), (int)df, nofPostings, fi->second);
+		}
+	}
+	// Every document is found with the postings of its terms:
+	for (ti = 0; ti < NOF_COMMIT_THREADS; ++ti)
+	{
+		strus::local_ptr<strus::PostingIteratorInterface> itr( storage.sci->createTermPostingIterator( "word", featureString( "t", ti), 1, strus::TermStatistics()));
+		if (!itr.get()) throw std::runtime_error( g_errorhnd->fetchError());
+		for (unsigned int di = 0; di < NofDocumentsPerThread; ++di)
+		{
+			strus::Index docno = storage.sci->documentNumber( CommitThread::documentId( ti, di));
+			if (!docno || itr->skipDoc( docno) != docno)
+			{
+				throw strus::runtime_error( "posting of document '%s' not found after concurrent commits", CommitThread::documentId( ti, di).c_str());
+			}
+		}
+	}
+	storage.close();
+	if (g_errorhnd->hasError())
+	{
+		throw std::runtime_error( g_errorhnd->fetchError());
+	}
 }
 
 #define RUN_TEST( idx, TestName)\
@@ -1167,7 +1756,7 @@ int main( int argc, const char* argv[])
 			return -1;
 		}
 	}
-	g_errorhnd = strus::createErrorBuffer_standard( stderr, 1, NULL/*debug trace interface*/);
+	g_errorhnd = strus::createErrorBuffer_standard( stderr, NOF_COMMIT_THREADS+1, NULL/*debug trace interface*/);
 	if (!g_errorhnd) {std::cerr << "FAILED " << "strus::createErrorBuffer_standard" << std::endl; return -1;}
 	g_fileLocator = strus::createFileLocator_std( g_errorhnd);
 	if (!g_fileLocator) {std::cerr << "FAILED " << "strus::createFileLocator_std" << std::endl; return -1;}
@@ -1186,6 +1775,12 @@ int main( int argc, const char* argv[])
 			case 7: RUN_TEST( ti, StorageUpdateStability) break;
 			case 8: RUN_TEST( ti, DocumentUpdate) break;
 			case 9: RUN_TEST( ti, ReloadConfig) break;
+			case 10: RUN_TEST( ti, TermDictionary) break;
+			case 11: RUN_TEST( ti, BlockCache) break;
+			case 12: RUN_TEST( ti, ForwardIndexRange) break;
+			case 13: RUN_TEST( ti, ForwardIndexDictionary) break;
+			case 14: RUN_TEST( ti, ConcurrentCommit) break;
+			case 15: RUN_TEST( ti, AclUserSet) break;
 			default: goto TESTS_DONE;
 		}
 		if (test_index) break;